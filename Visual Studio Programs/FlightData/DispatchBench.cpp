@@ -0,0 +1,219 @@
+// --- Frame dispatch latency benchmark (Linux) ---
+// Measures how long a flight frame takes from arriving at the bridge to being written to the
+// serial port, with the sources sleeping on their events (Reactor) and, for comparison, with the
+// old loop that checked for a frame and slept a fixed interval when there wasn't one.
+//
+// Usage: DispatchBench [--frames N] [--rate HZ] [--udp PORT] [--poll-us US] [--serial DEV [--baud B]]
+//   --frames   frames sent per run              (default 3000)
+//   --rate     send rate in Hz                  (default 250)
+//   --udp      loopback UDP port to use         (default 49500)
+//   --poll-us  sleep of the polling run, 1000 = Sleep(1) on a 1 ms timer (default 1000).
+//              Windows' default 15.6 ms tick makes the real Sleep(1) a lot worse than this.
+//   --serial   real serial port to send to; by default a pseudo-terminal is opened and drained
+//
+// A sender thread stamps every frame's time_s with the steady clock just before sendto(), so
+// "send -> serial" is the whole trip: UDP stack, acquire, cue, ik, encode and the serial write.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "FlightRecording.hpp"
+#include "LatencyStats.hpp"
+#include "MotionPipeline.hpp"
+#include "UdpSource.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+// The pre-reactor acquire loop: ask without waiting, sleep a fixed interval if nothing was there
+class PollingSource : public TelemetrySource {
+public:
+    PollingSource(TelemetrySource& inner, std::chrono::microseconds interval) : inner(inner), interval(interval) {}
+
+    bool open() override { return inner.open(); }
+    void close() override { inner.close(); }
+    Status next(FlightData& frame, std::chrono::milliseconds timeout) override {
+        auto deadline = Clock::now() + timeout;
+        for (;;) {
+            Status status = inner.next(frame, std::chrono::milliseconds(0));
+            if (status != Status::TIMEOUT || Clock::now() >= deadline) {
+                return status;
+            }
+            std::this_thread::sleep_for(interval);
+        }
+    }
+    void interrupt() override {}
+    std::string describe() const override { return "polling " + inner.describe(); }
+
+private:
+    TelemetrySource& inner;
+    std::chrono::microseconds interval;
+};
+
+// Sends frames stamped with the steady clock to 127.0.0.1:port at a fixed rate
+static void sendFrames(uint16_t port, int frames, double rateHz) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in target = {};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(port);
+    target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rateHz));
+    auto due = Clock::now() + std::chrono::milliseconds(200); // Let the pipeline settle first
+    for (int i = 0; i < frames; ++i) {
+        std::this_thread::sleep_until(due);
+        due += period;
+        FlightData f;
+        f.pitch = 2.0;
+        f.bank = (i % 200) * 0.1 - 10.0;
+        f.accelZ = 0.0; // Kinematic, level flight: FlightCue adds gravity
+        f.time_s = nowSeconds();
+        FlightRecording::RecordedFrame record = FlightRecording::toRecord(f, static_cast<uint32_t>(i));
+        sendto(sock, &record, sizeof(record), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+    }
+    close(sock);
+}
+
+// Opens a pseudo-terminal to stand in for the platform and drains it until stop is set.
+// Returns the slave's name, empty on error.
+static std::string openDrainedPty(std::atomic<bool>& stop, std::thread& drain) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        std::cerr << "Error opening a pseudo-terminal" << std::endl;
+        return "";
+    }
+    std::string name = ptsname(master);
+    drain = std::thread([master, &stop] {
+        uint8_t data[4096];
+        fcntl(master, F_SETFL, O_NONBLOCK);
+        while (!stop.load()) {
+            if (read(master, data, sizeof(data)) <= 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        close(master);
+    });
+    return name;
+}
+
+struct RunResult {
+    uint64_t received = 0;
+    uint64_t lost = 0;
+};
+
+static RunResult run(const char* name, bool polling, uint16_t udpPort, int frames, double rateHz,
+                     std::chrono::microseconds pollInterval, const std::string& serial, int baudRate,
+                     LatencyHistogram& toAcquire, LatencyHistogram& toSerial) {
+    RunResult result;
+    UdpSource udp(udpPort, "127.0.0.1");
+    PollingSource poller(udp, pollInterval);
+    TelemetrySource& source = polling ? static_cast<TelemetrySource&>(poller) : udp;
+    if (!source.open()) {
+        return result;
+    }
+    SerialTransmitter transmitter;
+    if (!transmitter.open(serial, baudRate)) {
+        source.close();
+        return result;
+    }
+
+    printf("%s: %d frames at %.0f Hz ...\n", name, frames, rateHz);
+    MotionPipeline pipeline(source, &transmitter, MotionPipeline::Settings());
+    double epoch_s = std::chrono::duration<double>(pipeline.clockEpoch().time_since_epoch()).count();
+    pipeline.start();
+    std::thread sender(sendFrames, udpPort, frames, rateHz);
+
+    // Keep collecting until the sender is done and nothing more has arrived for a while
+    auto quietUntil = Clock::now() + std::chrono::seconds(2);
+    while (Clock::now() < quietUntil) {
+        const MotionPipeline::PipelineFrame* frame = pipeline.nextOutput(std::chrono::milliseconds(50));
+        if (!frame) {
+            continue;
+        }
+        double sent_s = frame->flight.time_s;
+        toAcquire.add(static_cast<int32_t>((epoch_s + frame->done_ns[MotionPipeline::ACQUIRE] * 1e-9 - sent_s) * 1e6));
+        toSerial.add(static_cast<int32_t>((epoch_s + frame->done_ns[MotionPipeline::TRANSMIT] * 1e-9 - sent_s) * 1e6));
+        ++result.received;
+        pipeline.releaseOutput();
+        quietUntil = Clock::now() + std::chrono::milliseconds(500);
+    }
+    sender.join();
+    pipeline.stop();
+    transmitter.close();
+    result.lost = udp.stats().framesLost;
+    source.close();
+    return result;
+}
+
+int main(int argc, char** argv) {
+    int frames = 3000;
+    double rateHz = 250.0;
+    int udpPort = 49500;
+    long pollUs = 1000;
+    std::string serial;
+    int baudRate = 921600;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--frames" && value) { frames = atoi(value); ++i; }
+        else if (arg == "--rate" && value) { rateHz = atof(value); ++i; }
+        else if (arg == "--udp" && value) { udpPort = atoi(value); ++i; }
+        else if (arg == "--poll-us" && value) { pollUs = atol(value); ++i; }
+        else if (arg == "--serial" && value) { serial = value; ++i; }
+        else if (arg == "--baud" && value) { baudRate = atoi(value); ++i; }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--frames N] [--rate HZ] [--udp PORT] [--poll-us US] "
+                      << "[--serial DEV [--baud B]]" << std::endl;
+            return 1;
+        }
+    }
+    if (frames <= 0 || rateHz <= 0.0) {
+        std::cerr << "Nothing to do" << std::endl;
+        return 1;
+    }
+
+    std::atomic<bool> stopDrain{false};
+    std::thread drain;
+    if (serial.empty()) {
+        serial = openDrainedPty(stopDrain, drain);
+        if (serial.empty()) {
+            return 1;
+        }
+    }
+
+    // 10 us bins up to 50 ms
+    LatencyHistogram pollAcquire("poll: acquire", 10, 5000), pollSerial("poll: serial", 10, 5000);
+    LatencyHistogram eventAcquire("event: acquire", 10, 5000), eventSerial("event: serial", 10, 5000);
+    uint16_t port = static_cast<uint16_t>(udpPort);
+    RunResult polled = run("Polling (before)", true, port, frames, rateHz, std::chrono::microseconds(pollUs),
+                           serial, baudRate, pollAcquire, pollSerial);
+    RunResult evented = run("Event-driven (after)", false, port, frames, rateHz, std::chrono::microseconds(pollUs),
+                            serial, baudRate, eventAcquire, eventSerial);
+
+    stopDrain.store(true);
+    if (drain.joinable()) {
+        drain.join();
+    }
+
+    printf("\nLatency from sendto() to the end of each stage (serial = written to %s)\n", serial.c_str());
+    LatencyHistogram::printSummaryHeader();
+    pollAcquire.printSummary();
+    pollSerial.printSummary();
+    eventAcquire.printSummary();
+    eventSerial.printSummary();
+    printf("\nReceived %llu / %llu frames (lost %llu / %llu)\n", (unsigned long long)polled.received,
+           (unsigned long long)evented.received, (unsigned long long)polled.lost, (unsigned long long)evented.lost);
+    return 0;
+}
@@ -0,0 +1,36 @@
+#ifndef FLIGHT_CUE_HPP
+#define FLIGHT_CUE_HPP
+
+// --- Flight frame -> washout input ---
+// What the motion cueing sees of a simulator frame: specific force and body rates. Shared by the
+// pipeline's cue stage and the offline tools (WashoutTuner) so both feed the washout the same thing.
+
+#include <cmath>
+#include "TelemetrySource.hpp"
+#include "MotionLink_Lib/Washout.hpp"
+
+namespace FlightCue {
+
+// Specific force (what a seat accelerometer reads) from the sim's body acceleration: add the
+// reaction to gravity, resolved into body axes with pitch nose up / bank right side down positive
+inline void specificForce(const FlightData& f, float out[3]) {
+    const double DEG = 3.14159265358979323846 / 180.0;
+    double sp = sin(f.pitch * DEG), cp = cos(f.pitch * DEG);
+    double sb = sin(f.bank * DEG), cb = cos(f.bank * DEG);
+    out[0] = static_cast<float>(f.accelX + MotionCue::GRAVITY * sp);
+    out[1] = static_cast<float>(f.accelY - MotionCue::GRAVITY * sb * cp);
+    out[2] = static_cast<float>(f.accelZ + MotionCue::GRAVITY * cb * cp);
+}
+
+inline MotionCue::WashoutInput washoutInput(const FlightData& f) {
+    MotionCue::WashoutInput in;
+    specificForce(f, in.specificForce_mps2);
+    in.rate_dps[0] = static_cast<float>(f.rollRate);
+    in.rate_dps[1] = static_cast<float>(f.pitchRate);
+    in.rate_dps[2] = static_cast<float>(f.yawRate);
+    return in;
+}
+
+} // namespace FlightCue
+
+#endif // FLIGHT_CUE_HPP
@@ -1,164 +1,233 @@
+// --- Live / recorded flight telemetry reader ---
+// Reads frames from MSFS (Windows, SimConnect) or from a recorded flight and prints them,
+// optionally recording them so they can be replayed later on any machine.
+//
+// Usage: FlightData [--replay FILE [--speed N|max] [--loop] | --udp PORT] [--record FILE]
+//                   [--port DEV [--baud B]] [--level L] [--cue C] [--gain G] [--offload-ik] [--stats] [--quiet]
+//   --replay  play a recording (.fltrec or .csv) instead of connecting to MSFS
+//   --udp     receive frames on this UDP port instead (UdpSource.hpp), e.g. from a sim PC
+//   --speed   replay speed, 1 = real time (default), 4 = four times faster, max = no waiting
+//   --loop    start the recording again when it ends
+//   --record  write every frame to FILE, a CSV if the name ends in .csv, otherwise a binary
+//             .fltrec recording (FlightRecording.hpp, much faster to scan and seek)
+//   --port    send motion frames to the platform on this serial port (e.g. /dev/ttyACM0, COM3)
+//   --baud    serial line rate (default 115200)
+//   --level   quantization level coarse|standard|fine (default standard)
+//   --cue     washout (default): classical washout on the host (MotionLink_Lib/Washout.hpp)
+//             tilt: aircraft attitude scaled by --gain, no washout
+//             raw: level pose plus forces and rates, for firmware built with WASHOUT_ON_MCU
+//   --gain    tilt cue: platform tilt per degree of aircraft attitude (default 0.5)
+//   --offload-ik  run the platform IK here and send actuator strokes (StrokeCommand.hpp), so the
+//             firmware skips its own IK; without it the firmware gets poses and does the IK
+//   --stats   print per-stage pipeline metrics every second
+//   --quiet   don't print frames, just the summary (for benchmarks)
+//
+// Frames go through MotionPipeline (acquire -> cue -> ik -> encode -> transmit, one thread per
+// stage); this thread only prints and records what comes out the end.
+
+#ifdef _WIN32
 #include <Windows.h>
-#include <tchar.h>
+#include "SimConnectSource.hpp"
+#endif
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip> // Required for std::fixed and std::setprecision
-#include "SimConnect.h"
+#include <memory>
 #include <string> // Required for std::to_string
+#include "FlightLog.hpp"
+#include "FlightRecording.hpp"
+#include "MotionPipeline.hpp"
+#include "ReplaySource.hpp"
+#include "TelemetrySource.hpp"
+#include "UdpSource.hpp"
+
+static void printMetrics(const MotionPipeline::Metrics& metrics) {
+    printf("%-9s %10s %8s %11s %11s %11s %11s %11s\n", "stage", "frames", "dropped",
+           "service us", "max us", "latency us", "max us", "queue/max");
+    for (int s = 0; s < MotionPipeline::STAGE_COUNT; ++s) {
+        const MotionPipeline::StageMetrics& m = metrics.stages[s];
+        printf("%-9s %10llu %8llu %11.1f %11.1f %11.1f %11.1f %5zu/%-5zu\n", MotionPipeline::stageName(s),
+               (unsigned long long)m.frames, (unsigned long long)m.dropped, m.meanService_us, m.maxService_us,
+               m.meanLatency_us, m.maxLatency_us, m.queueDepth, m.queueHighWater);
+    }
+}
 
-// Forward declaration for the dispatch proc
-void CALLBACK MyDispatchProc(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext);
-
-enum DATA_DEFINE_ID {
-    DEFINITION_FLIGHT_DATA
-};
-
-enum DATA_REQUEST_ID {
-    REQUEST_FLIGHT_DATA
-};
-
-// Data structure to receive simulation data
-struct FlightData {
-    double pitch;     // degrees
-    double bank;      // degrees
-    double heading;   // degrees
-};
-
-HANDLE hSimConnect = nullptr;
-bool g_quit = false; // Flag to signal program termination
-
-// Callback function to handle received SimConnect messages
-void CALLBACK MyDispatchProc(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext) {
-    switch (pData->dwID) {
-    case SIMCONNECT_RECV_ID_SIMOBJECT_DATA: {
-        SIMCONNECT_RECV_SIMOBJECT_DATA* pObjData = reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData);
-
-        // Check if this data is the one we requested
-        if (pObjData->dwRequestID == REQUEST_FLIGHT_DATA) {
-            // Cast the received data block to our FlightData struct
-            FlightData* data = reinterpret_cast<FlightData*>(&pObjData->dwData);
-
-            // Print the data to the console, overwriting the previous line
-            std::cout << "\rPitch: " << std::fixed << std::setprecision(2) << data->pitch
-                << ",  Roll: " << std::fixed << std::setprecision(2) << data->bank
-                << ",  Yaw: " << std::fixed << std::setprecision(2) << data->heading << "       " // Added padding spaces
-                << std::flush;
+int main(int argc, char** argv) {
+    std::string replayPath;
+    std::string recordPath;
+    std::string port;
+    int baudRate = 115200;
+    int udpPort = 0;
+    double speed = 1.0;
+    bool loop = false;
+    bool quiet = false;
+    bool showStats = false;
+    MotionPipeline::Settings settings;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--replay" && value) { replayPath = value; ++i; }
+        else if (arg == "--record" && value) { recordPath = value; ++i; }
+        else if (arg == "--udp" && value) { udpPort = atoi(value); ++i; }
+        else if (arg == "--speed" && value) {
+            speed = std::string(value) == "max" ? ReplaySource::MAX_SPEED : atof(value);
+            ++i;
+        }
+        else if (arg == "--port" && value) { port = value; ++i; }
+        else if (arg == "--baud" && value) { baudRate = atoi(value); ++i; }
+        else if (arg == "--gain" && value) { settings.attitudeGain = atof(value); ++i; }
+        else if (arg == "--cue" && value) {
+            std::string name = value; ++i;
+            if (name == "tilt") settings.cue = MotionPipeline::Cue::TILT;
+            else if (name == "raw") settings.cue = MotionPipeline::Cue::RAW;
+            else settings.cue = MotionPipeline::Cue::WASHOUT;
+        }
+        else if (arg == "--level" && value) {
+            std::string name = value; ++i;
+            if (name == "coarse") settings.level = MotionSchema::QuantLevel::COARSE;
+            else if (name == "fine") settings.level = MotionSchema::QuantLevel::FINE;
+            else settings.level = MotionSchema::QuantLevel::STANDARD;
+        }
+        else if (arg == "--loop") { loop = true; }
+        else if (arg == "--offload-ik") { settings.offloadIK = true; }
+        else if (arg == "--stats") { showStats = true; }
+        else if (arg == "--quiet") { quiet = true; }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--replay FILE [--speed N|max] [--loop] | --udp PORT] [--record FILE] "
+                      << "[--port DEV [--baud B]] [--level coarse|standard|fine] [--cue washout|tilt|raw] [--gain G] [--offload-ik] [--stats] [--quiet]" << std::endl;
+            return 1;
         }
-        break;
     }
 
-    case SIMCONNECT_RECV_ID_QUIT: {
-        // Simulator has closed the connection
-        std::cerr << "\nSimConnect connection closed by simulator." << std::endl;
-        g_quit = true; // Signal the main loop to exit
-        break;
+    std::unique_ptr<TelemetrySource> source;
+    ReplaySource* replay = nullptr;
+    if (!replayPath.empty()) {
+        replay = new ReplaySource(replayPath, speed, loop);
+        source.reset(replay);
+    } else if (udpPort > 0) {
+        source.reset(new UdpSource(static_cast<uint16_t>(udpPort)));
+    } else {
+#ifdef _WIN32
+        source.reset(new SimConnectSource());
+#else
+        std::cerr << "SimConnect is only available on Windows, use --replay FILE or --udp PORT" << std::endl;
+        return 1;
+#endif
     }
 
-    case SIMCONNECT_RECV_ID_EXCEPTION: {
-        // An exception occurred within SimConnect
-        SIMCONNECT_RECV_EXCEPTION* pEx = reinterpret_cast<SIMCONNECT_RECV_EXCEPTION*>(pData);
-        std::cerr << "\nSimConnect Exception received: Code=" << pEx->dwException
-            << " SendID=" << pEx->dwSendID
-            << " Index=" << pEx->dwIndex << std::endl;
-        // Depending on the severity, you might want to quit
-        // For simplicity here, we will quit on any exception
-        g_quit = true;
-        break;
+    if (!source->open()) {
+        return 1;
     }
-
-    case SIMCONNECT_RECV_ID_OPEN: {
-        // Connection successfully opened (though we already know this from SimConnect_Open)
-        std::cout << "SimConnect connection opened event received." << std::endl;
-        break;
+    std::cout << "Reading " << source->describe() << std::endl;
+
+    FILE* recordFile = nullptr;
+    FlightRecording::Writer recordWriter;
+    bool recordCsv = recordPath.size() >= 4 && recordPath.compare(recordPath.size() - 4, 4, ".csv") == 0;
+    if (!recordPath.empty() && !recordCsv) {
+        if (!recordWriter.open(recordPath)) {
+            source->close();
+            return 1;
+        }
+    } else if (!recordPath.empty()) {
+        recordFile = fopen(recordPath.c_str(), "w");
+        if (!recordFile) {
+            std::cerr << "Error opening " << recordPath << std::endl;
+            source->close();
+            return 1;
+        }
+        fprintf(recordFile, "%s\n", FlightLog::csvHeader());
     }
 
-    case SIMCONNECT_RECV_ID_EVENT: {
-        // Handle other events if needed in the future
-        break;
-    }
+    // A max-speed replay is a benchmark/regression run: every frame has to make it through
+    settings.lossless = replay && speed <= ReplaySource::MAX_SPEED;
 
-    default: {
-        // Optional: Log unhandled message types
-        // std::cout << "\nReceived unhandled SimConnect message ID: " << pData->dwID << std::endl;
-        break;
-    }
+    SerialTransmitter transmitter;
+    if (!port.empty() && !transmitter.open(port, baudRate)) {
+        source->close();
+        return 1;
     }
-}
-
-int main() {
-    HRESULT hr; // Variable to store function results
-
-    // Attempt to open a connection to SimConnect
-    hr = SimConnect_Open(&hSimConnect, "Live Telemetry Reader", nullptr, 0, 0, 0);
 
-    if (SUCCEEDED(hr)) {
-        std::cout << "Connected to MSFS via SimConnect!" << std::endl;
-
-        // Define the data structure members we want to receive
-        // IMPORTANT: The order MUST match the FlightData struct definition
-        hr = SimConnect_AddToDataDefinition(hSimConnect, DEFINITION_FLIGHT_DATA, "PLANE PITCH DEGREES", "degrees", SIMCONNECT_DATATYPE_FLOAT64);
-        if FAILED(hr) std::cerr << "Error adding pitch definition: " << hr << std::endl;
-
-        hr = SimConnect_AddToDataDefinition(hSimConnect, DEFINITION_FLIGHT_DATA, "PLANE BANK DEGREES", "degrees", SIMCONNECT_DATATYPE_FLOAT64);
-        if FAILED(hr) std::cerr << "Error adding bank definition: " << hr << std::endl;
-
-        hr = SimConnect_AddToDataDefinition(hSimConnect, DEFINITION_FLIGHT_DATA, "PLANE HEADING DEGREES MAGNETIC", "degrees", SIMCONNECT_DATATYPE_FLOAT64);
-        if FAILED(hr) std::cerr << "Error adding heading definition: " << hr << std::endl;
-
-
-        // Request the defined data structure periodically (per simulation frame)
-        hr = SimConnect_RequestDataOnSimObject(
-            hSimConnect,
-            REQUEST_FLIGHT_DATA,              // Unique ID for this request
-            DEFINITION_FLIGHT_DATA,           // ID of the data definition to use
-            SIMCONNECT_OBJECT_ID_USER,        // Request data for the user's aircraft
-            SIMCONNECT_PERIOD_SIM_FRAME,      // *** Request data every simulation frame (high speed) ***
-            SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT, // Send data normally (consider _CHANGED if needed later)
-            0,                                // No offset within the period
-            0,                                // No interval limit
-            0                                 // *** Corrected: dwArrayCount should be 0 for single struct ***
-        );
-        if FAILED(hr) std::cerr << "Error requesting data: " << hr << std::endl;
-
-
-        // Main message processing loop
-        std::cout << "Starting real-time data processing loop..." << std::endl;
-        while (!g_quit) {
-            // Process any pending SimConnect messages
-            hr = SimConnect_CallDispatch(hSimConnect, MyDispatchProc, nullptr);
-
-            if (FAILED(hr)) {
-                // An error occurred during message dispatch (e.g., connection lost)
-                std::cerr << "\nSimConnect_CallDispatch failed with HRESULT: 0x"
-                    << std::hex << hr << std::dec << std::endl;
-                g_quit = true; // Signal loop termination
-                break;         // Exit the loop immediately
+    // Acquisition, cueing, encoding and sending run on the pipeline's own threads; this thread is
+    // only the sink (console + recorder), so a slow console never holds up the next sim frame
+    MotionPipeline pipeline(*source, port.empty() ? nullptr : &transmitter, settings);
+    std::cout << "Starting motion pipeline" << (settings.offloadIK ? " with host-side IK" : "")
+              << (port.empty() ? " (no --port, not sending)" : (" -> " + port)) << "..." << std::endl;
+    auto startTime = std::chrono::steady_clock::now();
+    auto nextPrint = startTime;
+    auto nextStats = startTime + std::chrono::seconds(1);
+    unsigned long long frameCount = 0;
+    unsigned long long clampedFrames = 0;
+    bool running = true;
+    pipeline.start();
+    while (running) {
+        const MotionPipeline::PipelineFrame* frame = pipeline.nextOutput(std::chrono::milliseconds(100));
+        auto now = std::chrono::steady_clock::now();
+        if (frame) {
+            const FlightData& data = frame->flight;
+            ++frameCount;
+            if (!frame->reachable) {
+                ++clampedFrames;
             }
-
-            // Sleep briefly to avoid consuming 100% CPU if the dispatch call returns very quickly
-            // without processing any messages. Adjust as needed or remove if CPU usage is acceptable.
-            Sleep(1);
-        }
-        std::cout << std::endl << "Exiting processing loop." << std::endl; // Move to next line after loop ends
-
-
-        // Clean up and close the SimConnect connection
-        hr = SimConnect_Close(hSimConnect);
-        if (FAILED(hr)) {
-            std::cerr << "Error closing SimConnect connection: " << hr << std::endl;
+            if (recordFile) {
+                FlightLog::writeCsvRow(recordFile, data);
+            } else if (!recordPath.empty() && !recordWriter.append(data)) {
+                running = false;
+            }
+            if (!quiet && now >= nextPrint) {
+                // Print the data to the console, overwriting the previous line (at most 20 times a second)
+                std::cout << "\rPitch: " << std::fixed << std::setprecision(2) << data.pitch
+                    << " deg,  Roll: " << std::fixed << std::setprecision(2) << data.bank
+                    << " deg,  Yaw: " << std::fixed << std::setprecision(2) << data.heading << " deg       " // Added padding spaces
+                    << std::flush;
+                nextPrint = now + std::chrono::milliseconds(50);
+            }
+            pipeline.releaseOutput();
+        } else if (pipeline.finished()) {
+            running = false;
         }
-        else {
-            std::cout << "SimConnect connection closed." << std::endl;
+        if (showStats && now >= nextStats) {
+            std::cout << std::endl;
+            printMetrics(pipeline.metrics());
+            nextStats = now + std::chrono::seconds(1);
         }
     }
-    else {
-        // Failed to open the connection
-        std::cerr << "Failed to connect to MSFS. HRESULT: 0x"
-            << std::hex << hr << std::dec << std::endl;
-        std::cerr << "Ensure MSFS is running and SimConnect is installed/configured correctly." << std::endl;
+    pipeline.stop();
+    std::cout << std::endl << "Exiting processing loop." << std::endl; // Move to next line after loop ends
+
+    double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    printf("%llu frames in %.3f s (%.0f frames/s)\n\n", frameCount, elapsed_s, elapsed_s > 0.0 ? frameCount / elapsed_s : 0.0);
+    printMetrics(pipeline.metrics());
+    if (settings.offloadIK) {
+        printf("Host IK: %llu frames outside the workspace (strokes clamped)\n", clampedFrames);
+    }
+    if (!port.empty()) {
+        const SerialTransmitter::Stats& tx = transmitter.stats();
+        printf("Serial: %llu frames queued, %llu coalesced, %llu dropped, %llu bytes written\n",
+               (unsigned long long)tx.framesQueued, (unsigned long long)tx.framesCoalesced,
+               (unsigned long long)tx.framesDropped, (unsigned long long)tx.bytesWritten);
+        transmitter.close();
+    }
+    if (replay && speed > ReplaySource::MAX_SPEED) {
+        printf("Recording is %.3f s long, %llu frames more than 1 ms late (worst %.2f ms)\n",
+               replay->duration_s(), (unsigned long long)replay->stats().framesLate, replay->stats().maxLate_ms);
     }
 
-    std::cout << "Program finished. Press Enter to exit." << std::endl;
-    std::cin.get(); // Keep console window open until user presses Enter
+    if (recordFile) {
+        fclose(recordFile);
+    }
+    if (!recordPath.empty() && recordWriter.close()) {
+        std::cout << "Recorded to " << recordPath << std::endl;
+    }
+    source->close();
 
+#ifdef _WIN32
+    if (!replay && udpPort == 0) {
+        std::cout << "Program finished. Press Enter to exit." << std::endl;
+        std::cin.get(); // Keep console window open until user presses Enter
+    }
+#endif
     return 0;
-}
\ No newline at end of file
+}
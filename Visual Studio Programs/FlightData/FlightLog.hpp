@@ -0,0 +1,34 @@
+#ifndef FLIGHT_LOG_HPP
+#define FLIGHT_LOG_HPP
+
+// --- Recorded flight CSV ---
+// One FlightData per line, columns in struct order, written by FlightData --record and read
+// back by ReplaySource. Plain text so recordings can be opened in a spreadsheet.
+
+#include <cstdio>
+#include <string>
+#include "TelemetrySource.hpp"
+
+namespace FlightLog {
+
+inline const char* csvHeader() {
+    return "time_s,pitch_deg,bank_deg,heading_deg,pitch_rate_dps,roll_rate_dps,yaw_rate_dps,"
+           "accel_x_mps2,accel_y_mps2,accel_z_mps2";
+}
+
+inline void writeCsvRow(FILE* file, const FlightData& f) {
+    fprintf(file, "%.6f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+            f.time_s, f.pitch, f.bank, f.heading, f.pitchRate, f.rollRate, f.yawRate,
+            f.accelX, f.accelY, f.accelZ);
+}
+
+// False for the header, blank lines or anything that doesn't have all ten columns
+inline bool parseCsvRow(const char* line, FlightData& f) {
+    return sscanf(line, "%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf",
+                  &f.time_s, &f.pitch, &f.bank, &f.heading, &f.pitchRate, &f.rollRate, &f.yawRate,
+                  &f.accelX, &f.accelY, &f.accelZ) == 10;
+}
+
+} // namespace FlightLog
+
+#endif // FLIGHT_LOG_HPP
@@ -0,0 +1,281 @@
+#include "FlightRecording.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace FlightRecording {
+
+// Large stdio buffer so a chunk goes out in a handful of write() calls
+static const size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+bool isRecording(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    char magic[sizeof(MAGIC)] = {};
+    bool match = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    fclose(file);
+    return match;
+}
+
+// --- Writer ---
+
+bool Writer::open(const std::string& path) {
+    close();
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error opening " << path << " for writing" << std::endl;
+        return false;
+    }
+    setvbuf(file, nullptr, _IOFBF, WRITE_BUFFER_SIZE);
+
+    // Placeholder header, the counts and index offset are filled in by close()
+    FileHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.recordSize = sizeof(RecordedFrame);
+    header.chunkRecords = CHUNK_RECORDS;
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::cerr << "Error writing " << path << std::endl;
+        fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    chunk.clear();
+    chunk.reserve(CHUNK_RECORDS);
+    index.clear();
+    offset = sizeof(FileHeader);
+    records = 0;
+    nextSequence = 0;
+    return true;
+}
+
+bool Writer::append(const FlightData& frame) {
+    return append(toRecord(frame, nextSequence));
+}
+
+bool Writer::append(const RecordedFrame& record) {
+    if (!file) {
+        return false;
+    }
+    if (records == 0) {
+        firstTime_s = record.time_s;
+    }
+    lastTime_s = record.time_s;
+    chunk.push_back(record);
+    nextSequence = record.sequence + 1;
+    ++records;
+    return chunk.size() < CHUNK_RECORDS || flushChunk();
+}
+
+bool Writer::flushChunk() {
+    if (chunk.empty()) {
+        return true;
+    }
+    ChunkHeader header = {};
+    header.magic = CHUNK_MAGIC;
+    header.count = static_cast<uint32_t>(chunk.size());
+    header.firstTime_s = chunk.front().time_s;
+    header.lastTime_s = chunk.back().time_s;
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(chunk.data(), sizeof(RecordedFrame), chunk.size(), file) != chunk.size()) {
+        std::cerr << "Error writing recording chunk" << std::endl;
+        return false;
+    }
+
+    ChunkIndexEntry entry;
+    entry.firstTime_s = header.firstTime_s;
+    entry.lastTime_s = header.lastTime_s;
+    entry.offset = offset;
+    entry.count = header.count;
+    index.push_back(entry);
+
+    offset += sizeof(ChunkHeader) + chunk.size() * sizeof(RecordedFrame);
+    chunk.clear();
+    return true;
+}
+
+bool Writer::close() {
+    if (!file) {
+        return true;
+    }
+    bool ok = flushChunk();
+    ok = ok && fwrite(index.data(), sizeof(ChunkIndexEntry), index.size(), file) == index.size();
+
+    FileHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.recordSize = sizeof(RecordedFrame);
+    header.chunkRecords = CHUNK_RECORDS;
+    header.recordCount = records;
+    header.chunkCount = index.size();
+    header.indexOffset = offset;
+    header.firstTime_s = firstTime_s;
+    header.lastTime_s = lastTime_s;
+    ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+
+    ok = (fclose(file) == 0) && ok;
+    file = nullptr;
+    if (!ok) {
+        std::cerr << "Error finishing recording" << std::endl;
+    }
+    return ok;
+}
+
+// --- Reader ---
+
+bool Reader::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE fileH = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileH == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error opening " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(fileH, &fileSize);
+    size = static_cast<uint64_t>(fileSize.QuadPart);
+    HANDLE mappingH = size > 0 ? CreateFileMappingA(fileH, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = mappingH ? MapViewOfFile(mappingH, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cerr << "Error mapping " << path << std::endl;
+        if (mappingH) CloseHandle(mappingH);
+        CloseHandle(fileH);
+        return false;
+    }
+    fileHandle = fileH;
+    mappingHandle = mappingH;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error opening " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    fstat(fd, &info);
+    size = static_cast<uint64_t>(info.st_size);
+    void* view = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd); // The mapping keeps the file alive
+    if (view == MAP_FAILED) {
+        std::cerr << "Error mapping " << path << std::endl;
+        return false;
+    }
+    // Mostly read front to back, let the kernel read ahead aggressively
+    madvise(view, size, MADV_SEQUENTIAL);
+#endif
+    data = static_cast<const uint8_t*>(view);
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+    if (size < sizeof(FileHeader) || memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << path << " is not a flight recording" << std::endl;
+        close();
+        return false;
+    }
+    if (header->version != FORMAT_VERSION || header->byteOrder != BYTE_ORDER_MARK ||
+        header->recordSize != sizeof(RecordedFrame) || header->chunkRecords != CHUNK_RECORDS) {
+        std::cerr << path << ": unsupported recording version or byte order" << std::endl;
+        close();
+        return false;
+    }
+
+    uint64_t indexBytes = header->chunkCount * sizeof(ChunkIndexEntry);
+    if (header->indexOffset != 0 && header->indexOffset + indexBytes <= size) {
+        const ChunkIndexEntry* entries = reinterpret_cast<const ChunkIndexEntry*>(data + header->indexOffset);
+        index.assign(entries, entries + header->chunkCount);
+        records = header->recordCount;
+    } else if (!rebuildIndex()) {
+        std::cerr << path << ": no readable chunks" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Walks the chunk headers of a file that was never closed; stops at the first incomplete chunk
+bool Reader::rebuildIndex() {
+    index.clear();
+    records = 0;
+    uint64_t position = sizeof(FileHeader);
+    while (position + sizeof(ChunkHeader) <= size) {
+        const ChunkHeader* chunk = reinterpret_cast<const ChunkHeader*>(data + position);
+        uint64_t bytes = sizeof(ChunkHeader) + uint64_t(chunk->count) * sizeof(RecordedFrame);
+        if (chunk->magic != CHUNK_MAGIC || chunk->count == 0 || chunk->count > CHUNK_RECORDS || position + bytes > size) {
+            break;
+        }
+        ChunkIndexEntry entry;
+        entry.firstTime_s = chunk->firstTime_s;
+        entry.lastTime_s = chunk->lastTime_s;
+        entry.offset = position;
+        entry.count = chunk->count;
+        index.push_back(entry);
+        records += chunk->count;
+        position += bytes;
+    }
+    indexRebuilt = true;
+    return !index.empty();
+}
+
+void Reader::close() {
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<uint8_t*>(data), size);
+#endif
+    }
+    data = nullptr;
+    size = 0;
+    index.clear();
+    records = 0;
+    indexRebuilt = false;
+}
+
+const RecordedFrame* Reader::chunkRecords(size_t chunk, size_t& count) const {
+    const ChunkIndexEntry& entry = index[chunk];
+    count = static_cast<size_t>(entry.count);
+    return reinterpret_cast<const RecordedFrame*>(data + entry.offset + sizeof(ChunkHeader));
+}
+
+const RecordedFrame& Reader::record(uint64_t i) const {
+    // Every chunk but the last is full, so the chunk number is a division
+    size_t count;
+    const RecordedFrame* chunk = chunkRecords(static_cast<size_t>(i / CHUNK_RECORDS), count);
+    return chunk[i % CHUNK_RECORDS];
+}
+
+uint64_t Reader::seek(double time_s) const {
+    // First chunk whose last record is at or after time_s...
+    auto entry = std::lower_bound(index.begin(), index.end(), time_s,
+                                  [](const ChunkIndexEntry& e, double t) { return e.lastTime_s < t; });
+    if (entry == index.end()) {
+        return records;
+    }
+    // ...then the first record in it at or after time_s
+    size_t chunk = static_cast<size_t>(entry - index.begin());
+    size_t count;
+    const RecordedFrame* first = chunkRecords(chunk, count);
+    const RecordedFrame* found = std::lower_bound(first, first + count, time_s,
+                                                  [](const RecordedFrame& r, double t) { return r.time_s < t; });
+    return uint64_t(chunk) * CHUNK_RECORDS + static_cast<uint64_t>(found - first);
+}
+
+} // namespace FlightRecording
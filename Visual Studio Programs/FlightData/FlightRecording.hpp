@@ -0,0 +1,191 @@
+#ifndef FLIGHT_RECORDING_HPP
+#define FLIGHT_RECORDING_HPP
+
+// --- Binary flight recordings (.fltrec) ---
+// Hours of FlightData frames in a form that can be scanned at memory speed and seeked by time
+// without parsing text. Layout:
+//
+//   FileHeader                          64 B, rewritten on close with the final counts
+//   chunk 0: ChunkHeader + records      64 B + up to CHUNK_RECORDS x 64 B
+//   chunk 1: ...
+//   ChunkIndexEntry[chunkCount]         time range + file offset of every chunk
+//
+// Every record is one 64-byte, 64-byte-aligned RecordedFrame, so a record never straddles a
+// cache line and a chunk is a plain array. Chunks hold CHUNK_RECORDS records each (the last may
+// be short), so record i is found without a search; time seeks binary-search the chunk index and
+// then the records inside one chunk, O(log n) either way.
+//
+// The writer appends whole chunks with one write each. If it never gets to close() (crash, power
+// cut), the header still says "no index" and the reader rebuilds the index by walking the chunk
+// headers, losing at most the chunk that was still in memory.
+//
+// Files are written in the host's byte order (checked on open); every machine we run on is
+// little-endian.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "TelemetrySource.hpp"
+
+namespace FlightRecording {
+
+constexpr char MAGIC[8] = { 'F', 'L', 'T', 'R', 'E', 'C', '0', '1' };
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t CHUNK_MAGIC = 0x4B4E4843;    // "CHNK"
+constexpr uint32_t CHUNK_RECORDS = 4096;        // 256 KB of records per chunk
+
+// Frames are stored as float apart from the timestamp: 0.0001 deg / 0.0001 m/s^2 resolution is
+// far below anything the platform can reproduce, and it keeps a record in one cache line.
+struct alignas(64) RecordedFrame {
+    double time_s;
+    float pitch;
+    float bank;
+    float heading;
+    float pitchRate;
+    float rollRate;
+    float yawRate;
+    float accelX;
+    float accelY;
+    float accelZ;
+    uint32_t sequence;              // Frame number in the recording, gaps show dropped frames
+    uint8_t reserved[16];
+};
+static_assert(sizeof(RecordedFrame) == 64, "RecordedFrame must be one cache line");
+
+struct alignas(64) FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t recordSize;
+    uint32_t chunkRecords;
+    uint64_t recordCount;           // 0 and indexOffset 0 until the file is closed cleanly
+    uint64_t chunkCount;
+    uint64_t indexOffset;
+    double firstTime_s;
+    double lastTime_s;
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader must be 64 bytes");
+
+struct alignas(64) ChunkHeader {
+    uint32_t magic;
+    uint32_t count;
+    double firstTime_s;
+    double lastTime_s;
+    uint8_t reserved[40];
+};
+static_assert(sizeof(ChunkHeader) == 64, "ChunkHeader must be 64 bytes");
+
+struct ChunkIndexEntry {
+    double firstTime_s;
+    double lastTime_s;
+    uint64_t offset;                // File offset of the ChunkHeader
+    uint64_t count;
+};
+
+inline RecordedFrame toRecord(const FlightData& f, uint32_t sequence) {
+    RecordedFrame r = {};
+    r.time_s = f.time_s;
+    r.pitch = static_cast<float>(f.pitch);
+    r.bank = static_cast<float>(f.bank);
+    r.heading = static_cast<float>(f.heading);
+    r.pitchRate = static_cast<float>(f.pitchRate);
+    r.rollRate = static_cast<float>(f.rollRate);
+    r.yawRate = static_cast<float>(f.yawRate);
+    r.accelX = static_cast<float>(f.accelX);
+    r.accelY = static_cast<float>(f.accelY);
+    r.accelZ = static_cast<float>(f.accelZ);
+    r.sequence = sequence;
+    return r;
+}
+
+inline FlightData fromRecord(const RecordedFrame& r) {
+    FlightData f;
+    f.time_s = r.time_s;
+    f.pitch = r.pitch;
+    f.bank = r.bank;
+    f.heading = r.heading;
+    f.pitchRate = r.pitchRate;
+    f.rollRate = r.rollRate;
+    f.yawRate = r.yawRate;
+    f.accelX = r.accelX;
+    f.accelY = r.accelY;
+    f.accelZ = r.accelZ;
+    return f;
+}
+
+// True if path starts with the .fltrec magic (used to pick binary vs CSV replay)
+bool isRecording(const std::string& path);
+
+// --- Writer: buffered append, one write per chunk ---
+class Writer {
+public:
+    Writer() = default;
+    ~Writer() { close(); }
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    bool open(const std::string& path);
+    bool append(const FlightData& frame);
+    bool append(const RecordedFrame& record);
+    bool close();                   // Writes the last chunk, the index and the final header
+
+    uint64_t recordCount() const { return records; }
+
+private:
+    bool flushChunk();
+
+    FILE* file = nullptr;
+    std::vector<RecordedFrame> chunk;
+    std::vector<ChunkIndexEntry> index;
+    uint64_t offset = 0;
+    uint64_t records = 0;
+    uint32_t nextSequence = 0;
+    double firstTime_s = 0.0;
+    double lastTime_s = 0.0;
+};
+
+// --- Reader: whole file memory-mapped read-only ---
+class Reader {
+public:
+    Reader() = default;
+    ~Reader() { close(); }
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    uint64_t recordCount() const { return records; }
+    size_t chunkCount() const { return index.size(); }
+    double firstTime_s() const { return index.empty() ? 0.0 : index.front().firstTime_s; }
+    double lastTime_s() const { return index.empty() ? 0.0 : index.back().lastTime_s; }
+    bool recovered() const { return indexRebuilt; }  // File wasn't closed cleanly
+
+    // Records of one chunk as a contiguous array, for full scans
+    const RecordedFrame* chunkRecords(size_t chunk, size_t& count) const;
+
+    // Record i of the whole file (i < recordCount())
+    const RecordedFrame& record(uint64_t i) const;
+
+    // Index of the first record at or after time_s (recordCount() if there is none)
+    uint64_t seek(double time_s) const;
+
+private:
+    bool rebuildIndex();
+
+    const uint8_t* data = nullptr;
+    uint64_t size = 0;
+    std::vector<ChunkIndexEntry> index;
+    uint64_t records = 0;
+    bool indexRebuilt = false;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+} // namespace FlightRecording
+
+#endif // FLIGHT_RECORDING_HPP
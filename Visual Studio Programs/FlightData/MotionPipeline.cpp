@@ -0,0 +1,337 @@
+#include "MotionPipeline.hpp"
+#include "FlightCue.hpp"
+#include "MotionLink_Lib/StrokeCommand.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using MotionSchema::QuantLevel;
+
+// How long an idle stage sleeps before re-checking for shutdown
+static const std::chrono::microseconds IDLE_WAIT(20000);
+// Where the port can't be watched for writability (Windows), transmit re-flushes this often
+// while bytes are still waiting for the driver
+static const std::chrono::microseconds TX_RETRY_WAIT(1000);
+// Longest acquire waits for a frame before re-checking for shutdown
+static const std::chrono::milliseconds ACQUIRE_TIMEOUT(100);
+
+const char* MotionPipeline::stageName(int stage) {
+    static const char* names[STAGE_COUNT] = { "acquire", "cue", "ik", "encode", "transmit" };
+    return stage >= 0 && stage < STAGE_COUNT ? names[stage] : "?";
+}
+
+MotionPipeline::MotionPipeline(TelemetrySource& source, SerialTransmitter* transmitter, const Settings& settings)
+    : source(source), transmitter(transmitter), settings(settings), epoch(std::chrono::steady_clock::now()) {
+    washout.configure(settings.washout, static_cast<float>(1.0 / settings.washoutRate_hz));
+    for (std::atomic<bool>& done : stageDone) {
+        done.store(false);
+    }
+}
+
+MotionPipeline::~MotionPipeline() {
+    stop();
+}
+
+int64_t MotionPipeline::now_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void MotionPipeline::start() {
+    stopping.store(false);
+    threads[ACQUIRE] = std::thread(&MotionPipeline::acquireLoop, this);
+    for (int stage = CUE; stage < TRANSMIT; ++stage) {
+        threads[stage] = std::thread(&MotionPipeline::workerLoop, this, static_cast<Stage>(stage));
+    }
+    threads[TRANSMIT] = std::thread(&MotionPipeline::transmitLoop, this);
+}
+
+void MotionPipeline::stop() {
+    stopping.store(true);
+    source.interrupt();
+    for (std::thread& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+// --- Stage threads ---
+
+void MotionPipeline::acquireLoop() {
+    PipelineFrame frame;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        TelemetrySource::Status status = source.next(frame.flight, ACQUIRE_TIMEOUT);
+        if (status == TelemetrySource::Status::FRAME) {
+            frame.done_ns[ACQUIRE] = now_ns();
+            forward(ACQUIRE, frame, frame.done_ns[ACQUIRE]);
+        } else if (status != TelemetrySource::Status::TIMEOUT) {
+            break;
+        }
+    }
+    stageDone[ACQUIRE].store(true, std::memory_order_release);
+    doorbells[ACQUIRE].ring();
+}
+
+void MotionPipeline::workerLoop(Stage stage) {
+    Queue& input = queues[stage - 1];
+    Doorbell& inputBell = doorbells[stage - 1];
+    std::atomic<bool>& upstreamDone = stageDone[stage - 1];
+
+    for (;;) {
+        PipelineFrame* frame = input.front();
+        if (frame) {
+            int64_t start_ns = now_ns();
+            if (process(stage, *frame)) {
+                forward(stage, *frame, start_ns);
+            }
+            release(static_cast<Stage>(stage - 1));
+            continue;
+        }
+        // Upstream has finished and everything it sent has been handled
+        if (upstreamDone.load(std::memory_order_acquire) && input.empty()) {
+            break;
+        }
+
+        inputBell.wait([&] { return !input.empty() || upstreamDone.load(std::memory_order_acquire); }, IDLE_WAIT);
+    }
+
+    stageDone[stage].store(true, std::memory_order_release);
+    doorbells[stage].ring();
+}
+
+// Same as workerLoop(), but sleeps on the serial port as well as the encode queue: a new frame
+// rings the doorbell, which notifies the reactor, and room in the driver makes the port writable
+void MotionPipeline::transmitLoop() {
+    Queue& input = queues[ENCODE];
+    Doorbell& inputBell = doorbells[ENCODE];
+    std::atomic<bool>& upstreamDone = stageDone[ENCODE];
+
+    Reactor reactor;
+    inputBell.setWaker([](void* context) { static_cast<Reactor*>(context)->notify(); }, &reactor);
+    bool watchingPort = false;
+#ifndef _WIN32
+    if (transmitter && transmitter->isOpen()) {
+        watchingPort = reactor.watch(transmitter->nativeHandle(), 0, [&](uint32_t events) {
+            if (events & Reactor::WRITABLE) {
+                transmitter->flush();
+            }
+        });
+    }
+#endif
+
+    for (;;) {
+        PipelineFrame* frame = input.front();
+        if (frame) {
+            int64_t start_ns = now_ns();
+            if (process(TRANSMIT, *frame)) {
+                forward(TRANSMIT, *frame, start_ns);
+            }
+            release(ENCODE);
+            continue;
+        }
+        if (upstreamDone.load(std::memory_order_acquire) && input.empty()) {
+            break;
+        }
+
+        // Only ask for writability while something is waiting, or an idle port would wake us constantly
+        bool txPending = transmitter && transmitter->pending() > 0;
+        if (watchingPort) {
+            reactor.modify(transmitter->nativeHandle(), txPending ? uint32_t(Reactor::WRITABLE) : 0u);
+        } else if (txPending) {
+            transmitter->flush();
+        }
+        inputBell.waitWith([&] { return !input.empty() || upstreamDone.load(std::memory_order_acquire); },
+                           [&] { reactor.poll(txPending && !watchingPort ? TX_RETRY_WAIT : IDLE_WAIT); });
+    }
+    inputBell.setWaker(nullptr, nullptr);
+
+    if (transmitter) {
+        transmitter->flushBlocking(std::chrono::milliseconds(200));
+    }
+    stageDone[TRANSMIT].store(true, std::memory_order_release);
+    doorbells[TRANSMIT].ring();
+}
+
+// The work of one stage on one frame; false drops the frame without forwarding it
+bool MotionPipeline::process(Stage stage, PipelineFrame& frame) {
+    switch (stage) {
+    case CUE:
+        cue(frame);
+        return true;
+
+    case IK:
+        // Without offload the MCU runs the IK on the pose and this stage passes the frame on
+        if (settings.offloadIK) {
+            frame.reachable = ik.solve(frame.pose, frame.stroke_mm);
+        }
+        return true;
+
+    case ENCODE: {
+        frame.pose.sequence = sequence++;
+        frame.pose.hostTime_us = static_cast<uint32_t>(now_ns() / 1000);
+        if (settings.offloadIK) {
+            MotionLink::StrokeCommand command;
+            command.sequence = frame.pose.sequence;
+            command.hostTime_us = frame.pose.hostTime_us;
+            for (size_t i = 0; i < PlatformIK::LEGS; ++i) {
+                command.stroke_mm[i] = frame.stroke_mm[i];
+            }
+            frame.wireLength = MotionLink::buildStrokeCommand(command, frame.wire);
+            return true;
+        }
+        switch (settings.level) {
+        case QuantLevel::COARSE:
+            frame.wireLength = MotionLink::buildMotionFrame<QuantLevel::COARSE>(frame.pose, frame.wire);
+            break;
+        case QuantLevel::FINE:
+            frame.wireLength = MotionLink::buildMotionFrame<QuantLevel::FINE>(frame.pose, frame.wire);
+            break;
+        case QuantLevel::STANDARD:
+        default:
+            frame.wireLength = MotionLink::buildMotionFrame<QuantLevel::STANDARD>(frame.pose, frame.wire);
+            break;
+        }
+        return true;
+    }
+
+    case TRANSMIT:
+        if (transmitter) {
+            transmitter->queueFrame(frame.wire, frame.wireLength, true);
+            transmitter->flush();
+        }
+        return true;
+
+    default:
+        return true;
+    }
+}
+
+void MotionPipeline::cue(PipelineFrame& frame) {
+    const FlightData& flight = frame.flight;
+    MotionSchema::MotionFrame& pose = frame.pose;
+    const MotionCue::WashoutInput in = FlightCue::washoutInput(flight);
+    pose.rollRate_dps = in.rate_dps[0];
+    pose.pitchRate_dps = in.rate_dps[1];
+    pose.yawRate_dps = in.rate_dps[2];
+    pose.specificForceX_mps2 = in.specificForce_mps2[0];
+    pose.specificForceY_mps2 = in.specificForce_mps2[1];
+    pose.specificForceZ_mps2 = in.specificForce_mps2[2];
+    pose.roll_deg = pose.pitch_deg = pose.yaw_deg = 0.0f;
+    pose.translationX_mm = pose.translationY_mm = pose.translationZ_mm = 0.0f;
+
+    switch (settings.cue) {
+    case Cue::TILT: {
+        // Aircraft attitude scaled onto the platform and limited to what it can reach. Heading is
+        // not cued; the platform can't yaw continuously.
+        auto limit = [&](double deg) {
+            return static_cast<float>(std::max(-settings.maxTilt_deg, std::min(settings.maxTilt_deg, deg)));
+        };
+        pose.roll_deg = limit(settings.attitudeGain * flight.bank);
+        pose.pitch_deg = limit(settings.attitudeGain * flight.pitch);
+        break;
+    }
+
+    case Cue::WASHOUT: {
+        // Step the washout at its own fixed rate up to this frame's flight time, holding the
+        // frame's values across the steps. Using the flight's own clock keeps replays identical at
+        // any speed. A jump back (loop) or a long gap (pause) restarts it from neutral.
+        double dt = washout.dt();
+        if (!washoutStarted || flight.time_s < washoutTime_s || flight.time_s - washoutTime_s > 1.0) {
+            washout.reset();
+            washoutOutput = MotionCue::WashoutOutput();
+            washoutTime_s = flight.time_s - dt;
+            washoutStarted = true;
+        }
+        MotionCue::WashoutOutput& out = washoutOutput;  // Unchanged if no step was due yet
+        while (washoutTime_s + dt <= flight.time_s + 1e-9) {
+            washout.step(in, out);
+            washoutTime_s += dt;
+        }
+        pose.translationX_mm = out.translation_mm[0];
+        pose.translationY_mm = out.translation_mm[1];
+        pose.translationZ_mm = out.translation_mm[2];
+        pose.roll_deg = out.roll_deg;
+        pose.pitch_deg = out.pitch_deg;
+        pose.yaw_deg = out.yaw_deg;
+        break;
+    }
+
+    case Cue::RAW:
+    default:
+        break;
+    }
+}
+
+void MotionPipeline::forward(Stage stage, const PipelineFrame& frame, int64_t start_ns) {
+    Counters& c = counters[stage];
+    int64_t end_ns = now_ns();
+    PipelineFrame* slot = queues[stage].beginPush();
+    while (!slot && settings.lossless && !stopping.load(std::memory_order_relaxed)) {
+        Queue& output = queues[stage];
+        spaceBells[stage].wait([&] { return output.size() < QUEUE_CAPACITY || stopping.load(); }, IDLE_WAIT);
+        slot = output.beginPush();
+    }
+    if (slot) {
+        *slot = frame;
+        slot->done_ns[stage] = end_ns;
+        queues[stage].endPush();
+        doorbells[stage].ring();
+    } else {
+        c.dropped.store(c.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Single writer per counter, so plain load/store is enough
+    uint64_t service = static_cast<uint64_t>(end_ns - start_ns);
+    uint64_t latency = static_cast<uint64_t>(end_ns - frame.done_ns[ACQUIRE]);
+    c.frames.store(c.frames.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    c.service_ns.store(c.service_ns.load(std::memory_order_relaxed) + service, std::memory_order_relaxed);
+    c.latency_ns.store(c.latency_ns.load(std::memory_order_relaxed) + latency, std::memory_order_relaxed);
+    if (service > c.maxService_ns.load(std::memory_order_relaxed)) {
+        c.maxService_ns.store(service, std::memory_order_relaxed);
+    }
+    if (latency > c.maxLatency_ns.load(std::memory_order_relaxed)) {
+        c.maxLatency_ns.store(latency, std::memory_order_relaxed);
+    }
+}
+
+// --- Sink ---
+
+const MotionPipeline::PipelineFrame* MotionPipeline::nextOutput(std::chrono::microseconds timeout) {
+    Queue& output = queues[TRANSMIT];
+    const PipelineFrame* frame = output.front();
+    if (!frame) {
+        doorbells[TRANSMIT].wait([&] { return !output.empty() || finished(); }, timeout);
+        frame = output.front();
+    }
+    return frame;
+}
+
+void MotionPipeline::releaseOutput() {
+    release(TRANSMIT);
+}
+
+void MotionPipeline::release(Stage producer) {
+    queues[producer].pop();
+    if (settings.lossless) {
+        spaceBells[producer].ring();
+    }
+}
+
+MotionPipeline::Metrics MotionPipeline::metrics() const {
+    Metrics m;
+    for (int s = 0; s < STAGE_COUNT; ++s) {
+        const Counters& c = counters[s];
+        StageMetrics& out = m.stages[s];
+        out.frames = c.frames.load(std::memory_order_relaxed);
+        out.dropped = c.dropped.load(std::memory_order_relaxed);
+        if (out.frames > 0) {
+            out.meanService_us = c.service_ns.load(std::memory_order_relaxed) / 1000.0 / out.frames;
+            out.meanLatency_us = c.latency_ns.load(std::memory_order_relaxed) / 1000.0 / out.frames;
+        }
+        out.maxService_us = c.maxService_ns.load(std::memory_order_relaxed) / 1000.0;
+        out.maxLatency_us = c.maxLatency_ns.load(std::memory_order_relaxed) / 1000.0;
+        out.queueDepth = queues[s].size();
+        out.queueHighWater = queues[s].highWater();
+    }
+    return m;
+}
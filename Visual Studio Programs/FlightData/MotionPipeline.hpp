@@ -0,0 +1,160 @@
+#ifndef MOTION_PIPELINE_HPP
+#define MOTION_PIPELINE_HPP
+
+// --- Host motion pipeline ---
+// Turns simulator frames into MotionLink frames on the serial port in five stages, each on its
+// own thread and joined by SpscQueues of preallocated PipelineFrames:
+//
+//   acquire --> cue --> ik --> encode --> transmit --> (sink: console / recorder, caller's thread)
+//
+//   acquire   TelemetrySource::next(), nothing else, so a new sim frame is always picked up promptly
+//   cue       flight forces/rates -> platform pose: classical washout (Washout.hpp) by default,
+//             or the old scaled-attitude tilt, or raw forces/rates for a firmware-side washout
+//   ik        with Settings::offloadIK, the six actuator strokes (PlatformIK); otherwise a pass-through
+//             and the firmware runs the IK on the pose
+//   encode    MotionLink wire frame: a StrokeCommand when offloading, else a motion frame at the
+//             configured quantization level
+//   transmit  SerialTransmitter queue + non-blocking flush (skipped if no port is open)
+//
+// Idle stages sleep rather than poll: acquire inside the source's own event wait, the middle
+// stages on their input queue's Doorbell, and transmit in a Reactor that wakes on either a new
+// frame or the serial port becoming writable again, so a frame goes out as soon as it arrives.
+//
+// By default no stage ever blocks on the next one: when an output queue is full the frame is
+// dropped and counted, so a slow console, recorder or serial link costs frames downstream of it,
+// never acquisition. Settings::lossless makes full queues apply backpressure instead, for replays
+// at max speed where every frame has to come out the end (benchmarks, regression runs).
+// Per-stage service time, latency since acquisition, drops and queue depths are available while
+// running through metrics().
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "Reactor.hpp"
+#include "SpscQueue.hpp"
+#include "TelemetrySource.hpp"
+#include "SerialTransmitter.hpp"
+#include "MotionLink_Lib/MotionLink.hpp"
+#include "MotionLink_Lib/MotionSchema.hpp"
+#include "MotionLink_Lib/Washout.hpp"
+#include "PlatformIK.hpp"
+
+class MotionPipeline {
+public:
+    enum Stage { ACQUIRE, CUE, IK, ENCODE, TRANSMIT, STAGE_COUNT };
+    static const char* stageName(int stage);
+
+    static constexpr size_t QUEUE_CAPACITY = 64;
+
+    struct PipelineFrame {
+        FlightData flight;
+        MotionSchema::MotionFrame pose;
+        float stroke_mm[PlatformIK::LEGS] = {};     // offloadIK only
+        bool reachable = true;                      // false if IK had to clamp a leg
+        uint8_t wire[MotionLink::MAX_FRAME_SIZE];
+        size_t wireLength = 0;
+        int64_t done_ns[STAGE_COUNT] = {};  // Pipeline clock when each stage finished with the frame
+    };
+
+    enum class Cue {
+        WASHOUT,    // classical washout on the host, the platform gets the finished pose
+        TILT,       // aircraft attitude scaled and limited (no washout)
+        RAW         // level pose plus the aircraft's forces and rates, for a washout in the firmware
+    };
+
+    struct Settings {
+        Cue cue = Cue::WASHOUT;
+        MotionCue::WashoutParams washout;
+        double washoutRate_hz = 200.0;      // washout step rate, independent of the sim frame rate
+        double attitudeGain = 0.5;          // TILT: platform tilt per degree of aircraft attitude
+        double maxTilt_deg = 15.0;          // TILT: roll/pitch limit
+        MotionSchema::QuantLevel level = MotionSchema::QuantLevel::STANDARD;
+        bool lossless = false;              // wait for queue space instead of dropping (replay only)
+        bool offloadIK = false;             // send actuator strokes instead of the pose
+    };
+
+    struct StageMetrics {
+        uint64_t frames = 0;                // frames the stage finished
+        uint64_t dropped = 0;               // frames thrown away because the next queue was full
+        double meanService_us = 0.0;        // time spent on one frame in this stage
+        double maxService_us = 0.0;
+        double meanLatency_us = 0.0;        // acquisition -> end of this stage
+        double maxLatency_us = 0.0;
+        size_t queueDepth = 0;              // output queue, now
+        size_t queueHighWater = 0;          // output queue, worst so far
+    };
+
+    struct Metrics {
+        StageMetrics stages[STAGE_COUNT];
+    };
+
+    // transmitter may be null (dry run) or an open port; the pipeline only uses it from the
+    // transmit thread while running
+    MotionPipeline(TelemetrySource& source, SerialTransmitter* transmitter, const Settings& settings);
+    ~MotionPipeline();
+
+    MotionPipeline(const MotionPipeline&) = delete;
+    MotionPipeline& operator=(const MotionPipeline&) = delete;
+
+    void start();
+    void stop();                            // Stops acquisition, lets queued frames drain, joins
+
+    // True once the source has ended and every stage has drained
+    bool finished() const { return stageDone[TRANSMIT].load(std::memory_order_acquire); }
+
+    // --- Sink (caller's thread) ---
+    // Waits up to timeout for a frame that made it through transmit. Returns nullptr on timeout;
+    // otherwise the frame stays valid until releaseOutput().
+    const PipelineFrame* nextOutput(std::chrono::microseconds timeout);
+    void releaseOutput();
+
+    Metrics metrics() const;
+    int64_t now_ns() const;
+    // now_ns() counts from here, for lining done_ns up with other steady_clock times
+    std::chrono::steady_clock::time_point clockEpoch() const { return epoch; }
+
+private:
+    using Queue = SpscQueue<PipelineFrame, QUEUE_CAPACITY>;
+
+    // Per-stage counters, written by the stage's own thread only
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> service_ns{0};
+        std::atomic<uint64_t> maxService_ns{0};
+        std::atomic<uint64_t> latency_ns{0};
+        std::atomic<uint64_t> maxLatency_ns{0};
+    };
+
+    void acquireLoop();
+    void workerLoop(Stage stage);           // CUE .. ENCODE
+    void transmitLoop();
+    void release(Stage producer);           // Pops queues[producer] on the consumer's side
+    bool process(Stage stage, PipelineFrame& frame);
+    void cue(PipelineFrame& frame);
+
+    // Pushes frame to the stage's output queue (or drops it) and updates the stage counters
+    void forward(Stage stage, const PipelineFrame& frame, int64_t start_ns);
+
+    TelemetrySource& source;
+    SerialTransmitter* transmitter;
+    Settings settings;
+    std::chrono::steady_clock::time_point epoch;
+    MotionCue::ClassicalWashout washout;    // cue thread only
+    MotionCue::WashoutOutput washoutOutput;
+    double washoutTime_s = 0.0;             // flight time the washout has been stepped up to
+    bool washoutStarted = false;
+    PlatformIK ik;                          // read-only after construction
+    uint16_t sequence = 0;                  // encode thread only
+
+    Queue queues[STAGE_COUNT];              // queues[s] is stage s's output
+    Doorbell doorbells[STAGE_COUNT];        // doorbells[s] rings when queues[s] gets a frame
+    Doorbell spaceBells[STAGE_COUNT];       // spaceBells[s] rings when queues[s] frees a slot (lossless only)
+    Counters counters[STAGE_COUNT];
+    std::atomic<bool> stageDone[STAGE_COUNT];
+    std::atomic<bool> stopping{false};
+    std::thread threads[STAGE_COUNT];
+};
+
+#endif // MOTION_PIPELINE_HPP
@@ -0,0 +1,60 @@
+#include "PlatformIK.hpp"
+
+#include <cmath>
+
+using namespace PlatformGeometry;
+
+static const float DEG_TO_RAD = 3.14159265358979323846f / 180.0f;
+
+PlatformIK::PlatformIK() {
+    float center[3] = { 0.0f, 0.0f, 0.0f };
+    for (size_t j = 0; j < LEGS; ++j) {
+        for (int axis = 0; axis < 3; ++axis) {
+            center[axis] += PLATFORM_JOINTS_HOME[j][axis] / LEGS;
+        }
+    }
+
+    for (size_t i = 0; i < LANES; ++i) {
+        // Padding lanes repeat leg 0 so they compute something harmless that is then ignored
+        size_t leg = i < LEGS ? i : 0;
+        const float* p = PLATFORM_JOINTS_HOME[ACTUATOR_PLATFORM[leg]];
+        const float* b = BASE_JOINTS[ACTUATOR_BASE[leg]];
+        homeX[i] = p[0] - center[0];
+        homeY[i] = p[1] - center[1];
+        homeZ[i] = p[2] - center[2];
+        offsetX[i] = center[0] - b[0];
+        offsetY[i] = center[1] - b[1];
+        offsetZ[i] = center[2] - b[2];
+    }
+}
+
+bool PlatformIK::solve(const MotionSchema::MotionFrame& pose, float stroke_mm[LEGS]) const {
+    float sr = sinf(pose.roll_deg * DEG_TO_RAD), cr = cosf(pose.roll_deg * DEG_TO_RAD);
+    float sp = sinf(pose.pitch_deg * DEG_TO_RAD), cp = cosf(pose.pitch_deg * DEG_TO_RAD);
+    float sy = sinf(pose.yaw_deg * DEG_TO_RAD), cy = cosf(pose.yaw_deg * DEG_TO_RAD);
+
+    // R = Ry * Rz * Rx, written out (same order as getRotationMatrix() in the firmware)
+    const float r00 = cp * cy, r01 = sp * sr - cp * sy * cr, r02 = cp * sy * sr + sp * cr;
+    const float r10 = sy,      r11 = cy * cr,                r12 = -cy * sr;
+    const float r20 = -sp * cy, r21 = sp * sy * cr + cp * sr, r22 = cp * cr - sp * sy * sr;
+    const float tx = pose.translationX_mm, ty = pose.translationY_mm, tz = pose.translationZ_mm;
+
+    // Leg vector = R * home + (centroid - base) + T, for all lanes at once
+    alignas(32) float legX[LANES], legY[LANES], legZ[LANES], stroke[LANES];
+    for (size_t i = 0; i < LANES; ++i) {
+        legX[i] = r00 * homeX[i] + r01 * homeY[i] + r02 * homeZ[i] + offsetX[i] + tx;
+        legY[i] = r10 * homeX[i] + r11 * homeY[i] + r12 * homeZ[i] + offsetY[i] + ty;
+        legZ[i] = r20 * homeX[i] + r21 * homeY[i] + r22 * homeZ[i] + offsetZ[i] + tz;
+    }
+    for (size_t i = 0; i < LANES; ++i) {
+        stroke[i] = sqrtf(legX[i] * legX[i] + legY[i] * legY[i] + legZ[i] * legZ[i]) - BASE_ACTUATOR_LENGTH;
+    }
+
+    bool reachable = true;
+    for (size_t i = 0; i < LEGS; ++i) {
+        float s = stroke[i];
+        reachable = reachable && s >= 0.0f && s <= MAX_STROKE;
+        stroke_mm[i] = s < 0.0f ? 0.0f : (s > MAX_STROKE ? MAX_STROKE : s);
+    }
+    return reachable;
+}
@@ -0,0 +1,36 @@
+#ifndef PLATFORM_IK_HPP
+#define PLATFORM_IK_HPP
+
+// --- Host-side platform inverse kinematics ---
+// Same maths as the firmware loop in Platform IK/main.cpp (R = Ry * Rz * Rx about the centroid of
+// the home platform joints, then translate, leg length minus BASE_ACTUATOR_LENGTH, clamped to the
+// stroke), on the same MotionLink_Lib/PlatformGeometry.hpp constants, so offloaded strokes match
+// what the MCU would have computed.
+//
+// The six legs are kept structure-of-arrays in LANES-wide float rows (padded with a dummy leg),
+// and every per-leg step is a straight, branch-free loop over those rows. The compiler turns each
+// one into a couple of SSE/AVX/NEON instructions, so a pose is one sin/cos set plus a handful of
+// vector multiplies, adds and square roots.
+
+#include <cstddef>
+#include "MotionLink_Lib/MotionSchema.hpp"
+#include "MotionLink_Lib/PlatformGeometry.hpp"
+
+class PlatformIK {
+public:
+    static constexpr size_t LEGS = PlatformGeometry::LEGS;
+    static constexpr size_t LANES = 8;      // LEGS rounded up to a whole AVX register
+
+    PlatformIK();
+
+    // Target stroke (mm, 0 .. MAX_STROKE) of each actuator A1..A6 for the pose's attitude and
+    // translation. Returns false if any leg had to be clamped (pose outside the workspace).
+    bool solve(const MotionSchema::MotionFrame& pose, float stroke_mm[LEGS]) const;
+
+private:
+    // Per leg: platform joint relative to the home centroid, and centroid minus base joint
+    alignas(32) float homeX[LANES], homeY[LANES], homeZ[LANES];
+    alignas(32) float offsetX[LANES], offsetY[LANES], offsetZ[LANES];
+};
+
+#endif // PLATFORM_IK_HPP
@@ -0,0 +1,232 @@
+#include "Reactor.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+#endif
+
+Reactor::Watch* Reactor::find(Handle handle) {
+    for (Watch& w : watches) {
+        if (w.handle == handle) {
+            return &w;
+        }
+    }
+    return nullptr;
+}
+
+#ifdef _WIN32
+
+// --- Windows: WaitForMultipleObjects ---
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+Reactor::Reactor() {
+    wakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    // High-resolution timers need Windows 10 1803+; older versions fall back to a normal one
+    timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!timer) {
+        timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    }
+    ok = wakeEvent && timer;
+    if (!ok) {
+        std::cerr << "Reactor: could not create wake event / timer" << std::endl;
+    }
+}
+
+Reactor::~Reactor() {
+    if (wakeEvent) CloseHandle(wakeEvent);
+    if (timer) CloseHandle(timer);
+}
+
+bool Reactor::watch(Handle handle, uint32_t events, Callback callback) {
+    if (events & WRITABLE) {
+        return false;
+    }
+    // Two slots are taken by the wake event and the timer
+    if (find(handle) || watches.size() + 2 >= MAXIMUM_WAIT_OBJECTS) {
+        return false;
+    }
+    watches.push_back({ handle, events, std::move(callback) });
+    return true;
+}
+
+bool Reactor::modify(Handle handle, uint32_t events) {
+    Watch* w = find(handle);
+    if (!w || (events & WRITABLE)) {
+        return false;
+    }
+    w->events = events;
+    return true;
+}
+
+void Reactor::unwatch(Handle handle) {
+    watches.erase(std::remove_if(watches.begin(), watches.end(), [&](const Watch& w) { return w.handle == handle; }),
+                  watches.end());
+}
+
+void Reactor::notify() {
+    SetEvent(wakeEvent);
+}
+
+int Reactor::pollUntil(Clock::time_point deadline) {
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    Watch* active[MAXIMUM_WAIT_OBJECTS];
+    DWORD count = 0;
+    handles[count++] = wakeEvent;
+    handles[count++] = timer;
+    for (Watch& w : watches) {
+        if (w.events) {
+            active[count] = &w;
+            handles[count++] = w.handle;
+        }
+    }
+
+    // Relative due time in 100 ns units (negative = relative)
+    auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now()).count();
+    LARGE_INTEGER due;
+    due.QuadPart = -std::max<long long>(remaining / 100, 0);
+    SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE);
+
+    DWORD result = WaitForMultipleObjects(count, handles, FALSE, INFINITE);
+    CancelWaitableTimer(timer);
+    if (result < WAIT_OBJECT_0 + 2 || result >= WAIT_OBJECT_0 + count) {
+        return 0; // wake, deadline or error
+    }
+    // Run the signaled handle, then any others that are signaled right now
+    int ran = 0;
+    for (DWORD i = result - WAIT_OBJECT_0; i < count; ++i) {
+        if (i == result - WAIT_OBJECT_0 || WaitForSingleObject(handles[i], 0) == WAIT_OBJECT_0) {
+            active[i]->callback(READABLE);
+            ++ran;
+        }
+    }
+    return ran;
+}
+
+#else
+
+// --- Linux: epoll + eventfd + timerfd ---
+
+Reactor::Reactor() {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    ok = epollFd >= 0 && wakeFd >= 0 && timerFd >= 0;
+    if (ok) {
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = wakeFd;
+        ok = epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev) == 0;
+        ev.data.fd = timerFd;
+        ok = ok && epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &ev) == 0;
+    }
+    if (!ok) {
+        std::cerr << "Reactor: could not create epoll/eventfd/timerfd" << std::endl;
+    }
+}
+
+Reactor::~Reactor() {
+    if (epollFd >= 0) ::close(epollFd);
+    if (wakeFd >= 0) ::close(wakeFd);
+    if (timerFd >= 0) ::close(timerFd);
+}
+
+static uint32_t toEpoll(uint32_t events) {
+    return ((events & Reactor::READABLE) ? EPOLLIN : 0u) | ((events & Reactor::WRITABLE) ? EPOLLOUT : 0u);
+}
+
+bool Reactor::watch(Handle handle, uint32_t events, Callback callback) {
+    if (find(handle)) {
+        return false;
+    }
+    epoll_event ev = {};
+    ev.events = toEpoll(events);
+    ev.data.fd = handle;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, handle, &ev) != 0) {
+        return false;
+    }
+    watches.push_back({ handle, events, std::move(callback) });
+    return true;
+}
+
+bool Reactor::modify(Handle handle, uint32_t events) {
+    Watch* w = find(handle);
+    if (!w) {
+        return false;
+    }
+    if (w->events == events) {
+        return true;
+    }
+    epoll_event ev = {};
+    ev.events = toEpoll(events);
+    ev.data.fd = handle;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, handle, &ev) != 0) {
+        return false;
+    }
+    w->events = events;
+    return true;
+}
+
+void Reactor::unwatch(Handle handle) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, handle, nullptr);
+    watches.erase(std::remove_if(watches.begin(), watches.end(), [&](const Watch& w) { return w.handle == handle; }),
+                  watches.end());
+}
+
+void Reactor::notify() {
+    uint64_t one = 1;
+    ssize_t written = ::write(wakeFd, &one, sizeof(one));
+    (void)written; // Only fails if the counter is already huge, which still wakes the poll
+}
+
+int Reactor::pollUntil(Clock::time_point deadline) {
+    // steady_clock is CLOCK_MONOTONIC on Linux, so the deadline can be armed as an absolute time
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    if (ns <= 0) ns = 1; // 0 would disarm the timer
+    itimerspec spec = {};
+    spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+    timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+    epoll_event events[16];
+    int n;
+    do {
+        n = epoll_wait(epollFd, events, 16, -1);
+    } while (n < 0 && errno == EINTR);
+
+    // Disarm so a deadline left over from this call can't cut the next one short
+    itimerspec off = {};
+    timerfd_settime(timerFd, 0, &off, nullptr);
+
+    int ran = 0;
+    for (int i = 0; i < n; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == wakeFd || fd == timerFd) {
+            uint64_t count;
+            ssize_t got = ::read(fd, &count, sizeof(count)); // Reset the counter / expiry
+            (void)got;
+            continue;
+        }
+        Watch* w = find(fd);
+        if (w) {
+            uint32_t fired = ((events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) ? READABLE : 0u) |
+                             ((events[i].events & EPOLLOUT) ? WRITABLE : 0u);
+            w->callback(fired & (w->events | READABLE));
+            ++ran;
+        }
+    }
+    return ran;
+}
+
+#endif
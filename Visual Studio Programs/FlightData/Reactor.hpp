@@ -0,0 +1,85 @@
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+// --- Event-driven wait for the host bridge threads ---
+// One Reactor per thread that has to sleep until "something happened": data on a socket, a
+// SimConnect message, room in the serial driver, the time the next replay frame is due, or a
+// wake-up from another thread. The thread blocks in the kernel and wakes exactly when one of
+// those happens, instead of polling with Sleep(1) (which on Windows usually sleeps a whole
+// 15.6 ms timer tick).
+//
+//   Linux    epoll over the watched fds, an eventfd for notify() and a timerfd for deadlines
+//            (nanosecond resolution, CLOCK_MONOTONIC = std::chrono::steady_clock)
+//   Windows  WaitForMultipleObjects over the watched handles, an auto-reset event for notify()
+//            and a high-resolution waitable timer for deadlines. Windows handles are only
+//            "signaled" or not, so only READABLE is supported there; serial writes are retried
+//            on the timer instead (see MotionPipeline). A manual-reset handle (e.g. a WSAEventSelect
+//            event) stays signaled until its owner resets it, and until then every poll returns at once.
+//
+// watch/modify/unwatch/poll belong to the owning thread; notify() may be called from any thread.
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Reactor {
+public:
+#ifdef _WIN32
+    using Handle = void*;   // HANDLE, kept opaque so this header doesn't pull in Windows.h
+#else
+    using Handle = int;     // file descriptor
+#endif
+    using Clock = std::chrono::steady_clock;
+
+    enum Events : uint32_t {
+        READABLE = 1,       // Linux: data to read. Windows: handle is signaled.
+        WRITABLE = 2        // Linux only
+    };
+
+    // Called from poll() on the owning thread with the events that fired
+    using Callback = std::function<void(uint32_t events)>;
+
+    Reactor();
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    bool valid() const { return ok; }
+
+    bool watch(Handle handle, uint32_t events, Callback callback);
+    bool modify(Handle handle, uint32_t events);    // events = 0 keeps the handle but ignores it
+    void unwatch(Handle handle);
+
+    // Wakes a poll() in progress (or the next one), from any thread
+    void notify();
+
+    // Waits until a watched handle is ready, notify() is called or the deadline passes, and runs
+    // the callbacks of whatever fired. Returns the number of callbacks run (0 on deadline/notify).
+    int pollUntil(Clock::time_point deadline);
+    int poll(std::chrono::nanoseconds timeout) { return pollUntil(Clock::now() + timeout); }
+
+private:
+    struct Watch {
+        Handle handle;
+        uint32_t events;
+        Callback callback;
+    };
+
+    Watch* find(Handle handle);
+
+    std::vector<Watch> watches;
+    bool ok = false;
+
+#ifdef _WIN32
+    void* wakeEvent = nullptr;
+    void* timer = nullptr;
+#else
+    int epollFd = -1;
+    int wakeFd = -1;        // eventfd
+    int timerFd = -1;       // timerfd
+#endif
+};
+
+#endif // REACTOR_HPP
@@ -0,0 +1,165 @@
+// --- Flight recording throughput benchmark ---
+// Writes a synthetic flight, then times a full scan, random time seeks and, for comparison, the
+// same work on the equivalent CSV.
+//
+// Usage: RecordingBench [--hours H] [--rate HZ] [--seeks N] [--dir DIR] [--keep]
+//   --hours  length of the synthetic flight   (default 2)
+//   --rate   frame rate in Hz                 (default 60)
+//   --seeks  random seeks to time             (default 100000)
+//   --dir    where to put the temporary files (default .)
+//   --keep   don't delete the files afterwards
+//
+// The scan runs straight after the write, so the file is normally still in the page cache and the
+// figure is memory bandwidth rather than disk; drop caches first for a cold-disk number.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include "FlightLog.hpp"
+#include "FlightRecording.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static FlightData syntheticFrame(uint64_t i, double rateHz) {
+    FlightData f;
+    f.time_s = i / rateHz;
+    f.pitch = 5.0 * sin(0.3 * f.time_s);
+    f.bank = 20.0 * sin(0.1 * f.time_s);
+    f.heading = fmod(10.0 * f.time_s, 360.0);
+    f.pitchRate = 1.5 * cos(0.3 * f.time_s);
+    f.rollRate = 2.0 * cos(0.1 * f.time_s);
+    f.yawRate = 10.0;
+    f.accelX = 0.5 * sin(f.time_s);
+    f.accelY = 0.2 * cos(f.time_s);
+    f.accelZ = 0.3 * sin(0.5 * f.time_s); // Kinematic: FlightCue adds gravity
+    return f;
+}
+
+static void report(const char* what, double seconds, double bytes, uint64_t frames) {
+    printf("  %-22s %8.3f s  %9.1f MB/s  %8.2f M frames/s\n", what, seconds, bytes / seconds / 1e6, frames / seconds / 1e6);
+}
+
+int main(int argc, char** argv) {
+    double hours = 2.0;
+    double rateHz = 60.0;
+    long seeks = 100000;
+    std::string dir = ".";
+    bool keep = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--hours" && value) { hours = atof(value); ++i; }
+        else if (arg == "--rate" && value) { rateHz = atof(value); ++i; }
+        else if (arg == "--seeks" && value) { seeks = atol(value); ++i; }
+        else if (arg == "--dir" && value) { dir = value; ++i; }
+        else if (arg == "--keep") { keep = true; }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--hours H] [--rate HZ] [--seeks N] [--dir DIR] [--keep]" << std::endl;
+            return 1;
+        }
+    }
+    const uint64_t frames = static_cast<uint64_t>(hours * 3600.0 * rateHz);
+    if (frames == 0 || rateHz <= 0.0) {
+        std::cerr << "Nothing to do" << std::endl;
+        return 1;
+    }
+    const std::string binPath = dir + "/bench.fltrec";
+    const std::string csvPath = dir + "/bench.csv";
+    printf("%.1f h at %.0f Hz = %llu frames\n\n", hours, rateHz, (unsigned long long)frames);
+
+    // --- Write ---
+    Clock::time_point start = Clock::now();
+    FlightRecording::Writer writer;
+    if (!writer.open(binPath)) {
+        return 1;
+    }
+    for (uint64_t i = 0; i < frames; ++i) {
+        writer.append(syntheticFrame(i, rateHz));
+    }
+    if (!writer.close()) {
+        return 1;
+    }
+    double binBytes = double(frames) * sizeof(FlightRecording::RecordedFrame);
+    double writeBin_s = secondsSince(start);
+
+    start = Clock::now();
+    FILE* csv = fopen(csvPath.c_str(), "w");
+    if (!csv) {
+        std::cerr << "Error opening " << csvPath << std::endl;
+        return 1;
+    }
+    fprintf(csv, "%s\n", FlightLog::csvHeader());
+    for (uint64_t i = 0; i < frames; ++i) {
+        FlightLog::writeCsvRow(csv, syntheticFrame(i, rateHz));
+    }
+    double csvBytes = double(ftell(csv));
+    fclose(csv);
+    double writeCsv_s = secondsSince(start);
+
+    // --- Full scan (sum every field so nothing is optimized away) ---
+    start = Clock::now();
+    FlightRecording::Reader reader;
+    if (!reader.open(binPath)) {
+        return 1;
+    }
+    double binSum = 0.0;
+    for (size_t chunk = 0; chunk < reader.chunkCount(); ++chunk) {
+        size_t count;
+        const FlightRecording::RecordedFrame* records = reader.chunkRecords(chunk, count);
+        for (size_t i = 0; i < count; ++i) {
+            const FlightRecording::RecordedFrame& r = records[i];
+            binSum += r.pitch + r.bank + r.heading + r.pitchRate + r.rollRate + r.yawRate + r.accelX + r.accelY + r.accelZ;
+        }
+    }
+    double scanBin_s = secondsSince(start);
+
+    start = Clock::now();
+    csv = fopen(csvPath.c_str(), "r");
+    double csvSum = 0.0;
+    char line[512];
+    FlightData f;
+    while (fgets(line, sizeof(line), csv)) {
+        if (FlightLog::parseCsvRow(line, f)) {
+            csvSum += f.pitch + f.bank + f.heading + f.pitchRate + f.rollRate + f.yawRate + f.accelX + f.accelY + f.accelZ;
+        }
+    }
+    fclose(csv);
+    double scanCsv_s = secondsSince(start);
+
+    // --- Random seeks by time ---
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> when(reader.firstTime_s(), reader.lastTime_s());
+    uint64_t seekCheck = 0;
+    start = Clock::now();
+    for (long i = 0; i < seeks; ++i) {
+        seekCheck += reader.seek(when(rng));
+    }
+    double seek_s = secondsSince(start);
+
+    printf("Write\n");
+    report("binary (buffered)", writeBin_s, binBytes, frames);
+    report("csv", writeCsv_s, csvBytes, frames);
+    printf("Full scan\n");
+    report("binary (mmap)", scanBin_s, binBytes, frames);
+    report("csv (parse)", scanCsv_s, csvBytes, frames);
+    printf("Seek\n");
+    printf("  %ld random seeks, %.0f ns each (%zu chunks, index %s)\n", seeks, seeks > 0 ? seek_s / seeks * 1e9 : 0.0,
+           reader.chunkCount(), reader.recovered() ? "rebuilt" : "from file");
+    printf("\nFile sizes: binary %.1f MB, csv %.1f MB\n", binBytes / 1e6, csvBytes / 1e6);
+    printf("Checksums: %.3f / %.3f / %llu\n", binSum, csvSum, (unsigned long long)seekCheck);
+
+    reader.close();
+    if (!keep) {
+        remove(binPath.c_str());
+        remove(csvPath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+// --- Flight recording converter ---
+// Moves flights between the FlightLog CSV and the binary .fltrec format (FlightRecording.hpp)
+// and inspects recordings.
+//
+// Usage: RecordingTool <command>
+//   convert <in.csv> <out.fltrec>   CSV -> binary
+//   export <in.fltrec> <out.csv>    binary -> CSV
+//   info <file.fltrec>              record/chunk counts, time range, dropped frames
+//   seek <file.fltrec> <time_s>     print the first frame at or after time_s
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "FlightLog.hpp"
+#include "FlightRecording.hpp"
+
+static bool convert(const std::string& inPath, const std::string& outPath) {
+    FILE* in = fopen(inPath.c_str(), "r");
+    if (!in) {
+        std::cerr << "Error opening " << inPath << std::endl;
+        return false;
+    }
+    FlightRecording::Writer writer;
+    if (!writer.open(outPath)) {
+        fclose(in);
+        return false;
+    }
+    char line[512];
+    FlightData frame;
+    unsigned long skipped = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), in)) {
+        if (FlightLog::parseCsvRow(line, frame)) {
+            ok = writer.append(frame);
+        } else {
+            ++skipped;
+        }
+    }
+    fclose(in);
+    unsigned long long count = writer.recordCount();
+    ok = writer.close() && ok;
+    if (ok) {
+        printf("%llu frames written to %s (%lu lines skipped, including the header)\n", count, outPath.c_str(), skipped);
+    }
+    return ok;
+}
+
+static bool exportCsv(const std::string& inPath, const std::string& outPath) {
+    FlightRecording::Reader reader;
+    if (!reader.open(inPath)) {
+        return false;
+    }
+    FILE* out = fopen(outPath.c_str(), "w");
+    if (!out) {
+        std::cerr << "Error opening " << outPath << std::endl;
+        return false;
+    }
+    fprintf(out, "%s\n", FlightLog::csvHeader());
+    for (size_t chunk = 0; chunk < reader.chunkCount(); ++chunk) {
+        size_t count;
+        const FlightRecording::RecordedFrame* records = reader.chunkRecords(chunk, count);
+        for (size_t i = 0; i < count; ++i) {
+            FlightLog::writeCsvRow(out, FlightRecording::fromRecord(records[i]));
+        }
+    }
+    bool ok = fclose(out) == 0;
+    if (ok) {
+        printf("%llu frames written to %s\n", (unsigned long long)reader.recordCount(), outPath.c_str());
+    }
+    return ok;
+}
+
+static bool info(const std::string& path) {
+    FlightRecording::Reader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    // Sequence gaps are frames the recorder never got
+    unsigned long long gaps = 0;
+    uint32_t expected = reader.recordCount() > 0 ? reader.record(0).sequence : 0;
+    for (size_t chunk = 0; chunk < reader.chunkCount(); ++chunk) {
+        size_t count;
+        const FlightRecording::RecordedFrame* records = reader.chunkRecords(chunk, count);
+        for (size_t i = 0; i < count; ++i) {
+            gaps += records[i].sequence - expected;
+            expected = records[i].sequence + 1;
+        }
+    }
+    double span_s = reader.lastTime_s() - reader.firstTime_s();
+    printf("%s\n", path.c_str());
+    printf("  frames:   %llu in %zu chunks%s\n", (unsigned long long)reader.recordCount(), reader.chunkCount(),
+           reader.recovered() ? " (not closed cleanly, index rebuilt)" : "");
+    printf("  time:     %.3f s to %.3f s (%.1f min)\n", reader.firstTime_s(), reader.lastTime_s(), span_s / 60.0);
+    if (span_s > 0.0) {
+        printf("  rate:     %.1f frames/s\n", (reader.recordCount() - 1) / span_s);
+    }
+    printf("  dropped:  %llu\n", gaps);
+    return true;
+}
+
+static bool seek(const std::string& path, double time_s) {
+    FlightRecording::Reader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    uint64_t i = reader.seek(time_s);
+    if (i >= reader.recordCount()) {
+        std::cerr << "No frame at or after " << time_s << " s" << std::endl;
+        return false;
+    }
+    printf("frame %llu\n%s\n", (unsigned long long)i, FlightLog::csvHeader());
+    FlightLog::writeCsvRow(stdout, FlightRecording::fromRecord(reader.record(i)));
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string command = argc > 1 ? argv[1] : "";
+    bool ok;
+    if (command == "convert" && argc == 4) {
+        ok = convert(argv[2], argv[3]);
+    } else if (command == "export" && argc == 4) {
+        ok = exportCsv(argv[2], argv[3]);
+    } else if (command == "info" && argc == 3) {
+        ok = info(argv[2]);
+    } else if (command == "seek" && argc == 4) {
+        ok = seek(argv[2], atof(argv[3]));
+    } else {
+        std::cerr << "Usage: " << argv[0] << " convert <in.csv> <out.fltrec> | export <in.fltrec> <out.csv> | "
+                  << "info <file.fltrec> | seek <file.fltrec> <time_s>" << std::endl;
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include "ReplaySource.hpp"
+#include "FlightLog.hpp"
+#include "FlightRecording.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+ReplaySource::ReplaySource(const std::string& path, double speed, bool loop)
+    : path(path), speed(speed), loop(loop) {}
+
+bool ReplaySource::open() {
+    frames.clear();
+    if (FlightRecording::isRecording(path)) {
+        if (!loadRecording()) {
+            return false;
+        }
+    } else if (!loadCsv()) {
+        return false;
+    }
+
+    if (frames.empty()) {
+        std::cerr << "No frames in recording " << path << std::endl;
+        return false;
+    }
+    position = 0;
+    replayStats = Stats();
+    started = false;
+    return true;
+}
+
+bool ReplaySource::loadCsv() {
+    FILE* file = fopen(path.c_str(), "r");
+    if (!file) {
+        std::cerr << "Error opening recording " << path << std::endl;
+        return false;
+    }
+    char line[512];
+    FlightData frame;
+    while (fgets(line, sizeof(line), file)) {
+        if (FlightLog::parseCsvRow(line, frame)) {
+            frames.push_back(frame);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+bool ReplaySource::loadRecording() {
+    FlightRecording::Reader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    frames.reserve(static_cast<size_t>(reader.recordCount()));
+    for (size_t chunk = 0; chunk < reader.chunkCount(); ++chunk) {
+        size_t count;
+        const FlightRecording::RecordedFrame* records = reader.chunkRecords(chunk, count);
+        for (size_t i = 0; i < count; ++i) {
+            frames.push_back(FlightRecording::fromRecord(records[i]));
+        }
+    }
+    return true;
+}
+
+void ReplaySource::close() {
+    frames.clear();
+    position = 0;
+}
+
+TelemetrySource::Status ReplaySource::next(FlightData& frame, std::chrono::milliseconds timeout) {
+    if (position >= frames.size()) {
+        if (!loop || frames.empty()) {
+            return Status::END;
+        }
+        // Start the next pass one average frame period after the last frame of this one
+        double period_s = frames.size() > 1 ? duration_s() / (frames.size() - 1) : 0.0;
+        double pass_s = duration_s() + period_s;
+        for (FlightData& f : frames) f.time_s += pass_s;
+        if (speed > MAX_SPEED) {
+            startTime += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(pass_s / speed));
+        }
+        position = 0;
+    }
+
+    const FlightData& due = frames[position];
+    if (!started) {
+        // The clock starts with the first request, not at open(), so set-up time doesn't make frames late
+        startTime = Clock::now();
+        started = true;
+    }
+    if (speed > MAX_SPEED) {
+        // Scheduled time of this frame relative to the first one, at the requested speed
+        auto offset = std::chrono::duration<double>((due.time_s - frames.front().time_s) / speed);
+        Clock::time_point dueTime = startTime + std::chrono::duration_cast<Clock::duration>(offset);
+        Clock::time_point waitUntil = std::min(dueTime, Clock::now() + timeout);
+        while (Clock::now() < waitUntil) {
+            reactor.pollUntil(waitUntil);
+            if (interrupted.exchange(false)) {
+                return Status::TIMEOUT;
+            }
+        }
+        if (waitUntil < dueTime) {
+            return Status::TIMEOUT;
+        }
+
+        double late_ms = std::chrono::duration<double, std::milli>(Clock::now() - dueTime).count();
+        if (late_ms > 1.0) {
+            ++replayStats.framesLate;
+        }
+        if (late_ms > replayStats.maxLate_ms) {
+            replayStats.maxLate_ms = late_ms;
+        }
+    }
+
+    frame = due;
+    ++position;
+    ++replayStats.framesDelivered;
+    return Status::FRAME;
+}
+
+void ReplaySource::interrupt() {
+    interrupted.store(true);
+    reactor.notify();
+}
+
+std::string ReplaySource::describe() const {
+    char text[64];
+    if (speed > MAX_SPEED) {
+        snprintf(text, sizeof(text), " at %gx", speed);
+    } else {
+        snprintf(text, sizeof(text), " at max speed");
+    }
+    return "replay of " + path + text + (loop ? " (looping)" : "");
+}
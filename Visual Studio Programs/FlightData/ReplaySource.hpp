@@ -0,0 +1,60 @@
+#ifndef REPLAY_SOURCE_HPP
+#define REPLAY_SOURCE_HPP
+
+// --- Recorded flight replay ---
+// Plays a recording (.fltrec, see FlightRecording.hpp, or a FlightLog CSV) back through the
+// TelemetrySource interface. Frames come out with the recording's own inter-frame timing, scaled
+// by speed (2.0 = twice as fast), or back to back with speed = MAX_SPEED for benchmarks and
+// regression runs. Waits are Reactor deadlines, so a frame is released on its due time and
+// interrupt() ends a wait at once. The recorded time_s is passed
+// through untouched at every speed, so downstream results don't depend on how fast the machine is.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Reactor.hpp"
+#include "TelemetrySource.hpp"
+
+class ReplaySource : public TelemetrySource {
+public:
+    static constexpr double MAX_SPEED = 0.0;
+
+    struct Stats {
+        uint64_t framesDelivered = 0;
+        uint64_t framesLate = 0;        // delivered more than 1 ms after their scheduled time
+        double maxLate_ms = 0.0;
+    };
+
+    explicit ReplaySource(const std::string& path, double speed = 1.0, bool loop = false);
+
+    bool open() override;
+    void close() override;
+    Status next(FlightData& frame, std::chrono::milliseconds timeout) override;
+    void interrupt() override;
+    std::string describe() const override;
+
+    size_t frameCount() const { return frames.size(); }
+    double duration_s() const { return frames.empty() ? 0.0 : frames.back().time_s - frames.front().time_s; }
+    const Stats& stats() const { return replayStats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool loadCsv();
+    bool loadRecording();
+
+    std::string path;
+    double speed;
+    bool loop;
+    std::vector<FlightData> frames;
+    size_t position = 0;
+    Clock::time_point startTime;
+    bool started = false;
+    Stats replayStats;
+    Reactor reactor;
+    std::atomic<bool> interrupted{false};
+};
+
+#endif // REPLAY_SOURCE_HPP
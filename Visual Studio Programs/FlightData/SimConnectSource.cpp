@@ -0,0 +1,170 @@
+#ifdef _WIN32
+
+#include "SimConnectSource.hpp"
+#include <iostream>
+
+bool SimConnectSource::open() {
+    HRESULT hr; // Variable to store function results
+
+    // Attempt to open a connection to SimConnect. It sets messageEvent whenever messages arrive.
+    messageEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    hr = SimConnect_Open(&hSimConnect, "Live Telemetry Reader", nullptr, 0, messageEvent, 0);
+    if (FAILED(hr)) {
+        std::cerr << "Failed to connect to MSFS. HRESULT: 0x"
+            << std::hex << hr << std::dec << std::endl;
+        std::cerr << "Ensure MSFS is running and SimConnect is installed/configured correctly." << std::endl;
+        hSimConnect = nullptr;
+        CloseHandle(messageEvent);
+        messageEvent = nullptr;
+        return false;
+    }
+    std::cout << "Connected to MSFS via SimConnect!" << std::endl;
+    reactor.watch(messageEvent, Reactor::READABLE, [](uint32_t) {});
+
+    // Define the data structure members we want to receive
+    // IMPORTANT: The order MUST match the SimVars struct definition
+    struct Var { const char* name; const char* units; };
+    static const Var vars[] = {
+        { "PLANE PITCH DEGREES",            "degrees" },
+        { "PLANE BANK DEGREES",             "degrees" },
+        { "PLANE HEADING DEGREES MAGNETIC", "degrees" },
+        { "ROTATION VELOCITY BODY X",       "degrees per second" },
+        { "ROTATION VELOCITY BODY Z",       "degrees per second" },
+        { "ROTATION VELOCITY BODY Y",       "degrees per second" },
+        { "ACCELERATION BODY Z",            "meters per second squared" },
+        { "ACCELERATION BODY X",            "meters per second squared" },
+        { "ACCELERATION BODY Y",            "meters per second squared" },
+    };
+    for (const Var& var : vars) {
+        hr = SimConnect_AddToDataDefinition(hSimConnect, DEFINITION_FLIGHT_DATA, var.name, var.units, SIMCONNECT_DATATYPE_FLOAT64);
+        if FAILED(hr) std::cerr << "Error adding " << var.name << " definition: " << hr << std::endl;
+    }
+
+    // Request the defined data structure periodically (per simulation frame)
+    hr = SimConnect_RequestDataOnSimObject(
+        hSimConnect,
+        REQUEST_FLIGHT_DATA,              // Unique ID for this request
+        DEFINITION_FLIGHT_DATA,           // ID of the data definition to use
+        SIMCONNECT_OBJECT_ID_USER,        // Request data for the user's aircraft
+        SIMCONNECT_PERIOD_SIM_FRAME,      // Request data every simulation frame (high speed)
+        SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT,
+        0,                                // No offset within the period
+        0,                                // No interval limit
+        0                                 // dwArrayCount should be 0 for single struct
+    );
+    if FAILED(hr) std::cerr << "Error requesting data: " << hr << std::endl;
+
+    openTime = std::chrono::steady_clock::now();
+    haveFrame = false;
+    quit = false;
+    return true;
+}
+
+void SimConnectSource::close() {
+    if (!hSimConnect) {
+        return;
+    }
+    // Clean up and close the SimConnect connection
+    HRESULT hr = SimConnect_Close(hSimConnect);
+    if (FAILED(hr)) {
+        std::cerr << "Error closing SimConnect connection: " << hr << std::endl;
+    }
+    else {
+        std::cout << "SimConnect connection closed." << std::endl;
+    }
+    hSimConnect = nullptr;
+    reactor.unwatch(messageEvent);
+    CloseHandle(messageEvent);
+    messageEvent = nullptr;
+}
+
+TelemetrySource::Status SimConnectSource::next(FlightData& frame, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!quit) {
+        // Process any pending SimConnect messages
+        HRESULT hr = SimConnect_CallDispatch(hSimConnect, dispatchProc, this);
+        if (FAILED(hr)) {
+            // An error occurred during message dispatch (e.g., connection lost)
+            std::cerr << "\nSimConnect_CallDispatch failed with HRESULT: 0x"
+                << std::hex << hr << std::dec << std::endl;
+            return Status::FAILED;
+        }
+        if (haveFrame) {
+            frame = latest;
+            haveFrame = false;
+            return Status::FRAME;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return Status::TIMEOUT;
+        }
+        // Sleep until SimConnect signals new messages (or the timeout / an interrupt)
+        reactor.pollUntil(deadline);
+        if (interrupted.exchange(false)) {
+            return Status::TIMEOUT;
+        }
+    }
+    return Status::END;
+}
+
+void SimConnectSource::interrupt() {
+    interrupted.store(true);
+    reactor.notify();
+}
+
+void CALLBACK SimConnectSource::dispatchProc(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext) {
+    (void)cbData;
+    static_cast<SimConnectSource*>(pContext)->handle(pData);
+}
+
+// Handles one received SimConnect message
+void SimConnectSource::handle(SIMCONNECT_RECV* pData) {
+    switch (pData->dwID) {
+    case SIMCONNECT_RECV_ID_SIMOBJECT_DATA: {
+        SIMCONNECT_RECV_SIMOBJECT_DATA* pObjData = reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData);
+
+        // Check if this data is the one we requested
+        if (pObjData->dwRequestID == REQUEST_FLIGHT_DATA) {
+            const SimVars* vars = reinterpret_cast<const SimVars*>(&pObjData->dwData);
+            latest.time_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - openTime).count();
+            latest.pitch = vars->pitch;
+            latest.bank = vars->bank;
+            latest.heading = vars->heading;
+            latest.pitchRate = vars->pitchRate;
+            latest.rollRate = vars->rollRate;
+            latest.yawRate = vars->yawRate;
+            latest.accelX = vars->accelX;
+            latest.accelY = vars->accelY;
+            latest.accelZ = vars->accelZ;
+            haveFrame = true; // Several per dispatch only keep the newest
+        }
+        break;
+    }
+
+    case SIMCONNECT_RECV_ID_QUIT: {
+        // Simulator has closed the connection
+        std::cerr << "\nSimConnect connection closed by simulator." << std::endl;
+        quit = true;
+        break;
+    }
+
+    case SIMCONNECT_RECV_ID_EXCEPTION: {
+        // An exception occurred within SimConnect. For simplicity, quit on any exception
+        SIMCONNECT_RECV_EXCEPTION* pEx = reinterpret_cast<SIMCONNECT_RECV_EXCEPTION*>(pData);
+        std::cerr << "\nSimConnect Exception received: Code=" << pEx->dwException
+            << " SendID=" << pEx->dwSendID
+            << " Index=" << pEx->dwIndex << std::endl;
+        quit = true;
+        break;
+    }
+
+    case SIMCONNECT_RECV_ID_OPEN: {
+        std::cout << "SimConnect connection opened event received." << std::endl;
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+#endif // _WIN32
@@ -0,0 +1,64 @@
+#ifndef SIMCONNECT_SOURCE_HPP
+#define SIMCONNECT_SOURCE_HPP
+
+// --- Live MSFS telemetry through SimConnect (Windows only) ---
+// Requests the user aircraft's attitude, body rates and body accelerations every simulation
+// frame and hands them out one at a time through TelemetrySource::next(). SimConnect signals an
+// event handle whenever messages are waiting, so next() sleeps on that (through a Reactor)
+// rather than polling CallDispatch with Sleep(1).
+
+#ifdef _WIN32
+
+#include <Windows.h>
+#include <atomic>
+#include <chrono>
+#include "SimConnect.h"
+#include "Reactor.hpp"
+#include "TelemetrySource.hpp"
+
+class SimConnectSource : public TelemetrySource {
+public:
+    bool open() override;
+    void close() override;
+    Status next(FlightData& frame, std::chrono::milliseconds timeout) override;
+    void interrupt() override;
+    std::string describe() const override { return "MSFS via SimConnect"; }
+
+private:
+    enum DATA_DEFINE_ID {
+        DEFINITION_FLIGHT_DATA
+    };
+
+    enum DATA_REQUEST_ID {
+        REQUEST_FLIGHT_DATA
+    };
+
+    // Layout SimConnect fills in. IMPORTANT: the order MUST match the AddToDataDefinition calls
+    struct SimVars {
+        double pitch;
+        double bank;
+        double heading;
+        double pitchRate;
+        double rollRate;
+        double yawRate;
+        double accelX;
+        double accelY;
+        double accelZ;
+    };
+
+    static void CALLBACK dispatchProc(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext);
+    void handle(SIMCONNECT_RECV* pData);
+
+    HANDLE hSimConnect = nullptr;
+    HANDLE messageEvent = nullptr;      // Set by SimConnect when messages are waiting
+    Reactor reactor;
+    std::atomic<bool> interrupted{false};
+    std::chrono::steady_clock::time_point openTime;
+    FlightData latest;
+    bool haveFrame = false;
+    bool quit = false;
+};
+
+#endif // _WIN32
+
+#endif // SIMCONNECT_SOURCE_HPP
@@ -0,0 +1,136 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+// --- Single-producer / single-consumer queue ---
+// Bounded ring of preallocated slots between two pipeline threads. The producer fills a slot in
+// place (beginPush/endPush) and the consumer reads it in place (front/pop), so nothing is
+// allocated or locked per frame. head and tail sit on their own cache lines and each side keeps
+// a cached copy of the other's index, so the two threads only share a line when the queue looks
+// full or empty.
+//
+// Doorbell lets a consumer sleep while its queue is empty. The producer only touches the mutex
+// when someone is actually waiting, so the fast path stays lock-free. A consumer that sleeps in an
+// event loop instead (the transmit stage waits on the serial port too) registers a waker and uses
+// waitWith().
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // --- Producer side ---
+    // Slot to fill, or nullptr if the queue is full
+    T* beginPush() {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache >= Capacity) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache >= Capacity) {
+                return nullptr;
+            }
+        }
+        return &slots[t & (Capacity - 1)];
+    }
+
+    // Publishes the slot returned by beginPush()
+    void endPush() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // --- Consumer side ---
+    // Oldest slot, or nullptr if the queue is empty
+    T* front() {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache) {
+                return nullptr;
+            }
+            // Backlog the consumer found on waking up; the queue is deepest just before this
+            size_t depth = tailCache - h;
+            if (depth > maxDepth.load(std::memory_order_relaxed)) {
+                maxDepth.store(depth, std::memory_order_relaxed);
+            }
+        }
+        return &slots[h & (Capacity - 1)];
+    }
+
+    // Releases the slot returned by front() back to the producer
+    void pop() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // --- Either side / monitoring (approximate while both threads run) ---
+    bool empty() const { return size() == 0; }
+    size_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+    size_t highWater() const { return maxDepth.load(std::memory_order_relaxed); }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    alignas(64) std::atomic<size_t> head{0};    // Written by the consumer
+    size_t tailCache = 0;                       // Consumer's copy of tail
+    std::atomic<size_t> maxDepth{0};            // Written by the consumer
+    alignas(64) std::atomic<size_t> tail{0};    // Written by the producer
+    size_t headCache = 0;                       // Producer's copy of head
+    alignas(64) std::array<T, Capacity> slots;
+};
+
+class Doorbell {
+public:
+    // Producer: call after publishing work
+    void ring() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            wake.notify_all();
+            if (waker) {
+                waker(wakerContext);
+            }
+        }
+    }
+
+    // Consumer, before any waitWith(): how to wake it when it isn't on the condition variable
+    void setWaker(void (*function)(void*), void* context) {
+        std::lock_guard<std::mutex> lock(mutex);
+        waker = function;
+        wakerContext = context;
+    }
+
+    // Consumer: like wait(), but sleep() does the sleeping (and must return when the waker runs)
+    template <typename Ready, typename Sleep>
+    void waitWith(Ready ready, Sleep sleep) {
+        waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            sleep();
+        }
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Consumer: sleeps until ready() is true, ring() is called or the timeout expires
+    template <typename Ready>
+    void wait(Ready ready, std::chrono::microseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            wake.wait_for(lock, timeout, ready);
+        }
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int> waiters{0};
+    std::mutex mutex;
+    std::condition_variable wake;
+    void (*waker)(void*) = nullptr;
+    void* wakerContext = nullptr;
+};
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,55 @@
+#ifndef TELEMETRY_SOURCE_HPP
+#define TELEMETRY_SOURCE_HPP
+
+// --- Telemetry sources ---
+// Everything downstream of the simulator (printing, recording, cueing, the serial link) reads
+// frames through TelemetrySource, so the same pipeline runs against MSFS on Windows
+// (SimConnectSource) or against a recorded flight on any machine (ReplaySource).
+
+#include <chrono>
+#include <string>
+
+// One simulator sample. Angles are as SimConnect reports them; rates and accelerations are in
+// aircraft body axes, x forward, y right, z up (SimConnect's body Z, X and Y).
+struct FlightData {
+    double time_s = 0.0;            // Seconds since the source was opened (or since the start of the recording)
+
+    double pitch = 0.0;             // degrees
+    double bank = 0.0;              // degrees
+    double heading = 0.0;           // degrees (magnetic)
+
+    double pitchRate = 0.0;         // degrees/s, about y
+    double rollRate = 0.0;          // degrees/s, about x
+    double yawRate = 0.0;           // degrees/s, about z
+
+    double accelX = 0.0;            // m/s^2
+    double accelY = 0.0;            // m/s^2
+    double accelZ = 0.0;            // m/s^2
+};
+
+class TelemetrySource {
+public:
+    enum class Status {
+        FRAME,      // frame was filled in
+        TIMEOUT,    // nothing arrived within the timeout, try again
+        END,        // no more frames (recording finished, simulator closed)
+        FAILED      // connection/file error, already reported on std::cerr
+    };
+
+    virtual ~TelemetrySource() = default;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    // Waits up to timeout for the next frame. Sources sleep on their own events (socket,
+    // SimConnect event, replay due time) and return as soon as a frame is there.
+    virtual Status next(FlightData& frame, std::chrono::milliseconds timeout) = 0;
+
+    // Makes a next() that is waiting in another thread return TIMEOUT straight away (shutdown)
+    virtual void interrupt() = 0;
+
+    // Short human-readable description for start-up messages
+    virtual std::string describe() const = 0;
+};
+
+#endif // TELEMETRY_SOURCE_HPP
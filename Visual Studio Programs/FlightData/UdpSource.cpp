@@ -0,0 +1,191 @@
+#ifdef _WIN32
+#include <winsock2.h>   // Before anything that pulls in Windows.h
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include "UdpSource.hpp"
+#include "FlightRecording.hpp"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+#else
+using NativeSocket = int;
+#endif
+
+UdpSource::UdpSource(uint16_t port, const std::string& bindAddress)
+    : port(port), bindAddress(bindAddress) {}
+
+UdpSource::~UdpSource() {
+    close();
+}
+
+bool UdpSource::open() {
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "WSAStartup failed" << std::endl;
+        return false;
+    }
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET) {
+        std::cerr << "Error creating UDP socket" << std::endl;
+        WSACleanup();
+        return false;
+    }
+    sock = static_cast<intptr_t>(s);
+#else
+    sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        std::cerr << "Error creating UDP socket" << std::endl;
+        return false;
+    }
+#endif
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, bindAddress.c_str(), &address.sin_addr) != 1 ||
+        bind(static_cast<NativeSocket>(sock), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Error binding UDP " << bindAddress << ":" << port << std::endl;
+        close();
+        return false;
+    }
+
+    // A bigger receive buffer rides out a stall in the acquire thread without losing frames
+    int bufferSize = 1 << 20;
+    setsockopt(static_cast<NativeSocket>(sock), SOL_SOCKET, SO_RCVBUF,
+               reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
+
+#ifdef _WIN32
+    // Non-blocking, and an event that is signaled whenever a datagram arrives. WSACreateEvent()
+    // makes a manual-reset event, so receive() resets it before each recv().
+    u_long nonBlocking = 1;
+    ioctlsocket(static_cast<NativeSocket>(sock), FIONBIO, &nonBlocking);
+    socketEvent = WSACreateEvent();
+    WSAEventSelect(static_cast<NativeSocket>(sock), static_cast<WSAEVENT>(socketEvent), FD_READ);
+    reactor.watch(socketEvent, Reactor::READABLE, [](uint32_t) {});
+#else
+    reactor.watch(static_cast<NativeSocket>(sock), Reactor::READABLE, [](uint32_t) {});
+#endif
+
+    haveSequence = false;
+    udpStats = Stats();
+    return true;
+}
+
+void UdpSource::close() {
+#ifdef _WIN32
+    if (socketEvent) {
+        reactor.unwatch(socketEvent);
+        WSACloseEvent(static_cast<WSAEVENT>(socketEvent));
+        socketEvent = nullptr;
+    }
+    if (sock != -1) {
+        closesocket(static_cast<NativeSocket>(sock));
+        sock = -1;
+        WSACleanup();
+    }
+#else
+    if (sock >= 0) {
+        reactor.unwatch(static_cast<NativeSocket>(sock));
+        ::close(static_cast<NativeSocket>(sock));
+        sock = -1;
+    }
+#endif
+}
+
+UdpSource::Receive UdpSource::receive(FlightData& frame) {
+    FlightRecording::RecordedFrame record;
+#ifdef _WIN32
+    // Reset first: recv() re-records FD_READ and signals the event again if more datagrams are
+    // waiting, so none is missed, and the reactor doesn't wake up forever on a stale signal
+    WSAResetEvent(static_cast<WSAEVENT>(socketEvent));
+    int got = recv(static_cast<NativeSocket>(sock), reinterpret_cast<char*>(&record), sizeof(record), 0);
+    if (got == SOCKET_ERROR) {
+        int error = WSAGetLastError();
+        // WSAEMSGSIZE: datagram bigger than a record, treated as a bad datagram below
+        if (error == WSAEWOULDBLOCK) {
+            return Receive::NOTHING;
+        }
+        if (error != WSAEMSGSIZE) {
+            std::cerr << "UDP receive failed: " << error << std::endl;
+            return Receive::FAILED;
+        }
+    }
+#else
+    ssize_t got = recv(static_cast<NativeSocket>(sock), &record, sizeof(record), MSG_TRUNC);
+    if (got < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return Receive::NOTHING;
+        }
+        std::cerr << "UDP receive failed: " << strerror(errno) << std::endl;
+        return Receive::FAILED;
+    }
+#endif
+    if (got != static_cast<int>(sizeof(record))) {
+        ++udpStats.badDatagrams;
+        return Receive::BAD;
+    }
+    if (haveSequence && record.sequence != nextSequence) {
+        // Signed so a late datagram or a restarted sender doesn't count as four billion lost frames
+        int32_t gap = static_cast<int32_t>(record.sequence - nextSequence);
+        if (gap > 0 && gap <= MAX_LOSS_GAP) {
+            udpStats.framesLost += static_cast<uint64_t>(gap);
+        } else if (gap < 0 && gap >= -REORDER_WINDOW) {
+            ++udpStats.framesReordered; // Older than what's already been used
+            return Receive::STALE;
+        } else {
+            ++udpStats.sequenceResets;
+        }
+    }
+    haveSequence = true;
+    nextSequence = record.sequence + 1;
+    ++udpStats.framesReceived;
+    frame = FlightRecording::fromRecord(record);
+    return Receive::FRAME;
+}
+
+TelemetrySource::Status UdpSource::next(FlightData& frame, std::chrono::milliseconds timeout) {
+    auto deadline = Reactor::Clock::now() + timeout;
+    for (;;) {
+        Receive result;
+        // Skip bad and stale datagrams, anything else ends the drain
+        do {
+            result = receive(frame);
+        } while (result == Receive::BAD || result == Receive::STALE);
+
+        if (result == Receive::FRAME) {
+            return Status::FRAME;
+        }
+        if (result == Receive::FAILED) {
+            return Status::FAILED;
+        }
+        if (Reactor::Clock::now() >= deadline) {
+            return Status::TIMEOUT;
+        }
+        // Sleep until the next datagram (or the timeout / an interrupt)
+        reactor.pollUntil(deadline);
+        if (interrupted.exchange(false)) {
+            return Status::TIMEOUT;
+        }
+    }
+}
+
+void UdpSource::interrupt() {
+    interrupted.store(true);
+    reactor.notify();
+}
+
+std::string UdpSource::describe() const {
+    return "UDP frames on " + bindAddress + ":" + std::to_string(port);
+}
@@ -0,0 +1,65 @@
+#ifndef UDP_SOURCE_HPP
+#define UDP_SOURCE_HPP
+
+// --- Flight frames over UDP ---
+// Receives FlightData from another process or machine (a sim PC streaming to the bridge PC, a
+// replay on a test box, the dispatch benchmark). Each datagram is one 64-byte
+// FlightRecording::RecordedFrame, the same record the .fltrec files use. Anything else is
+// counted and ignored. Sequence gaps (lost datagrams) are counted too. A datagram a little older
+// than the last one (reordered or duplicated on the way) is dropped; any bigger jump, backwards or
+// forwards, is taken as the sender restarting and resynchronises the sequence.
+//
+// next() sleeps on the socket through a Reactor (epoll on Linux, WSAEventSelect + wait on
+// Windows), so it returns as soon as a datagram lands.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "Reactor.hpp"
+#include "TelemetrySource.hpp"
+
+class UdpSource : public TelemetrySource {
+public:
+    struct Stats {
+        uint64_t framesReceived = 0;
+        uint64_t badDatagrams = 0;      // wrong size
+        uint64_t framesLost = 0;        // sequence gaps
+        uint64_t framesReordered = 0;   // late or duplicate, dropped
+        uint64_t sequenceResets = 0;    // sender restarted
+    };
+
+    static constexpr int32_t MAX_LOSS_GAP = 1000;       // Largest forward jump counted as loss, ~16 s at 60 Hz
+    static constexpr int32_t REORDER_WINDOW = 32;       // Largest backward step taken as a late datagram
+
+    explicit UdpSource(uint16_t port, const std::string& bindAddress = "0.0.0.0");
+    ~UdpSource() override;
+
+    bool open() override;
+    void close() override;
+    Status next(FlightData& frame, std::chrono::milliseconds timeout) override;
+    void interrupt() override;
+    std::string describe() const override;
+
+    const Stats& stats() const { return udpStats; }
+
+private:
+    enum class Receive { FRAME, NOTHING, BAD, STALE, FAILED };
+
+    // Reads one datagram without blocking
+    Receive receive(FlightData& frame);
+
+    uint16_t port;
+    std::string bindAddress;
+    intptr_t sock = -1;                 // SOCKET on Windows, fd elsewhere
+#ifdef _WIN32
+    void* socketEvent = nullptr;        // WSAEventSelect event, FD_READ
+#endif
+    Reactor reactor;
+    std::atomic<bool> interrupted{false};
+    bool haveSequence = false;
+    uint32_t nextSequence = 0;
+    Stats udpStats;
+};
+
+#endif // UDP_SOURCE_HPP
@@ -0,0 +1,126 @@
+// --- Washout filter benchmark ---
+// Checks the classical washout (MotionLink_Lib/Washout.hpp) against the standard manoeuvres and
+// times one step, to see how much of a control cycle it costs.
+//
+// Usage: WashoutBench [--rate HZ] [--steps N]
+//   --rate   washout step rate in Hz          (default 200)
+//   --steps  steps to time                    (default 10000000)
+//
+// Manoeuvres, each from level unaccelerated flight:
+//   surge   0.3 g forward acceleration held for 10 s (takeoff roll)
+//   sway    0.2 g sideways held for 10 s (skid)
+//   heave   +0.5 g for 1 s (pull-up), then back to 1 g
+//   roll    30 deg/s roll rate for 1 s, then held bank
+// For each: peak platform excursion, the pose when the input is released (translation washed out,
+// sustained forces left as a tilt-coordination angle), the pose at the end (back near neutral)
+// and whether any limit was hit.
+//
+// The firmware times the same step on the MCU at start-up when built with WASHOUT_ON_MCU
+// (Platform IK/main.cpp).
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "MotionLink_Lib/Washout.hpp"
+
+using namespace MotionCue;
+using Clock = std::chrono::steady_clock;
+
+struct Manoeuvre {
+    const char* name;
+    double hold_s;          // how long the input is applied
+    double total_s;         // how long to run
+    WashoutInput input;
+};
+
+static void runManoeuvre(const Manoeuvre& m, double rateHz) {
+    ClassicalWashout washout;
+    washout.configure(WashoutParams(), static_cast<float>(1.0 / rateHz));
+    WashoutInput level;
+    WashoutOutput out;
+    float peak[6] = {};
+    WashoutOutput released;
+    bool limited = false;
+    long steps = static_cast<long>(m.total_s * rateHz);
+    for (long i = 0; i < steps; ++i) {
+        washout.step(i < m.hold_s * rateHz ? m.input : level, out);
+        float values[6] = { out.translation_mm[0], out.translation_mm[1], out.translation_mm[2],
+                            out.roll_deg, out.pitch_deg, out.yaw_deg };
+        for (int v = 0; v < 6; ++v) {
+            if (fabsf(values[v]) > fabsf(peak[v])) peak[v] = values[v];
+        }
+        limited = limited || out.limited;
+        if (i + 1 == static_cast<long>(m.hold_s * rateHz)) {
+            released = out;
+        }
+    }
+    printf("  %-6s %-5s %7.1f %7.1f %7.1f mm  %6.2f %6.2f %6.2f deg%s\n", m.name, "peak", peak[0], peak[1], peak[2],
+           peak[3], peak[4], peak[5], limited ? "  (limited)" : "");
+    const WashoutOutput* rows[2] = { &released, &out };
+    const char* labels[2] = { "held", "end" };
+    for (int r = 0; r < 2; ++r) {
+        const WashoutOutput& o = *rows[r];
+        printf("  %-6s %-5s %7.1f %7.1f %7.1f mm  %6.2f %6.2f %6.2f deg\n", "", labels[r], o.translation_mm[0],
+               o.translation_mm[1], o.translation_mm[2], o.roll_deg, o.pitch_deg, o.yaw_deg);
+    }
+}
+
+int main(int argc, char** argv) {
+    double rateHz = 200.0;
+    long steps = 10000000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--rate" && value) { rateHz = atof(value); ++i; }
+        else if (arg == "--steps" && value) { steps = atol(value); ++i; }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--rate HZ] [--steps N]" << std::endl;
+            return 1;
+        }
+    }
+    if (rateHz <= 0.0 || steps <= 0) {
+        std::cerr << "Nothing to do" << std::endl;
+        return 1;
+    }
+
+    // --- Manoeuvres ---
+    Manoeuvre surge = { "surge", 10.0, 20.0, {} };
+    surge.input.specificForce_mps2[0] = 0.3f * GRAVITY;
+    Manoeuvre sway = { "sway", 10.0, 20.0, {} };
+    sway.input.specificForce_mps2[1] = 0.2f * GRAVITY;
+    Manoeuvre heave = { "heave", 1.0, 10.0, {} };
+    heave.input.specificForce_mps2[2] = 1.5f * GRAVITY;
+    Manoeuvre roll = { "roll", 1.0, 10.0, {} };
+    roll.input.rate_dps[0] = 30.0f;
+
+    printf("Washout at %.0f Hz                 surge    sway   heave        roll  pitch    yaw\n", rateHz);
+    runManoeuvre(surge, rateHz);
+    runManoeuvre(sway, rateHz);
+    runManoeuvre(heave, rateHz);
+    runManoeuvre(roll, rateHz);
+
+    // --- Cost of one step ---
+    // A slowly varying input so the filters do real work; the sum keeps the loop from being optimized away
+    ClassicalWashout washout;
+    washout.configure(WashoutParams(), static_cast<float>(1.0 / rateHz));
+    WashoutInput in;
+    WashoutOutput out;
+    double checksum = 0.0;
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < steps; ++i) {
+        float t = static_cast<float>(i % 4000) * 0.001f;
+        in.specificForce_mps2[0] = t;
+        in.rate_dps[0] = 10.0f - t;
+        washout.step(in, out);
+        checksum += out.pitch_deg + out.translation_mm[0];
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    double perStep_ns = seconds / steps * 1e9;
+    printf("\n%ld steps: %.1f ns per step, %.4f %% of a %.2f ms cycle on this machine (checksum %.3f)\n",
+           steps, perStep_ns, perStep_ns / (1e7 / rateHz), 1000.0 / rateHz, checksum);
+    printf("State: %zu bytes, no allocation\n", sizeof(ClassicalWashout));
+    return 0;
+}
@@ -0,0 +1,559 @@
+// --- Washout parameter auto-tuner ---
+// Replays recorded flights through the washout (MotionLink_Lib/Washout.hpp), the platform IK
+// (PlatformIK) and a model of the actuators for every point of a parameter grid, scores each
+// candidate and prints them ranked, best first.
+//
+// Usage: WashoutTuner [options] <recording.fltrec|.csv> [more recordings...]
+//   --grid NAME=V1,V2,...   values to try for one WashoutParams field (repeatable)
+//   --grid NAME=LO:HI:N     N evenly spaced values from LO to HI
+//   --rate HZ               washout step rate (default 200, as in FlightData)
+//   --threads N             worker threads (default: all cores)
+//   --weights F,R,L,T       score weights, see below (default 1,1,20,1)
+//   --top N                 candidates to print (default 10)
+//   --neutral-heave MM      platform heave the washout moves around (default: closest to mid-stroke)
+//   --out FILE              write every candidate, ranked, as CSV
+// Fields not on a --grid keep their WashoutParams default. Without any --grid a default sweep of
+// the scales and break frequencies is run.
+//
+// Per candidate, over every recording:
+//   force     RMS difference (m/s^2) between the aircraft's specific force and the one the
+//             platform produces (translational acceleration plus the gravity share from tilt)
+//   rate      RMS difference (deg/s) between aircraft and platform angular rates
+//   limited   fraction of washout steps where an axis hit its limit
+//   reach     fraction of control cycles where the IK had to clamp a leg
+//   track     RMS actuator tracking error (mm) of the plant model
+//   workspace peak stroke used around mid-stroke, % of the half stroke
+//   score     F * force + R * rate / 5 dps + L * (limited + reach) + T * track / tolerance,
+//             lower is better
+//
+// The plant is the firmware's actuator model (DigitalPosFeedback: constant speed, stop inside the
+// tolerance) run at the control loop period of Platform IK/main.cpp, fed by the IK every cycle.
+//
+// Candidates are independent, so they are handed out to the threads one at a time from an
+// atomic counter. The recordings are turned into washout inputs once, up front, and shared
+// read-only; each thread owns its washout, plant and accumulators, set up before it starts, so
+// the inner loop never allocates or shares a cache line with another thread.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FlightCue.hpp"
+#include "FlightLog.hpp"
+#include "FlightRecording.hpp"
+#include "PlatformIK.hpp"
+
+using namespace MotionCue;
+using Clock = std::chrono::steady_clock;
+
+// --- Plant (matches Platform IK/main.cpp and DigitalPosFeedback) ---
+const float CONTROL_PERIOD_S = 0.020f;
+const float ACTUATOR_SPEED_MM_PER_S = 30.6827057f;
+const float ACTUATOR_TOLERANCE_MM = 15.0f;
+
+const float RATE_NORM_DPS = 5.0f;
+const float NEUTRAL_SEARCH_MM = 200.0f;     // Heave range searched for the mid-stroke neutral
+
+// --- Tunable fields ---
+struct ParamField {
+    const char* name;
+    float WashoutParams::* member;
+};
+
+static const ParamField FIELDS[] = {
+    { "translationScale", &WashoutParams::translationScale },
+    { "translationHpFreq", &WashoutParams::translationHpFreq },
+    { "translationHpDamping", &WashoutParams::translationHpDamping },
+    { "translationHpReturn", &WashoutParams::translationHpReturn },
+    { "translationLimit_mm", &WashoutParams::translationLimit_mm },
+    { "tiltScale", &WashoutParams::tiltScale },
+    { "tiltLpFreq", &WashoutParams::tiltLpFreq },
+    { "tiltLpDamping", &WashoutParams::tiltLpDamping },
+    { "tiltRateLimit_dps", &WashoutParams::tiltRateLimit_dps },
+    { "tiltLimit_deg", &WashoutParams::tiltLimit_deg },
+    { "rotationScale", &WashoutParams::rotationScale },
+    { "rotationHpFreq", &WashoutParams::rotationHpFreq },
+    { "rotationHpDamping", &WashoutParams::rotationHpDamping },
+    { "angleLimit_deg", &WashoutParams::angleLimit_deg },
+    { "yawLimit_deg", &WashoutParams::yawLimit_deg },
+};
+
+struct GridAxis {
+    const ParamField* field;
+    std::vector<float> values;
+};
+
+// "name=1,2,3" or "name=lo:hi:n"
+static bool parseGrid(const std::string& spec, GridAxis& axis) {
+    size_t eq = spec.find('=');
+    if (eq == std::string::npos) {
+        return false;
+    }
+    std::string name = spec.substr(0, eq);
+    std::string values = spec.substr(eq + 1);
+    axis.field = nullptr;
+    for (const ParamField& f : FIELDS) {
+        if (name == f.name) axis.field = &f;
+    }
+    if (!axis.field) {
+        std::cerr << "Unknown parameter " << name << "; one of:";
+        for (const ParamField& f : FIELDS) std::cerr << " " << f.name;
+        std::cerr << std::endl;
+        return false;
+    }
+
+    axis.values.clear();
+    float lo, hi;
+    int n;
+    if (values.find(':') != std::string::npos) {
+        if (sscanf(values.c_str(), "%f:%f:%d", &lo, &hi, &n) != 3 || n < 1) {
+            return false;
+        }
+        for (int i = 0; i < n; ++i) {
+            axis.values.push_back(n == 1 ? lo : lo + (hi - lo) * i / (n - 1));
+        }
+    } else {
+        const char* p = values.c_str();
+        char* end;
+        while (*p) {
+            axis.values.push_back(strtof(p, &end));
+            if (end == p) return false;
+            p = (*end == ',') ? end + 1 : end;
+        }
+    }
+    return !axis.values.empty();
+}
+
+// --- Recordings -> washout input, once ---
+// Same resampling as MotionPipeline's cue stage: one input per washout step, holding the newest
+// frame, and a new segment (washout reset) wherever time jumps back or stalls for over a second.
+struct Flight {
+    std::vector<WashoutInput> steps;
+    std::vector<size_t> segments;       // Index of the first step of every segment
+};
+
+static void appendFrame(const FlightData& frame, double dt, Flight& flight, double& stepTime_s, bool& started) {
+    if (!started || frame.time_s < stepTime_s || frame.time_s - stepTime_s > 1.0) {
+        flight.segments.push_back(flight.steps.size());
+        stepTime_s = frame.time_s - dt;
+        started = true;
+    }
+    WashoutInput in = FlightCue::washoutInput(frame);
+    while (stepTime_s + dt <= frame.time_s + 1e-9) {
+        flight.steps.push_back(in);
+        stepTime_s += dt;
+    }
+}
+
+static bool loadFlight(const std::string& path, double dt, Flight& flight) {
+    double stepTime_s = 0.0;
+    bool started = false;
+    if (FlightRecording::isRecording(path)) {
+        FlightRecording::Reader reader;
+        if (!reader.open(path)) {
+            return false;
+        }
+        flight.steps.reserve(static_cast<size_t>((reader.lastTime_s() - reader.firstTime_s()) / dt) + 2);
+        for (size_t chunk = 0; chunk < reader.chunkCount(); ++chunk) {
+            size_t count = 0;
+            const FlightRecording::RecordedFrame* records = reader.chunkRecords(chunk, count);
+            for (size_t i = 0; i < count; ++i) {
+                appendFrame(FlightRecording::fromRecord(records[i]), dt, flight, stepTime_s, started);
+            }
+        }
+    } else {
+        FILE* in = fopen(path.c_str(), "r");
+        if (!in) {
+            std::cerr << "Error opening " << path << std::endl;
+            return false;
+        }
+        char line[512];
+        FlightData frame;
+        while (fgets(line, sizeof(line), in)) {
+            if (FlightLog::parseCsvRow(line, frame)) {
+                appendFrame(frame, dt, flight, stepTime_s, started);
+            }
+        }
+        fclose(in);
+    }
+    if (flight.steps.empty()) {
+        std::cerr << path << ": no frames" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// --- Scoring ---
+struct Weights {
+    float force = 1.0f;
+    float rate = 1.0f;
+    float limit = 20.0f;
+    float track = 1.0f;
+};
+
+struct Result {
+    size_t candidate = 0;
+    double forceRms_mps2 = 0.0;
+    double rateRms_dps = 0.0;
+    double limitedFraction = 0.0;
+    double unreachableFraction = 0.0;
+    double trackRms_mm = 0.0;
+    double workspace_pct = 0.0;
+    double score = 0.0;
+};
+
+static float meanStroke(const float stroke_mm[PlatformIK::LEGS]) {
+    float mean = 0.0f;
+    for (size_t leg = 0; leg < PlatformIK::LEGS; ++leg) mean += stroke_mm[leg] / PlatformIK::LEGS;
+    return mean;
+}
+
+// Mid-stroke neutral: the heave offset (within +/-NEUTRAL_SEARCH_MM) that brings the mean leg
+// closest to half stroke with the platform level; the geometry's own home pose is at the top of
+// the stroke
+static float findNeutralHeave(const PlatformIK& ik, float neutralStroke_mm[PlatformIK::LEGS]) {
+    float lo = -NEUTRAL_SEARCH_MM, hi = NEUTRAL_SEARCH_MM;
+    MotionSchema::MotionFrame pose;
+    for (int i = 0; i < 40; ++i) {
+        pose.translationZ_mm = 0.5f * (lo + hi);
+        ik.solve(pose, neutralStroke_mm);
+        (meanStroke(neutralStroke_mm) > 0.5f * PlatformGeometry::MAX_STROKE ? hi : lo) = pose.translationZ_mm;
+    }
+    ik.solve(pose, neutralStroke_mm);
+    return pose.translationZ_mm;
+}
+
+
+// Everything one thread needs, set up before it starts
+class Worker {
+public:
+    Worker(const std::vector<Flight>& flights, const PlatformIK& ik, float neutralHeave_mm,
+           const float neutralStroke_mm[PlatformIK::LEGS], float dt, const Weights& weights)
+        : flights(flights), ik(ik), neutralHeave_mm(neutralHeave_mm), dt(dt), weights(weights) {
+        std::copy(neutralStroke_mm, neutralStroke_mm + PlatformIK::LEGS, neutral);
+        controlEvery = std::max(1, static_cast<int>(lrintf(CONTROL_PERIOD_S / dt)));
+    }
+
+    void evaluate(const WashoutParams& params, Result& result) {
+        washout.configure(params, dt);
+        double forceSq = 0.0, rateSq = 0.0, trackSq = 0.0;
+        uint64_t steps = 0, limited = 0, cycles = 0, unreachable = 0;
+        float peakUse = 0.0f;
+
+        for (const Flight& flight : flights) {
+            for (size_t s = 0; s < flight.segments.size(); ++s) {
+                size_t begin = flight.segments[s];
+                size_t end = s + 1 < flight.segments.size() ? flight.segments[s + 1] : flight.steps.size();
+                startSegment();
+                for (size_t i = begin; i < end; ++i) {
+                    const WashoutInput& in = flight.steps[i];
+                    washout.step(in, out);
+                    ++steps;
+                    limited += out.limited ? 1 : 0;
+                    accumulateCue(in, forceSq, rateSq);
+
+                    if (++sinceControl >= controlEvery) {
+                        sinceControl = 0;
+                        ++cycles;
+                        unreachable += controlCycle(trackSq, peakUse) ? 0 : 1;
+                    }
+                }
+            }
+        }
+
+        result.forceRms_mps2 = sqrt(forceSq / std::max<uint64_t>(steps, 1));
+        result.rateRms_dps = sqrt(rateSq / std::max<uint64_t>(steps, 1));
+        result.limitedFraction = static_cast<double>(limited) / std::max<uint64_t>(steps, 1);
+        result.unreachableFraction = static_cast<double>(unreachable) / std::max<uint64_t>(cycles, 1);
+        result.trackRms_mm = sqrt(trackSq / std::max<uint64_t>(cycles * PlatformIK::LEGS, 1));
+        result.workspace_pct = 100.0 * peakUse / (0.5 * PlatformGeometry::MAX_STROKE);
+        result.score = weights.force * result.forceRms_mps2
+                     + weights.rate * result.rateRms_dps / RATE_NORM_DPS
+                     + weights.limit * (result.limitedFraction + result.unreachableFraction)
+                     + weights.track * result.trackRms_mm / ACTUATOR_TOLERANCE_MM;
+    }
+
+private:
+    enum class Motion { STOPPED, EXTENDING, RETRACTING };
+
+    void startSegment() {
+        washout.reset();
+        out = WashoutOutput();
+        for (int axis = 0; axis < 3; ++axis) {
+            position_m[axis][0] = position_m[axis][1] = 0.0f;
+        }
+        previousRoll_deg = previousPitch_deg = previousYaw_deg = 0.0f;
+        history = 0;
+        sinceControl = 0;
+        std::copy(neutral, neutral + PlatformIK::LEGS, stroke);
+        std::fill(motion, motion + PlatformIK::LEGS, Motion::STOPPED);
+    }
+
+    // Platform specific force: translational acceleration (second difference of the washout's
+    // translation) plus the share of gravity the tilt puts along x and y. Platform rates: first
+    // difference of its angles.
+    void accumulateCue(const WashoutInput& in, double& forceSq, double& rateSq) {
+        float x_m[3] = { 0.001f * out.translation_mm[0], 0.001f * out.translation_mm[1], 0.001f * out.translation_mm[2] };
+        if (history >= 2) {
+            float accel[3];
+            for (int axis = 0; axis < 3; ++axis) {
+                accel[axis] = (x_m[axis] - 2.0f * position_m[axis][0] + position_m[axis][1]) / (dt * dt);
+            }
+            float platform[3] = {
+                accel[0] + GRAVITY * sinf(out.pitch_deg * DEG_TO_RAD),
+                accel[1] - GRAVITY * sinf(out.roll_deg * DEG_TO_RAD),
+                accel[2]
+            };
+            float aircraft[3] = { in.specificForce_mps2[0], in.specificForce_mps2[1], in.specificForce_mps2[2] - GRAVITY };
+            float rates[3] = {
+                (out.roll_deg - previousRoll_deg) / dt,
+                (out.pitch_deg - previousPitch_deg) / dt,
+                (out.yaw_deg - previousYaw_deg) / dt
+            };
+            for (int axis = 0; axis < 3; ++axis) {
+                float df = platform[axis] - aircraft[axis];
+                float dr = rates[axis] - in.rate_dps[axis];
+                forceSq += df * df;
+                rateSq += dr * dr;
+            }
+        } else {
+            ++history;
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            position_m[axis][1] = position_m[axis][0];
+            position_m[axis][0] = x_m[axis];
+        }
+        previousRoll_deg = out.roll_deg;
+        previousPitch_deg = out.pitch_deg;
+        previousYaw_deg = out.yaw_deg;
+    }
+
+    // One firmware control cycle: IK on the current pose, then every actuator moves for one
+    // period in its current state and picks the next one (DigitalPosFeedback::updatePosition /
+    // moveToTarget). Returns false if the IK clamped a leg.
+    bool controlCycle(double& trackSq, float& peakUse) {
+        MotionSchema::MotionFrame pose;
+        pose.translationX_mm = out.translation_mm[0];
+        pose.translationY_mm = out.translation_mm[1];
+        pose.translationZ_mm = out.translation_mm[2] + neutralHeave_mm;
+        pose.roll_deg = out.roll_deg;
+        pose.pitch_deg = out.pitch_deg;
+        pose.yaw_deg = out.yaw_deg;
+        float target[PlatformIK::LEGS];
+        bool reachable = ik.solve(pose, target);
+
+        const float travel = ACTUATOR_SPEED_MM_PER_S * CONTROL_PERIOD_S;
+        for (size_t leg = 0; leg < PlatformIK::LEGS; ++leg) {
+            if (motion[leg] == Motion::EXTENDING) stroke[leg] = std::min(stroke[leg] + travel, PlatformGeometry::MAX_STROKE);
+            if (motion[leg] == Motion::RETRACTING) stroke[leg] = std::max(stroke[leg] - travel, 0.0f);
+            float error = target[leg] - stroke[leg];
+            motion[leg] = fabsf(error) <= ACTUATOR_TOLERANCE_MM ? Motion::STOPPED
+                        : (error > 0.0f ? Motion::EXTENDING : Motion::RETRACTING);
+            trackSq += error * error;
+            peakUse = std::max(peakUse, fabsf(target[leg] - neutral[leg]));
+        }
+        return reachable;
+    }
+
+    const std::vector<Flight>& flights;
+    const PlatformIK& ik;
+    float neutralHeave_mm;
+    float neutral[PlatformIK::LEGS];
+    float dt;
+    Weights weights;
+    int controlEvery = 1;
+
+    ClassicalWashout washout;
+    WashoutOutput out;
+    float position_m[3][2] = {};        // Translation one and two steps back
+    float previousRoll_deg = 0.0f, previousPitch_deg = 0.0f, previousYaw_deg = 0.0f;
+    int history = 0;
+    int sinceControl = 0;
+    float stroke[PlatformIK::LEGS] = {};
+    Motion motion[PlatformIK::LEGS] = {};
+};
+
+// --- Output ---
+static void printCandidate(const std::vector<GridAxis>& grid, const WashoutParams& p, FILE* file, const char* separator) {
+    for (size_t a = 0; a < grid.size(); ++a) {
+        fprintf(file, "%s%s=%g", a ? separator : "", grid[a].field->name, p.*(grid[a].field->member));
+    }
+}
+
+static bool writeCsv(const std::string& path, const std::vector<GridAxis>& grid,
+                     const std::vector<WashoutParams>& candidates, const std::vector<Result>& results) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        std::cerr << "Error opening " << path << std::endl;
+        return false;
+    }
+    fprintf(file, "rank,score,force_rms_mps2,rate_rms_dps,limited_pct,unreachable_pct,track_rms_mm,workspace_pct");
+    for (const GridAxis& axis : grid) fprintf(file, ",%s", axis.field->name);
+    fprintf(file, "\n");
+    for (size_t r = 0; r < results.size(); ++r) {
+        const Result& res = results[r];
+        fprintf(file, "%zu,%.5f,%.5f,%.5f,%.4f,%.4f,%.4f,%.2f", r + 1, res.score, res.forceRms_mps2, res.rateRms_dps,
+                100.0 * res.limitedFraction, 100.0 * res.unreachableFraction, res.trackRms_mm, res.workspace_pct);
+        for (const GridAxis& axis : grid) fprintf(file, ",%g", candidates[res.candidate].*(axis.field->member));
+        fprintf(file, "\n");
+    }
+    bool ok = fclose(file) == 0;
+    if (!ok) {
+        std::cerr << "Error writing " << path << std::endl;
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    double rateHz = 200.0;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t top = 10;
+    std::string outPath;
+    bool fixedNeutral = false;
+    float neutralHeave = 0.0f;
+    Weights weights;
+    std::vector<GridAxis> grid;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--grid" && value) {
+            GridAxis axis;
+            if (!parseGrid(value, axis)) {
+                std::cerr << "Bad --grid " << value << std::endl;
+                return 1;
+            }
+            grid.push_back(axis);
+            ++i;
+        }
+        else if (arg == "--rate" && value) { rateHz = atof(value); ++i; }
+        else if (arg == "--threads" && value) { threads = static_cast<unsigned>(std::max(1, atoi(value))); ++i; }
+        else if (arg == "--top" && value) { top = static_cast<size_t>(std::max(1, atoi(value))); ++i; }
+        else if (arg == "--out" && value) { outPath = value; ++i; }
+        else if (arg == "--neutral-heave" && value) { neutralHeave = static_cast<float>(atof(value)); fixedNeutral = true; ++i; }
+        else if (arg == "--weights" && value) {
+            if (sscanf(value, "%f,%f,%f,%f", &weights.force, &weights.rate, &weights.limit, &weights.track) != 4) {
+                std::cerr << "Bad --weights " << value << std::endl;
+                return 1;
+            }
+            ++i;
+        }
+        else if (arg.rfind("--", 0) != 0) { paths.push_back(arg); }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--grid NAME=V1,V2,..|NAME=LO:HI:N]... [--rate HZ] [--threads N] "
+                      << "[--weights F,R,L,T] [--top N] [--neutral-heave MM] [--out FILE] <recording>..." << std::endl;
+            return 1;
+        }
+    }
+    if (paths.empty() || rateHz <= 0.0) {
+        std::cerr << "Usage: " << argv[0] << " [options] <recording.fltrec|.csv>..." << std::endl;
+        return 1;
+    }
+    if (grid.empty()) {
+        const char* defaults[] = {
+            "translationScale=0.1,0.2,0.3", "translationHpFreq=2,3,4,6",
+            "tiltScale=0.2,0.4,0.6", "rotationScale=0.3,0.5,0.7", "rotationHpFreq=0.5,1,2"
+        };
+        for (const char* spec : defaults) {
+            GridAxis axis;
+            parseGrid(spec, axis);
+            grid.push_back(axis);
+        }
+    }
+
+    // --- Inputs, shared read-only by every thread ---
+    const float dt = static_cast<float>(1.0 / rateHz);
+    std::vector<Flight> flights(paths.size());
+    size_t totalSteps = 0;
+    for (size_t f = 0; f < paths.size(); ++f) {
+        if (!loadFlight(paths[f], dt, flights[f])) {
+            return 1;
+        }
+        totalSteps += flights[f].steps.size();
+    }
+    double flight_s = totalSteps * static_cast<double>(dt);
+
+    // --- Candidates: every combination of the grid values ---
+    std::vector<WashoutParams> candidates(1);
+    for (const GridAxis& axis : grid) {
+        std::vector<WashoutParams> next;
+        next.reserve(candidates.size() * axis.values.size());
+        for (const WashoutParams& base : candidates) {
+            for (float v : axis.values) {
+                next.push_back(base);
+                next.back().*(axis.field->member) = v;
+            }
+        }
+        candidates.swap(next);
+    }
+
+    PlatformIK ik;
+    float neutralStroke[PlatformIK::LEGS];
+    if (fixedNeutral) {
+        MotionSchema::MotionFrame pose;
+        pose.translationZ_mm = neutralHeave;
+        ik.solve(pose, neutralStroke);
+    } else {
+        neutralHeave = findNeutralHeave(ik, neutralStroke);
+    }
+
+    printf("%zu recording(s), %.1f min of flight at %.0f Hz; %zu candidates on %u threads\n",
+           paths.size(), flight_s / 60.0, rateHz, candidates.size(), threads);
+    printf("Neutral: heave %.1f mm, mean stroke %.1f of %.0f mm\n", neutralHeave, meanStroke(neutralStroke),
+           PlatformGeometry::MAX_STROKE);
+
+    // --- Sweep ---
+    std::vector<Result> results(candidates.size());
+    std::vector<Worker> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(flights, ik, neutralHeave, neutralStroke, dt, weights);
+    }
+    std::atomic<size_t> nextCandidate{0};
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            for (size_t c = nextCandidate.fetch_add(1, std::memory_order_relaxed); c < candidates.size();
+                 c = nextCandidate.fetch_add(1, std::memory_order_relaxed)) {
+                results[c].candidate = c;
+                workers[t].evaluate(candidates[c], results[c]);
+            }
+        });
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::sort(results.begin(), results.end(), [](const Result& a, const Result& b) { return a.score < b.score; });
+
+    // --- Ranking ---
+    printf("Swept in %.2f s: %.0f candidate-hours of flight per second\n\n",
+           seconds, candidates.size() * flight_s / 3600.0 / seconds);
+    printf("rank   score  force m/s2  rate dps  limited %%  reach %%  track mm  workspace %%  parameters\n");
+    for (size_t r = 0; r < std::min(top, results.size()); ++r) {
+        const Result& res = results[r];
+        printf("%4zu %7.3f %11.3f %9.2f %10.2f %8.2f %9.1f %12.0f  ", r + 1, res.score, res.forceRms_mps2,
+               res.rateRms_dps, 100.0 * res.limitedFraction, 100.0 * res.unreachableFraction, res.trackRms_mm,
+               res.workspace_pct);
+        printCandidate(grid, candidates[res.candidate], stdout, " ");
+        printf("\n");
+    }
+    printf("\nBest: ");
+    printCandidate(grid, candidates[results.front().candidate], stdout, ", ");
+    printf("\n");
+
+    if (!outPath.empty() && !writeCsv(outPath, grid, candidates, results)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#ifndef CONFIG_CLIENT_HPP
+#define CONFIG_CLIENT_HPP
+
+// --- Host side of the runtime configuration protocol ---
+// Sends get/set requests (MotionLink_Lib/ConfigProtocol.hpp) over an open SerialTransmitter and
+// waits for the matching reply. Anything else the platform sends in the meantime (telemetry,
+// latency traces, printf text) is skipped. Lost requests/replies are retried once.
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "SerialTransmitter.hpp"
+#include "MotionLink_Lib/ConfigProtocol.hpp"
+#include "MotionLink_Lib/MotionReceiver.hpp"
+
+class ConfigClient : private MotionLink::MessageHandler {
+public:
+    explicit ConfigClient(SerialTransmitter& serial) : serial(serial), receiver(*this) {}
+
+    // Sends one request and waits for its reply. Returns false if no reply arrived in time;
+    // otherwise reply.status says whether the platform accepted it.
+    bool get(uint8_t param, uint8_t index, MotionLink::ConfigReply& reply,
+             std::chrono::milliseconds timeout = std::chrono::milliseconds(500)) {
+        return transact(MotionLink::MSG_CONFIG_GET, param, index, 0.0f, reply, timeout);
+    }
+
+    bool set(uint8_t param, uint8_t index, float value, MotionLink::ConfigReply& reply,
+             std::chrono::milliseconds timeout = std::chrono::milliseconds(500)) {
+        return transact(MotionLink::MSG_CONFIG_SET, param, index, value, reply, timeout);
+    }
+
+private:
+    bool transact(uint8_t type, uint8_t param, uint8_t index, float value,
+                  MotionLink::ConfigReply& reply, std::chrono::milliseconds timeout) {
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            MotionLink::ConfigRequest request;
+            request.id = nextId++;
+            request.param = param;
+            request.index = index;
+            request.value = value;
+
+            uint8_t frame[MotionLink::frameSize(MotionLink::CONFIG_REQUEST_SIZE)];
+            size_t length = MotionLink::buildConfigRequest(type, request, frame);
+            if (serial.queueFrame(frame, length, false) == SerialTransmitter::QueueResult::DROPPED ||
+                !serial.flushBlocking(timeout)) {
+                return false;
+            }
+
+            waitingFor = request.id;
+            gotReply = false;
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            uint8_t rxBuffer[256];
+            while (!gotReply && std::chrono::steady_clock::now() < deadline) {
+                long count = serial.read(rxBuffer, sizeof(rxBuffer));
+                if (count < 0) {
+                    return false;
+                }
+                if (count > 0) {
+                    receiver.push(rxBuffer, static_cast<size_t>(count));
+                } else {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+            if (gotReply) {
+                reply = lastReply;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void onMotionFrame(const MotionSchema::MotionFrame& frame, uint32_t arrival_us) override {
+        (void)frame; (void)arrival_us;
+    }
+
+    void onOtherFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint32_t arrival_us) override {
+        (void)arrival_us;
+        MotionLink::ConfigReply reply;
+        if (type == MotionLink::MSG_CONFIG_REPLY && MotionLink::decodeConfigReply(payload, length, reply) &&
+            reply.id == waitingFor) {
+            lastReply = reply;
+            gotReply = true;
+        }
+    }
+
+    SerialTransmitter& serial;
+    MotionLink::MotionReceiver receiver;
+    uint16_t nextId = 1;
+    uint16_t waitingFor = 0;
+    bool gotReply = false;
+    MotionLink::ConfigReply lastReply;
+};
+
+#endif // CONFIG_CLIENT_HPP
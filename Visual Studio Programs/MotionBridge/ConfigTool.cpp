@@ -0,0 +1,194 @@
+// --- Runtime configuration tool ---
+// Reads and changes Platform IK controller parameters over the serial link, no reflash needed.
+// The firmware applies a change at the start of its next control cycle.
+//
+// Usage: ConfigTool <port> [--baud B] <command>
+//   dump                                  print every parameter
+//   get <param> [index]                   read one parameter (index defaults to 0)
+//   set <param> <index|all> <value>       change one actuator's parameter, or all six
+//   pose <x> <y> <z> <roll> <pitch> <yaw> hold the platform at a pose (mm, deg), sent as one
+//                                         motion frame so all six axes change together
+//
+//   params: tolerance (mm), duty (0-1), speed (mm/s), pose (index 0-5 = x y z roll pitch yaw),
+//           decimation (telemetry, every Nth cycle),
+//           predict (per pose axis: 0 hold, 1 velocity, 2 acceleration, 3 Kalman),
+//           noise (per pose axis, Kalman process noise), lead (ms added to the measured latency),
+//           prederr / holderr (read-only, per pose axis: RMS error with / without prediction)
+//   Actuator indices are 1-6 as printed by the firmware.
+
+#include "SerialTransmitter.hpp"
+#include "ConfigClient.hpp"
+#include "MotionLink_Lib/MotionLink.hpp"
+#include "MotionLink_Lib/MotionSchema.hpp"
+#include "MotionLink_Lib/PosePredictor.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace MotionLink;
+
+struct ParamName {
+    const char* name;
+    uint8_t id;
+    bool perActuator;   // Indices are actuators 1-6 on the command line
+};
+
+static const ParamName PARAMS[] = {
+    { "tolerance",  PARAM_TOLERANCE_MM,         true  },
+    { "duty",       PARAM_DUTY_CYCLE,           true  },
+    { "speed",      PARAM_ACTUATOR_SPEED,       true  },
+    { "pose",       PARAM_POSE,                 false },
+    { "decimation", PARAM_TELEMETRY_DECIMATION, false },
+    { "predict",    PARAM_PREDICT_MODE,         false },
+    { "noise",      PARAM_PREDICT_NOISE,        false },
+    { "lead",       PARAM_PREDICT_LEAD_MS,      false },
+    { "prederr",    PARAM_PREDICT_ERROR,        false },
+    { "holderr",    PARAM_PREDICT_HOLD_ERROR,   false },
+};
+
+static const char* POSE_AXIS_NAMES[POSE_AXES] = { "x_mm", "y_mm", "z_mm", "roll_deg", "pitch_deg", "yaw_deg" };
+
+static const ParamName* findParam(const std::string& name) {
+    for (const ParamName& param : PARAMS) {
+        if (name == param.name) return &param;
+    }
+    std::cerr << "Unknown parameter '" << name << "'" << std::endl;
+    return nullptr;
+}
+
+// Command-line index -> wire index (actuators are 1-based for humans)
+static bool parseIndex(const ParamName& param, const std::string& text, uint8_t& index) {
+    if (text == "all") {
+        index = INDEX_ALL;
+        return true;
+    }
+    int value = atoi(text.c_str());
+    if (param.perActuator) value -= 1;
+    if (value < 0 || value > 254) {
+        std::cerr << "Bad index '" << text << "'" << std::endl;
+        return false;
+    }
+    index = static_cast<uint8_t>(value);
+    return true;
+}
+
+static bool report(bool answered, const ConfigReply& reply) {
+    if (!answered) {
+        std::cerr << "No reply from the platform" << std::endl;
+        return false;
+    }
+    if (reply.status != CONFIG_OK) {
+        std::cerr << "Rejected: " << configStatusName(reply.status) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool dump(ConfigClient& client) {
+    ConfigReply reply;
+    printf("%-10s", "");
+    for (int a = 1; a <= 6; ++a) printf("%10s%d", "A", a);
+    printf("\n");
+    for (const ParamName& param : PARAMS) {
+        if (!param.perActuator) continue;
+        printf("%-10s", param.name);
+        for (uint8_t i = 0; i < 6; ++i) {
+            if (!report(client.get(param.id, i, reply), reply)) return false;
+            printf("%11.3f", reply.value);
+        }
+        printf("\n");
+    }
+    printf("\npose     ");
+    for (uint8_t axis = 0; axis < POSE_AXES; ++axis) {
+        if (!report(client.get(PARAM_POSE, axis, reply), reply)) return false;
+        printf("  %s=%.2f", POSE_AXIS_NAMES[axis], reply.value);
+    }
+    if (!report(client.get(PARAM_TELEMETRY_DECIMATION, 0, reply), reply)) return false;
+    printf("\ntelemetry decimation: %.0f\n", reply.value);
+
+    static const char* MODE_NAMES[PREDICT_MODES] = { "hold", "velocity", "accel", "kalman" };
+    printf("\n%-10s%10s%12s%14s%14s\n", "predict", "mode", "noise", "RMS pred", "RMS held");
+    for (uint8_t axis = 0; axis < POSE_AXES; ++axis) {
+        float values[4];
+        const uint8_t ids[4] = { PARAM_PREDICT_MODE, PARAM_PREDICT_NOISE, PARAM_PREDICT_ERROR, PARAM_PREDICT_HOLD_ERROR };
+        for (int i = 0; i < 4; ++i) {
+            if (!report(client.get(ids[i], axis, reply), reply)) return false;
+            values[i] = reply.value;
+        }
+        int mode = static_cast<int>(values[0] + 0.5f);
+        printf("%-10s%10s%12.0f%14.4f%14.4f\n", POSE_AXIS_NAMES[axis],
+               mode >= 0 && mode < PREDICT_MODES ? MODE_NAMES[mode] : "?", values[1], values[2], values[3]);
+    }
+    if (!report(client.get(PARAM_PREDICT_LEAD_MS, 0, reply), reply)) return false;
+    printf("fixed lead: %.1f ms\n", reply.value);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    int baudRate = 115200;
+    for (size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--baud") {
+            baudRate = atoi(args[i + 1].c_str());
+            args.erase(args.begin() + i, args.begin() + i + 2);
+            break;
+        }
+    }
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0] << " <port> [--baud B] dump | get <param> [index] | "
+                  << "set <param> <index|all> <value> | pose <x> <y> <z> <roll> <pitch> <yaw>" << std::endl;
+        return 1;
+    }
+
+    SerialTransmitter serial;
+    if (!serial.open(args[0], baudRate)) {
+        return 1;
+    }
+    ConfigClient client(serial);
+    ConfigReply reply;
+    const std::string& command = args[1];
+    bool ok = false;
+
+    if (command == "dump") {
+        ok = dump(client);
+    } else if (command == "get" && args.size() >= 3) {
+        const ParamName* param = findParam(args[2]);
+        uint8_t index = 0;
+        if (param && (args.size() < 4 || parseIndex(*param, args[3], index))) {
+            ok = report(client.get(param->id, index, reply), reply);
+            if (ok) printf("%s = %.3f\n", param->name, reply.value);
+        }
+    } else if (command == "set" && args.size() >= 5) {
+        const ParamName* param = findParam(args[2]);
+        uint8_t index = 0;
+        if (param && parseIndex(*param, args[3], index)) {
+            ok = report(client.set(param->id, index, static_cast<float>(atof(args[4].c_str())), reply), reply);
+            if (ok) printf("%s = %.3f\n", param->name, reply.value);
+        }
+    } else if (command == "pose" && args.size() >= 2 + POSE_AXES) {
+        // Sent as one motion frame so the platform takes all six axes in the same cycle
+        MotionSchema::MotionFrame pose;
+        pose.translationX_mm = static_cast<float>(atof(args[2].c_str()));
+        pose.translationY_mm = static_cast<float>(atof(args[3].c_str()));
+        pose.translationZ_mm = static_cast<float>(atof(args[4].c_str()));
+        pose.roll_deg  = static_cast<float>(atof(args[5].c_str()));
+        pose.pitch_deg = static_cast<float>(atof(args[6].c_str()));
+        pose.yaw_deg   = static_cast<float>(atof(args[7].c_str()));
+        uint8_t frame[MotionLink::MAX_FRAME_SIZE];
+        size_t length = MotionLink::buildMotionFrame<MotionSchema::QuantLevel::FINE>(pose, frame);
+        serial.queueFrame(frame, length, false);
+        serial.flushBlocking(std::chrono::milliseconds(500));
+
+        // Read it back to confirm it landed
+        ok = report(client.get(PARAM_POSE, POSE_PITCH_DEG, reply), reply);
+        if (ok) printf("Pose set (pitch now %.2f deg)\n", reply.value);
+    } else {
+        std::cerr << "Bad command, run without arguments for usage" << std::endl;
+    }
+
+    serial.close();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+// --- End-to-end latency probe ---
+// Streams motion frames to the Platform IK firmware and collects the LatencyTrace it sends back
+// for every pose that reaches the actuators, then prints per-stage latency statistics:
+//
+//   link           host send   -> first byte in the platform's RX buffer   (crosses clocks)
+//   rx             RX buffer   -> decoded by the link thread
+//   wait-for-cycle decoded     -> taken by the control loop at a cycle boundary
+//   ik             taken       -> actuator strokes computed
+//   pwm            strokes     -> PWM outputs written
+//   end-to-end     host send   -> PWM outputs written                      (crosses clocks)
+//
+// Stages that cross clocks use the offset from a periodic NTP-style time-sync exchange (see
+// MotionLink_Lib/LatencyTrace.hpp). The stage with the largest mean is reported at the end.
+//
+// Usage: LatencyProbe <port> [--baud B] [--rate HZ] [--seconds S] [--level coarse|standard|fine] [--csv FILE]
+//   port       e.g. /dev/ttyACM0 or COM3
+//   --baud     line rate, must match LINK_BAUD_RATE in the firmware   (default 115200)
+//   --rate     motion frame rate in Hz                                (default 60)
+//   --seconds  how long to run                                        (default 10)
+//   --level    quantization level                                     (default standard)
+//   --csv      write the full per-stage histograms to FILE
+
+#include "SerialTransmitter.hpp"
+#include "LatencyStats.hpp"
+#include "MotionLink_Lib/LatencyTrace.hpp"
+#include "MotionLink_Lib/MotionLink.hpp"
+#include "MotionLink_Lib/MotionReceiver.hpp"
+#include "MotionLink_Lib/MotionSchema.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std::chrono;
+using MotionSchema::QuantLevel;
+
+using Clock = steady_clock;
+
+// --- Histogram layout: 50 us bins up to 100 ms ---
+const uint32_t BIN_WIDTH_US = 50;
+const size_t BIN_COUNT = 2000;
+
+// Time sync: quick bursts at start-up to lock on, then once a second to follow drift
+const int SYNC_BURST_COUNT = 8;
+const milliseconds SYNC_BURST_PERIOD(100);
+const milliseconds SYNC_PERIOD(1000);
+
+static const Clock::time_point startTime = Clock::now();
+
+// Host clock in the same wrapping microsecond format the firmware uses
+static uint32_t hostNow_us() {
+    return static_cast<uint32_t>(duration_cast<microseconds>(Clock::now() - startTime).count());
+}
+
+// Feeds time-sync replies into the clock estimate and latency traces into the histograms
+class ProbeHandler : public MotionLink::MessageHandler {
+public:
+    ClockSync clockSync;
+    LatencyHistogram link{"link", BIN_WIDTH_US, BIN_COUNT};
+    LatencyHistogram rx{"rx", BIN_WIDTH_US, BIN_COUNT};
+    LatencyHistogram waitForCycle{"wait-for-cycle", BIN_WIDTH_US, BIN_COUNT};
+    LatencyHistogram ik{"ik", BIN_WIDTH_US, BIN_COUNT};
+    LatencyHistogram pwm{"pwm", BIN_WIDTH_US, BIN_COUNT};
+    LatencyHistogram endToEnd{"end-to-end", BIN_WIDTH_US, BIN_COUNT};
+    uint32_t syncReplies = 0;
+    uint32_t tracesBeforeSync = 0;
+
+    void onMotionFrame(const MotionSchema::MotionFrame& frame, uint32_t arrival_us) override {
+        (void)frame; (void)arrival_us; // The platform doesn't send poses back
+    }
+
+    void onOtherFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint32_t arrival_us) override {
+        if (type == MotionLink::MSG_TIME_SYNC_REPLY) {
+            MotionLink::TimeSyncReply reply;
+            if (MotionLink::decodeTimeSyncReply(payload, length, reply)) {
+                clockSync.addSample(reply.t1_us, reply.t2_us, reply.t3_us, arrival_us);
+                ++syncReplies;
+            }
+        } else if (type == MotionLink::MSG_LATENCY_TRACE) {
+            MotionLink::LatencyTrace trace;
+            if (!MotionLink::decodeLatencyTrace(payload, length, trace)) {
+                return;
+            }
+            if (!clockSync.valid()) {
+                ++tracesBeforeSync;
+                return;
+            }
+            using MotionLink::elapsed_us;
+            link.add(elapsed_us(clockSync.toHost(trace.arrival_us), trace.hostTime_us));
+            rx.add(elapsed_us(trace.parsed_us, trace.arrival_us));
+            waitForCycle.add(elapsed_us(trace.pickup_us, trace.parsed_us));
+            ik.add(elapsed_us(trace.ikDone_us, trace.pickup_us));
+            pwm.add(elapsed_us(trace.pwmCommit_us, trace.ikDone_us));
+            endToEnd.add(elapsed_us(clockSync.toHost(trace.pwmCommit_us), trace.hostTime_us));
+        }
+    }
+};
+
+// Builds one frame at the requested level
+static size_t buildFrame(QuantLevel level, const MotionSchema::MotionFrame& frame, uint8_t* out) {
+    switch (level) {
+        case QuantLevel::COARSE:   return MotionLink::buildMotionFrame<QuantLevel::COARSE>(frame, out);
+        case QuantLevel::FINE:     return MotionLink::buildMotionFrame<QuantLevel::FINE>(frame, out);
+        case QuantLevel::STANDARD:
+        default:                   return MotionLink::buildMotionFrame<QuantLevel::STANDARD>(frame, out);
+    }
+}
+
+static bool writeCsv(const std::string& path, const ProbeHandler& handler) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        std::cerr << "Error opening " << path << std::endl;
+        return false;
+    }
+    const LatencyHistogram* stages[] = { &handler.link, &handler.rx, &handler.waitForCycle, &handler.ik, &handler.pwm, &handler.endToEnd };
+    fprintf(file, "bin_start_us");
+    for (const LatencyHistogram* stage : stages) fprintf(file, ",%s", stage->label());
+    fprintf(file, "\n");
+    for (size_t bin = 0; bin <= BIN_COUNT; ++bin) {
+        fprintf(file, "%lu", (unsigned long)(bin * BIN_WIDTH_US));
+        for (const LatencyHistogram* stage : stages) {
+            fprintf(file, ",%llu", (unsigned long long)stage->binCounts()[bin]);
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argv[1][0] == '-') {
+        std::cerr << "Usage: " << argv[0] << " <port> [--baud B] [--rate HZ] [--seconds S] [--level coarse|standard|fine] [--csv FILE]" << std::endl;
+        return 1;
+    }
+    std::string port = argv[1];
+    int baudRate = 115200;
+    double rateHz = 60.0;
+    double seconds = 10.0;
+    QuantLevel level = QuantLevel::STANDARD;
+    std::string csvPath;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--baud" && value) { baudRate = atoi(value); ++i; }
+        else if (arg == "--rate" && value) { rateHz = atof(value); ++i; }
+        else if (arg == "--seconds" && value) { seconds = atof(value); ++i; }
+        else if (arg == "--csv" && value) { csvPath = value; ++i; }
+        else if (arg == "--level" && value) {
+            std::string name = value; ++i;
+            if (name == "coarse") level = QuantLevel::COARSE;
+            else if (name == "fine") level = QuantLevel::FINE;
+            else level = QuantLevel::STANDARD;
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (rateHz <= 0.0) {
+        std::cerr << "--rate must be positive" << std::endl;
+        return 1;
+    }
+
+    SerialTransmitter transmitter;
+    if (!transmitter.open(port, baudRate)) {
+        return 1;
+    }
+
+    ProbeHandler handler;
+    MotionLink::MotionReceiver receiver(handler);
+
+    std::cout << "Probing " << port << " at " << baudRate << " baud, " << rateHz << " Hz for " << seconds << " s" << std::endl;
+
+    uint8_t frameBuffer[MotionLink::MAX_FRAME_SIZE];
+    uint8_t rxBuffer[256];
+    MotionSchema::MotionFrame frame;
+    uint16_t syncId = 0;
+    int syncSent = 0;
+
+    Clock::duration framePeriod = duration_cast<Clock::duration>(duration<double>(1.0 / rateHz));
+    Clock::time_point endTime = Clock::now() + duration_cast<Clock::duration>(duration<double>(seconds));
+    Clock::time_point nextFrame = Clock::now();
+    Clock::time_point nextSync = Clock::now();
+
+    while (Clock::now() < endTime) {
+        Clock::time_point now = Clock::now();
+        bool busy = false;
+
+        // --- Time sync request ---
+        if (now >= nextSync) {
+            MotionLink::TimeSyncRequest request;
+            request.id = syncId++;
+            request.t1_us = hostNow_us();
+            size_t length = MotionLink::buildTimeSyncRequest(request, frameBuffer);
+            transmitter.queueFrame(frameBuffer, length, false);
+            ++syncSent;
+            nextSync += syncSent < SYNC_BURST_COUNT ? SYNC_BURST_PERIOD : SYNC_PERIOD;
+            busy = true;
+        }
+
+        // --- Motion frame (slow sine sweep, just something for the IK to chew on) ---
+        if (now >= nextFrame) {
+            float t = duration<float>(now - startTime).count();
+            frame.sequence++;
+            frame.roll_deg = 5.0f * sinf(t);
+            frame.pitch_deg = 5.0f * cosf(0.7f * t);
+            frame.translationZ_mm = 20.0f * sinf(0.5f * t);
+            frame.hostTime_us = hostNow_us();
+            size_t length = buildFrame(level, frame, frameBuffer);
+            transmitter.queueFrame(frameBuffer, length, true);
+            nextFrame += framePeriod;
+            busy = true;
+        }
+
+        if (transmitter.flush() < 0) {
+            break;
+        }
+
+        // --- Replies and traces ---
+        long count = transmitter.read(rxBuffer, sizeof(rxBuffer));
+        if (count < 0) {
+            break;
+        }
+        if (count > 0) {
+            receiver.push(rxBuffer, static_cast<size_t>(count), hostNow_us());
+            busy = true;
+        }
+
+        if (!busy) {
+            std::this_thread::sleep_for(microseconds(200));
+        }
+    }
+
+    // --- Report ---
+    const SerialTransmitter::Stats& tx = transmitter.stats();
+    const MotionLink::FrameParser& linkStats = receiver.stats();
+    printf("\nFrames sent: %llu (%llu coalesced, %llu dropped), frames back: %lu OK, %lu CRC errors\n",
+           (unsigned long long)tx.framesQueued, (unsigned long long)tx.framesCoalesced, (unsigned long long)tx.framesDropped,
+           (unsigned long)linkStats.framesOk, (unsigned long)linkStats.crcErrors);
+    printf("Time sync: %lu replies, offset %ld us, best round trip %ld us (%lu traces before first sync)\n\n",
+           (unsigned long)handler.syncReplies, (long)handler.clockSync.offset_us(),
+           (long)handler.clockSync.roundTrip_us(), (unsigned long)handler.tracesBeforeSync);
+
+    LatencyHistogram::printSummaryHeader();
+    const LatencyHistogram* stages[] = { &handler.link, &handler.rx, &handler.waitForCycle, &handler.ik, &handler.pwm };
+    const LatencyHistogram* largest = stages[0];
+    for (const LatencyHistogram* stage : stages) {
+        stage->printSummary();
+        if (stage->mean() > largest->mean()) largest = stage;
+    }
+    handler.endToEnd.printSummary();
+
+    if (handler.endToEnd.count() > 0) {
+        printf("\nLargest contributor: %s (mean %.0f us, %.0f%% of end-to-end)\n",
+               largest->label(), largest->mean(), 100.0 * largest->mean() / handler.endToEnd.mean());
+    } else {
+        printf("\nNo latency traces received. Is Platform IK running and LINK_BAUD_RATE = %d?\n", baudRate);
+    }
+
+    if (!csvPath.empty() && writeCsv(csvPath, handler)) {
+        std::cout << "Histograms written to " << csvPath << std::endl;
+    }
+
+    transmitter.close();
+    return 0;
+}
@@ -0,0 +1,133 @@
+#ifndef LATENCY_STATS_HPP
+#define LATENCY_STATS_HPP
+
+// --- Host-side latency statistics ---
+// ClockSync turns TimeSyncReply round trips into a platform -> host clock offset, and
+// LatencyHistogram collects one pipeline stage. See MotionLink_Lib/LatencyTrace.hpp for the
+// messages and the offset formula.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include "MotionLink_Lib/LatencyTrace.hpp"
+
+// --- Clock offset estimate ---
+// Keeps the last WINDOW round trips and trusts the one with the smallest round trip: the less
+// time a request spent queued somewhere, the less room there is for the two directions to be
+// asymmetric. Re-syncing every second or so also tracks the drift between the two crystals
+// (tens of ppm, i.e. tens of microseconds per second).
+class ClockSync {
+public:
+    static constexpr size_t WINDOW = 8;
+
+    // t1/t4 are host times, t2/t3 platform times of one request/reply
+    void addSample(uint32_t t1, uint32_t t2, uint32_t t3, uint32_t t4) {
+        Sample sample;
+        sample.roundTrip_us = MotionLink::elapsed_us(t4, t1) - MotionLink::elapsed_us(t3, t2);
+        sample.offset_us = (MotionLink::elapsed_us(t2, t1) + MotionLink::elapsed_us(t3, t4)) / 2;
+        if (sample.roundTrip_us < 0) {
+            return; // Impossible, a stale or corrupt reply
+        }
+
+        samples[next] = sample;
+        next = (next + 1) % WINDOW;
+        if (count < WINDOW) ++count;
+
+        best = samples[0];
+        for (size_t i = 1; i < count; ++i) {
+            if (samples[i].roundTrip_us < best.roundTrip_us) best = samples[i];
+        }
+    }
+
+    bool valid() const { return count > 0; }
+    int32_t offset_us() const { return best.offset_us; }        // Platform clock minus host clock
+    int32_t roundTrip_us() const { return best.roundTrip_us; }
+
+    // Converts a platform timestamp into the host clock
+    uint32_t toHost(uint32_t platform_us) const {
+        return platform_us - static_cast<uint32_t>(best.offset_us);
+    }
+
+private:
+    struct Sample {
+        int32_t offset_us = 0;
+        int32_t roundTrip_us = 0;
+    };
+
+    Sample samples[WINDOW];
+    size_t next = 0;
+    size_t count = 0;
+    Sample best;
+};
+
+// --- Fixed-bin latency histogram ---
+// Linear bins plus an overflow bin, so adding a sample is one divide and an increment and the
+// memory use is fixed up front. Percentiles are read off the bins (resolution = binWidth_us);
+// min, max and mean are exact.
+class LatencyHistogram {
+public:
+    LatencyHistogram(const char* name, uint32_t binWidth_us, size_t binCount)
+        : name(name), binWidth(binWidth_us), bins(binCount + 1, 0) {}
+
+    void add(int32_t latency_us) {
+        if (latency_us < 0) {
+            ++negative;     // Clock offset error bigger than the stage itself
+            latency_us = 0;
+        }
+        size_t bin = static_cast<size_t>(latency_us) / binWidth;
+        if (bin >= bins.size() - 1) bin = bins.size() - 1;
+        ++bins[bin];
+
+        if (samples == 0 || latency_us < min) min = latency_us;
+        if (samples == 0 || latency_us > max) max = latency_us;
+        sum += latency_us;
+        ++samples;
+    }
+
+    uint64_t count() const { return samples; }
+    double mean() const { return samples ? static_cast<double>(sum) / samples : 0.0; }
+
+    // Upper edge of the bin holding the p-th fraction of samples (p in [0, 1]), capped at max
+    uint32_t percentile(double p) const {
+        if (samples == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(p * (samples - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bins.size(); ++i) {
+            seen += bins[i];
+            if (seen >= target) {
+                uint64_t edge = (i + 1) * static_cast<uint64_t>(binWidth);
+                return edge < static_cast<uint64_t>(max) ? static_cast<uint32_t>(edge) : static_cast<uint32_t>(max);
+            }
+        }
+        return static_cast<uint32_t>(max);
+    }
+
+    void printSummary() const {
+        printf("%-16s %8llu %9.0f %9lu %9lu %9lu %9lu %6llu\n", name,
+               (unsigned long long)samples, mean(), (unsigned long)(samples ? min : 0),
+               (unsigned long)percentile(0.5), (unsigned long)percentile(0.99),
+               (unsigned long)(samples ? max : 0), (unsigned long long)negative);
+    }
+
+    static void printSummaryHeader() {
+        printf("%-16s %8s %9s %9s %9s %9s %9s %6s\n",
+               "Stage (us)", "Count", "Mean", "Min", "p50", "p99", "Max", "Neg");
+    }
+
+    const char* label() const { return name; }
+    uint32_t binWidth_us() const { return binWidth; }
+    const std::vector<uint64_t>& binCounts() const { return bins; }
+
+private:
+    const char* name;
+    uint32_t binWidth;
+    std::vector<uint64_t> bins;     // Last bin collects everything past the range
+    uint64_t samples = 0;
+    uint64_t negative = 0;
+    int64_t sum = 0;
+    int32_t min = 0;
+    int32_t max = 0;
+};
+
+#endif // LATENCY_STATS_HPP
@@ -0,0 +1,149 @@
+#ifndef CONFIG_PROTOCOL_HPP
+#define CONFIG_PROTOCOL_HPP
+
+// --- Runtime Configuration Protocol ---
+// Get/set of controller parameters over the serial link, so tuning doesn't need a reflash.
+// Every request gets exactly one reply carrying the same request id, so the host can match them
+// up and retry on timeout.
+//
+// Request payload (host -> platform, MSG_CONFIG_GET or MSG_CONFIG_SET):
+//   uint16  request id
+//   uint8   ParamId
+//   uint8   index            (actuator 0-5, pose axis 0-5, or INDEX_ALL on set)
+//   float   value            (IEEE-754, little-endian; ignored for get)
+//
+// Reply payload (platform -> host, MSG_CONFIG_REPLY): the same layout plus
+//   uint8   ConfigStatus
+// with value holding the parameter's value after the request (for INDEX_ALL, index 0's).
+//
+// The platform only stages a set; the control loop picks staged values up at the start of its
+// next cycle, so a change never lands half way through an IK/PWM update.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "MotionLink.hpp"
+#include "MotionSchema.hpp"
+
+namespace MotionLink {
+
+enum ParamId : uint8_t {
+    PARAM_TOLERANCE_MM      = 0x01,   // Per actuator, position error deadband
+    PARAM_DUTY_CYCLE        = 0x02,   // Per actuator, 0-1
+    PARAM_ACTUATOR_SPEED    = 0x03,   // Per actuator, mm/s used by the position estimate
+    PARAM_POSE              = 0x10,   // Pose setpoint, index = POSE_* axis below
+    PARAM_TELEMETRY_DECIMATION = 0x20, // Index 0, record every Nth cycle (1-255)
+
+    // Pose prediction (PosePredictor.hpp), index = POSE_* axis unless noted
+    PARAM_PREDICT_MODE      = 0x30,   // PredictMode: 0 hold, 1 velocity, 2 acceleration, 3 Kalman
+    PARAM_PREDICT_NOISE     = 0x31,   // Kalman process noise (mm^2/s^3 or deg^2/s^3)
+    PARAM_PREDICT_LEAD_MS   = 0x32,   // Index 0, latency added to the measured one (link before the
+                                      // first byte lands, actuator response)
+    PARAM_PREDICT_ERROR     = 0x33,   // Read-only, RMS error of the predicted pose since the axis was set up
+    PARAM_PREDICT_HOLD_ERROR = 0x34   // Read-only, RMS error the same cycles would have had without prediction
+};
+
+// PARAM_POSE indices (same order and units as the IK loop)
+enum PoseAxis : uint8_t {
+    POSE_X_MM = 0, POSE_Y_MM, POSE_Z_MM, POSE_ROLL_DEG, POSE_PITCH_DEG, POSE_YAW_DEG,
+    POSE_AXES
+};
+
+enum ConfigStatus : uint8_t {
+    CONFIG_OK            = 0,
+    CONFIG_UNKNOWN_PARAM = 1,
+    CONFIG_BAD_INDEX     = 2,
+    CONFIG_OUT_OF_RANGE  = 3,
+    CONFIG_READ_ONLY     = 4
+};
+
+constexpr uint8_t INDEX_ALL = 0xFF;
+constexpr size_t CONFIG_REQUEST_SIZE = 8;
+constexpr size_t CONFIG_REPLY_SIZE = 9;
+
+struct ConfigRequest {
+    uint16_t id = 0;
+    uint8_t param = 0;
+    uint8_t index = 0;
+    float value = 0.0f;
+};
+
+struct ConfigReply {
+    uint16_t id = 0;
+    uint8_t param = 0;
+    uint8_t index = 0;
+    float value = 0.0f;
+    uint8_t status = CONFIG_OK;
+};
+
+inline const char* configStatusName(uint8_t status) {
+    switch (status) {
+        case CONFIG_OK:            return "OK";
+        case CONFIG_UNKNOWN_PARAM: return "unknown parameter";
+        case CONFIG_BAD_INDEX:     return "bad index";
+        case CONFIG_OUT_OF_RANGE:  return "out of range";
+        case CONFIG_READ_ONLY:     return "read-only";
+        default:                   return "?";
+    }
+}
+
+// --- float <-> little-endian bits ---
+inline uint8_t* putFloatLE(uint8_t* out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return MotionSchema::putLE(out, bits);
+}
+
+inline const uint8_t* getFloatLE(const uint8_t* in, float& value) {
+    uint32_t bits;
+    in = MotionSchema::getLE(in, bits);
+    memcpy(&value, &bits, sizeof(value));
+    return in;
+}
+
+// --- Build (straight into a wire frame) ---
+
+// type is MSG_CONFIG_GET or MSG_CONFIG_SET
+inline size_t buildConfigRequest(uint8_t type, const ConfigRequest& msg, uint8_t* out) {
+    uint8_t* p = out + HEADER_SIZE;
+    p = MotionSchema::putLE(p, msg.id);
+    p = MotionSchema::putLE(p, msg.param);
+    p = MotionSchema::putLE(p, msg.index);
+    p = putFloatLE(p, msg.value);
+    return buildFrame(type, out + HEADER_SIZE, CONFIG_REQUEST_SIZE, out);
+}
+
+inline size_t buildConfigReply(const ConfigReply& msg, uint8_t* out) {
+    uint8_t* p = out + HEADER_SIZE;
+    p = MotionSchema::putLE(p, msg.id);
+    p = MotionSchema::putLE(p, msg.param);
+    p = MotionSchema::putLE(p, msg.index);
+    p = putFloatLE(p, msg.value);
+    p = MotionSchema::putLE(p, msg.status);
+    return buildFrame(MSG_CONFIG_REPLY, out + HEADER_SIZE, CONFIG_REPLY_SIZE, out);
+}
+
+// --- Decode (false if the length is wrong) ---
+
+inline bool decodeConfigRequest(const uint8_t* in, size_t length, ConfigRequest& msg) {
+    if (length != CONFIG_REQUEST_SIZE) return false;
+    in = MotionSchema::getLE(in, msg.id);
+    in = MotionSchema::getLE(in, msg.param);
+    in = MotionSchema::getLE(in, msg.index);
+    in = getFloatLE(in, msg.value);
+    return true;
+}
+
+inline bool decodeConfigReply(const uint8_t* in, size_t length, ConfigReply& msg) {
+    if (length != CONFIG_REPLY_SIZE) return false;
+    in = MotionSchema::getLE(in, msg.id);
+    in = MotionSchema::getLE(in, msg.param);
+    in = MotionSchema::getLE(in, msg.index);
+    in = getFloatLE(in, msg.value);
+    in = MotionSchema::getLE(in, msg.status);
+    return true;
+}
+
+} // namespace MotionLink
+
+#endif // CONFIG_PROTOCOL_HPP
@@ -0,0 +1,127 @@
+#ifndef LATENCY_TRACE_HPP
+#define LATENCY_TRACE_HPP
+
+// --- Latency Tracing Messages ---
+// Lets the host measure how old a pose is at each stage of the platform's pipeline:
+//
+//   host send --link--> arrival --rx--> parsed --wait for cycle--> pickup --IK--> IK done --actuators--> PWM commit
+//
+// Every motion frame carries the host send time (MotionFrame::hostTime_us). The platform stamps
+// the other five points with its own microsecond clock and sends them back in a LatencyTrace.
+// Stages inside the platform can be compared directly; the link stage and the end-to-end total
+// cross the two clocks, so the host also runs an NTP-style exchange to work out the offset:
+//
+//   host    t1 ---- TimeSyncRequest ---->  t2 platform
+//   host    t4 <---- TimeSyncReply -------  t3 platform
+//
+//   offset     = ((t2 - t1) + (t3 - t4)) / 2     (platform clock minus host clock)
+//   round trip = (t4 - t1) - (t3 - t2)
+//
+// All times are uint32 microseconds that wrap every ~71 minutes; only differences are used, and
+// differences are taken in uint32 and then read as int32, so the wrap never matters.
+// Shared between the firmware and the host bridge, so no mbed.h / OS headers in here.
+
+#include <cstdint>
+#include <cstddef>
+#include "MotionLink.hpp"
+#include "MotionSchema.hpp"
+
+namespace MotionLink {
+
+// Host -> platform. t1 is the host clock when the request was sent.
+struct TimeSyncRequest {
+    uint16_t id = 0;
+    uint32_t t1_us = 0;
+};
+
+// Platform -> host. Echoes the request and adds the platform's receive (t2) and send (t3) times.
+struct TimeSyncReply {
+    uint16_t id = 0;
+    uint32_t t1_us = 0;
+    uint32_t t2_us = 0;
+    uint32_t t3_us = 0;
+};
+
+// Platform -> host. hostTime_us is in the host clock, everything else in the platform clock.
+struct LatencyTrace {
+    uint16_t sequence = 0;
+    uint32_t hostTime_us = 0;   // Echo of MotionFrame::hostTime_us
+    uint32_t arrival_us = 0;    // First byte of the frame landed in the serial RX buffer
+    uint32_t parsed_us = 0;     // Frame decoded by the link thread
+    uint32_t pickup_us = 0;     // Control loop took the pose at the start of a cycle
+    uint32_t ikDone_us = 0;     // Actuator strokes computed
+    uint32_t pwmCommit_us = 0;  // Actuator commands written to the PWM outputs
+};
+
+constexpr size_t TIME_SYNC_REQUEST_SIZE = 6;
+constexpr size_t TIME_SYNC_REPLY_SIZE = 14;
+constexpr size_t LATENCY_TRACE_SIZE = 26;
+
+// Signed difference a - b of two wrapping microsecond timestamps
+inline int32_t elapsed_us(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b);
+}
+
+// --- Build (straight into a wire frame, out must hold frameSize(payload) bytes) ---
+
+inline size_t buildTimeSyncRequest(const TimeSyncRequest& msg, uint8_t* out) {
+    uint8_t* p = out + HEADER_SIZE;
+    p = MotionSchema::putLE(p, msg.id);
+    p = MotionSchema::putLE(p, msg.t1_us);
+    return buildFrame(MSG_TIME_SYNC_REQUEST, out + HEADER_SIZE, TIME_SYNC_REQUEST_SIZE, out);
+}
+
+inline size_t buildTimeSyncReply(const TimeSyncReply& msg, uint8_t* out) {
+    uint8_t* p = out + HEADER_SIZE;
+    p = MotionSchema::putLE(p, msg.id);
+    p = MotionSchema::putLE(p, msg.t1_us);
+    p = MotionSchema::putLE(p, msg.t2_us);
+    p = MotionSchema::putLE(p, msg.t3_us);
+    return buildFrame(MSG_TIME_SYNC_REPLY, out + HEADER_SIZE, TIME_SYNC_REPLY_SIZE, out);
+}
+
+inline size_t buildLatencyTrace(const LatencyTrace& msg, uint8_t* out) {
+    uint8_t* p = out + HEADER_SIZE;
+    p = MotionSchema::putLE(p, msg.sequence);
+    p = MotionSchema::putLE(p, msg.hostTime_us);
+    p = MotionSchema::putLE(p, msg.arrival_us);
+    p = MotionSchema::putLE(p, msg.parsed_us);
+    p = MotionSchema::putLE(p, msg.pickup_us);
+    p = MotionSchema::putLE(p, msg.ikDone_us);
+    p = MotionSchema::putLE(p, msg.pwmCommit_us);
+    return buildFrame(MSG_LATENCY_TRACE, out + HEADER_SIZE, LATENCY_TRACE_SIZE, out);
+}
+
+// --- Decode (from a parsed payload, false if the length is wrong) ---
+
+inline bool decodeTimeSyncRequest(const uint8_t* in, size_t length, TimeSyncRequest& msg) {
+    if (length != TIME_SYNC_REQUEST_SIZE) return false;
+    in = MotionSchema::getLE(in, msg.id);
+    in = MotionSchema::getLE(in, msg.t1_us);
+    return true;
+}
+
+inline bool decodeTimeSyncReply(const uint8_t* in, size_t length, TimeSyncReply& msg) {
+    if (length != TIME_SYNC_REPLY_SIZE) return false;
+    in = MotionSchema::getLE(in, msg.id);
+    in = MotionSchema::getLE(in, msg.t1_us);
+    in = MotionSchema::getLE(in, msg.t2_us);
+    in = MotionSchema::getLE(in, msg.t3_us);
+    return true;
+}
+
+inline bool decodeLatencyTrace(const uint8_t* in, size_t length, LatencyTrace& msg) {
+    if (length != LATENCY_TRACE_SIZE) return false;
+    in = MotionSchema::getLE(in, msg.sequence);
+    in = MotionSchema::getLE(in, msg.hostTime_us);
+    in = MotionSchema::getLE(in, msg.arrival_us);
+    in = MotionSchema::getLE(in, msg.parsed_us);
+    in = MotionSchema::getLE(in, msg.pickup_us);
+    in = MotionSchema::getLE(in, msg.ikDone_us);
+    in = MotionSchema::getLE(in, msg.pwmCommit_us);
+    return true;
+}
+
+} // namespace MotionLink
+
+#endif // LATENCY_TRACE_HPP
@@ -0,0 +1,222 @@
+#ifndef MOTION_LINK_HPP
+#define MOTION_LINK_HPP
+
+// --- Motion Link Framing ---
+// Binary framing for the host <-> platform serial link. Shared between the mbed firmware and
+// the host bridge, so no mbed.h / OS headers in here.
+//
+// Frame layout:
+//   [0]     0xA5        sync byte 0
+//   [1]     0x5A        sync byte 1
+//   [2]     version     MotionSchema::SCHEMA_VERSION of the sender
+//   [3]     type        MsgType below
+//   [4]     length      payload length in bytes (0-255)
+//   [5..]   payload
+//   [+0,+1] CRC-16/CCITT-FALSE over bytes [2 .. end of payload], little-endian
+//
+// The parser resynchronises on the sync bytes after any error, so a dropped or corrupted byte
+// costs at most the frame it landed in.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "MotionSchema.hpp"
+
+namespace MotionLink {
+
+constexpr uint8_t SYNC0 = 0xA5;
+constexpr uint8_t SYNC1 = 0x5A;
+constexpr size_t HEADER_SIZE = 5;
+constexpr size_t CRC_SIZE = 2;
+constexpr size_t FRAME_OVERHEAD = HEADER_SIZE + CRC_SIZE;
+constexpr size_t MAX_PAYLOAD = 255;
+constexpr size_t MAX_FRAME_SIZE = MAX_PAYLOAD + FRAME_OVERHEAD;
+
+// --- Message types ---
+enum MsgType : uint8_t {
+    // Host -> platform motion cue, one per quantization level
+    MSG_MOTION_COARSE   = 0x10,
+    MSG_MOTION_STANDARD = 0x11,
+    MSG_MOTION_FINE     = 0x12,
+
+    // Host -> platform actuator strokes from host-side IK, see StrokeCommand.hpp
+    MSG_STROKE_COMMAND  = 0x18,
+
+    // Clock alignment for latency tracing, see LatencyTrace.hpp
+    MSG_TIME_SYNC_REQUEST = 0x20,   // Host -> platform
+    MSG_TIME_SYNC_REPLY   = 0x21,   // Platform -> host
+
+    // Platform -> host pipeline timestamps of one motion frame
+    MSG_LATENCY_TRACE     = 0x30,
+
+    // Platform -> host batched actuator state and loop timing, see Telemetry.hpp
+    MSG_TELEMETRY         = 0x31,
+
+    // Runtime parameter get/set, see ConfigProtocol.hpp
+    MSG_CONFIG_GET        = 0x40,   // Host -> platform
+    MSG_CONFIG_SET        = 0x41,   // Host -> platform
+    MSG_CONFIG_REPLY      = 0x42    // Platform -> host
+};
+
+// Message type carrying a motion frame at the given quantization level
+template <MotionSchema::QuantLevel L>
+constexpr uint8_t motionMsgType() {
+    return static_cast<uint8_t>(MSG_MOTION_COARSE + static_cast<uint8_t>(L));
+}
+
+// Size of a full frame on the wire for a given payload length
+constexpr size_t frameSize(size_t payloadLength) {
+    return payloadLength + FRAME_OVERHEAD;
+}
+
+// --- CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) ---
+// Nibble table: 32 bytes of flash and two lookups per byte, a good fit for the MCU.
+inline uint16_t crc16Update(uint16_t crc, uint8_t byte) {
+    static const uint16_t NIBBLE_TABLE[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    crc = static_cast<uint16_t>((crc << 4) ^ NIBBLE_TABLE[((crc >> 12) ^ (byte >> 4)) & 0x0F]);
+    crc = static_cast<uint16_t>((crc << 4) ^ NIBBLE_TABLE[((crc >> 12) ^ (byte & 0x0F)) & 0x0F]);
+    return crc;
+}
+
+inline uint16_t crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF) {
+    for (size_t i = 0; i < length; ++i) {
+        crc = crc16Update(crc, data[i]);
+    }
+    return crc;
+}
+
+// --- Frame building ---
+
+// Writes a complete frame to out (which must hold frameSize(length) bytes).
+// Returns the number of bytes written.
+inline size_t buildFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint8_t* out) {
+    out[0] = SYNC0;
+    out[1] = SYNC1;
+    out[2] = MotionSchema::SCHEMA_VERSION;
+    out[3] = type;
+    out[4] = length;
+    if (length > 0 && out + HEADER_SIZE != payload) {
+        memcpy(out + HEADER_SIZE, payload, length);
+    }
+    uint16_t crc = crc16(out + 2, HEADER_SIZE - 2 + length);
+    out[HEADER_SIZE + length]     = static_cast<uint8_t>(crc & 0xFF);
+    out[HEADER_SIZE + length + 1] = static_cast<uint8_t>(crc >> 8);
+    return frameSize(length);
+}
+
+// Encodes a motion frame at level L straight into a wire frame (no intermediate copy).
+template <MotionSchema::QuantLevel L>
+size_t buildMotionFrame(const MotionSchema::MotionFrame& frame, uint8_t* out) {
+    size_t length = MotionSchema::encodeMotion<L>(frame, out + HEADER_SIZE);
+    return buildFrame(motionMsgType<L>(), out + HEADER_SIZE, static_cast<uint8_t>(length), out);
+}
+
+// --- Frame parser ---
+// Byte-at-a-time state machine. Holds at most one frame, so it needs no dynamic allocation and
+// can be fed straight from a serial RX buffer of any size.
+class FrameParser {
+public:
+    // Feeds one byte. Returns true when a complete, CRC-valid frame with the current schema
+    // version is available through type()/payload()/length(). The frame stays valid until the
+    // next call to feed().
+    bool feed(uint8_t byte) {
+        switch (state) {
+            case State::SYNC0:
+                if (byte == SYNC0) state = State::SYNC1;
+                break;
+
+            case State::SYNC1:
+                if (byte == SYNC1) {
+                    state = State::HEADER;
+                    index = 0;
+                } else if (byte != SYNC0) {
+                    state = State::SYNC0;
+                }
+                break;
+
+            case State::HEADER:
+                buffer[index++] = byte;     // version, type, length
+                if (index == HEADER_SIZE - 2) {
+                    payloadLength = buffer[2];
+                    state = payloadLength > 0 ? State::PAYLOAD : State::CRC;
+                }
+                break;
+
+            case State::PAYLOAD:
+                buffer[index++] = byte;
+                if (index == HEADER_SIZE - 2 + payloadLength) {
+                    state = State::CRC;
+                }
+                break;
+
+            case State::CRC:
+                buffer[index++] = byte;
+                if (index == HEADER_SIZE - 2 + payloadLength + CRC_SIZE) {
+                    state = State::SYNC0;
+                    return finishFrame();
+                }
+                break;
+        }
+        return false;
+    }
+
+    // True between frames, i.e. the next byte could be the start of a new frame
+    bool idle() const { return state == State::SYNC0; }
+
+    uint8_t version() const { return buffer[0]; }
+    uint8_t type() const { return buffer[1]; }
+    uint8_t length() const { return payloadLength; }
+    const uint8_t* payload() const { return buffer + HEADER_SIZE - 2; }
+
+    // --- Link statistics ---
+    uint32_t framesOk = 0;
+    uint32_t crcErrors = 0;
+    uint32_t versionErrors = 0;
+
+private:
+    enum class State : uint8_t { SYNC0, SYNC1, HEADER, PAYLOAD, CRC };
+
+    bool finishFrame() {
+        size_t crcOffset = HEADER_SIZE - 2 + payloadLength;
+        uint16_t received = static_cast<uint16_t>(buffer[crcOffset] | (buffer[crcOffset + 1] << 8));
+        if (crc16(buffer, crcOffset) != received) {
+            ++crcErrors;
+            return false;
+        }
+        if (buffer[0] != MotionSchema::SCHEMA_VERSION) {
+            ++versionErrors;
+            return false;
+        }
+        ++framesOk;
+        return true;
+    }
+
+    State state = State::SYNC0;
+    size_t index = 0;
+    uint8_t payloadLength = 0;
+    // version + type + length + payload + crc (sync bytes aren't stored)
+    uint8_t buffer[HEADER_SIZE - 2 + MAX_PAYLOAD + CRC_SIZE];
+};
+
+// Decodes a motion frame of any quantization level from a parsed frame.
+// Returns false if the frame isn't a motion frame or has the wrong length.
+inline bool decodeMotionFrame(const FrameParser& parser, MotionSchema::MotionFrame& frame) {
+    using MotionSchema::QuantLevel;
+    switch (parser.type()) {
+        case MSG_MOTION_COARSE:
+            return MotionSchema::decodeMotion<QuantLevel::COARSE>(parser.payload(), parser.length(), frame);
+        case MSG_MOTION_STANDARD:
+            return MotionSchema::decodeMotion<QuantLevel::STANDARD>(parser.payload(), parser.length(), frame);
+        case MSG_MOTION_FINE:
+            return MotionSchema::decodeMotion<QuantLevel::FINE>(parser.payload(), parser.length(), frame);
+        default:
+            return false;
+    }
+}
+
+} // namespace MotionLink
+
+#endif // MOTION_LINK_HPP
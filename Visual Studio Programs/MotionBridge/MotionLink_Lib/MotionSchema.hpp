@@ -0,0 +1,282 @@
+#ifndef MOTION_SCHEMA_HPP
+#define MOTION_SCHEMA_HPP
+
+// --- Motion-Cue Telemetry Schema ---
+// Defines the values carried from the host (sim) to the platform controller, and how they are
+// quantized onto the wire. This header is shared between the mbed firmware and the host bridge,
+// so it must not depend on mbed.h or any OS headers.
+//
+// Every field has a fixed physical range. The fixed-point scale of each field is worked out at
+// compile time from that range and the storage type picked by the quantization level, and it is
+// always a power of two. That way encoding is one multiply + round + clamp and decoding is one
+// multiply (no divides, no pow(), no lookups).
+//
+// Wire payload layout (little-endian), see MotionLink.hpp for the frame around it:
+//   uint16  sequence
+//   uint32  host send time                  (us, host clock, for latency tracing)
+//   S x 3   roll, pitch, yaw                (deg)
+//   S x 3   translation X, Y, Z             (mm)
+//   S x 3   roll, pitch, yaw rate           (deg/s)
+//   S x 3   specific force X, Y, Z          (m/s^2)
+// where S is int8/int16/int32 depending on the quantization level.
+//
+// --- Bandwidth per message ---
+// Frame = 5 header bytes + payload + 2 CRC bytes. 8N1 serial costs 10 bits per byte.
+//
+//   Level     | Field | Payload | Frame | Resolution (att / trans / rate / force)     | 9600 | 115200 | 921600 (msg/s)
+//   ----------+-------+---------+-------+---------------------------------------------+------+--------+---------------
+//   COARSE    | int8  |   18 B  |  25 B | 2 deg    / 4 mm       / 4 deg/s    / 1      |   38 |    460 |   3686
+//   STANDARD  | int16 |   30 B  |  37 B | 1/128 deg/ 1/64 mm    / 1/64 deg/s / 1/256  |   25 |    311 |   2490
+//   FINE      | int32 |   54 B  |  61 B | 2^-23 deg/ 2^-22 mm   / 2^-22 deg/s/ 2^-24  |   15 |    188 |   1510
+//
+// For comparison, the old text line "Pitch:%lf,Roll:%lf,Yaw:%lf\n" is ~40 bytes for 3 of these 12 fields.
+// The sim produces frames at 30-60 Hz and the IK loop runs at 50 Hz, so at 9600 baud only COARSE
+// keeps up, while STANDARD leaves plenty of room at 115200 and up (the link default). COARSE is the "scale down to one byte" idea from the
+// COM testing project (maximum_range / scaling_factor), done per field instead of with one global range.
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <type_traits>
+
+namespace MotionSchema {
+
+// Bump this whenever the payload layout changes. The receiver drops frames with another version.
+// v2: added the host send time after the sequence number.
+// v3: latency traces gained the control-loop pickup time.
+// v4: stroke commands (host-side IK); older firmware would silently ignore them.
+constexpr uint8_t SCHEMA_VERSION = 4;
+
+// --- Physical ranges of each field group (+/- value, in the field's units) ---
+constexpr int32_t ATTITUDE_RANGE_DEG     = 180;  // Full circle for yaw; roll/pitch use the same scale
+constexpr int32_t TRANSLATION_RANGE_MM   = 256;  // Reach in any one axis is far below the 300 mm leg stroke
+constexpr int32_t RATE_RANGE_DEG_PER_S   = 500;  // Aerobatic roll rates still fit
+constexpr int32_t FORCE_RANGE_MPS2       = 64;   // ~6.5 g
+
+// --- Quantization levels ---
+enum class QuantLevel : uint8_t {
+    COARSE   = 0,   // 1 byte per field
+    STANDARD = 1,   // 2 bytes per field
+    FINE     = 2    // 4 bytes per field
+};
+
+constexpr int FIELD_COUNT = 12;
+
+// Storage type used for every field at a given level
+template <QuantLevel L> struct LevelStorage;
+template <> struct LevelStorage<QuantLevel::COARSE>   { using type = int8_t;  };
+template <> struct LevelStorage<QuantLevel::STANDARD> { using type = int16_t; };
+template <> struct LevelStorage<QuantLevel::FINE>     { using type = int32_t; };
+
+// --- Compile-time helpers ---
+
+// Largest positive value a signed storage type can hold
+template <typename StorageT>
+constexpr int64_t storageMax() {
+    return (int64_t(1) << (8 * sizeof(StorageT) - 1)) - 1;
+}
+
+// Largest float that is not above storageMax<StorageT>(). Same thing for int8/int16, but a float
+// only has 24 significant bits, so float(INT32_MAX) rounds up to 2^31, which no longer fits.
+template <typename StorageT>
+constexpr float storageMaxFloat() {
+    return 8 * sizeof(StorageT) - 1 <= 24
+        ? float(storageMax<StorageT>())
+        : float((int64_t(1) << (8 * sizeof(StorageT) - 1)) - (int64_t(1) << (8 * sizeof(StorageT) - 1 - 24)));
+}
+
+// 2^exp as a float, for positive or negative exp (constexpr replacement for ldexpf)
+constexpr float pow2(int exp) {
+    return exp >= 0 ? float(int64_t(1) << exp) : 1.0f / float(int64_t(1) << -exp);
+}
+
+// True if +/-range still fits in StorageT with the given number of fractional bits
+template <typename StorageT>
+constexpr bool rangeFits(int32_t range, int bits) {
+    return bits >= 0 ? (int64_t(range) << bits) <= storageMax<StorageT>()
+                     : int64_t(range) <= (storageMax<StorageT>() << -bits);
+}
+
+// Number of fractional bits so that +/-range fits in StorageT. Negative means the LSB is
+// worth more than one unit (e.g. 2 deg per count in an int8).
+template <typename StorageT>
+constexpr int fracBitsFor(int32_t range) {
+    int bits = 8 * int(sizeof(StorageT)) - 1;   // start from the full width and back off
+    while (bits > -16 && !rangeFits<StorageT>(range, bits)) {
+        --bits;
+    }
+    return bits;
+}
+
+// --- Fixed-point field ---
+// One field of the schema. FRAC_BITS, SCALE and INV_SCALE are all compile-time constants, so
+// encode() and decode() inline down to a multiply (plus a round and clamp on encode).
+template <typename StorageT, int32_t RANGE>
+struct FixedField {
+    using Storage = StorageT;
+    static constexpr int   FRAC_BITS = fracBitsFor<StorageT>(RANGE);
+    static constexpr float SCALE     = pow2(FRAC_BITS);    // counts per unit
+    static constexpr float INV_SCALE = pow2(-FRAC_BITS);   // units per count
+    static constexpr float MAX_VALUE = storageMaxFloat<StorageT>() * INV_SCALE;   // exact: SCALE is a power of two
+
+    static StorageT encode(float value) {
+        // Clamp in float space first so the cast below can never overflow. NaN fails every
+        // comparison, so it is sent as 0 rather than whatever lrintf() makes of it.
+        if (value != value)     value = 0.0f;
+        if (value > MAX_VALUE)  value = MAX_VALUE;
+        if (value < -MAX_VALUE) value = -MAX_VALUE;
+        return static_cast<StorageT>(lrintf(value * SCALE));
+    }
+
+    static float decode(StorageT counts) {
+        return static_cast<float>(counts) * INV_SCALE;
+    }
+};
+
+// Field types for each group at a given level
+template <QuantLevel L>
+struct Fields {
+    using S = typename LevelStorage<L>::type;
+    using Attitude    = FixedField<S, ATTITUDE_RANGE_DEG>;
+    using Translation = FixedField<S, TRANSLATION_RANGE_MM>;
+    using Rate        = FixedField<S, RATE_RANGE_DEG_PER_S>;
+    using Force       = FixedField<S, FORCE_RANGE_MPS2>;
+};
+
+// Payload size in bytes at a given level
+template <QuantLevel L>
+constexpr size_t payloadSize() {
+    return sizeof(uint16_t) + sizeof(uint32_t) + FIELD_COUNT * sizeof(typename LevelStorage<L>::type);
+}
+
+// --- Decoded frame ---
+// Units match the IK loop in Platform IK (degrees and mm) so values can be copied straight in.
+struct MotionFrame {
+    uint16_t sequence = 0;
+
+    // Host clock (us) when the frame was built. Echoed back in latency traces so the host can
+    // tell how old the pose is at each stage; it wraps every ~71 minutes, only differences matter.
+    uint32_t hostTime_us = 0;
+
+    // Attitude (deg)
+    float roll_deg  = 0.0f;
+    float pitch_deg = 0.0f;
+    float yaw_deg   = 0.0f;
+
+    // Translation (mm)
+    float translationX_mm = 0.0f;
+    float translationY_mm = 0.0f;
+    float translationZ_mm = 0.0f;
+
+    // Angular rates (deg/s)
+    float rollRate_dps  = 0.0f;
+    float pitchRate_dps = 0.0f;
+    float yawRate_dps   = 0.0f;
+
+    // Specific forces (m/s^2), aircraft body axes
+    float specificForceX_mps2 = 0.0f;
+    float specificForceY_mps2 = 0.0f;
+    float specificForceZ_mps2 = 0.0f;
+};
+
+// --- Little-endian byte helpers ---
+template <typename T>
+inline uint8_t* putLE(uint8_t* out, T value) {
+    using U = typename std::make_unsigned<T>::type;
+    U raw = static_cast<U>(value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<uint8_t>(raw >> (8 * i));
+    }
+    return out + sizeof(T);
+}
+
+template <typename T>
+inline const uint8_t* getLE(const uint8_t* in, T& value) {
+    using U = typename std::make_unsigned<T>::type;
+    U raw = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        raw |= static_cast<U>(static_cast<U>(in[i]) << (8 * i));
+    }
+    value = static_cast<T>(raw);
+    return in + sizeof(T);
+}
+
+// --- Encode / Decode ---
+
+// Writes payloadSize<L>() bytes to out. Returns the number of bytes written.
+template <QuantLevel L>
+size_t encodeMotion(const MotionFrame& frame, uint8_t* out) {
+    using F = Fields<L>;
+    uint8_t* p = out;
+    p = putLE(p, frame.sequence);
+    p = putLE(p, frame.hostTime_us);
+
+    p = putLE(p, F::Attitude::encode(frame.roll_deg));
+    p = putLE(p, F::Attitude::encode(frame.pitch_deg));
+    p = putLE(p, F::Attitude::encode(frame.yaw_deg));
+
+    p = putLE(p, F::Translation::encode(frame.translationX_mm));
+    p = putLE(p, F::Translation::encode(frame.translationY_mm));
+    p = putLE(p, F::Translation::encode(frame.translationZ_mm));
+
+    p = putLE(p, F::Rate::encode(frame.rollRate_dps));
+    p = putLE(p, F::Rate::encode(frame.pitchRate_dps));
+    p = putLE(p, F::Rate::encode(frame.yawRate_dps));
+
+    p = putLE(p, F::Force::encode(frame.specificForceX_mps2));
+    p = putLE(p, F::Force::encode(frame.specificForceY_mps2));
+    p = putLE(p, F::Force::encode(frame.specificForceZ_mps2));
+
+    return static_cast<size_t>(p - out);
+}
+
+// Reads a payload of the given level. Returns false if the length doesn't match.
+template <QuantLevel L>
+bool decodeMotion(const uint8_t* in, size_t length, MotionFrame& frame) {
+    using F = Fields<L>;
+    using S = typename LevelStorage<L>::type;
+    if (length != payloadSize<L>()) {
+        return false;
+    }
+
+    const uint8_t* p = in;
+    p = getLE(p, frame.sequence);
+    p = getLE(p, frame.hostTime_us);
+
+    S raw[FIELD_COUNT];
+    for (int i = 0; i < FIELD_COUNT; ++i) {
+        p = getLE(p, raw[i]);
+    }
+
+    frame.roll_deg  = F::Attitude::decode(raw[0]);
+    frame.pitch_deg = F::Attitude::decode(raw[1]);
+    frame.yaw_deg   = F::Attitude::decode(raw[2]);
+
+    frame.translationX_mm = F::Translation::decode(raw[3]);
+    frame.translationY_mm = F::Translation::decode(raw[4]);
+    frame.translationZ_mm = F::Translation::decode(raw[5]);
+
+    frame.rollRate_dps  = F::Rate::decode(raw[6]);
+    frame.pitchRate_dps = F::Rate::decode(raw[7]);
+    frame.yawRate_dps   = F::Rate::decode(raw[8]);
+
+    frame.specificForceX_mps2 = F::Force::decode(raw[9]);
+    frame.specificForceY_mps2 = F::Force::decode(raw[10]);
+    frame.specificForceZ_mps2 = F::Force::decode(raw[11]);
+
+    return true;
+}
+
+// Sanity checks on the generated scales (these are the numbers in the bandwidth table above)
+static_assert(Fields<QuantLevel::COARSE>::Attitude::FRAC_BITS == -1,  "COARSE attitude should be 2 deg/count");
+static_assert(Fields<QuantLevel::STANDARD>::Attitude::FRAC_BITS == 7, "STANDARD attitude should be 1/128 deg/count");
+static_assert(Fields<QuantLevel::STANDARD>::Translation::FRAC_BITS == 6, "STANDARD translation should be 1/64 mm/count");
+static_assert(Fields<QuantLevel::FINE>::Attitude::MAX_VALUE * Fields<QuantLevel::FINE>::Attitude::SCALE < 2147483648.0f,
+              "FINE clamp must stay below 2^31 counts");
+static_assert(payloadSize<QuantLevel::COARSE>() == 18,   "COARSE payload size");
+static_assert(payloadSize<QuantLevel::STANDARD>() == 30, "STANDARD payload size");
+static_assert(payloadSize<QuantLevel::FINE>() == 54,     "FINE payload size");
+
+} // namespace MotionSchema
+
+#endif // MOTION_SCHEMA_HPP
@@ -0,0 +1,347 @@
+#ifndef POSE_TRAJECTORY_HPP
+#define POSE_TRAJECTORY_HPP
+
+// --- Online Pose Trajectory Generator ---
+// Sits between "the pose we want" and the IK. A step change in the target pose would otherwise
+// become a step in every leg's target stroke and the legs would go at full duty at once; this
+// moves a commanded pose towards the target instead, one control cycle at a time, so that no leg
+// goes faster, accelerates harder or changes acceleration quicker than its limits.
+//
+// The limits are per leg but the motion is planned in pose space, through the IK Jacobian J (mm
+// of stroke per mm / deg of pose, PlatformGeometry::legJacobian). Every pose-space vector is
+// measured by the largest leg rate it causes, |v|_leg = max|J v|, and each cycle:
+//
+//   1. distance   D, the largest stroke change still to go (IK at the pose and at the target)
+//   2. velocity   wanted: along the pose error, at the speed from which a jerk-limited stop ends
+//                 at the target, v = -A^2/2J + sqrt(A^4/4J^2 + 2 A D), capped at the limit
+//   3. accel      wanted: towards that velocity, no faster than a jerk-limited approach to it
+//                 allows, counting what the present acceleration still adds while it winds down
+//   4. limits     jerk, acceleration, speed, each by scaling the whole vector so the direction
+//                 of motion is kept
+//   5. check      the IK strokes of the new pose, differenced against the last cycles the way
+//                 the legs will see them; if a leg is over a limit, the change of acceleration is
+//                 scaled back until none is
+//
+// Steps 2-4 work to first order in J and aim for TRAJECTORY_PLAN_*_SHARE of the limits; step 5 is
+// what actually holds them (to TRAJECTORY_GUARD_MARGIN), TrajectoryCheck on the host tests it.
+//
+// J changes along the path, strongly for yaw: at home the legs barely change length for a small
+// yaw, so J's yaw column is nearly zero and a leg's length grows with the square of the angle.
+// Two things keep that honest. The pose error is measured by the larger of J e and the actual
+// stroke change D, so a move whose legs "start slow" is not given a huge pose velocity. And the
+// legs' acceleration includes the part from J changing under a constant pose velocity (the
+// change of J along the path, from a second Jacobian a leg millimetre ahead); the speed is held
+// to where that part uses no more than TRAJECTORY_DRIFT_SHARE of the acceleration limit, and the
+// pose acceleration gets what is left.
+//
+// There is no stored plan: every cycle starts from the current pose, velocity and acceleration,
+// so a new target arriving mid-motion is simply the next cycle's error and the pose curves
+// towards it without a jump in velocity or acceleration. The cost per cycle is two 6x6 Jacobians,
+// two or three IKs and a few 6x6 products, plus GUARD_BISECTIONS + 2 IKs when step 5 steps in.
+//
+// Pose order X, Y, Z (mm), roll, pitch, yaw (deg), as MotionLink::POSE_*. No allocation, no OS
+// headers.
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include "ConfigProtocol.hpp"
+#include "LegKinematics.hpp"
+
+namespace MotionLink {
+
+constexpr float TRAJECTORY_SETTLE_MM = 0.005f;      // Snap to the target inside this (leg mm)
+constexpr float TRAJECTORY_DRIFT_SHARE = 0.3f;      // Of the acceleration limit, for J changing
+// Shares of the limits the plan aims for; the rest is headroom for what the Jacobian misses, so
+// the stroke check (step 5) seldom has to step in
+constexpr float TRAJECTORY_PLAN_SPEED_SHARE = 0.95f;
+constexpr float TRAJECTORY_PLAN_ACCEL_SHARE = 0.9f;
+constexpr float TRAJECTORY_PLAN_JERK_SHARE = 0.8f;
+constexpr float TRAJECTORY_GUARD_MARGIN = 0.98f;    // Stroke check holds this share, for float rounding in the IK
+
+struct TrajectoryLimits {
+    float speed_mm_s = 30.0f;       // Per leg
+    float accel_mm_s2 = 100.0f;
+    float jerk_mm_s3 = 1000.0f;
+};
+
+class PoseTrajectory {
+public:
+    void configure(const TrajectoryLimits& newLimits, float dt) {
+        limits = newLimits;
+        step_s = dt;
+    }
+
+    // Limits can change at runtime without disturbing the motion
+    void setLimits(const TrajectoryLimits& newLimits) { limits = newLimits; }
+    const TrajectoryLimits& currentLimits() const { return limits; }
+
+    // Start at rest at pose
+    void reset(const float pose[POSE_AXES]) {
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            position[axis] = pose[axis];
+            velocity[axis] = 0.0f;
+            acceleration[axis] = 0.0f;
+        }
+        strokesAt(position, stroke);
+        for (size_t leg = 0; leg < PlatformGeometry::LEGS; ++leg) {
+            strokeSpeed[leg] = 0.0f;
+            strokeAccel[leg] = 0.0f;
+        }
+        isSettled = true;
+    }
+
+    // Advances one dt towards target and writes the pose to command now
+    void step(const float target[POSE_AXES], float pose[POSE_AXES]) {
+        float next[POSE_AXES];
+        bool arrived = plan(target, next);
+        bool limited = keepStrokeLimits(next);
+
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            float newVelocity = (next[axis] - position[axis]) / step_s;
+            acceleration[axis] = (newVelocity - velocity[axis]) / step_s;
+            velocity[axis] = newVelocity;
+            position[axis] = next[axis];
+            pose[axis] = position[axis];
+        }
+        // Settled once the legs can also stop dead here next cycle without breaking a limit
+        float strokes[PlatformGeometry::LEGS];
+        isSettled = arrived && !limited && withinLimits(position, true, strokes);
+        if (isSettled) {
+            for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+                velocity[axis] = 0.0f;
+                acceleration[axis] = 0.0f;
+            }
+        }
+    }
+
+    bool settled() const { return isSettled; }
+    const float* currentPose() const { return position; }
+
+private:
+    // Steps 1-4: the pose for the next cycle, planned through the Jacobian. True if that is the
+    // target itself (the move is over).
+    bool plan(const float target[POSE_AXES], float next[POSE_AXES]) const {
+        const float A = TRAJECTORY_PLAN_ACCEL_SHARE * limits.accel_mm_s2;
+        const float Jk = TRAJECTORY_PLAN_JERK_SHARE * limits.jerk_mm_s3;
+        const float V = TRAJECTORY_PLAN_SPEED_SHARE * limits.speed_mm_s;
+
+        // 1. Distance left, in leg mm
+        float there[PlatformGeometry::LEGS];
+        strokesAt(target, there);
+        float distance = 0.0f;
+        for (size_t leg = 0; leg < PlatformGeometry::LEGS; ++leg) {
+            distance = fmaxf(distance, fabsf(there[leg] - stroke[leg]));
+        }
+
+        float J[PlatformGeometry::LEGS][POSE_AXES];
+        PlatformGeometry::legJacobian(position, J);
+        if (distance < TRAJECTORY_SETTLE_MM && legNorm(J, velocity) < Jk * step_s * step_s) {
+            for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+                next[axis] = target[axis];
+            }
+            return true;
+        }
+
+        // 2. Velocity wanted
+        float error[POSE_AXES];
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            error[axis] = target[axis] - position[axis];
+        }
+        float errorSize = fmaxf(legNorm(J, error), distance);
+        float reach = fmaxf(distance - legNorm(J, velocity) * step_s, 0.0f);    // Less the step in flight
+        float stopSpeed = -A * A / (2.0f * Jk) + sqrtf(A * A * A * A / (4.0f * Jk * Jk) + 2.0f * A * reach);
+        float wantedSpeed = fminf(V, stopSpeed);
+
+        // J changing along the way adds curvature * speed^2 to the legs' acceleration: keep the
+        // speed where that is at most its share, and leave the rest to the pose acceleration
+        // (the present speed in the same units: pose velocity over the pose error per leg mm)
+        float curvature = pathCurvature(J, error, errorSize);
+        float errorLength = 0.0f, velocityLength = 0.0f;
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            errorLength += error[axis] * error[axis];
+            velocityLength += velocity[axis] * velocity[axis];
+        }
+        float speedNow = sqrtf(velocityLength / errorLength) * errorSize;
+        if (curvature > 0.0f) {
+            wantedSpeed = fminf(wantedSpeed, sqrtf(TRAJECTORY_DRIFT_SHARE * A / curvature));
+        }
+        float accelRoom = fmaxf(A - curvature * speedNow * speedNow, (1.0f - TRAJECTORY_DRIFT_SHARE) * A);
+
+        float velocityGap[POSE_AXES];
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            velocityGap[axis] = error[axis] * (wantedSpeed / errorSize) - velocity[axis];
+        }
+
+        // 3. Acceleration wanted
+        float accelNow = legNorm(J, acceleration);
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            velocityGap[axis] -= acceleration[axis] * accelNow / (2.0f * Jk);
+        }
+        float mismatch = legNorm(J, velocityGap);
+        float accelMagnitude = fminf(accelRoom, sqrtf(2.0f * Jk * mismatch));
+        float change[POSE_AXES];
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            float wanted = mismatch > 0.0f ? velocityGap[axis] * (accelMagnitude / mismatch) : 0.0f;
+            change[axis] = wanted - acceleration[axis];
+        }
+
+        // 4. Jerk, acceleration (what the curvature leaves), speed
+        scaleTo(J, change, Jk * step_s);
+        float nextAcceleration[POSE_AXES], nextVelocity[POSE_AXES];
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            nextAcceleration[axis] = acceleration[axis] + change[axis];
+        }
+        scaleTo(J, nextAcceleration, accelRoom);
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            nextVelocity[axis] = velocity[axis] + nextAcceleration[axis] * step_s;
+        }
+        scaleTo(J, nextVelocity, V);
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            next[axis] = position[axis] + nextVelocity[axis] * step_s;
+        }
+        return false;
+    }
+
+    // Step 5: the plan only holds the limits to first order in J, so check them on the strokes
+    // the IK actually gives for next, differenced the way the legs see them cycle to cycle. If a
+    // leg goes over, pull next back towards the pose that carries on at the present velocity and
+    // acceleration (so no jerk), by bisection, until every leg is within the limits. Should even
+    // that be over (J bending the path hard), give up on jerk and pull back towards carrying on
+    // at the present velocity instead, which keeps speed and acceleration. True if next was moved.
+    bool keepStrokeLimits(float next[POSE_AXES]) {
+        float wanted[PlatformGeometry::LEGS];
+        if (withinLimits(next, true, wanted)) {
+            record(wanted);
+            return false;
+        }
+
+        float base[POSE_AXES];
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            base[axis] = position[axis] + (velocity[axis] + acceleration[axis] * step_s) * step_s;
+        }
+        bool withJerk = withinLimits(base, true, wanted);
+        if (!withJerk) {
+            for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+                base[axis] = position[axis] + velocity[axis] * step_s;
+            }
+        }
+
+        float low = 0.0f, high = 1.0f, trial[POSE_AXES];
+        for (int i = 0; i < GUARD_BISECTIONS; ++i) {
+            float middle = 0.5f * (low + high);
+            for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+                trial[axis] = base[axis] + middle * (next[axis] - base[axis]);
+            }
+            if (withinLimits(trial, withJerk, wanted)) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            next[axis] = base[axis] + low * (next[axis] - base[axis]);
+        }
+        strokesAt(next, wanted);
+        record(wanted);
+        return true;
+    }
+
+    // Strokes at pose, and whether moving every leg there this cycle keeps speed, acceleration
+    // and (if checked) jerk within the limits, less TRAJECTORY_GUARD_MARGIN
+    bool withinLimits(const float pose[POSE_AXES], bool checkJerk, float wanted[PlatformGeometry::LEGS]) const {
+        const float dt = step_s;
+        const float speedStep = TRAJECTORY_GUARD_MARGIN * limits.speed_mm_s * dt;
+        const float accelStep = TRAJECTORY_GUARD_MARGIN * limits.accel_mm_s2 * dt * dt;
+        const float jerkStep = checkJerk ? TRAJECTORY_GUARD_MARGIN * limits.jerk_mm_s3 * dt * dt * dt : INFINITY;
+        strokesAt(pose, wanted);
+        for (size_t leg = 0; leg < PlatformGeometry::LEGS; ++leg) {
+            float move = wanted[leg] - stroke[leg];
+            float coast = strokeSpeed[leg] * dt;
+            float keep = coast + strokeAccel[leg] * dt * dt;
+            if (fabsf(move) > speedStep || fabsf(move - coast) > accelStep || fabsf(move - keep) > jerkStep) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The legs moved to stroke_mm this cycle
+    void record(const float stroke_mm[PlatformGeometry::LEGS]) {
+        for (size_t leg = 0; leg < PlatformGeometry::LEGS; ++leg) {
+            float speed = (stroke_mm[leg] - stroke[leg]) / step_s;
+            strokeAccel[leg] = (speed - strokeSpeed[leg]) / step_s;
+            strokeSpeed[leg] = speed;
+            stroke[leg] = stroke_mm[leg];
+        }
+    }
+
+    static void strokesAt(const float pose[POSE_AXES], float stroke_mm[PlatformGeometry::LEGS]) {
+        float R[3][3];
+        PlatformGeometry::rotationFromRpy(pose[POSE_ROLL_DEG], pose[POSE_PITCH_DEG], pose[POSE_YAW_DEG], R);
+        PlatformGeometry::legStrokes(R, pose, stroke_mm);
+    }
+
+    // Largest leg rate a pose-space vector implies
+    static float legNorm(const float J[PlatformGeometry::LEGS][POSE_AXES], const float v[POSE_AXES]) {
+        float worst = 0.0f;
+        for (size_t leg = 0; leg < PlatformGeometry::LEGS; ++leg) {
+            float rate = 0.0f;
+            for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+                rate += J[leg][axis] * v[axis];
+            }
+            worst = fmaxf(worst, fabsf(rate));
+        }
+        return worst;
+    }
+
+    // Shrinks v (keeping its direction) until no leg sees more than limit
+    static void scaleTo(const float J[PlatformGeometry::LEGS][POSE_AXES], float v[POSE_AXES], float limit) {
+        float norm = legNorm(J, v);
+        if (norm > limit) {
+            float k = limit / norm;
+            for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+                v[axis] *= k;
+            }
+        }
+    }
+
+    // Largest change of a leg's rate per leg mm travelled, per unit leg speed, moving along error
+    // (scaled so a leg speed of 1 is error / errorSize): (J(p + u H) - J(p)) u / H over one leg mm
+    float pathCurvature(const float J[PlatformGeometry::LEGS][POSE_AXES], const float error[POSE_AXES], float errorSize) const {
+        float unit[POSE_AXES], ahead[POSE_AXES];
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            unit[axis] = error[axis] / errorSize;
+            ahead[axis] = position[axis] + unit[axis] * CURVATURE_STEP_MM;
+        }
+        float Jahead[PlatformGeometry::LEGS][POSE_AXES];
+        PlatformGeometry::legJacobian(ahead, Jahead);
+        float worst = 0.0f;
+        for (size_t leg = 0; leg < PlatformGeometry::LEGS; ++leg) {
+            float d = 0.0f;
+            for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+                d += (Jahead[leg][axis] - J[leg][axis]) * unit[axis];
+            }
+            worst = fmaxf(worst, fabsf(d) / CURVATURE_STEP_MM);
+        }
+        return worst;
+    }
+
+    static constexpr float CURVATURE_STEP_MM = 1.0f;
+    static constexpr int GUARD_BISECTIONS = 12;
+
+    TrajectoryLimits limits;
+    float step_s = 0.02f;
+    float position[POSE_AXES] = {};
+    float velocity[POSE_AXES] = {};
+    float acceleration[POSE_AXES] = {};
+    // What the legs did: the strokes at position and their last cycle-to-cycle differences
+    float stroke[PlatformGeometry::LEGS] = {};
+    float strokeSpeed[PlatformGeometry::LEGS] = {};
+    float strokeAccel[PlatformGeometry::LEGS] = {};
+    bool isSettled = true;
+};
+
+} // namespace MotionLink
+
+#endif // POSE_TRAJECTORY_HPP
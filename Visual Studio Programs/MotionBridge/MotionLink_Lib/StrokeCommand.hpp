@@ -0,0 +1,77 @@
+#ifndef STROKE_COMMAND_HPP
+#define STROKE_COMMAND_HPP
+
+// --- Actuator Stroke Commands (host-side IK) ---
+// In offload mode the host bridge runs the platform IK itself and sends the six target strokes
+// instead of a pose, so the firmware can skip the rotation matrix, the twelve joint transforms
+// and the six square roots and feed the strokes straight into DigitalPosFeedback::targetPosition.
+// Motion frames (poses) still work as before; whichever the platform received last is what it
+// tracks, so the on-MCU IK is the fallback whenever the host sends poses again.
+//
+// Payload layout (little-endian):
+//   uint16  sequence                        (same counter as motion frames)
+//   uint32  host send time                  (us, host clock, for latency tracing)
+//   uint16  x 6 actuator target stroke      (1/128 mm, 0 - 511.99 mm)
+//
+// 18 byte payload, 25 B on the wire: the size of a COARSE motion frame with better than
+// 0.01 mm resolution, vs 37 B for a STANDARD pose.
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include "MotionLink.hpp"
+#include "MotionSchema.hpp"
+
+namespace MotionLink {
+
+constexpr size_t STROKE_ACTUATORS = 6;
+constexpr size_t STROKE_COMMAND_SIZE = 6 + STROKE_ACTUATORS * 2;
+
+// Unsigned 1/128 mm counts (a power of two, like the schema's fields, so decode is one multiply)
+constexpr float STROKE_SCALE = 128.0f;                      // counts per mm
+constexpr float STROKE_INV_SCALE = 1.0f / STROKE_SCALE;     // mm per count
+constexpr float STROKE_MAX_MM = 65535.0f * STROKE_INV_SCALE;
+
+struct StrokeCommand {
+    uint16_t sequence = 0;
+    uint32_t hostTime_us = 0;
+    float stroke_mm[STROKE_ACTUATORS] = {};
+};
+
+inline uint16_t encodeStroke(float stroke_mm) {
+    // Clamp in float space first so the cast can never overflow (NaN ends up at 0)
+    if (!(stroke_mm > 0.0f)) stroke_mm = 0.0f;
+    if (stroke_mm > STROKE_MAX_MM) stroke_mm = STROKE_MAX_MM;
+    return static_cast<uint16_t>(lrintf(stroke_mm * STROKE_SCALE));
+}
+
+inline float decodeStroke(uint16_t counts) {
+    return static_cast<float>(counts) * STROKE_INV_SCALE;
+}
+
+// Writes a complete frame to out (frameSize(STROKE_COMMAND_SIZE) bytes). Returns the bytes written.
+inline size_t buildStrokeCommand(const StrokeCommand& msg, uint8_t* out) {
+    uint8_t* p = out + HEADER_SIZE;
+    p = MotionSchema::putLE(p, msg.sequence);
+    p = MotionSchema::putLE(p, msg.hostTime_us);
+    for (size_t i = 0; i < STROKE_ACTUATORS; ++i) {
+        p = MotionSchema::putLE(p, encodeStroke(msg.stroke_mm[i]));
+    }
+    return buildFrame(MSG_STROKE_COMMAND, out + HEADER_SIZE, STROKE_COMMAND_SIZE, out);
+}
+
+inline bool decodeStrokeCommand(const uint8_t* in, size_t length, StrokeCommand& msg) {
+    if (length != STROKE_COMMAND_SIZE) return false;
+    in = MotionSchema::getLE(in, msg.sequence);
+    in = MotionSchema::getLE(in, msg.hostTime_us);
+    for (size_t i = 0; i < STROKE_ACTUATORS; ++i) {
+        uint16_t counts;
+        in = MotionSchema::getLE(in, counts);
+        msg.stroke_mm[i] = decodeStroke(counts);
+    }
+    return true;
+}
+
+} // namespace MotionLink
+
+#endif // STROKE_COMMAND_HPP
@@ -0,0 +1,238 @@
+// --- Pseudo-terminal loopback harness (Linux) ---
+// Connects SerialTransmitter to a host build of the firmware's receive path (MotionReceiver from
+// MotionLink_Lib) through a pty pair, so link throughput and latency can be measured with no board
+// attached.
+//
+//   SerialTransmitter --> pty slave ==kernel==> pty master --> MotionReceiver (reader thread)
+//
+// A pty doesn't enforce a baud rate, so --baud makes the reader drain the master no faster than a
+// real 8N1 line would. That backs data up into the pty and the transmitter's buffer, which is
+// exactly the situation batching, coalescing and backpressure are there for. Latency is measured
+// from queueFrame() to decode, so it includes time spent queued in the kernel's pty buffer.
+//
+// Usage: PtyLoopback [--frames N] [--rate HZ] [--baud B] [--level coarse|standard|fine]
+//                    [--driver-queue BYTES] [--max-latency-ms MS]
+//   --frames          number of motion frames to send               (default 10000)
+//   --rate            send rate in Hz, 0 = as fast as possible        (default 0)
+//   --baud            emulated line rate in baud, 0 = unthrottled     (default 0)
+//   --level           quantization level                             (default standard)
+//   --driver-queue    transmitter driver queue cap, 0 = uncapped      (default 64)
+//   --max-latency-ms  exit 1 if p99 latency is above this             (default: no check)
+//
+// Overload check, 1000 Hz of frames into a line that carries about 380 of them:
+//   PtyLoopback --frames 2000 --rate 1000 --baud 115200 --max-latency-ms 20
+
+#include "SerialTransmitter.hpp"
+#include "MotionLink_Lib/MotionLink.hpp"
+#include "MotionLink_Lib/MotionReceiver.hpp"
+#include "MotionLink_Lib/MotionSchema.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+using MotionSchema::QuantLevel;
+
+using Clock = steady_clock;
+
+// Send time of each sequence number (sequence wraps at 65536, far more than can be in flight)
+static std::vector<Clock::time_point> sendTimes(65536);
+
+// Records the latency of every motion frame that makes it through
+class LatencyHandler : public MotionLink::MessageHandler {
+public:
+    std::vector<double> latencies_us;
+    uint32_t received = 0;
+
+    void onMotionFrame(const MotionSchema::MotionFrame& frame, uint32_t arrival_us) override {
+        (void)arrival_us;
+        double latency = duration<double, std::micro>(Clock::now() - sendTimes[frame.sequence]).count();
+        latencies_us.push_back(latency);
+        ++received;
+    }
+};
+
+// Builds one frame at the requested level
+static size_t buildFrame(QuantLevel level, const MotionSchema::MotionFrame& frame, uint8_t* out) {
+    switch (level) {
+        case QuantLevel::COARSE:   return MotionLink::buildMotionFrame<QuantLevel::COARSE>(frame, out);
+        case QuantLevel::FINE:     return MotionLink::buildMotionFrame<QuantLevel::FINE>(frame, out);
+        case QuantLevel::STANDARD:
+        default:                   return MotionLink::buildMotionFrame<QuantLevel::STANDARD>(frame, out);
+    }
+}
+
+static double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+int main(int argc, char** argv) {
+    long frameCount = 10000;
+    double rateHz = 0.0;
+    long emulatedBaud = 0;
+    long driverQueue = static_cast<long>(SerialTransmitter::DEFAULT_DRIVER_QUEUE_LIMIT);
+    double maxLatency_ms = 0.0;
+    QuantLevel level = QuantLevel::STANDARD;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--frames" && value) { frameCount = atol(value); ++i; }
+        else if (arg == "--rate" && value) { rateHz = atof(value); ++i; }
+        else if (arg == "--baud" && value) { emulatedBaud = atol(value); ++i; }
+        else if (arg == "--driver-queue" && value) { driverQueue = atol(value); ++i; }
+        else if (arg == "--max-latency-ms" && value) { maxLatency_ms = atof(value); ++i; }
+        else if (arg == "--level" && value) {
+            std::string name = value; ++i;
+            if (name == "coarse") level = QuantLevel::COARSE;
+            else if (name == "fine") level = QuantLevel::FINE;
+            else level = QuantLevel::STANDARD;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--frames N] [--rate HZ] [--baud B] [--level coarse|standard|fine]"
+                      << " [--driver-queue BYTES] [--max-latency-ms MS]" << std::endl;
+            return 1;
+        }
+    }
+
+    // --- Create the pty pair ---
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        std::cerr << "Error creating pseudo-terminal" << std::endl;
+        return 1;
+    }
+    std::string slavePath = ptsname(master);
+
+    // Raw mode on the master side too, so no byte is ever translated or swallowed
+    termios tty;
+    tcgetattr(master, &tty);
+    cfmakeraw(&tty);
+    tcsetattr(master, TCSANOW, &tty);
+
+    SerialTransmitter transmitter;
+    if (!transmitter.open(slavePath, emulatedBaud > 0 && emulatedBaud <= SerialTransmitter::MAX_BAUD_RATE ? static_cast<int>(emulatedBaud) : 115200)) {
+        return 1;
+    }
+    // Without --baud the pty really is unthrottled, so the transmitter's line estimate would be wrong
+    transmitter.setDriverQueueLimit(emulatedBaud > 0 && driverQueue > 0 ? static_cast<size_t>(driverQueue) : 0);
+
+    std::cout << "Loopback over " << slavePath << ": " << frameCount << " frames, rate "
+              << (rateHz > 0 ? std::to_string(rateHz) + " Hz" : std::string("max"))
+              << ", line " << (emulatedBaud > 0 ? std::to_string(emulatedBaud) + " baud" : std::string("unthrottled")) << std::endl;
+
+    // --- Receiver thread: the host build of the firmware receive path ---
+    LatencyHandler handler;
+    handler.latencies_us.reserve(static_cast<size_t>(frameCount));
+    MotionLink::MotionReceiver receiver(handler);
+    std::atomic<bool> senderDone(false);
+    uint64_t bytesReceived = 0;
+
+    std::thread reader([&]() {
+        uint8_t chunk[256];
+        Clock::time_point lineStart = Clock::now();
+        auto idleSince = Clock::now();
+
+        while (true) {
+            pollfd pfd = { master, POLLIN, 0 };
+            int ready = poll(&pfd, 1, 10);
+            if (ready > 0 && (pfd.revents & POLLIN)) {
+                ssize_t n = read(master, chunk, sizeof(chunk));
+                if (n <= 0) continue;
+                receiver.push(chunk, static_cast<size_t>(n));
+                bytesReceived += static_cast<uint64_t>(n);
+                idleSince = Clock::now();
+
+                if (emulatedBaud > 0) {
+                    // 10 bits per byte on an 8N1 line
+                    auto lineTime = duration<double>(bytesReceived * 10.0 / emulatedBaud);
+                    std::this_thread::sleep_until(lineStart + duration_cast<Clock::duration>(lineTime));
+                }
+            } else if (senderDone && Clock::now() - idleSince > milliseconds(200)) {
+                break; // Sender finished and nothing more is coming
+            }
+        }
+    });
+
+    // --- Sender: synthetic motion at the requested rate ---
+    uint8_t frameBuffer[MotionLink::MAX_FRAME_SIZE];
+    MotionSchema::MotionFrame frame;
+    Clock::time_point start = Clock::now();
+    Clock::duration period = rateHz > 0 ? duration_cast<Clock::duration>(duration<double>(1.0 / rateHz)) : Clock::duration::zero();
+
+    for (long i = 0; i < frameCount; ++i) {
+        float t = static_cast<float>(i) * 0.02f;
+        frame.sequence = static_cast<uint16_t>(i);
+        frame.roll_deg = 20.0f * sinf(t);
+        frame.pitch_deg = 15.0f * cosf(t);
+        frame.yaw_deg = 5.0f * sinf(0.5f * t);
+        frame.translationZ_mm = 50.0f * sinf(0.25f * t);
+
+        size_t length = buildFrame(level, frame, frameBuffer);
+        sendTimes[frame.sequence] = Clock::now();
+        transmitter.queueFrame(frameBuffer, length, true);
+        if (transmitter.flush() < 0) {
+            break;
+        }
+
+        if (rateHz > 0) {
+            std::this_thread::sleep_until(start + period * (i + 1));
+        }
+    }
+    transmitter.flushBlocking(seconds(10));
+    Clock::time_point sendEnd = Clock::now();
+    senderDone = true;
+    reader.join();
+
+    // --- Report ---
+    const SerialTransmitter::Stats& tx = transmitter.stats();
+    const MotionLink::FrameParser& link = receiver.stats();
+    double elapsed = duration<double>(sendEnd - start).count();
+
+    std::vector<double> sorted = handler.latencies_us;
+    std::sort(sorted.begin(), sorted.end());
+    double mean = 0.0;
+    for (double v : sorted) mean += v;
+    if (!sorted.empty()) mean /= sorted.size();
+
+    printf("\n--- Transmitter ---\n");
+    printf("Frames queued: %llu, coalesced: %llu, dropped: %llu\n",
+           (unsigned long long)tx.framesQueued, (unsigned long long)tx.framesCoalesced, (unsigned long long)tx.framesDropped);
+    printf("Bytes written: %llu in %llu write() calls (%llu would-block, %llu throttled flushes)\n",
+           (unsigned long long)tx.bytesWritten, (unsigned long long)tx.writeCalls, (unsigned long long)tx.wouldBlock,
+           (unsigned long long)tx.throttled);
+    printf("\n--- Receiver ---\n");
+    printf("Frames OK: %lu, CRC errors: %lu, version errors: %lu\n",
+           (unsigned long)link.framesOk, (unsigned long)link.crcErrors, (unsigned long)link.versionErrors);
+    printf("Throughput: %.0f frames/s, %.1f kB/s over %.3f s\n",
+           handler.received / elapsed, bytesReceived / elapsed / 1000.0, elapsed);
+    printf("Latency (us): min %.1f, mean %.1f, p50 %.1f, p99 %.1f, max %.1f\n",
+           percentile(sorted, 0.0), mean, percentile(sorted, 0.5), percentile(sorted, 0.99), percentile(sorted, 1.0));
+
+    transmitter.close();
+    close(master);
+
+    if (maxLatency_ms > 0.0) {
+        double p99_ms = percentile(sorted, 0.99) / 1000.0;
+        if (sorted.empty() || p99_ms > maxLatency_ms) {
+            printf("FAIL: p99 latency %.1f ms is above %.1f ms\n", p99_ms, maxLatency_ms);
+            return 1;
+        }
+        printf("OK: p99 latency %.1f ms is within %.1f ms\n", p99_ms, maxLatency_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+// --- BNO080 Q-point conversion benchmark (host) ---
+// Times the sensor report parsing in the BNO080 driver with its old Q-point conversion
+// (value * pow(2, -q) per number) against QFormat.h (a compile-time power-of-two scale, and
+// ldexpf() for Q points only known at runtime), on
+// batched sensor data packets laid out as the IMU sends them: a base timestamp followed by
+// accelerometer, gyroscope, game rotation vector and rotation vector reports back to back.
+// The packets are generated from a fixed seed with realistic readings (unit quaternions,
+// ~1 g, a few rad/s), and all the parsers must produce bit-identical floats.
+//
+// The host has a fast libm and a double-precision FPU, so this understates the gap on the
+// STM32's single-precision FPU, where pow() runs as software double maths.
+//
+// Usage: QFormatBench [--packets N] [--reports R] [--rounds K]
+//   --packets  distinct packets                 (default 256)
+//   --reports  sensor reports per packet        (default 8)
+//   --rounds   passes over all the packets      (default 2000)
+//
+// Exits 1 if the two conversions disagree on any value.
+
+#include "BNO080Constants.h"
+#include "QFormat.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+using Clock = steady_clock;
+
+// Report sizes, as in BNO080.cpp
+constexpr size_t SIZEOF_BASE_TIMESTAMP = 5;
+constexpr size_t SIZEOF_VECTOR_REPORT = 10;         // Accelerometer, gyroscope
+constexpr size_t SIZEOF_GAME_ROTATION_VECTOR = 12;
+constexpr size_t SIZEOF_ROTATION_VECTOR = 14;
+
+// The driver's conversion before QFormat.h. Out of line, as BNO080Base::qToFloat() is called from
+// the parser (otherwise the compiler folds pow() of a constant and there is nothing to measure).
+__attribute__((noinline)) static float powToFloat(int16_t fixedPointValue, uint8_t qPoint) {
+    float qFloat = fixedPointValue;
+    qFloat *= pow(2.0f, qPoint * -1);
+    return qFloat;
+}
+
+struct PowConvert {
+    template <uint8_t qPoint>
+    static float toFloat(int16_t value) { return powToFloat(value, qPoint); }
+};
+
+// QFormat.h with the Q point only known at runtime, as the non-template qToFloat() now is
+__attribute__((noinline)) static float ldexpToFloat(int16_t fixedPointValue, uint8_t qPoint) {
+    return QFormat::toFloat(fixedPointValue, qPoint);
+}
+
+struct LdexpConvert {
+    template <uint8_t qPoint>
+    static float toFloat(int16_t value) { return ldexpToFloat(value, qPoint); }
+};
+
+struct ScaleConvert {
+    template <uint8_t qPoint>
+    static float toFloat(int16_t value) { return QFormat::toFloat<qPoint>(value); }
+};
+
+static void put16(std::vector<uint8_t>& packet, size_t offset, int16_t value) {
+    packet[offset] = static_cast<uint8_t>(value & 0xFF);
+    packet[offset + 1] = static_cast<uint8_t>((static_cast<uint16_t>(value) >> 8) & 0xFF);
+}
+
+static int16_t toQ(float value, int qPoint) {
+    float scaled = std::round(std::ldexp(value, qPoint));
+    return static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, scaled)));
+}
+
+// One sensor data packet body (as rxShtpData, without the SHTP header)
+static std::vector<uint8_t> makePacket(std::mt19937& rng, int reports) {
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<uint8_t> packet(SIZEOF_BASE_TIMESTAMP, 0);
+    packet[0] = SHTP_REPORT_BASE_TIMESTAMP;
+    packet[1] = 20;
+
+    const uint8_t cycle[] = { SENSOR_REPORTID_ACCELEROMETER, SENSOR_REPORTID_GYROSCOPE_CALIBRATED,
+                              SENSOR_REPORTID_GAME_ROTATION_VECTOR, SENSOR_REPORTID_ROTATION_VECTOR };
+    for (int r = 0; r < reports; ++r) {
+        uint8_t id = cycle[r % 4];
+        size_t offset = packet.size();
+        size_t size = id == SENSOR_REPORTID_ROTATION_VECTOR ? SIZEOF_ROTATION_VECTOR
+                    : id == SENSOR_REPORTID_GAME_ROTATION_VECTOR ? SIZEOF_GAME_ROTATION_VECTOR
+                    : SIZEOF_VECTOR_REPORT;
+        packet.resize(offset + size, 0);
+        packet[offset] = id;
+        packet[offset + 1] = static_cast<uint8_t>(r);
+        packet[offset + 2] = 3;
+        packet[offset + 3] = static_cast<uint8_t>(r * 10);
+
+        if (id == SENSOR_REPORTID_ACCELEROMETER) {
+            put16(packet, offset + 4, toQ(0.2f * noise(rng), ACCELEROMETER_Q_POINT));
+            put16(packet, offset + 6, toQ(0.2f * noise(rng), ACCELEROMETER_Q_POINT));
+            put16(packet, offset + 8, toQ(9.81f + 0.2f * noise(rng), ACCELEROMETER_Q_POINT));
+        } else if (id == SENSOR_REPORTID_GYROSCOPE_CALIBRATED) {
+            for (int axis = 0; axis < 3; ++axis) {
+                put16(packet, offset + 4 + 2 * axis, toQ(2.0f * noise(rng), GYRO_Q_POINT));
+            }
+        } else {
+            float q[4], norm = 0.0f;
+            for (float& v : q) {
+                v = noise(rng);
+                norm += v * v;
+            }
+            norm = std::sqrt(norm);
+            for (int i = 0; i < 4; ++i) {
+                put16(packet, offset + 4 + 2 * i, toQ(q[i] / norm, ROTATION_Q_POINT));
+            }
+            if (id == SENSOR_REPORTID_ROTATION_VECTOR) {
+                put16(packet, offset + 12, toQ(0.05f, ROTATION_ACCURACY_Q_POINT));
+            }
+        }
+    }
+    return packet;
+}
+
+static int16_t get16(const uint8_t* data) {
+    return static_cast<int16_t>(static_cast<uint16_t>(data[1]) << 8 | data[0]);
+}
+
+// The conversion part of BNO080Base::parseSensorDataPacket(); writes every converted value to out
+template <typename Convert>
+static size_t parsePacket(const std::vector<uint8_t>& packet, float* out) {
+    size_t count = 0;
+    size_t offset = SIZEOF_BASE_TIMESTAMP;
+    while (offset < packet.size()) {
+        const uint8_t* report = &packet[offset];
+        int16_t data1 = get16(report + 4), data2 = get16(report + 6), data3 = get16(report + 8);
+        switch (report[0]) {
+            case SENSOR_REPORTID_ACCELEROMETER:
+                out[count++] = Convert::template toFloat<ACCELEROMETER_Q_POINT>(data1);
+                out[count++] = Convert::template toFloat<ACCELEROMETER_Q_POINT>(data2);
+                out[count++] = Convert::template toFloat<ACCELEROMETER_Q_POINT>(data3);
+                offset += SIZEOF_VECTOR_REPORT;
+                break;
+            case SENSOR_REPORTID_GYROSCOPE_CALIBRATED:
+                out[count++] = Convert::template toFloat<GYRO_Q_POINT>(data1);
+                out[count++] = Convert::template toFloat<GYRO_Q_POINT>(data2);
+                out[count++] = Convert::template toFloat<GYRO_Q_POINT>(data3);
+                offset += SIZEOF_VECTOR_REPORT;
+                break;
+            case SENSOR_REPORTID_GAME_ROTATION_VECTOR:
+            case SENSOR_REPORTID_ROTATION_VECTOR:
+                out[count++] = Convert::template toFloat<ROTATION_Q_POINT>(data1);
+                out[count++] = Convert::template toFloat<ROTATION_Q_POINT>(data2);
+                out[count++] = Convert::template toFloat<ROTATION_Q_POINT>(data3);
+                out[count++] = Convert::template toFloat<ROTATION_Q_POINT>(get16(report + 10));
+                if (report[0] == SENSOR_REPORTID_ROTATION_VECTOR) {
+                    out[count++] = Convert::template toFloat<ROTATION_ACCURACY_Q_POINT>(get16(report + 12));
+                    offset += SIZEOF_ROTATION_VECTOR;
+                } else {
+                    offset += SIZEOF_GAME_ROTATION_VECTOR;
+                }
+                break;
+            default:
+                return count;
+        }
+    }
+    return count;
+}
+
+template <typename Convert>
+static double timeParse(const std::vector<std::vector<uint8_t>>& packets, int rounds, std::vector<float>& out,
+                        size_t& conversions) {
+    volatile float sink = 0.0f;
+    auto start = Clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        conversions = 0;
+        for (const auto& packet : packets) {
+            conversions += parsePacket<Convert>(packet, &out[conversions]);
+        }
+        sink = sink + out[round % conversions];
+    }
+    (void)sink;
+    return static_cast<double>(duration_cast<nanoseconds>(Clock::now() - start).count());
+}
+
+int main(int argc, char** argv) {
+    int packetCount = 256;
+    int reports = 8;
+    int rounds = 2000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--packets" && i + 1 < argc) {
+            packetCount = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--reports" && i + 1 < argc) {
+            reports = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Usage: QFormatBench [--packets N] [--reports R] [--rounds K]\n");
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(1234);
+    std::vector<std::vector<uint8_t>> packets;
+    for (int p = 0; p < packetCount; ++p) {
+        packets.push_back(makePacket(rng, reports));
+    }
+
+    // At most 5 values per report
+    size_t capacity = static_cast<size_t>(packetCount) * reports * 5;
+    std::vector<float> powOut(capacity), ldexpOut(capacity), scaleOut(capacity);
+    size_t powCount = 0, ldexpCount = 0, scaleCount = 0;
+
+    // Warm up, then interleave so none of them gets the warmer cache throughout
+    timeParse<PowConvert>(packets, 10, powOut, powCount);
+    timeParse<LdexpConvert>(packets, 10, ldexpOut, ldexpCount);
+    timeParse<ScaleConvert>(packets, 10, scaleOut, scaleCount);
+    double pow_ns = 0.0, ldexp_ns = 0.0, scale_ns = 0.0;
+    int passRounds = rounds / 4 + 1;
+    for (int pass = 0; pass < 4; ++pass) {
+        pow_ns += timeParse<PowConvert>(packets, passRounds, powOut, powCount);
+        ldexp_ns += timeParse<LdexpConvert>(packets, passRounds, ldexpOut, ldexpCount);
+        scale_ns += timeParse<ScaleConvert>(packets, passRounds, scaleOut, scaleCount);
+    }
+    double parsed = 4.0 * passRounds * packetCount;
+    double values = parsed * powCount / packetCount;
+
+    size_t mismatches = (powCount == ldexpCount && powCount == scaleCount) ? 0 : 1;
+    for (size_t i = 0; i < std::min({powCount, ldexpCount, scaleCount}); ++i) {
+        if (std::memcmp(&powOut[i], &ldexpOut[i], sizeof(float)) != 0
+            || std::memcmp(&powOut[i], &scaleOut[i], sizeof(float)) != 0) {
+            ++mismatches;
+        }
+    }
+
+    std::printf("Packets:           %d x %d reports, %zu values\n", packetCount, reports, powCount);
+    std::printf("pow(2, -q):        %.1f ns/packet, %.2f ns/value\n", pow_ns / parsed, pow_ns / values);
+    std::printf("ldexpf, runtime q: %.1f ns/packet, %.2f ns/value\n", ldexp_ns / parsed, ldexp_ns / values);
+    std::printf("qToFloat<Q>:       %.1f ns/packet, %.2f ns/value\n", scale_ns / parsed, scale_ns / values);
+    std::printf("Speedup:           %.1fx (ldexpf), %.1fx (qToFloat<Q>)\n", pow_ns / ldexp_ns, pow_ns / scale_ns);
+    std::printf("Mismatches:        %zu\n", mismatches);
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+// --- Sample ring stress test (host) ---
+// Runs the BNO080 driver's per-report sample ring (BNO080Base::SampleRing, i.e. SPSCRing from
+// SampleRing.h) on two host threads standing in for the RTOS ones: a producer pushing samples as
+// fast as it can, the way the driver thread does while parsing a batched packet, and a consumer
+// popping them. The ring is small, so the producer keeps finding it full; it then yields, as the
+// driver thread goes back to waiting for INT, so most items do pass through the ring.
+//
+// Every sample carries its push attempt number in its timestamp and values derived from it. The
+// check then requires that
+//   - every popped sample is whole (all fields belong to the same push);
+//   - the popped samples are exactly the accepted pushes, in order, none lost or repeated;
+//   - accepted + overflowCount() == attempts, i.e. every refused push was counted.
+//
+// Usage: SampleRingStress [--items N] [--pause-every N]
+//   --items        push attempts                           (default 5000000)
+//   --pause-every  consumer yields after this many pops    (default 0, never)
+//
+// Exits 1 if any check failed.
+
+#include "BNO080.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr uint32_t RING_CAPACITY = 64;
+
+static BNO080Base::Sample makeSample(uint32_t attempt) {
+    BNO080Base::Sample sample = {};
+    sample.report = BNO080Base::GYROSCOPE;
+    sample.status = static_cast<uint8_t>(attempt & 3);
+    sample.timestamp = attempt;
+    for (int i = 0; i < 4; ++i) {
+        sample.data[i] = static_cast<float>(attempt % 1000000) + i * 0.25f;
+    }
+    sample.accuracy = static_cast<float>(attempt % 7);
+    for (int i = 0; i < 3; ++i) {
+        sample.angularVelocity[i] = static_cast<float>(attempt % 3333) - i;
+    }
+    return sample;
+}
+
+// True if every field belongs to the same push
+static bool whole(const BNO080Base::Sample& sample) {
+    BNO080Base::Sample expected = makeSample(sample.timestamp);
+    if (sample.report != expected.report || sample.status != expected.status || sample.accuracy != expected.accuracy) {
+        return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (sample.data[i] != expected.data[i]) {
+            return false;
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (sample.angularVelocity[i] != expected.angularVelocity[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint32_t items = 5000000;
+    uint32_t pauseEvery = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--items" && i + 1 < argc) {
+            items = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--pause-every" && i + 1 < argc) {
+            pauseEvery = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::fprintf(stderr, "Usage: SampleRingStress [--items N] [--pause-every N]\n");
+            return 2;
+        }
+    }
+
+    BNO080Base::SampleRing<RING_CAPACITY> ring;
+    std::vector<uint32_t> accepted;
+    std::vector<uint32_t> popped;
+    accepted.reserve(items);
+    popped.reserve(items);
+    std::atomic<bool> done{false};
+    uint64_t torn = 0;
+
+    std::thread consumer([&] {
+        BNO080Base::Sample sample;
+        for (;;) {
+            // Read done before popping, so an empty ring after done means the producer has finished
+            bool finished = done.load(std::memory_order_acquire);
+            if (!ring.pop(sample)) {
+                if (finished) {
+                    break;
+                }
+                continue;
+            }
+            if (!whole(sample)) {
+                ++torn;
+            }
+            popped.push_back(sample.timestamp);
+            if (pauseEvery != 0 && popped.size() % pauseEvery == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (uint32_t attempt = 1; attempt <= items; ++attempt) {
+        if (ring.push(makeSample(attempt))) {
+            accepted.push_back(attempt);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    const uint64_t overflows = ring.overflowCount();
+    const bool counted = accepted.size() + overflows == items;
+    const bool exact = popped == accepted;
+
+    std::printf("Ring capacity:     %u\n", ring.capacity());
+    std::printf("Push attempts:     %u\n", items);
+    std::printf("Accepted:          %zu\n", accepted.size());
+    std::printf("Overflows:         %llu\n", static_cast<unsigned long long>(overflows));
+    std::printf("Popped:            %zu\n", popped.size());
+    std::printf("Torn samples:      %llu\n", static_cast<unsigned long long>(torn));
+    std::printf("Overflows counted: %s\n", counted ? "yes" : "NO");
+    std::printf("Pops match pushes: %s\n", exact ? "yes" : "NO");
+
+    return (torn == 0 && counted && exact) ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+// --- Motion schema round-trip check (host) ---
+// Encodes and decodes every field type of every quantization level in MotionLink_Lib/MotionSchema.hpp
+// at and beyond its limits: zero, one count, the nominal range, the clamp value, just past it, far
+// past it, infinities and NaN. A value inside the clamp must come back within half a count; one
+// outside must come back as the clamp value with its own sign (the FINE int32 fields used to wrap
+// here, e.g. attitude 300 came back as -256). Then does the same through encodeMotion()/decodeMotion().
+//
+// Usage: SchemaCheck
+//
+// Prints every mismatch and exits 1 if there was any.
+
+#include "MotionLink_Lib/MotionSchema.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+using namespace MotionSchema;
+
+static int failures = 0;
+
+// What decode(encode(value)) should give: value clamped to +/-MAX_VALUE, NaN as 0
+template <typename Field>
+static float expected(float value) {
+    if (std::isnan(value)) {
+        return 0.0f;
+    }
+    return std::fmax(-Field::MAX_VALUE, std::fmin(Field::MAX_VALUE, value));
+}
+
+template <typename Field>
+static std::vector<float> probes(float range) {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float max = Field::MAX_VALUE;
+    std::vector<float> values = { 0.0f, Field::INV_SCALE, range, max, std::nextafter(max, 0.0f),
+                                  std::nextafter(max, inf), max * 1.0001f, range * 2.0f, 1e30f, inf,
+                                  std::numeric_limits<float>::quiet_NaN() };
+    size_t count = values.size();
+    for (size_t i = 0; i < count; ++i) {
+        values.push_back(-values[i]);
+    }
+    return values;
+}
+
+template <typename Field>
+static void checkField(const char* level, const char* name, float range) {
+    for (float value : probes<Field>(range)) {
+        typename Field::Storage counts = Field::encode(value);
+        float decoded = Field::decode(counts);
+        float want = expected<Field>(value);
+        // within half a count of the clamped value, and never the wrong sign
+        bool ok = std::fabs(decoded - want) <= 0.5f * Field::INV_SCALE
+                  && !(want > 0.0f && decoded < 0.0f) && !(want < 0.0f && decoded > 0.0f);
+        if (!ok) {
+            std::printf("FAIL %-8s %-11s encode(%g) = %lld counts, decodes to %g, expected %g\n", level, name,
+                        value, static_cast<long long>(counts), decoded, want);
+            ++failures;
+        }
+    }
+}
+
+template <QuantLevel L>
+static void checkFrame(const char* level) {
+    using F = Fields<L>;
+    // every field well past its limit, alternating signs
+    MotionFrame frame;
+    frame.sequence = 0xBEEF;
+    frame.hostTime_us = 0xDEADBEEF;
+    frame.roll_deg = 300.0f;           frame.pitch_deg = -300.0f;       frame.yaw_deg = 1e9f;
+    frame.translationX_mm = 1000.0f;   frame.translationY_mm = -1000.0f; frame.translationZ_mm = -1e9f;
+    frame.rollRate_dps = 600.0f;       frame.pitchRate_dps = -600.0f;   frame.yawRate_dps = 1e9f;
+    frame.specificForceX_mps2 = 1000.0f; frame.specificForceY_mps2 = -1000.0f; frame.specificForceZ_mps2 = -1e9f;
+
+    uint8_t payload[payloadSize<L>()];
+    MotionFrame decoded;
+    if (encodeMotion<L>(frame, payload) != sizeof(payload) || !decodeMotion<L>(payload, sizeof(payload), decoded)) {
+        std::printf("FAIL %-8s frame didn't round-trip\n", level);
+        ++failures;
+        return;
+    }
+
+    struct Pair { const char* name; float sent, got, max; };
+    const Pair pairs[] = {
+        { "roll",   frame.roll_deg,            decoded.roll_deg,            F::Attitude::MAX_VALUE },
+        { "pitch",  frame.pitch_deg,           decoded.pitch_deg,           F::Attitude::MAX_VALUE },
+        { "yaw",    frame.yaw_deg,             decoded.yaw_deg,             F::Attitude::MAX_VALUE },
+        { "x",      frame.translationX_mm,     decoded.translationX_mm,     F::Translation::MAX_VALUE },
+        { "y",      frame.translationY_mm,     decoded.translationY_mm,     F::Translation::MAX_VALUE },
+        { "z",      frame.translationZ_mm,     decoded.translationZ_mm,     F::Translation::MAX_VALUE },
+        { "p",      frame.rollRate_dps,        decoded.rollRate_dps,        F::Rate::MAX_VALUE },
+        { "q",      frame.pitchRate_dps,       decoded.pitchRate_dps,       F::Rate::MAX_VALUE },
+        { "r",      frame.yawRate_dps,         decoded.yawRate_dps,         F::Rate::MAX_VALUE },
+        { "fx",     frame.specificForceX_mps2, decoded.specificForceX_mps2, F::Force::MAX_VALUE },
+        { "fy",     frame.specificForceY_mps2, decoded.specificForceY_mps2, F::Force::MAX_VALUE },
+        { "fz",     frame.specificForceZ_mps2, decoded.specificForceZ_mps2, F::Force::MAX_VALUE },
+    };
+    for (const Pair& pair : pairs) {
+        if (pair.got != std::copysign(pair.max, pair.sent)) {
+            std::printf("FAIL %-8s frame %-5s sent %g, got %g, expected %g\n", level, pair.name, pair.sent, pair.got,
+                        std::copysign(pair.max, pair.sent));
+            ++failures;
+        }
+    }
+    if (decoded.sequence != frame.sequence || decoded.hostTime_us != frame.hostTime_us) {
+        std::printf("FAIL %-8s frame header changed\n", level);
+        ++failures;
+    }
+}
+
+template <QuantLevel L>
+static bool checkLevel(const char* level) {
+    using F = Fields<L>;
+    int before = failures;
+    checkField<typename F::Attitude>(level, "attitude", ATTITUDE_RANGE_DEG);
+    checkField<typename F::Translation>(level, "translation", TRANSLATION_RANGE_MM);
+    checkField<typename F::Rate>(level, "rate", RATE_RANGE_DEG_PER_S);
+    checkField<typename F::Force>(level, "force", FORCE_RANGE_MPS2);
+    checkFrame<L>(level);
+    std::printf("%-8s %s\n", level, failures == before ? "ok" : "FAILED");
+    return failures == before;
+}
+
+int main() {
+    bool ok = checkLevel<QuantLevel::COARSE>("COARSE");
+    ok = checkLevel<QuantLevel::STANDARD>("STANDARD") && ok;
+    ok = checkLevel<QuantLevel::FINE>("FINE") && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+// --- Seqlock stress test (host) ---
+// Runs the BNO080 driver's Seqlock.h on host threads standing in for the RTOS ones: one writer
+// publishing snapshots the way the driver thread does after each sensor packet, and several readers
+// copying them the way application threads call getSnapshot(). The snapshots are the driver's own
+// BNO080Base::SensorSnapshot (through the ShtpHarness/HostMbed shim), so the test follows its size
+// and layout. Every field of a snapshot is derived from its packet count, so a copy that mixes two
+// writes is caught by checking each field against the count it arrived with.
+//
+// --unsafe swaps the seqlock for a plain shared struct copied with memcpy, to show the check does
+// catch torn copies when they happen (on a single core they need a preemption mid-copy, so give it
+// plenty of writes).
+//
+// Usage: SeqlockStress [--writes N] [--readers R] [--unsafe]
+//   --writes   snapshots to publish                  (default 2000000)
+//   --readers  reader threads                        (default 3)
+//   --unsafe   copy without the seqlock              (default off)
+//
+// Exits 1 if a torn or out-of-order snapshot was read through the seqlock.
+
+#include "BNO080.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+using Clock = steady_clock;
+
+using Snapshot = BNO080Base::SensorSnapshot;
+
+// Fills a float field from the packet count; field numbers each float so no two are alike
+template <size_t N>
+static void fillFloats(float (&values)[N], uint32_t count, size_t& field) {
+    for (size_t i = 0; i < N; ++i, ++field) {
+        values[i] = static_cast<float>(count % 100000) + field * 0.25f;
+    }
+}
+
+static void fillFloat(float& value, uint32_t count, size_t& field) {
+    value = static_cast<float>(count % 100000) + field++ * 0.25f;
+}
+
+static void fill(Snapshot& snapshot, uint32_t count) {
+    memset(&snapshot, 0, sizeof(Snapshot));     // Padding too, so whole snapshots compare with memcmp
+    snapshot.packetCount = count;
+    size_t field = 0;
+    fillFloats(snapshot.totalAcceleration, count, field);
+    fillFloats(snapshot.linearAcceleration, count, field);
+    fillFloats(snapshot.gravityAcceleration, count, field);
+    fillFloats(snapshot.gyroRotation, count, field);
+    fillFloats(snapshot.magField, count, field);
+    fillFloats(snapshot.rotationVector, count, field);
+    fillFloat(snapshot.rotationAccuracy, count, field);
+    fillFloats(snapshot.gameRotationVector, count, field);
+    fillFloats(snapshot.geomagneticRotationVector, count, field);
+    fillFloat(snapshot.geomagneticRotationAccuracy, count, field);
+    fillFloats(snapshot.gyroIntegratedRotationVector, count, field);
+    fillFloats(snapshot.gyroIntegratedAngularVelocity, count, field);
+    snapshot.stepCount = count * 3;
+    snapshot.stability = static_cast<BNO080Base::Stability>(count % 5);
+    const size_t reports = sizeof(snapshot.reportStatus) / sizeof(snapshot.reportStatus[0]);
+    for (size_t i = 0; i < reports; ++i) {
+        snapshot.reportTimestamp[i] = count * 5000 + i;
+        snapshot.reportStatus[i] = static_cast<uint8_t>((count + i) & 3);
+    }
+}
+
+// True if every field belongs to the same write
+static bool consistent(const Snapshot& snapshot) {
+    Snapshot expected;
+    fill(expected, snapshot.packetCount);
+    return memcmp(&expected, &snapshot, sizeof(Snapshot)) == 0;
+}
+
+struct ReaderStats {
+    uint64_t reads = 0;
+    uint64_t retries = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+};
+
+int main(int argc, char** argv) {
+    uint32_t writes = 2000000;
+    int readers = 3;
+    bool unsafe = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--writes" && i + 1 < argc) {
+            writes = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--readers" && i + 1 < argc) {
+            readers = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--unsafe") {
+            unsafe = true;
+        } else {
+            std::fprintf(stderr, "Usage: SeqlockStress [--writes N] [--readers R] [--unsafe]\n");
+            return 2;
+        }
+    }
+
+    Seqlock<Snapshot> published;
+    Snapshot shared;                    // --unsafe only
+    fill(shared, 0);
+    published.write(shared);            // Readers may start before the first packet
+    std::atomic<bool> done{false};
+    std::vector<ReaderStats> stats(readers);
+    std::vector<std::thread> threads;
+
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            ReaderStats& mine = stats[r];
+            uint32_t last = 0;
+            Snapshot copy;
+            while (!done.load(std::memory_order_relaxed)) {
+                if (unsafe) {
+                    memcpy(&copy, &shared, sizeof(Snapshot));
+                } else {
+                    while (!published.tryRead(copy)) {
+                        ++mine.retries;
+                    }
+                }
+                ++mine.reads;
+                if (!consistent(copy)) {
+                    ++mine.torn;
+                } else if (copy.packetCount < last) {
+                    ++mine.backwards;
+                } else {
+                    last = copy.packetCount;
+                }
+            }
+        });
+    }
+
+    // Writer: time each publish, as the driver thread would pay it after a packet
+    Snapshot next;
+    uint64_t writeTotal_ns = 0;
+    uint64_t writeMax_ns = 0;
+    for (uint32_t count = 1; count <= writes; ++count) {
+        fill(next, count);
+        auto start = Clock::now();
+        if (unsafe) {
+            memcpy(&shared, &next, sizeof(Snapshot));
+        } else {
+            published.write(next);
+        }
+        uint64_t ns = static_cast<uint64_t>(duration_cast<nanoseconds>(Clock::now() - start).count());
+        writeTotal_ns += ns;
+        writeMax_ns = std::max(writeMax_ns, ns);
+    }
+    done = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ReaderStats total;
+    for (const auto& s : stats) {
+        total.reads += s.reads;
+        total.retries += s.retries;
+        total.torn += s.torn;
+        total.backwards += s.backwards;
+    }
+
+    std::printf("Mode:              %s\n", unsafe ? "unsafe memcpy" : "seqlock");
+    std::printf("Snapshot size:     %zu bytes\n", sizeof(Snapshot));
+    std::printf("Writes:            %u\n", writes);
+    std::printf("Write time:        %.1f ns mean, %.1f us max\n",
+                static_cast<double>(writeTotal_ns) / writes, writeMax_ns / 1000.0);
+    std::printf("Readers:           %d\n", readers);
+    std::printf("Reads:             %llu\n", static_cast<unsigned long long>(total.reads));
+    std::printf("Read retries:      %llu\n", static_cast<unsigned long long>(total.retries));
+    std::printf("Torn reads:        %llu\n", static_cast<unsigned long long>(total.torn));
+    std::printf("Out-of-order:      %llu\n", static_cast<unsigned long long>(total.backwards));
+
+    return (!unsafe && (total.torn || total.backwards)) ? 1 : 0;
+}
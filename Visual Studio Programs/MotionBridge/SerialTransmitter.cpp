@@ -0,0 +1,391 @@
+#include "SerialTransmitter.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+SerialTransmitter::SerialTransmitter(size_t bufferSize)
+    : buffer(bufferSize)
+{
+}
+
+SerialTransmitter::~SerialTransmitter() {
+    close();
+}
+
+#ifndef _WIN32
+
+// Maps a numeric baud rate onto the termios speed constant
+static bool baudToSpeed(int baudRate, speed_t& speed) {
+    switch (baudRate) {
+        case 9600:   speed = B9600;   return true;
+        case 19200:  speed = B19200;  return true;
+        case 38400:  speed = B38400;  return true;
+        case 57600:  speed = B57600;  return true;
+        case 115200: speed = B115200; return true;
+        case 230400: speed = B230400; return true;
+#ifdef B460800
+        case 460800: speed = B460800; return true;
+#endif
+#ifdef B921600
+        case 921600: speed = B921600; return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+bool SerialTransmitter::open(const std::string& device, int baudRate) {
+    close();
+
+    speed_t speed;
+    if (!baudToSpeed(baudRate, speed)) {
+        std::cerr << "Unsupported baud rate " << baudRate << std::endl;
+        return false;
+    }
+
+    // O_NONBLOCK so write() never stalls the caller; O_NOCTTY so the port can't become our terminal
+    fd = ::open(device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        std::cerr << "Error opening " << device << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Configure Serial Port: raw 8N1, no flow control
+    termios tty;
+    if (tcgetattr(fd, &tty) != 0) {
+        std::cerr << "Error getting " << device << " state: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    cfmakeraw(&tty);
+    tty.c_cflag |= (CLOCAL | CREAD);
+    tty.c_cflag &= ~(CSTOPB | PARENB);
+#ifdef CRTSCTS
+    tty.c_cflag &= ~CRTSCTS;
+#endif
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        std::cerr << "Error setting " << device << " parameters: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    byteTime_s = 10.0 / baudRate; // 8N1: start + 8 data + stop bits
+    lineIdleAt = std::chrono::steady_clock::now();
+    return true;
+}
+
+void SerialTransmitter::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    head = tail = 0;
+    coalesceOffset = NO_FRAME;
+}
+
+bool SerialTransmitter::isOpen() const {
+    return fd >= 0;
+}
+
+long SerialTransmitter::writeSome(const uint8_t* data, size_t length) {
+    ssize_t written = ::write(fd, data, length);
+    if (written < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0; // Driver buffer is full, try again later
+        }
+        std::cerr << "Error writing to serial port: " << strerror(errno) << std::endl;
+        return -1;
+    }
+    return static_cast<long>(written);
+}
+
+size_t SerialTransmitter::osQueued() const {
+#ifdef TIOCOUTQ
+    int queued = 0;
+    if (ioctl(fd, TIOCOUTQ, &queued) == 0 && queued > 0) {
+        return static_cast<size_t>(queued);
+    }
+#endif
+    return 0;
+}
+
+long SerialTransmitter::read(uint8_t* data, size_t length) {
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t count = ::read(fd, data, length);
+    if (count < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0; // Nothing waiting
+        }
+        std::cerr << "Error reading from serial port: " << strerror(errno) << std::endl;
+        return -1;
+    }
+    return static_cast<long>(count);
+}
+
+bool SerialTransmitter::flushBlocking(std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (pending() > 0) {
+        if (flush() < 0) {
+            return false;
+        }
+        if (pending() == 0) {
+            break;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            return false;
+        }
+
+        // Sleep until the driver has room again instead of spinning
+        if (driverQueueLimit > 0 && driverQueued() >= driverQueueLimit) {
+            std::this_thread::sleep_for(std::min(remaining, std::chrono::milliseconds(1)));
+        } else {
+            pollfd pfd = { fd, POLLOUT, 0 };
+            poll(&pfd, 1, static_cast<int>(remaining.count()));
+        }
+    }
+    return true;
+}
+
+#else // _WIN32
+
+bool SerialTransmitter::open(const std::string& device, int baudRate) {
+    close();
+
+    if (baudRate <= 0 || baudRate > MAX_BAUD_RATE) {
+        std::cerr << "Unsupported baud rate " << baudRate << std::endl;
+        return false;
+    }
+
+    // "\\.\" prefix is needed for COM10 and up, and harmless below that
+    std::string path = "\\\\.\\" + device;
+    handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error opening " << device << std::endl;
+        return false;
+    }
+
+    // Configure Serial Port
+    DCB dcbSerialParams = { 0 };
+    dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
+    if (!GetCommState(handle, &dcbSerialParams)) {
+        std::cerr << "Error getting " << device << " state" << std::endl;
+        close();
+        return false;
+    }
+
+    dcbSerialParams.BaudRate = static_cast<DWORD>(baudRate);
+    dcbSerialParams.ByteSize = 8;
+    dcbSerialParams.StopBits = ONESTOPBIT;
+    dcbSerialParams.Parity = NOPARITY;
+    dcbSerialParams.fOutxCtsFlow = FALSE;
+    dcbSerialParams.fRtsControl = RTS_CONTROL_DISABLE;
+
+    if (!SetCommState(handle, &dcbSerialParams)) {
+        std::cerr << "Error setting " << device << " parameters" << std::endl;
+        close();
+        return false;
+    }
+
+    // Make WriteFile return almost immediately with whatever the driver accepted,
+    // which gives us the same non-blocking behaviour as O_NONBLOCK on Linux.
+    COMMTIMEOUTS timeouts = { 0 };
+    timeouts.ReadIntervalTimeout = MAXDWORD;
+    timeouts.WriteTotalTimeoutConstant = 1;
+    timeouts.WriteTotalTimeoutMultiplier = 0;
+    SetCommTimeouts(handle, &timeouts);
+
+    byteTime_s = 10.0 / baudRate; // 8N1: start + 8 data + stop bits
+    lineIdleAt = std::chrono::steady_clock::now();
+    return true;
+}
+
+void SerialTransmitter::close() {
+    if (handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(handle);
+        handle = INVALID_HANDLE_VALUE;
+    }
+    head = tail = 0;
+    coalesceOffset = NO_FRAME;
+}
+
+bool SerialTransmitter::isOpen() const {
+    return handle != INVALID_HANDLE_VALUE;
+}
+
+long SerialTransmitter::writeSome(const uint8_t* data, size_t length) {
+    DWORD bytesWritten = 0;
+    if (!WriteFile(handle, data, static_cast<DWORD>(length), &bytesWritten, NULL)) {
+        std::cerr << "Error writing to serial port" << std::endl;
+        return -1;
+    }
+    return static_cast<long>(bytesWritten);
+}
+
+size_t SerialTransmitter::osQueued() const {
+    DWORD errors = 0;
+    COMSTAT status = { 0 };
+    if (ClearCommError(handle, &errors, &status)) {
+        return static_cast<size_t>(status.cbOutQue);
+    }
+    return 0;
+}
+
+long SerialTransmitter::read(uint8_t* data, size_t length) {
+    if (handle == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+    // ReadIntervalTimeout = MAXDWORD with zero totals makes ReadFile return immediately
+    DWORD bytesRead = 0;
+    if (!ReadFile(handle, data, static_cast<DWORD>(length), &bytesRead, NULL)) {
+        std::cerr << "Error reading from serial port" << std::endl;
+        return -1;
+    }
+    return static_cast<long>(bytesRead);
+}
+
+bool SerialTransmitter::flushBlocking(std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (pending() > 0) {
+        if (flush() < 0) {
+            return false;
+        }
+        if (pending() > 0) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            // WriteFile already waits up to WriteTotalTimeoutConstant for room, but a capped
+            // flush never calls it
+            if (driverQueueLimit > 0 && driverQueued() >= driverQueueLimit) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+    return true;
+}
+
+#endif // _WIN32
+
+size_t SerialTransmitter::driverQueued() const {
+    size_t onLine = 0;
+    auto now = std::chrono::steady_clock::now();
+    if (byteTime_s > 0.0 && lineIdleAt > now) {
+        onLine = static_cast<size_t>(std::chrono::duration<double>(lineIdleAt - now).count() / byteTime_s + 0.5);
+    }
+    return std::max(onLine, osQueued());
+}
+
+void SerialTransmitter::compact() {
+    if (head == 0) {
+        return;
+    }
+    size_t count = tail - head;
+    memmove(buffer.data(), buffer.data() + head, count);
+    if (coalesceOffset != NO_FRAME) {
+        coalesceOffset -= head;
+    }
+    head = 0;
+    tail = count;
+}
+
+SerialTransmitter::QueueResult SerialTransmitter::queueFrame(const uint8_t* frame, size_t length, bool coalescible) {
+    if (!isOpen()) {
+        ++counters.framesDropped;
+        return QueueResult::DROPPED;
+    }
+
+    // The previous coalescible frame is only safe to overwrite if none of it has gone out yet
+    if (coalescible && coalesceOffset != NO_FRAME && coalesceOffset >= head && coalesceLength == length) {
+        memcpy(buffer.data() + coalesceOffset, frame, length);
+        ++counters.framesCoalesced;
+        return QueueResult::COALESCED;
+    }
+
+    if (buffer.size() - tail < length) {
+        compact();
+        if (buffer.size() - tail < length) {
+            ++counters.framesDropped;
+            return QueueResult::DROPPED;
+        }
+    }
+
+    memcpy(buffer.data() + tail, frame, length);
+    if (coalescible) {
+        coalesceOffset = tail;
+        coalesceLength = length;
+    }
+    tail += length;
+    ++counters.framesQueued;
+    return QueueResult::QUEUED;
+}
+
+long SerialTransmitter::flush() {
+    if (!isOpen()) {
+        return -1;
+    }
+    if (pending() == 0) {
+        return 0;
+    }
+
+    // One write for everything queued since the last flush (this is the batching), but only as
+    // much as fits under the driver queue cap. The rest stays here where it can still be coalesced.
+    size_t length = pending();
+    if (driverQueueLimit > 0) {
+        size_t queued = driverQueued();
+        size_t room = queued < driverQueueLimit ? driverQueueLimit - queued : 0;
+        if (room < length) {
+            ++counters.throttled;
+            length = room;
+            if (length == 0) {
+                return 0;
+            }
+        }
+    }
+
+    long written = writeSome(buffer.data() + head, length);
+    ++counters.writeCalls;
+    if (written < 0) {
+        return -1;
+    }
+    if (written == 0) {
+        ++counters.wouldBlock;
+        return 0;
+    }
+
+    head += static_cast<size_t>(written);
+    counters.bytesWritten += static_cast<uint64_t>(written);
+
+    // The wire picks up where the last write's bytes finish, or now if it has gone idle
+    auto now = std::chrono::steady_clock::now();
+    if (lineIdleAt < now) {
+        lineIdleAt = now;
+    }
+    lineIdleAt += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(written * byteTime_s));
+
+    // Once the coalescing target has started going out it can no longer be overwritten
+    if (coalesceOffset != NO_FRAME && coalesceOffset < head) {
+        coalesceOffset = NO_FRAME;
+    }
+    if (head == tail) {
+        head = tail = 0;
+    }
+    return written;
+}
@@ -0,0 +1,137 @@
+#ifndef SERIAL_TRANSMITTER_HPP
+#define SERIAL_TRANSMITTER_HPP
+
+// --- Host Serial Transmitter ---
+// Keeps the serial port open for the lifetime of the bridge (COM testing's sendByteToCOM3()
+// reopened and reconfigured COM3 for every byte) and sends MotionLink frames through a
+// fixed-size outgoing buffer:
+//
+// - Batching: frames queued between two flush() calls go out in a single write().
+// - Coalescing: a motion frame that hasn't started transmitting yet is overwritten in place by
+//   a newer one, so a slow link carries the freshest pose instead of a backlog of stale ones.
+// - Non-blocking writes: flush() writes whatever the driver accepts right now and returns.
+// - Driver queue cap: flush() hands the OS at most about one frame that hasn't reached the wire
+//   yet. Anything the driver holds can't be coalesced any more, so letting it soak up the whole
+//   backlog (4 kB on Linux) turns an overloaded link into a second-long delay line.
+// - Backpressure: when the buffer is full, queueFrame() refuses the frame (DROPPED) instead of
+//   blocking the caller, and the caller can watch pending() / the stats.
+//
+// Linux/macOS use termios, Windows uses the Win32 comm API. Baud rates up to 921600 are
+// supported where the OS driver supports them.
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+class SerialTransmitter {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 4096;
+    static constexpr int MAX_BAUD_RATE = 921600;
+    static constexpr size_t DEFAULT_DRIVER_QUEUE_LIMIT = 64;   // About one FINE motion frame
+
+    enum class QueueResult {
+        QUEUED,     // Appended to the outgoing buffer
+        COALESCED,  // Replaced an older motion frame that hadn't been sent yet
+        DROPPED     // Buffer full (backpressure) or port closed
+    };
+
+    // Running counters, handy for spotting a link that can't keep up
+    struct Stats {
+        uint64_t framesQueued = 0;
+        uint64_t framesCoalesced = 0;
+        uint64_t framesDropped = 0;
+        uint64_t bytesWritten = 0;
+        uint64_t writeCalls = 0;
+        uint64_t wouldBlock = 0;    // write() calls that accepted nothing because the driver was full
+        uint64_t throttled = 0;     // flush() calls that held data back because the driver queue was at its cap
+    };
+
+    explicit SerialTransmitter(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~SerialTransmitter();
+
+    SerialTransmitter(const SerialTransmitter&) = delete;
+    SerialTransmitter& operator=(const SerialTransmitter&) = delete;
+
+    // --- Port control ---
+    // device is e.g. "/dev/ttyACM0" on Linux or "COM3" on Windows. Returns false on error.
+    bool open(const std::string& device, int baudRate);
+    void close();
+    bool isOpen() const;
+
+    // --- Sending ---
+    // Queues a complete wire frame. Set coalescible for frames where only the newest matters
+    // (motion frames); leave it false for frames that must all arrive (commands, replies).
+    QueueResult queueFrame(const uint8_t* frame, size_t length, bool coalescible);
+
+    // Non-blocking. Writes as much of the pending data as the port accepts right now.
+    // Returns the number of bytes written, or -1 on a port error.
+    long flush();
+
+    // Keeps flushing until everything pending has been written or the timeout expires.
+    // Returns true if the buffer was fully drained.
+    bool flushBlocking(std::chrono::milliseconds timeout);
+
+    // --- Receiving ---
+    // Replies and telemetry from the platform come back on the same port. Non-blocking: returns
+    // the number of bytes read (0 if nothing is waiting), or -1 on a port error.
+    long read(uint8_t* data, size_t length);
+
+    // Bytes queued but not yet accepted by the driver
+    size_t pending() const { return tail - head; }
+
+    // Most bytes flush() lets sit in the OS driver before the wire has taken them; 0 removes the cap
+    void setDriverQueueLimit(size_t bytes) { driverQueueLimit = bytes; }
+
+    // Bytes written to the driver that haven't gone out on the wire yet. The larger of what the
+    // driver reports and what the baud rate could have sent since the last writes, because some
+    // drivers (ptys, many USB serial adapters) always report an empty queue.
+    size_t driverQueued() const;
+
+    const Stats& stats() const { return counters; }
+
+#ifdef _WIN32
+    HANDLE nativeHandle() const { return handle; }
+#else
+    int nativeHandle() const { return fd; }
+#endif
+
+private:
+    // Writes up to length bytes without blocking. Returns bytes written, 0 if the driver is
+    // full, -1 on error.
+    long writeSome(const uint8_t* data, size_t length);
+
+    // Moves pending bytes to the start of the buffer to make room at the end
+    void compact();
+
+    // Output queue size as reported by the OS, 0 where it can't tell
+    size_t osQueued() const;
+
+    std::vector<uint8_t> buffer;
+    size_t head = 0;    // First byte not yet written to the port
+    size_t tail = 0;    // One past the last queued byte
+
+    // Last coalescible frame that is still entirely unsent, or NO_FRAME
+    static constexpr size_t NO_FRAME = static_cast<size_t>(-1);
+    size_t coalesceOffset = NO_FRAME;
+    size_t coalesceLength = 0;
+
+    Stats counters;
+
+    size_t driverQueueLimit = DEFAULT_DRIVER_QUEUE_LIMIT;
+    double byteTime_s = 0.0;                            // One 8N1 character at the open baud rate
+    std::chrono::steady_clock::time_point lineIdleAt;   // When the wire will have sent everything written
+
+#ifdef _WIN32
+    HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+};
+
+#endif // SERIAL_TRANSMITTER_HPP
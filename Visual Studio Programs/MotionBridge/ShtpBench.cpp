@@ -0,0 +1,143 @@
+// --- BNO080 SHTP replay bench (host) ---
+// Runs the BNO080 driver (mbed programs/IMU/BNO080x/BNO080.cpp, unmodified) on Linux against a
+// fake IMU that replays SHTP packets over the host I2C stand-in (ShtpHarness/), and measures how
+// fast the driver gets through them: updateData() -> receivePacket() -> processPacket() ->
+// parseSensorDataPacket(), with the samples drained from the driver's queue as the application
+// would. Use it to check and time parser changes without the chip.
+//
+// Packets come from a capture (raw SHTP packets back to back, as read off the I2C bus) or are
+// generated: batched sensor data packets with several report types and timestamp rebases, or with
+// --gyro-rv the one-sample gyro-integrated rotation vector packets the IMU sends at up to 1kHz.
+// --save writes the generated stream out, e.g. as a seed for ShtpFuzz.
+//
+// Usage: ShtpBench [--capture FILE] [--gyro-rv] [--packets N] [--reports R] [--rounds K] [--save FILE] [--verbose]
+//   --capture  replay this stream instead of generating one
+//   --gyro-rv  generate gyro-integrated rotation vector packets instead
+//   --packets  generated packets                    (default 200)
+//   --reports  sensor reports per generated packet  (default 8)
+//   --rounds   passes over the stream               (default 2000)
+//   --save     write the stream to FILE and exit
+//   --verbose  show the driver's debug output
+//
+// Exits 1 if the driver didn't take in every packet or produced no samples from a valid stream.
+
+#include "ShtpHarness/ShtpReplay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+using namespace ShtpHarness;
+using Clock = steady_clock;
+
+int main(int argc, char** argv) {
+    const char* capturePath = nullptr;
+    const char* savePath = nullptr;
+    int packetCount = 200;
+    int reports = 8;
+    int rounds = 2000;
+    bool verbose = false;
+    bool gyroRotation = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--capture" && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (arg == "--gyro-rv") {
+            gyroRotation = true;
+        } else if (arg == "--packets" && i + 1 < argc) {
+            packetCount = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--reports" && i + 1 < argc) {
+            reports = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--save" && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else {
+            std::fprintf(stderr, "Usage: ShtpBench [--capture FILE] [--gyro-rv] [--packets N] [--reports R] [--rounds K] [--save FILE] [--verbose]\n");
+            return 2;
+        }
+    }
+
+    std::vector<Packet> packets;
+    if (capturePath) {
+        std::vector<uint8_t> stream;
+        if (!readFile(capturePath, stream)) {
+            std::fprintf(stderr, "Can't read %s\n", capturePath);
+            return 2;
+        }
+        packets = splitPackets(stream.data(), stream.size());
+    } else if (gyroRotation) {
+        packets = gyroRotationPackets(packetCount, 1234);
+    } else {
+        packets = syntheticPackets(packetCount, reports, 1234);
+    }
+
+    if (savePath) {
+        if (!writeFile(savePath, joinPackets(packets))) {
+            std::fprintf(stderr, "Can't write %s\n", savePath);
+            return 2;
+        }
+        std::printf("Wrote %zu packets to %s\n", packets.size(), savePath);
+        return 0;
+    }
+
+    size_t streamBytes = joinPackets(packets).size();
+    size_t reportsPerRound = countReports(packets);
+
+    Stream debug(!verbose);
+    FakeShtpDevice device;
+    BNO080I2C imu(&debug, SDA_PIN, SCL_PIN, INT_PIN, RST_PIN);
+
+    // Warm up, and check one pass takes in everything
+    device.load(packets);
+    runToIdle(imu, device, packets.size() * 4 + 16);
+    bool consumed = device.idle();
+
+    BNO080Base::Sample sample;
+    unsigned long samples = 0;
+    while (imu.readSample(sample)) {
+        ++samples;
+    }
+
+    auto start = Clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        device.load(packets);
+        runToIdle(imu, device, packets.size() * 4 + 16);
+        while (imu.readSample(sample)) {
+            ++samples;
+        }
+    }
+    double elapsed_s = duration<double>(Clock::now() - start).count();
+
+    BNO080Base::SensorSnapshot snapshot;
+    imu.getSnapshot(snapshot);
+
+    double passes = static_cast<double>(rounds);
+    std::printf("Stream:            %zu packets, %zu bytes, %zu reports\n", packets.size(), streamBytes, reportsPerRound);
+    std::printf("Rounds:            %d in %.3f s\n", rounds, elapsed_s);
+    std::printf("Packets/s:         %.0f\n", passes * packets.size() / elapsed_s);
+    std::printf("Reports/s:         %.0f (%.1f ns/report)\n", passes * reportsPerRound / elapsed_s,
+                reportsPerRound ? elapsed_s * 1e9 / (passes * reportsPerRound) : 0.0);
+    std::printf("Throughput:        %.1f MB/s\n", passes * streamBytes / elapsed_s / 1e6);
+    std::printf("Samples drained:   %lu (%lu dropped from the queue)\n", samples,
+                static_cast<unsigned long>(imu.getDroppedSampleCount()));
+    std::printf("Packets published: %lu\n", static_cast<unsigned long>(snapshot.packetCount));
+    std::printf("Driver messages:   %lu\n", debug.printed());
+
+    if (!consumed) {
+        std::printf("FAIL: the driver stopped reading before the end of the stream\n");
+        return 1;
+    }
+    if (reportsPerRound > 0 && samples == 0) {
+        std::printf("FAIL: no samples from a stream with sensor reports\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,191 @@
+// --- BNO080 SHTP fuzz target (host) ---
+// Feeds arbitrary bytes to the BNO080 driver as the SHTP packet stream coming off the I2C bus
+// (through the fake IMU in ShtpHarness/), so every header length, channel, report ID and report
+// size the chip could send, truncated or not, goes through receivePacket(), processPacket() and
+// parseSensorDataPacket(). Then reads everything back through the public API. Build it with
+// sanitizers: a crash, a sanitizer report, or the driver stalling before the end of the stream
+// is a bug.
+//
+// With clang, it is a libFuzzer target:
+//   clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined -IShtpHarness/HostMbed
+//       -I"../../mbed programs/IMU/BNO080x" ShtpFuzz.cpp "../../mbed programs/IMU/BNO080x/BNO080.cpp"
+//   ./ShtpFuzz corpus/          (seed corpus/ with ShtpBench --save corpus/synthetic.bin)
+//
+// Without libFuzzer, build with -DSHTP_FUZZ_STANDALONE (g++ is fine) for a small built-in
+// mutation fuzzer over the same entry point, seeded with generated packets and any files given:
+//
+// Usage: ShtpFuzz [--runs N] [--seed S] [--save-crash FILE] [FILES...]
+//   --runs        mutated inputs to try              (default 200000)
+//   --seed        random seed                        (default 1)
+//   --save-crash  write each input here before running it, so the one that crashed is kept
+//   FILES         replayed as they are, then used as extra seeds
+
+#include "ShtpHarness/ShtpReplay.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using namespace ShtpHarness;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static Stream quiet(true);
+
+    std::vector<Packet> packets = splitPackets(data, size);
+    FakeShtpDevice device;
+    BNO080I2C imu(&quiet, SDA_PIN, SCL_PIN, INT_PIN, RST_PIN);
+
+    BNO080Base::Sample sample;
+    BNO080::SampleRing<8> ring;
+    imu.attachSampleRing(BNO080Base::GAME_ROTATION, ring);
+    BNO080::SampleRing<4> gyroRing;
+    imu.attachSampleRing(BNO080Base::GYRO_INTEGRATED_ROTATION, gyroRing);
+
+    device.load(packets);
+    size_t maxCalls = packets.size() * 4 + 16;
+    size_t calls = 0;
+    while (!device.idle() && calls < maxCalls) {
+        imu.updateData();
+        ++calls;
+        while (imu.readSample(sample) || ring.pop(sample) || gyroRing.pop(sample)) {
+        }
+    }
+    if (!device.idle()) {
+        // the driver stopped reading with packets still waiting
+        __builtin_trap();
+    }
+
+    BNO080Base::SensorSnapshot snapshot;
+    imu.getSnapshot(snapshot);
+    for (uint8_t report = 0; report <= MAX_SENSOR_REPORTID; ++report) {
+        imu.getReportStatus(static_cast<BNO080Base::Report>(report));
+        imu.getReportTimestamp(static_cast<BNO080Base::Report>(report));
+        imu.hasNewData(static_cast<BNO080Base::Report>(report));
+    }
+    if (imu.getQueuedSampleCount() > SAMPLE_QUEUE_LEN || ring.size() > ring.capacity()) {
+        __builtin_trap();
+    }
+    return 0;
+}
+
+#ifdef SHTP_FUZZ_STANDALONE
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+// One random edit, biased towards the bytes SHTP cares about
+static void mutate(std::vector<uint8_t>& input, std::mt19937& rng) {
+    static const uint8_t interesting[] = { 0x00, 0x01, 0x03, 0x04, 0x05, 0x7F, 0x80, 0xFF,
+                                           CHANNEL_REPORTS, CHANNEL_WAKE_REPORTS, CHANNEL_CONTROL, CHANNEL_GYRO,
+                                           SHTP_REPORT_BASE_TIMESTAMP, SENSOR_REPORTID_TIMESTAMP_REBASE,
+                                           SENSOR_REPORTID_TAP_DETECTOR, SENSOR_REPORTID_STEP_COUNTER,
+                                           SENSOR_REPORTID_SHAKE_DETECTOR, SENSOR_REPORTID_ROTATION_VECTOR,
+                                           SENSOR_REPORTID_RAW_ACCELEROMETER, SENSOR_REPORTID_RAW_GYROSCOPE };
+    auto pick = [&](size_t n) { return n ? std::uniform_int_distribution<size_t>(0, n - 1)(rng) : 0; };
+
+    switch (pick(7)) {
+        case 0:     // flip a bit
+            if (!input.empty()) {
+                input[pick(input.size())] ^= static_cast<uint8_t>(1 << pick(8));
+            }
+            break;
+        case 1:     // random byte
+            if (!input.empty()) {
+                input[pick(input.size())] = static_cast<uint8_t>(rng());
+            }
+            break;
+        case 2:     // interesting byte
+            if (!input.empty()) {
+                input[pick(input.size())] = interesting[pick(sizeof(interesting))];
+            }
+            break;
+        case 3: {   // insert random bytes
+            size_t at = pick(input.size() + 1);
+            size_t count = 1 + pick(16);
+            for (size_t i = 0; i < count; ++i) {
+                input.insert(input.begin() + at, static_cast<uint8_t>(rng()));
+            }
+            break;
+        }
+        case 4: {   // delete a range
+            if (!input.empty()) {
+                size_t at = pick(input.size());
+                size_t count = 1 + pick(std::min<size_t>(32, input.size() - at));
+                input.erase(input.begin() + at, input.begin() + at + count);
+            }
+            break;
+        }
+        case 5: {   // duplicate a range
+            if (!input.empty()) {
+                size_t at = pick(input.size());
+                size_t count = 1 + pick(std::min<size_t>(64, input.size() - at));
+                std::vector<uint8_t> copy(input.begin() + at, input.begin() + at + count);
+                input.insert(input.begin() + pick(input.size() + 1), copy.begin(), copy.end());
+            }
+            break;
+        }
+        default:    // new 16-bit length somewhere
+            if (input.size() >= 2) {
+                size_t at = pick(input.size() - 1);
+                uint16_t length = static_cast<uint16_t>(pick(2) ? pick(600) : rng());
+                input[at] = static_cast<uint8_t>(length & 0xFF);
+                input[at + 1] = static_cast<uint8_t>(length >> 8);
+            }
+            break;
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned long runs = 200000;
+    uint32_t seed = 1;
+    const char* crashPath = nullptr;
+    std::vector<std::vector<uint8_t>> seeds;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) {
+            runs = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--save-crash" && i + 1 < argc) {
+            crashPath = argv[++i];
+        } else if (arg.rfind("--", 0) == 0) {
+            std::fprintf(stderr, "Usage: ShtpFuzz [--runs N] [--seed S] [--save-crash FILE] [FILES...]\n");
+            return 2;
+        } else {
+            std::vector<uint8_t> file;
+            if (!readFile(argv[i], file)) {
+                std::fprintf(stderr, "Can't read %s\n", argv[i]);
+                return 2;
+            }
+            LLVMFuzzerTestOneInput(file.data(), file.size());
+            seeds.push_back(file);
+        }
+    }
+    std::printf("Replayed %zu file(s)\n", seeds.size());
+
+    seeds.push_back(joinPackets(syntheticPackets(4, 3, seed)));
+    seeds.push_back(joinPackets(syntheticPackets(2, 40, seed + 1)));
+    seeds.push_back(joinPackets(gyroRotationPackets(4, seed + 2)));
+    seeds.push_back({});
+
+    std::mt19937 rng(seed);
+    size_t largest = 0;
+    for (unsigned long run = 0; run < runs; ++run) {
+        std::vector<uint8_t> input = seeds[rng() % seeds.size()];
+        int edits = 1 + static_cast<int>(rng() % 8);
+        for (int edit = 0; edit < edits; ++edit) {
+            mutate(input, rng);
+        }
+        if (crashPath) {
+            writeFile(crashPath, input);
+        }
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+        largest = std::max(largest, input.size());
+    }
+    std::printf("Ran %lu mutated inputs (up to %zu bytes), no failures\n", runs, largest);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef SHTP_HARNESS_HOST_STREAM_H
+#define SHTP_HARNESS_HOST_STREAM_H
+
+// --- Host stand-in for mbed's Stream ---
+// The BNO080 driver only printf()s to its debug port. Output goes to stderr, or nowhere when
+// quiet (the fuzzer and benchmark feed it garbage on purpose and would drown in error messages).
+
+#include <cstdarg>
+#include <cstdio>
+
+class Stream {
+public:
+    explicit Stream(bool quiet = false) : quiet(quiet) {}
+    virtual ~Stream() {}
+
+    int printf(const char* format, ...) {
+        ++lines;
+        if (quiet) {
+            return 0;
+        }
+        va_list args;
+        va_start(args, format);
+        int written = std::vfprintf(stderr, format, args);
+        va_end(args);
+        return written;
+    }
+
+    // Host only: how many messages the driver has printed
+    unsigned long printed() const { return lines; }
+
+private:
+    bool quiet;
+    unsigned long lines = 0;
+};
+
+#endif // SHTP_HARNESS_HOST_STREAM_H
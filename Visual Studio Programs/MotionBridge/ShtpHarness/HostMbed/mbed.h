@@ -0,0 +1,191 @@
+#ifndef SHTP_HARNESS_HOST_MBED_H
+#define SHTP_HARNESS_HOST_MBED_H
+
+// --- Host stand-in for the parts of mbed.h the BNO080 driver uses ---
+// Just enough of Mbed OS 6 to compile BNO080x/BNO080.cpp on Linux for the SHTP replay bench and
+// fuzzer. Interrupt pins are levels the harness drives with HostPins::setLevel() (pulling one low
+// runs its fall handler, as the real edge interrupt does); clocks come from steady_clock; delays
+// return at once. I2C transfers go to whatever HostI2CDevice is attached to the bus, and fail
+// when there is none; SPI has no chip on it. No RTOS: the async drivers (BNO080Async.cpp) are
+// not built on the host.
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+
+using namespace std::chrono_literals;
+
+#define MBED_ASSERT(expr) ((void)0)
+
+typedef int PinName;
+constexpr PinName NC = -1;
+
+// us_ticker clock: microseconds since start, wrapping at 32 bits like the real one
+inline uint32_t us_ticker_read() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now() - start).count());
+}
+
+inline void wait_us(int) {}
+
+inline void core_util_critical_section_enter() {}
+inline void core_util_critical_section_exit() {}
+
+namespace ThisThread {
+inline void sleep_for(std::chrono::milliseconds) {}
+}
+
+template <typename F>
+F callback(F f) { return f; }
+
+template <typename T, typename R, typename... Args>
+std::function<R(Args...)> callback(T* object, R (T::*method)(Args...)) {
+    return [object, method](Args... args) { return (object->*method)(args...); };
+}
+
+class Timer {
+public:
+    void start() { if (!running) { begin = std::chrono::steady_clock::now(); running = true; } }
+    void stop() { if (running) { total += std::chrono::steady_clock::now() - begin; running = false; } }
+    void reset() { total = {}; begin = std::chrono::steady_clock::now(); }
+    std::chrono::microseconds elapsed_time() const {
+        auto sum = total + (running ? std::chrono::steady_clock::now() - begin : std::chrono::steady_clock::duration{});
+        return std::chrono::duration_cast<std::chrono::microseconds>(sum);
+    }
+private:
+    std::chrono::steady_clock::time_point begin{};
+    std::chrono::steady_clock::duration total{};
+    bool running = false;
+};
+
+class DigitalOut {
+public:
+    DigitalOut(PinName, int value = 0) : level(value) {}
+    DigitalOut& operator=(int value) { level = value; return *this; }
+    int read() const { return level; }
+    operator int() const { return level; }
+private:
+    int level;
+};
+
+class InterruptIn {
+public:
+    explicit InterruptIn(PinName pin) : pin(pin) { registry()[pin] = this; }
+    ~InterruptIn() { registry().erase(pin); }
+    InterruptIn(const InterruptIn&) = delete;
+    InterruptIn& operator=(const InterruptIn&) = delete;
+
+    int read() const { return level; }
+    operator int() const { return level; }
+    void fall(std::function<void()> handler) { onFall = handler; }
+    void rise(std::function<void()> handler) { onRise = handler; }
+
+    // Host only: drive the pin, running the edge handler as the interrupt would
+    void hostSetLevel(int value) {
+        if (value == level) {
+            return;
+        }
+        level = value;
+        auto& handler = value ? onRise : onFall;
+        if (handler) {
+            handler();
+        }
+    }
+
+    static std::map<PinName, InterruptIn*>& registry() {
+        static std::map<PinName, InterruptIn*> pins;
+        return pins;
+    }
+
+private:
+    PinName pin;
+    int level = 1;
+    std::function<void()> onFall, onRise;
+};
+
+// Host only: what is on the other end of the wires
+namespace HostPins {
+inline void setLevel(PinName pin, int level) {
+    auto found = InterruptIn::registry().find(pin);
+    if (found != InterruptIn::registry().end()) {
+        found->second->hostSetLevel(level);
+    }
+}
+}
+
+class HostI2CDevice {
+public:
+    virtual ~HostI2CDevice() {}
+    // A read or write transaction of length bytes; false to NACK it
+    virtual bool read(uint8_t* data, int length) = 0;
+    virtual bool write(const uint8_t* data, int length) = 0;
+};
+
+namespace HostBus {
+inline HostI2CDevice*& i2cDevice() {
+    static HostI2CDevice* device = nullptr;
+    return device;
+}
+}
+
+typedef std::function<void(int)> event_callback_t;
+
+#define I2C_EVENT_ERROR               (1 << 1)
+#define I2C_EVENT_ERROR_NO_SLAVE      (1 << 2)
+#define I2C_EVENT_TRANSFER_COMPLETE   (1 << 3)
+#define I2C_EVENT_TRANSFER_EARLY_NACK (1 << 4)
+#define I2C_EVENT_ALL (I2C_EVENT_ERROR | I2C_EVENT_TRANSFER_COMPLETE | I2C_EVENT_ERROR_NO_SLAVE | I2C_EVENT_TRANSFER_EARLY_NACK)
+
+#define SPI_EVENT_ERROR    (1 << 1)
+#define SPI_EVENT_COMPLETE (1 << 2)
+#define SPI_EVENT_ALL      (SPI_EVENT_ERROR | SPI_EVENT_COMPLETE)
+
+// One device per bus, no address decoding; 0 on success as mbed's I2C
+class I2C {
+public:
+    I2C(PinName, PinName) {}
+    void frequency(int) {}
+    int read(int, char* data, int length, bool = false) {
+        HostI2CDevice* device = HostBus::i2cDevice();
+        return device && device->read(reinterpret_cast<uint8_t*>(data), length) ? 0 : 1;
+    }
+    int write(int, const char* data, int length, bool = false) {
+        HostI2CDevice* device = HostBus::i2cDevice();
+        return device && device->write(reinterpret_cast<const uint8_t*>(data), length) ? 0 : 1;
+    }
+    int transfer(int, const char*, int, char*, int, const event_callback_t&, int = I2C_EVENT_TRANSFER_COMPLETE, bool = false) { return -1; }
+};
+
+#define use_gpio_ssel 0
+
+// Nothing on the bus: reads come back as 0xFF
+class SPI {
+public:
+    SPI(PinName, PinName, PinName, PinName, int = 0) {}
+    void frequency(int) {}
+    void format(int, int = 0) {}
+    void set_default_write_value(char) {}
+    int write(const char*, int, char* rx, int rxLength) { memset(rx, 0xFF, rxLength); return rxLength; }
+    int transfer(const uint8_t*, int, uint8_t*, int, const event_callback_t&, int = SPI_EVENT_COMPLETE) { return -1; }
+};
+
+class EventFlags {
+public:
+    uint32_t set(uint32_t flags) { value |= flags; return value; }
+    uint32_t wait_any(uint32_t flags, uint32_t = 0xFFFFFFFF, bool clear = true) {
+        uint32_t got = value & flags;
+        if (clear) {
+            value &= ~flags;
+        }
+        return got;
+    }
+private:
+    uint32_t value = 0;
+};
+
+#endif // SHTP_HARNESS_HOST_MBED_H
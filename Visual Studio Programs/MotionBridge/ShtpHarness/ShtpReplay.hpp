@@ -0,0 +1,313 @@
+#ifndef SHTP_REPLAY_HPP
+#define SHTP_REPLAY_HPP
+
+// --- SHTP packet replay for the BNO080 driver on the host ---
+// A fake BNO080 on the host I2C bus (HostMbed/mbed.h) that serves a stream of SHTP packets to an
+// unmodified BNO080I2C, so the driver's real receive path (receivePacket(), the header-then-body
+// reads, continuations), processPacket() and parseSensorDataPacket() run without the chip.
+//
+// A stream is SHTP packets back to back as they appear on the wire: a 4-byte header (length
+// little-endian with the continuation bit in bit 15, channel, sequence number) and length - 4
+// bytes of payload. The device behaves like the chip on I2C: a read returns the next packet's
+// header and as much of the payload as was asked for; whatever a read leaves behind is sent on
+// the next read as a continuation with its own header. INT is held low while anything is left and
+// pulsed high between packets, so the driver latches an edge time for each one.
+
+#include <BNO080.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace ShtpHarness {
+
+constexpr PinName SDA_PIN = 1;
+constexpr PinName SCL_PIN = 2;
+constexpr PinName INT_PIN = 3;
+constexpr PinName RST_PIN = 4;
+
+constexpr size_t HEADER_SIZE = 4;
+
+typedef std::vector<uint8_t> Packet;
+
+// Splits a stream into packets. Header lengths under 4 still take the 4 header bytes, and a packet
+// cut short by the end of the stream keeps what there is (as a fuzzer or a truncated capture has it).
+inline std::vector<Packet> splitPackets(const uint8_t* data, size_t size) {
+    std::vector<Packet> packets;
+    size_t offset = 0;
+    while (offset < size) {
+        size_t length = HEADER_SIZE;
+        if (size - offset >= 2) {
+            length = std::max<size_t>(HEADER_SIZE, (data[offset] | data[offset + 1] << 8) & 0x7FFF);
+        }
+        length = std::min(length, size - offset);
+        packets.emplace_back(data + offset, data + offset + length);
+        offset += length;
+    }
+    return packets;
+}
+
+inline std::vector<uint8_t> joinPackets(const std::vector<Packet>& packets) {
+    std::vector<uint8_t> stream;
+    for (const auto& packet : packets) {
+        stream.insert(stream.end(), packet.begin(), packet.end());
+    }
+    return stream;
+}
+
+inline bool readFile(const char* path, std::vector<uint8_t>& bytes) {
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + got);
+    }
+    std::fclose(file);
+    return true;
+}
+
+inline bool writeFile(const char* path, const std::vector<uint8_t>& bytes) {
+    FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = bytes.empty() || std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// Size of a sensor report (SH-2 section 6.5), 0 if unknown. Same table as BNO080.cpp.
+inline size_t sensorReportSize(uint8_t reportID) {
+    switch (reportID) {
+        case SENSOR_REPORTID_TIMESTAMP_REBASE: return 5;
+        case SENSOR_REPORTID_ACCELEROMETER:
+        case SENSOR_REPORTID_LINEAR_ACCELERATION:
+        case SENSOR_REPORTID_GRAVITY:
+        case SENSOR_REPORTID_GYROSCOPE_CALIBRATED:
+        case SENSOR_REPORTID_MAGNETIC_FIELD_CALIBRATED: return 10;
+        case SENSOR_REPORTID_MAGNETIC_FIELD_UNCALIBRATED: return 16;
+        case SENSOR_REPORTID_ROTATION_VECTOR:
+        case SENSOR_REPORTID_GEOMAGNETIC_ROTATION_VECTOR: return 14;
+        case SENSOR_REPORTID_GAME_ROTATION_VECTOR: return 12;
+        case SENSOR_REPORTID_TAP_DETECTOR: return 5;
+        case SENSOR_REPORTID_STABILITY_CLASSIFIER: return 6;
+        case SENSOR_REPORTID_STEP_DETECTOR: return 8;
+        case SENSOR_REPORTID_STEP_COUNTER: return 12;
+        case SENSOR_REPORTID_SIGNIFICANT_MOTION: return 6;
+        case SENSOR_REPORTID_SHAKE_DETECTOR: return 6;
+        case SENSOR_REPORTID_RAW_ACCELEROMETER:
+        case SENSOR_REPORTID_RAW_GYROSCOPE: return 16;
+        default: return 0;
+    }
+}
+
+// Size of a gyro-integrated rotation vector sample on its own channel (SH-2 section 6.5.44)
+constexpr size_t GYRO_ROTATION_SIZE = 14;
+
+// Sensor reports (not counting base timestamps and rebases) in well-formed sensor data packets,
+// plus gyro-integrated rotation vector samples
+inline size_t countReports(const std::vector<Packet>& packets) {
+    size_t reports = 0;
+    for (const auto& packet : packets) {
+        if (packet.size() >= HEADER_SIZE && !(packet[1] & 0x80) && packet[2] == CHANNEL_GYRO) {
+            reports += (packet.size() - HEADER_SIZE) / GYRO_ROTATION_SIZE;
+            continue;
+        }
+        if (packet.size() < HEADER_SIZE + 5 || (packet[1] & 0x80)
+            || (packet[2] != CHANNEL_REPORTS && packet[2] != CHANNEL_WAKE_REPORTS)
+            || packet[HEADER_SIZE] != SHTP_REPORT_BASE_TIMESTAMP) {
+            continue;
+        }
+        size_t offset = HEADER_SIZE + 5;
+        while (offset < packet.size()) {
+            size_t size = sensorReportSize(packet[offset]);
+            if (size == 0 || offset + size > packet.size()) {
+                break;
+            }
+            if (packet[offset] != SENSOR_REPORTID_TIMESTAMP_REBASE) {
+                ++reports;
+            }
+            offset += size;
+        }
+    }
+    return reports;
+}
+
+// Plausible sensor data packets: a base timestamp, then reports cycling through accelerometer,
+// gyroscope, game rotation vector, rotation vector, linear acceleration, magnetometer, raw
+// accelerometer, raw gyroscope, with a timestamp rebase every 16 reports. Values are random but in range; sequence numbers count up.
+inline std::vector<Packet> syntheticPackets(size_t count, size_t reportsPerPacket, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> word(-32768, 32767);
+    const uint8_t cycle[] = { SENSOR_REPORTID_ACCELEROMETER, SENSOR_REPORTID_GYROSCOPE_CALIBRATED,
+                              SENSOR_REPORTID_GAME_ROTATION_VECTOR, SENSOR_REPORTID_ROTATION_VECTOR,
+                              SENSOR_REPORTID_LINEAR_ACCELERATION, SENSOR_REPORTID_MAGNETIC_FIELD_CALIBRATED,
+                              SENSOR_REPORTID_RAW_ACCELEROMETER, SENSOR_REPORTID_RAW_GYROSCOPE };
+
+    std::vector<Packet> packets;
+    uint8_t sequence = 0;
+    for (size_t p = 0; p < count; ++p) {
+        Packet packet(HEADER_SIZE, 0);
+        packet.insert(packet.end(), { SHTP_REPORT_BASE_TIMESTAMP, 20, 0, 0, 0 });
+        for (size_t r = 0; r < reportsPerPacket; ++r) {
+            if (r > 0 && r % 16 == 0) {
+                packet.insert(packet.end(), { SENSOR_REPORTID_TIMESTAMP_REBASE, 50, 0, 0, 0 });
+            }
+            uint8_t id = cycle[r % sizeof(cycle)];
+            size_t offset = packet.size();
+            packet.resize(offset + sensorReportSize(id), 0);
+            packet[offset] = id;
+            packet[offset + 1] = static_cast<uint8_t>(r);
+            packet[offset + 2] = static_cast<uint8_t>(3 | (r & 0x3F) << 2);  // status, delay high bits
+            packet[offset + 3] = static_cast<uint8_t>(r * 7);
+            for (size_t byte = offset + 4; byte + 1 < packet.size(); byte += 2) {
+                int value = word(rng);
+                packet[byte] = static_cast<uint8_t>(value & 0xFF);
+                packet[byte + 1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+            }
+        }
+        packet[0] = static_cast<uint8_t>(packet.size() & 0xFF);
+        packet[1] = static_cast<uint8_t>((packet.size() >> 8) & 0x7F);
+        packet[2] = CHANNEL_REPORTS;
+        packet[3] = sequence++;
+        packets.push_back(packet);
+    }
+    return packets;
+}
+
+// Gyro-integrated rotation vector packets as the IMU sends them on CHANNEL_GYRO: one sample each,
+// a unit quaternion (Q14) and an angular velocity (Q10) that drift a little from packet to packet.
+inline std::vector<Packet> gyroRotationPackets(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> step(-0.01f, 0.01f);
+    float angle = 0, rate = 1.0f;
+
+    std::vector<Packet> packets;
+    uint8_t sequence = 0;
+    for (size_t p = 0; p < count; ++p) {
+        angle += step(rng);
+        rate += step(rng);
+        float words[7] = { 0, 0, std::sin(angle / 2), std::cos(angle / 2), step(rng), step(rng), rate };
+        Packet packet(HEADER_SIZE + GYRO_ROTATION_SIZE, 0);
+        for (size_t word = 0; word < 7; ++word) {
+            int value = static_cast<int>(std::lround(words[word] * (word < 4 ? 1 << 14 : 1 << 10)));
+            value = std::max(-32768, std::min(32767, value));
+            packet[HEADER_SIZE + 2 * word] = static_cast<uint8_t>(value & 0xFF);
+            packet[HEADER_SIZE + 2 * word + 1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        }
+        packet[0] = static_cast<uint8_t>(packet.size());
+        packet[2] = CHANNEL_GYRO;
+        packet[3] = sequence++;
+        packets.push_back(packet);
+    }
+    return packets;
+}
+
+class FakeShtpDevice : public HostI2CDevice {
+public:
+    explicit FakeShtpDevice(PinName intPin = INT_PIN) : intPin(intPin) {
+        HostBus::i2cDevice() = this;
+    }
+
+    ~FakeShtpDevice() override {
+        HostBus::i2cDevice() = nullptr;
+    }
+
+    // Queues packets to send and asserts INT
+    void load(const std::vector<Packet>& newPackets) {
+        packets = &newPackets;
+        next = 0;
+        pendingOffset = 0;
+        pending = nullptr;
+        HostPins::setLevel(intPin, 1);
+        updateInt();
+    }
+
+    bool idle() const { return !pending && (!packets || next >= packets->size()); }
+
+    bool read(uint8_t* data, int length) override {
+        ++reads;
+        if (length <= 0) {
+            return true;
+        }
+
+        const Packet* packet = pending;
+        size_t bodyOffset = pendingOffset;
+        uint8_t header[HEADER_SIZE] = {};
+        if (packet) {
+            // continuation: a fresh header for what is left, continuation bit set
+            size_t remaining = HEADER_SIZE + packet->size() - bodyOffset;
+            header[0] = static_cast<uint8_t>(remaining & 0xFF);
+            header[1] = static_cast<uint8_t>(((remaining >> 8) & 0x7F) | 0x80);
+            header[2] = (*packet)[2];
+            header[3] = (*packet)[3];
+        } else if (packets && next < packets->size()) {
+            packet = &(*packets)[next++];
+            bodyOffset = HEADER_SIZE;
+            std::copy(packet->begin(), packet->begin() + std::min(packet->size(), HEADER_SIZE), header);
+        }
+
+        // header, then body, then zeros past the end
+        size_t copied = std::min<size_t>(length, HEADER_SIZE);
+        std::copy(header, header + copied, data);
+        size_t body = 0;
+        if (packet && static_cast<size_t>(length) > HEADER_SIZE && bodyOffset < packet->size()) {
+            body = std::min<size_t>(length - HEADER_SIZE, packet->size() - bodyOffset);
+            std::copy(packet->begin() + bodyOffset, packet->begin() + bodyOffset + body, data + HEADER_SIZE);
+        }
+        std::fill(data + copied + body, data + length, 0);
+
+        // anything left over goes out as a continuation on the next read
+        if (packet && bodyOffset + body < packet->size()) {
+            pending = packet;
+            pendingOffset = bodyOffset + body;
+        } else {
+            pending = nullptr;
+            pendingOffset = 0;
+            // INT goes high between packets and falls again for the next one
+            HostPins::setLevel(intPin, 1);
+        }
+        updateInt();
+        return true;
+    }
+
+    bool write(const uint8_t*, int) override {
+        ++writes;
+        return true;
+    }
+
+    unsigned long reads = 0;
+    unsigned long writes = 0;
+
+private:
+    void updateInt() {
+        HostPins::setLevel(intPin, idle() ? 1 : 0);
+    }
+
+    PinName intPin;
+    const std::vector<Packet>* packets = nullptr;
+    size_t next = 0;
+    const Packet* pending = nullptr;
+    size_t pendingOffset = 0;
+};
+
+// Feeds every packet through the driver as its owner would, calling updateData() until the
+// device has nothing left. Returns the number of updateData() calls; gives up after maxCalls
+// so a driver that stops consuming the stream can't hang the harness.
+inline size_t runToIdle(BNO080I2C& imu, FakeShtpDevice& device, size_t maxCalls) {
+    size_t calls = 0;
+    while (!device.idle() && calls < maxCalls) {
+        imu.updateData();
+        ++calls;
+    }
+    return calls;
+}
+
+} // namespace ShtpHarness
+
+#endif // SHTP_REPLAY_HPP
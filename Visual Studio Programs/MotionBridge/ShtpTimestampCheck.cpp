@@ -0,0 +1,126 @@
+// --- BNO080 sample timestamp check (host) ---
+// Replays hand-built sensor data packets through the BNO080 driver (ShtpHarness/) and checks the
+// host timestamps it gives the samples. A packet starts with a base timestamp; each timestamp
+// rebase in it moves the base by its delta *from the previous base* (SH-2 section 7.2.2, and the
+// reference driver's referenceDelta += rebase), so several rebases in one packet add up. Every
+// report then adds its own 14-bit delay. The absolute time depends on when the host saw INT, so
+// the check works back to the packet's base from its first sample and compares the rest with it.
+//
+// Usage: ShtpTimestampCheck [--verbose]
+//
+// Prints every mismatch and exits 1 if there was any.
+
+#include "ShtpHarness/ShtpReplay.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace ShtpHarness;
+
+// One report or rebase in a hand-built packet
+struct Entry {
+    uint8_t id;             // Sensor report ID, or SENSOR_REPORTID_TIMESTAMP_REBASE
+    int32_t ticks;          // Rebase delta, or the report's delay (100us ticks)
+    int32_t expectedUs;     // Report: expected timestamp relative to the packet's base timestamp
+};
+
+static void putLE32(Packet& packet, int32_t value) {
+    for (int byte = 0; byte < 4; ++byte) {
+        packet.push_back(static_cast<uint8_t>(static_cast<uint32_t>(value) >> (8 * byte)));
+    }
+}
+
+static Packet buildPacket(int32_t baseTicks, const std::vector<Entry>& entries, uint8_t sequence) {
+    Packet packet(HEADER_SIZE, 0);
+    packet.push_back(SHTP_REPORT_BASE_TIMESTAMP);
+    putLE32(packet, baseTicks);
+    for (const Entry& entry : entries) {
+        size_t offset = packet.size();
+        if (entry.id == SENSOR_REPORTID_TIMESTAMP_REBASE) {
+            packet.push_back(entry.id);
+            putLE32(packet, entry.ticks);
+            continue;
+        }
+        packet.resize(offset + sensorReportSize(entry.id), 0);
+        packet[offset] = entry.id;
+        packet[offset + 2] = static_cast<uint8_t>(3 | ((entry.ticks >> 8) & 0x3F) << 2);    // status, delay high bits
+        packet[offset + 3] = static_cast<uint8_t>(entry.ticks & 0xFF);
+    }
+    packet[0] = static_cast<uint8_t>(packet.size() & 0xFF);
+    packet[1] = static_cast<uint8_t>((packet.size() >> 8) & 0x7F);
+    packet[2] = CHANNEL_REPORTS;
+    packet[3] = sequence;
+    return packet;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = argc > 1 && std::string(argv[1]) == "--verbose";
+
+    const uint8_t ACCEL = SENSOR_REPORTID_ACCELEROMETER;
+    const uint8_t GYRO = SENSOR_REPORTID_GYROSCOPE_CALIBRATED;
+    const uint8_t REBASE = SENSOR_REPORTID_TIMESTAMP_REBASE;
+    const std::vector<std::vector<Entry>> entries = {
+        // Three rebases in a row, the last one backwards: they add up
+        { { ACCEL, 0, 0 },
+          { REBASE, 50, 0 },
+          { ACCEL, 0, 5000 },
+          { REBASE, 30, 0 },
+          { GYRO, 5, 8500 },
+          { REBASE, -20, 0 },
+          { ACCEL, 0, 6000 },
+          { GYRO, 300, 36000 } },
+        // A new packet starts from its own base again
+        { { GYRO, 10, 1000 },
+          { REBASE, 100, 0 },
+          { ACCEL, 10, 11000 } },
+    };
+    const int32_t baseTicks[] = { 20, 10 };
+
+    std::vector<Packet> packets;
+    for (size_t p = 0; p < entries.size(); ++p) {
+        packets.push_back(buildPacket(baseTicks[p], entries[p], static_cast<uint8_t>(p)));
+    }
+
+    Stream debug(!verbose);
+    FakeShtpDevice device;
+    BNO080I2C imu(&debug, SDA_PIN, SCL_PIN, INT_PIN, RST_PIN);
+    int failures = 0;
+
+    for (size_t p = 0; p < packets.size(); ++p) {
+        std::vector<Packet> one(1, packets[p]);
+        device.load(one);
+        runToIdle(imu, device, 16);
+
+        uint32_t packetBase = 0;
+        size_t index = 0;
+        BNO080Base::Sample sample;
+        for (const Entry& entry : entries[p]) {
+            if (entry.id == REBASE) {
+                continue;
+            }
+            if (!imu.readSample(sample)) {
+                std::printf("FAIL packet %zu: report %zu missing\n", p, index);
+                ++failures;
+                break;
+            }
+            if (index == 0) {
+                packetBase = sample.timestamp - static_cast<uint32_t>(entry.expectedUs);
+            }
+            int32_t got = static_cast<int32_t>(sample.timestamp - packetBase);
+            if (got != entry.expectedUs) {
+                std::printf("FAIL packet %zu report %zu: at %+ld us, expected %+ld us\n", p, index,
+                            static_cast<long>(got), static_cast<long>(entry.expectedUs));
+                ++failures;
+            }
+            ++index;
+        }
+        while (imu.readSample(sample)) {
+            std::printf("FAIL packet %zu: extra sample\n", p);
+            ++failures;
+        }
+    }
+
+    std::printf("%s\n", failures == 0 ? "Timestamps ok" : "Timestamps FAILED");
+    return failures == 0 ? 0 : 1;
+}
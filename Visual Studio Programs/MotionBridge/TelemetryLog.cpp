@@ -0,0 +1,175 @@
+// --- Telemetry logger ---
+// Reads the binary telemetry stream from the Platform IK firmware (see MotionLink_Lib/Telemetry.hpp)
+// and writes it as a column-per-signal CSV, one row per recorded control cycle, ready for
+// plotting (pandas, MATLAB readtable, Excel). Other frames on the link (latency traces,
+// time-sync replies) and the firmware's printf text are skipped.
+//
+// Usage: TelemetryLog <port> [--baud B] [--out FILE] [--seconds S]
+//   port       e.g. /dev/ttyACM0 or COM3
+//   --baud     line rate, must match LINK_BAUD_RATE in the firmware   (default 115200)
+//   --out      CSV file to write                                      (default telemetry.csv)
+//   --seconds  stop after S seconds, 0 = run until Ctrl+C             (default 0)
+
+#include "SerialTransmitter.hpp"
+#include "MotionLink_Lib/MotionLink.hpp"
+#include "MotionLink_Lib/MotionReceiver.hpp"
+#include "MotionLink_Lib/Telemetry.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std::chrono;
+
+static std::atomic<bool> stopRequested(false);
+
+static void onSignal(int) {
+    stopRequested = true;
+}
+
+// Running min / mean / max of one timing column
+struct TimingSummary {
+    uint32_t min = 0;
+    uint32_t max = 0;
+    uint64_t sum = 0;
+    uint64_t count = 0;
+
+    void add(uint32_t value) {
+        if (count == 0 || value < min) min = value;
+        if (count == 0 || value > max) max = value;
+        sum += value;
+        ++count;
+    }
+
+    void print(const char* name) const {
+        printf("%-10s min %6lu  mean %8.1f  max %6lu us\n", name,
+               (unsigned long)min, count ? static_cast<double>(sum) / count : 0.0, (unsigned long)max);
+    }
+};
+
+// Writes one CSV row per record and keeps track of gaps and timing
+class TelemetryWriter : public MotionLink::MessageHandler {
+public:
+    explicit TelemetryWriter(FILE* file) : file(file) {
+        fprintf(file, "cycle,cycle_start_us,period_us,work_us,pose_seq");
+        for (size_t a = 1; a <= MotionLink::TELEMETRY_ACTUATORS; ++a) {
+            fprintf(file, ",a%zu_target_mm,a%zu_estimate_mm,a%zu_state,a%zu_duty", a, a, a, a);
+        }
+        fprintf(file, "\n");
+    }
+
+    uint64_t records = 0;
+    uint64_t missingRecords = 0;    // Gaps in the cycle counter (lost frames or dropped on the platform)
+    uint16_t platformDropped = 0;   // Records the platform itself couldn't queue
+    TimingSummary period;
+    TimingSummary work;
+
+    void onMotionFrame(const MotionSchema::MotionFrame& frame, uint32_t arrival_us) override {
+        (void)frame; (void)arrival_us;
+    }
+
+    void onOtherFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint32_t arrival_us) override {
+        (void)arrival_us;
+        MotionLink::TelemetryBatch batch;
+        if (type != MotionLink::MSG_TELEMETRY || !MotionLink::decodeTelemetry(payload, length, batch)) {
+            return;
+        }
+        platformDropped = batch.recordsDropped;
+
+        for (uint8_t r = 0; r < batch.count; ++r) {
+            const MotionLink::TelemetryRecord& record = batch.records[r];
+            if (records > 0) {
+                uint32_t expected = lastCycle + batch.decimation;
+                if (record.cycle != expected && batch.decimation > 0) {
+                    missingRecords += (record.cycle - expected) / batch.decimation;
+                }
+                period.add(record.period_us);
+            }
+            work.add(record.work_us);
+            lastCycle = record.cycle;
+            ++records;
+
+            fprintf(file, "%lu,%lu,%lu,%lu,%u", (unsigned long)record.cycle, (unsigned long)record.cycleStart_us,
+                    (unsigned long)record.period_us, (unsigned long)record.work_us, record.poseSequence);
+            for (const MotionLink::ActuatorTelemetry& actuator : record.actuators) {
+                fprintf(file, ",%.3f,%.3f,%u,%.3f", actuator.target_mm, actuator.estimate_mm,
+                        actuator.state, actuator.duty);
+            }
+            fprintf(file, "\n");
+        }
+    }
+
+private:
+    FILE* file;
+    uint32_t lastCycle = 0;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argv[1][0] == '-') {
+        std::cerr << "Usage: " << argv[0] << " <port> [--baud B] [--out FILE] [--seconds S]" << std::endl;
+        return 1;
+    }
+    std::string port = argv[1];
+    int baudRate = 115200;
+    std::string outPath = "telemetry.csv";
+    double seconds = 0.0;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--baud" && value) { baudRate = atoi(value); ++i; }
+        else if (arg == "--out" && value) { outPath = value; ++i; }
+        else if (arg == "--seconds" && value) { seconds = atof(value); ++i; }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    SerialTransmitter serial;
+    if (!serial.open(port, baudRate)) {
+        return 1;
+    }
+    FILE* file = fopen(outPath.c_str(), "w");
+    if (!file) {
+        std::cerr << "Error opening " << outPath << std::endl;
+        return 1;
+    }
+
+    TelemetryWriter writer(file);
+    MotionLink::MotionReceiver receiver(writer);
+    std::signal(SIGINT, onSignal);
+
+    std::cout << "Logging telemetry from " << port << " to " << outPath
+              << (seconds > 0 ? "" : " (Ctrl+C to stop)") << std::endl;
+
+    auto endTime = steady_clock::now() + duration_cast<steady_clock::duration>(duration<double>(seconds));
+    uint8_t rxBuffer[512];
+    while (!stopRequested && (seconds <= 0 || steady_clock::now() < endTime)) {
+        long count = serial.read(rxBuffer, sizeof(rxBuffer));
+        if (count < 0) {
+            break;
+        }
+        if (count > 0) {
+            receiver.push(rxBuffer, static_cast<size_t>(count));
+        } else {
+            std::this_thread::sleep_for(milliseconds(2));
+        }
+    }
+
+    fclose(file);
+    serial.close();
+
+    const MotionLink::FrameParser& link = receiver.stats();
+    printf("\nRecords: %llu, missing: %llu, dropped on platform: %u, link CRC errors: %lu\n",
+           (unsigned long long)writer.records, (unsigned long long)writer.missingRecords,
+           writer.platformDropped, (unsigned long)link.crcErrors);
+    writer.period.print("Period");
+    writer.work.print("Work");
+    return 0;
+}
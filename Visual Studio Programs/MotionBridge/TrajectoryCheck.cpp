@@ -0,0 +1,170 @@
+// --- Pose trajectory limit check (host) ---
+// Drives MotionLink_Lib/PoseTrajectory.hpp at the Platform IK control rate and checks the limits
+// where the actuators see them: on the IK strokes of every commanded pose, differenced cycle by
+// cycle (speed, then acceleration, then jerk), not on the pose-space plan. Runs
+//
+//   - single steps on every axis and a few combined ones, out and back, each of which has to
+//     settle on its target;
+//   - a stream of random targets, a new one every --hold seconds, so most moves are retargeted
+//     mid-flight.
+//
+// Usage: TrajectoryCheck [--seconds S] [--hold S] [--seed N]
+//   --seconds  length of the random run          (default 1000)
+//   --hold     time between random targets       (default 0.3)
+//   --seed     random seed                        (default 1)
+//
+// Prints the worst speed, acceleration and jerk as a share of their limits and exits 1 if any
+// went over, or a step didn't settle.
+
+#include "MotionLink_Lib/PoseTrajectory.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using namespace MotionLink;
+
+static constexpr float DT_S = 0.02f;                     // CONTROL_LOOP_PERIOD_MS in Platform IK
+static constexpr float SPEED_MM_S = 0.9f * 30.6827057f;  // TRAJECTORY_SPEED_MARGIN * ACTUATOR_SPEED_MM_PER_S
+static constexpr float ACCEL_MM_S2 = 100.0f;
+static constexpr float JERK_MM_S3 = 1000.0f;
+
+// Follows the commanded strokes and keeps the worst of each derivative
+class StrokeMonitor {
+public:
+    double worstSpeed = 0.0, worstAccel = 0.0, worstJerk = 0.0;
+
+    void start(const float pose[POSE_AXES]) {
+        strokesAt(pose, stroke);
+        for (size_t leg = 0; leg < PlatformGeometry::LEGS; ++leg) {
+            speed[leg] = accel[leg] = 0.0;
+        }
+    }
+
+    void add(const float pose[POSE_AXES]) {
+        float next[PlatformGeometry::LEGS];
+        strokesAt(pose, next);
+        for (size_t leg = 0; leg < PlatformGeometry::LEGS; ++leg) {
+            double v = (double(next[leg]) - stroke[leg]) / DT_S;
+            double a = (v - speed[leg]) / DT_S;
+            double j = (a - accel[leg]) / DT_S;
+            worstSpeed = fmax(worstSpeed, fabs(v) / SPEED_MM_S);
+            worstAccel = fmax(worstAccel, fabs(a) / ACCEL_MM_S2);
+            worstJerk = fmax(worstJerk, fabs(j) / JERK_MM_S3);
+            stroke[leg] = next[leg];
+            speed[leg] = v;
+            accel[leg] = a;
+        }
+    }
+
+private:
+    static void strokesAt(const float pose[POSE_AXES], float out[PlatformGeometry::LEGS]) {
+        float R[3][3];
+        PlatformGeometry::rotationFromRpy(pose[POSE_ROLL_DEG], pose[POSE_PITCH_DEG], pose[POSE_YAW_DEG], R);
+        PlatformGeometry::legStrokes(R, pose, out);
+    }
+
+    float stroke[PlatformGeometry::LEGS];
+    double speed[PlatformGeometry::LEGS];
+    double accel[PlatformGeometry::LEGS];
+};
+
+static bool report(const char* what, const StrokeMonitor& monitor) {
+    bool ok = monitor.worstSpeed <= 1.0 && monitor.worstAccel <= 1.0 && monitor.worstJerk <= 1.0;
+    printf("%-22s speed %5.1f%%  accel %5.1f%%  jerk %5.1f%%  %s\n", what, 100.0 * monitor.worstSpeed,
+           100.0 * monitor.worstAccel, 100.0 * monitor.worstJerk, ok ? "ok" : "OVER LIMIT");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    double seconds = 1000.0;
+    double hold_s = 0.3;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--seconds" && value) { seconds = atof(value); ++i; }
+        else if (arg == "--hold" && value) { hold_s = atof(value); ++i; }
+        else if (arg == "--seed" && value) { seed = static_cast<unsigned>(atol(value)); ++i; }
+        else {
+            fprintf(stderr, "Usage: %s [--seconds S] [--hold S] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    TrajectoryLimits limits;
+    limits.speed_mm_s = SPEED_MM_S;
+    limits.accel_mm_s2 = ACCEL_MM_S2;
+    limits.jerk_mm_s3 = JERK_MM_S3;
+    const float home[POSE_AXES] = {};
+    bool ok = true;
+
+    // --- Steps, out and back ---
+    struct Step { const char* name; float pose[POSE_AXES]; };
+    const Step steps[] = {
+        { "x 40 mm",              { 40, 0, 0, 0, 0, 0 } },
+        { "y 40 mm",              { 0, 40, 0, 0, 0, 0 } },
+        { "z 40 mm",              { 0, 0, 40, 0, 0, 0 } },
+        { "roll 10 deg",          { 0, 0, 0, 10, 0, 0 } },
+        { "pitch 10 deg",         { 0, 0, 0, 0, 10, 0 } },
+        { "yaw 15 deg",           { 0, 0, 0, 0, 0, 15 } },
+        { "yaw 2 deg",            { 0, 0, 0, 0, 0, 2 } },
+        { "x -30 pitch 8",        { -30, 0, 0, 0, 8, 0 } },
+        { "all axes",             { 25, -25, 30, -8, 8, 12 } },
+    };
+    StrokeMonitor all;
+    for (const Step& s : steps) {
+        PoseTrajectory trajectory;
+        trajectory.configure(limits, DT_S);
+        trajectory.reset(home);
+        StrokeMonitor monitor;
+        monitor.start(home);
+        float pose[POSE_AXES];
+        bool settled = true;
+        for (const float* target : { s.pose, home }) {
+            int cycle = 0;
+            do {
+                trajectory.step(target, pose);
+                monitor.add(pose);
+            } while (!trajectory.settled() && ++cycle < static_cast<int>(30.0f / DT_S));
+            settled = settled && trajectory.settled();
+        }
+        ok = report(s.name, monitor) && ok;
+        if (!settled) {
+            printf("%-22s didn't settle\n", s.name);
+            ok = false;
+        }
+    }
+
+    // --- Random targets, mostly retargeted mid-move ---
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> translation(-40.0f, 40.0f), tilt(-10.0f, 10.0f), yaw(-15.0f, 15.0f);
+    PoseTrajectory trajectory;
+    trajectory.configure(limits, DT_S);
+    trajectory.reset(home);
+    StrokeMonitor monitor;
+    monitor.start(home);
+    float target[POSE_AXES] = {};
+    float pose[POSE_AXES];
+    const long cycles = static_cast<long>(seconds / DT_S);
+    const long holdCycles = hold_s > DT_S ? static_cast<long>(hold_s / DT_S) : 1;
+    for (long cycle = 0; cycle < cycles; ++cycle) {
+        if (cycle % holdCycles == 0) {
+            target[POSE_X_MM] = translation(rng);
+            target[POSE_Y_MM] = translation(rng);
+            target[POSE_Z_MM] = translation(rng);
+            target[POSE_ROLL_DEG] = tilt(rng);
+            target[POSE_PITCH_DEG] = tilt(rng);
+            target[POSE_YAW_DEG] = yaw(rng);
+        }
+        trajectory.step(target, pose);
+        monitor.add(pose);
+    }
+    char label[48];
+    snprintf(label, sizeof(label), "random %.0f s / %.2f s", seconds, hold_s);
+    ok = report(label, monitor) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#ifndef MOTION_RECEIVER_HPP
+#define MOTION_RECEIVER_HPP
+
+// --- Motion Link Receiver ---
+// Turns a raw byte stream from the serial link into decoded messages. This is the whole receive
+// path of the firmware minus the serial port itself, so the same code runs on the MCU and in the
+// host loopback harness (MotionBridge/PtyLoopback.cpp).
+
+#include <cstdint>
+#include <cstddef>
+#include "MotionLink.hpp"
+#include "MotionSchema.hpp"
+
+namespace MotionLink {
+
+// Receives decoded messages. Override the ones you care about.
+// arrival_us is the timestamp passed to push() with the chunk the frame's first byte came in.
+class MessageHandler {
+public:
+    virtual ~MessageHandler() {}
+
+    // A motion frame (any quantization level) arrived
+    virtual void onMotionFrame(const MotionSchema::MotionFrame& frame, uint32_t arrival_us) = 0;
+
+    // A valid frame of any other type arrived
+    virtual void onOtherFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint32_t arrival_us) {
+        (void)type; (void)payload; (void)length; (void)arrival_us;
+    }
+};
+
+class MotionReceiver {
+public:
+    explicit MotionReceiver(MessageHandler& handler) : handler(handler) {}
+
+    // Feeds a chunk of received bytes. arrival_us is when the chunk was received, in whatever
+    // microsecond clock the caller uses (0 if it doesn't care). Returns the number of complete
+    // frames dispatched.
+    size_t push(const uint8_t* data, size_t length, uint32_t arrival_us = 0) {
+        size_t frames = 0;
+        for (size_t i = 0; i < length; ++i) {
+            // A frame that spans several chunks keeps the arrival time of its first byte
+            if (parser.idle()) {
+                frameArrival_us = arrival_us;
+            }
+            if (!parser.feed(data[i])) {
+                continue; // Frame not complete yet (or dropped by CRC/version check)
+            }
+            ++frames;
+
+            MotionSchema::MotionFrame frame;
+            if (decodeMotionFrame(parser, frame)) {
+                handler.onMotionFrame(frame, frameArrival_us);
+            } else {
+                handler.onOtherFrame(parser.type(), parser.payload(), parser.length(), frameArrival_us);
+            }
+        }
+        return frames;
+    }
+
+    // Link statistics (frames OK, CRC errors, version mismatches)
+    const FrameParser& stats() const { return parser; }
+
+private:
+    MessageHandler& handler;
+    FrameParser parser;
+    uint32_t frameArrival_us = 0;
+};
+
+} // namespace MotionLink
+
+#endif // MOTION_RECEIVER_HPP
@@ -1,13 +1,16 @@
 #include "mbed.h"
-#include <string>
-#include <stdio.h> // For sscanf
+#include <stdio.h>
+#include "MotionLink_Lib/MotionReceiver.hpp"
+#include "MotionLink_Lib/MotionSchema.hpp"
 
 // --- Configuration ---
-// Baud rate MUST match the sender application (PC C++ code)
-#define DATA_BAUD_RATE 9600
+// Baud rate MUST match the sender application (PC C++ code, MotionBridge SerialTransmitter).
+// The ST-Link virtual COM port also handles 921600 if more headroom is needed.
+#define DATA_BAUD_RATE 115200
 
-// Buffer to store incoming serial data line by line
-#define RX_BUFFER_SIZE 150
+// Chunk size for reads from the serial buffer. Frames are reassembled by the parser,
+// so this doesn't need to hold a whole frame.
+#define RX_CHUNK_SIZE 64
 
 // LED to blink on successful message parsing
 #define STATUS_LED LED1
@@ -21,13 +24,35 @@ static BufferedSerial serial_port(USBTX, USBRX, DATA_BAUD_RATE);
 // DigitalOut for status indicator
 static DigitalOut status_led(STATUS_LED);
 
-// Character buffer for assembling incoming lines
-char rx_buffer[RX_BUFFER_SIZE];
-int rx_index = 0; // Current position in the buffer
+// Raw bytes read from the serial port
+uint8_t rx_chunk[RX_CHUNK_SIZE];
+
+// Prints every decoded frame
+class PrintingHandler : public MotionLink::MessageHandler {
+public:
+    void onMotionFrame(const MotionSchema::MotionFrame& frame, uint32_t arrival_us) override {
+        printf("Received #%u -> Pitch: %.2f, Roll: %.2f, Yaw: %.2f, T=[%.1f, %.1f, %.1f]\n",
+               frame.sequence, frame.pitch_deg, frame.roll_deg, frame.yaw_deg,
+               frame.translationX_mm, frame.translationY_mm, frame.translationZ_mm);
+        status_led = !status_led;
+    }
+
+    void onOtherFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint32_t arrival_us) override {
+        // Make error more prominent
+        printf("\n*** UNKNOWN FRAME ***\n");
+        printf("Type: 0x%02x, Length: %u\n", type, length);
+        printf("*** END UNKNOWN FRAME ***\n");
+    }
+};
+
+PrintingHandler printingHandler;
+
+// Reassembles binary frames (see MotionLink_Lib/MotionLink.hpp for the wire format)
+MotionLink::MotionReceiver receiver(printingHandler);
 
 int main(void) {
     // ... (setup) ...
-    printf("Waiting for data...\n\n");
+    printf("Waiting for data (motion schema v%d)...\n\n", MotionSchema::SCHEMA_VERSION);
     long long mainLoopCounter = 0; // Add counter
 
     while (true) {
@@ -36,61 +61,24 @@ int main(void) {
         // if (mainLoopCounter % 200 == 0) { printf("."); fflush(stdout); }
 
         if (serial_port.readable()) {
-            uint32_t num_bytes_read = serial_port.read(rx_buffer + rx_index, RX_BUFFER_SIZE - 1 - rx_index);
-
+            ssize_t num_bytes_read = serial_port.read(rx_chunk, RX_CHUNK_SIZE);
             if (num_bytes_read > 0) {
-                rx_index += num_bytes_read;
-                rx_buffer[rx_index] = '\0';
-                // DEBUG: Print raw received content immediately
-                // printf("Raw Read (%lu bytes): \"%s\"\n", num_bytes_read, rx_buffer);
-
-                char* newline_ptr = strchr(rx_buffer, '\n');
-                while (newline_ptr != nullptr) { // Process all complete lines in the buffer
-                    *newline_ptr = '\0';
-                    // DEBUG: Print the line we are about to parse
-                    // printf("Processing line: \"%s\"\n", rx_buffer);
-
-                    double pitch = 0.0, roll = 0.0, yaw = 0.0;
-                    int items_parsed = sscanf(rx_buffer, "Pitch:%lf,Roll:%lf,Yaw:%lf", &pitch, &roll, &yaw);
-
-                    if (items_parsed == 3) {
-                        printf("Received -> Pitch: %.2f, Roll: %.2f, Yaw: %.2f\n", pitch, roll, yaw);
-                        status_led = !status_led;
-                    } else {
-                        // Make error more prominent
-                        printf("\n*** PARSING ERROR ***\n");
-                        printf("Malformed line content: \"%s\"\n", rx_buffer);
-                        printf("Items parsed: %d (expected 3)\n", items_parsed);
-                        printf("*** END PARSING ERROR ***\n");
-                        // Consider clearing the whole buffer on error?
-                        // rx_index = 0; rx_buffer[0] = '\0'; break; // Exit inner while to prevent processing garbage
-                    }
-
-                    int remaining_chars = rx_index - ( (newline_ptr - rx_buffer) + 1 );
-                    if (remaining_chars > 0) {
-                        memmove(rx_buffer, newline_ptr + 1, remaining_chars);
-                        rx_index = remaining_chars;
-                        rx_buffer[rx_index] = '\0';
-                         // Check for another newline immediately in the remaining data
-                        newline_ptr = strchr(rx_buffer, '\n');
-                    } else {
-                        rx_index = 0;
-                        rx_buffer[0] = '\0';
-                        newline_ptr = nullptr; // No more data in buffer
-                    }
-                } // End while(newline_ptr != nullptr)
-
-                if (rx_index >= RX_BUFFER_SIZE - 1) {
-                     printf("\n*** BUFFER FULL without newline! ***\n");
-                     printf("Buffer content: \"%s\"\n", rx_buffer);
-                     printf("Clearing buffer.\n");
-                     printf("*** END BUFFER FULL ***\n");
-                    rx_index = 0;
-                    rx_buffer[0] = '\0';
-                }
-            } // End if (num_bytes_read > 0)
+                receiver.push(rx_chunk, static_cast<size_t>(num_bytes_read));
+            }
         } // End if (serial_port.readable())
 
+        // Report link errors as they happen instead of silently dropping frames
+        static uint32_t reportedCrcErrors = 0;
+        static uint32_t reportedVersionErrors = 0;
+        const MotionLink::FrameParser& link = receiver.stats();
+        if (link.crcErrors != reportedCrcErrors || link.versionErrors != reportedVersionErrors) {
+            reportedCrcErrors = link.crcErrors;
+            reportedVersionErrors = link.versionErrors;
+            printf("*** LINK ERRORS: %lu CRC, %lu version mismatch (%lu frames OK) ***\n",
+                   (unsigned long)reportedCrcErrors, (unsigned long)reportedVersionErrors,
+                   (unsigned long)link.framesOk);
+        }
+
         ThisThread::sleep_for(5ms);
     } // end while(true)
-}
\ No newline at end of file
+}
@@ -78,6 +78,16 @@ BNO080Base::BNO080Base(Stream *debugPort, PinName user_INTPin, PinName user_RSTP
 		_int(user_INTPin),
 		_rst(user_RSTPin, 1),
 		commandSequenceNumber(0),
+		bufferMetadataRecord(0),
+		intEdgeTime(0),
+		intEdgeCount(0),
+		rxInterruptTime(0),
+		rxLatchedEdgeCount(0),
+		majorSoftwareVersion(0),
+		minorSoftwareVersion(0),
+		patchSoftwareVersion(0),
+		partNumber(0),
+		buildNumber(0),
 		stability(UNKNOWN),
 		stepDetected(false),
 		stepCount(0),
@@ -85,19 +95,42 @@ BNO080Base::BNO080Base(Stream *debugPort, PinName user_INTPin, PinName user_RSTP
 		shakeDetected(false),
 		xAxisShake(false),
 		yAxisShake(false),
-		zAxisShake(false)
+		zAxisShake(false),
+		snapshotPacketCount(0),
+		sampleQueueHead(0),
+		sampleQueueCount(0),
+		droppedSampleCount(0),
+		metadataCache(nullptr),
+		metadataCacheDirty(false),
+		startupReports(nullptr),
+		startupReportCount(0),
+		awaitingFirstData(false),
+		resetReleaseTime(0),
+		startupEdgeTime(0)
 {
 	// zero sequence numbers
 	memset(sequenceNumber, 0, sizeof(sequenceNumber));
+	memset(reportStatus, 0, sizeof(reportStatus));
+	memset(reportHasBeenUpdated, 0, sizeof(reportHasBeenUpdated));
+	memset(reportTimestamp, 0, sizeof(reportTimestamp));
+	memset(rawAcceleration, 0, sizeof(rawAcceleration));
+	memset(rawGyroRotation, 0, sizeof(rawGyroRotation));
+	std::fill(std::begin(sampleRings), std::end(sampleRings), nullptr);
+	memset(&bootTiming, 0, sizeof(bootTiming));
+
+	// timestamp every packet the IMU announces
+	_int.fall(callback(this, &BNO080Base::onInterruptEdge));
 }
 
 bool BNO080Base::begin()
 {
 	//Configure the BNO080
+	startBootTiming();
 
 	_rst = 0; // Reset BNO080
 	ThisThread::sleep_for(1ms); // Min length not specified in datasheet?
 	_rst = 1; // Bring out of reset
+	resetReleaseTime = us_ticker_read();
 
 	// wait for a falling edge (NOT just a low) on the INT pin to denote startup
 	Timer timeoutTimer;
@@ -111,6 +144,7 @@ bool BNO080Base::begin()
 		if(timeoutTimer.elapsed_time() > BNO080_RESET_TIMEOUT)
 		{
 			_debugPort->printf("Error: BNO080 reset timed out, chip not detected.\n");
+			finishBootTiming(0, 0);
 			return false;
 		}
 
@@ -127,6 +161,7 @@ bool BNO080Base::begin()
 			if(_int == 0)
 			{
 				lowDetected = true;
+				startupEdgeTime = us_ticker_read();
 			}
 		}
 		else
@@ -149,6 +184,7 @@ bool BNO080Base::begin()
 	if(!waitForPacket(CHANNEL_EXECUTABLE, EXECUTABLE_REPORTID_RESET))
 	{
 		_debugPort->printf("No initialization report from BNO080.\n");
+		finishBootTiming(0, 0);
 		return false;
 	}
 	else
@@ -157,41 +193,64 @@ bool BNO080Base::begin()
 		_debugPort->printf("BNO080 reports initialization successful!\n");
 #endif
 	}
+	uint32_t initializedTime = us_ticker_read();
 
 	// Finally, we want to interrogate the device about its model and version.
-	clearSendBuffer();
-	txShtpData[0] = SHTP_REPORT_PRODUCT_ID_REQUEST; //Request the product ID and reset info
-	txShtpData[1] = 0; //Reserved
-	sendPacket(CHANNEL_CONTROL, 2);
+	// The startup reports go out right behind the request, so the IMU starts sampling while we wait.
+	sendStartupRequests();
 
 	waitForPacket(CHANNEL_CONTROL, SHTP_REPORT_PRODUCT_ID_RESPONSE, 5ms);
 
-	if (rxShtpData[0] == SHTP_REPORT_PRODUCT_ID_RESPONSE)
-	{
-		majorSoftwareVersion = rxShtpData[2];
-		minorSoftwareVersion = rxShtpData[3];
-		patchSoftwareVersion = (rxShtpData[13] << 8) | rxShtpData[12];
-		partNumber = (rxShtpData[7] << 24) | (rxShtpData[6] << 16) | (rxShtpData[5] << 8) | rxShtpData[4];
-		buildNumber = (rxShtpData[11] << 24) | (rxShtpData[10] << 16) | (rxShtpData[9] << 8) | rxShtpData[8];
-
-#if BNO_DEBUG
-		_debugPort->printf("BNO080 reports as SW version %hhu.%hhu.%hu, build %lu, part no. %lu\n",
-						   majorSoftwareVersion, minorSoftwareVersion, patchSoftwareVersion,
-						   buildNumber, partNumber);
-#endif
-
-	}
-	else
+	if(!parseProductIDResponse())
 	{
 		_debugPort->printf("Bad response from product ID command.\n");
+		finishBootTiming(initializedTime, 0);
 		return false;
 	}
 
 	// successful init
+	finishBootTiming(initializedTime, us_ticker_read());
 	return true;
 
 }
 
+void BNO080Base::setStartupReports(const StartupReport * reports, size_t count)
+{
+	startupReports = reports;
+	startupReportCount = reports != nullptr ? count : 0;
+}
+
+void BNO080Base::setMetadataCache(MetadataCache * cache)
+{
+	lockMutex();
+	metadataCache = cache;
+	metadataCacheDirty = false;
+
+	// don't trust whatever was in the buffer to match what the cache will say
+	bufferMetadataRecord = 0;
+	unlockMutex();
+}
+
+void BNO080Base::printBootTiming()
+{
+	_debugPort->printf("BNO080 startup: begin() at %.1f ms after power-on, took %.1f ms\n",
+		bootTiming.beginTime / 1000.0f, bootTiming.beginTotal / 1000.0f);
+	_debugPort->printf("  reset -> INT: %.1f ms, INT -> initialized: %.1f ms, initialized -> product ID: %.1f ms\n",
+		bootTiming.resetToInterrupt / 1000.0f, bootTiming.interruptToInitialized / 1000.0f, bootTiming.initializedToProductID / 1000.0f);
+
+	if(awaitingFirstData)
+	{
+		_debugPort->printf("  no sensor data yet\n");
+	}
+	else
+	{
+		_debugPort->printf("  first sensor data %.1f ms after begin()\n", bootTiming.beginToFirstData / 1000.0f);
+	}
+
+	_debugPort->printf("  metadata: %hu record(s) from cache, %hu read from FRS in %.1f ms\n",
+		bootTiming.metadataCacheHits, bootTiming.metadataReads, bootTiming.metadataReadTime / 1000.0f);
+}
+
 void BNO080Base::tare(bool zOnly)
 {
 	clearSendBuffer();
@@ -366,13 +425,13 @@ bool BNO080Base::updateData()
 
 uint8_t BNO080Base::getReportStatus(Report report)
 {
-	uint8_t reportNum = static_cast<uint8_t>(report);
-	if(reportNum > STATUS_ARRAY_LEN)
+	uint8_t index = reportIndex(report);
+	if(index == REPORT_INDEX_NONE)
 	{
 		return 0;
 	}
 
-	return reportStatus[reportNum];
+	return reportStatus[index];
 }
 
 const char* BNO080Base::getReportStatusString(Report report)
@@ -394,19 +453,56 @@ const char* BNO080Base::getReportStatusString(Report report)
 
 bool BNO080Base::hasNewData(Report report)
 {
-	uint8_t reportNum = static_cast<uint8_t>(report);
-	if(reportNum > STATUS_ARRAY_LEN)
+	uint8_t index = reportIndex(report);
+	if(index == REPORT_INDEX_NONE)
 	{
 		return false;
 	}
 
-	bool newData = reportHasBeenUpdated[reportNum];
-	reportHasBeenUpdated[reportNum] = false; // clear flag
+	bool newData = reportHasBeenUpdated[index];
+	reportHasBeenUpdated[index] = false; // clear flag
 	return newData;
 }
 
+uint32_t BNO080Base::getReportTimestamp(Report report)
+{
+	uint8_t index = reportIndex(report);
+	if(index == REPORT_INDEX_NONE)
+	{
+		return 0;
+	}
+
+	return reportTimestamp[index];
+}
+
+bool BNO080Base::readSample(Sample & sample)
+{
+	if(sampleQueueCount == 0)
+	{
+		return false;
+	}
+
+	sample = sampleQueue[sampleQueueHead];
+	sampleQueueHead = (sampleQueueHead + 1) % SAMPLE_QUEUE_LEN;
+	--sampleQueueCount;
+	return true;
+}
+
+void BNO080Base::attachSampleRing(Report report, SPSCRingBase<Sample> * ring)
+{
+	uint8_t index = reportIndex(report);
+	if(index == REPORT_INDEX_NONE)
+	{
+		return;
+	}
+
+	lockMutex();
+	sampleRings[index] = ring;
+	unlockMutex();
+}
+
 //Sends the packet to enable the rotation vector
-void BNO080Base::enableReport(Report report, uint16_t timeBetweenReports)
+void BNO080Base::enableReport(Report report, uint16_t timeBetweenReports, uint16_t batchInterval)
 {
 #if BNO_DEBUG
 	// check time is valid
@@ -420,7 +516,7 @@ void BNO080Base::enableReport(Report report, uint16_t timeBetweenReports)
 	}
 
 #endif
-	setFeatureCommand(static_cast<uint8_t>(report), timeBetweenReports);
+	setFeatureCommand(static_cast<uint8_t>(report), timeBetweenReports, 0, batchInterval);
 
 	// note: we don't wait for ACKs on these packets because they can take quite a while, like half a second, to come in
 }
@@ -527,6 +623,33 @@ int16_t BNO080Base::getQ3(Report report)
 	return static_cast<int16_t>(metadataRecord[8] >> 16);
 }
 
+void BNO080Base::onInterruptEdge()
+{
+	intEdgeTime = us_ticker_read();
+	++intEdgeCount;
+}
+
+void BNO080Base::latchInterruptTime()
+{
+	core_util_critical_section_enter();
+	uint32_t edgeTime = intEdgeTime;
+	uint32_t edgeCount = intEdgeCount;
+	core_util_critical_section_exit();
+
+	if(edgeCount != rxLatchedEdgeCount)
+	{
+		rxInterruptTime = edgeTime;
+	}
+	else
+	{
+		// INT is low but no new edge was seen (e.g. it was already asserted when the handler was attached),
+		// so the best reference we have is now.  Samples in this packet will read slightly late.
+		rxInterruptTime = us_ticker_read();
+	}
+
+	rxLatchedEdgeCount = edgeCount;
+}
+
 void BNO080Base::processPacket()
 {
 	if(rxShtpHeader[2] == CHANNEL_CONTROL)
@@ -543,14 +666,96 @@ void BNO080Base::processPacket()
 	}
 	else if(rxShtpHeader[2] == CHANNEL_REPORTS || rxShtpHeader[2] == CHANNEL_WAKE_REPORTS)
 	{
-		if(rxShtpData[0] == SHTP_REPORT_BASE_TIMESTAMP)
+		// a continuation (MSb of the length set) carries the middle of a packet, not a new base timestamp
+		bool continuation = (rxShtpHeader[1] & 0x80) != 0;
+
+		if(!continuation && rxShtpData[0] == SHTP_REPORT_BASE_TIMESTAMP)
 		{
 			// sensor data packet
 			parseSensorDataPacket();
+			publishSnapshot();
+
+			if(awaitingFirstData)
+			{
+				bootTiming.beginToFirstData = us_ticker_read() - bootTiming.beginTime;
+				awaitingFirstData = false;
+			}
+		}
+	}
+	else if(rxShtpHeader[2] == CHANNEL_GYRO)
+	{
+		// gyro-integrated rotation vector, which has this channel to itself
+		if((rxShtpHeader[1] & 0x80) == 0)
+		{
+			parseGyroIntegratedRotationPacket();
+			publishSnapshot();
 		}
 	}
 }
 
+void BNO080Base::startBootTiming()
+{
+	memset(&bootTiming, 0, sizeof(bootTiming));
+	bootTiming.beginTime = us_ticker_read();
+	awaitingFirstData = true;
+	resetReleaseTime = 0;
+	startupEdgeTime = 0;
+}
+
+void BNO080Base::finishBootTiming(uint32_t initializedTime, uint32_t productIDTime)
+{
+	if(resetReleaseTime != 0 && startupEdgeTime != 0)
+	{
+		bootTiming.resetToInterrupt = startupEdgeTime - resetReleaseTime;
+	}
+	if(startupEdgeTime != 0 && initializedTime != 0)
+	{
+		bootTiming.interruptToInitialized = initializedTime - startupEdgeTime;
+	}
+	if(initializedTime != 0 && productIDTime != 0)
+	{
+		bootTiming.initializedToProductID = productIDTime - initializedTime;
+	}
+	bootTiming.beginTotal = us_ticker_read() - bootTiming.beginTime;
+}
+
+void BNO080Base::sendStartupRequests()
+{
+	clearSendBuffer();
+	txShtpData[0] = SHTP_REPORT_PRODUCT_ID_REQUEST; //Request the product ID and reset info
+	txShtpData[1] = 0; //Reserved
+	sendPacket(CHANNEL_CONTROL, 2);
+
+	// no acks to wait for here either, see enableReport()
+	for(size_t index = 0; index < startupReportCount; ++index)
+	{
+		const StartupReport & startupReport = startupReports[index];
+		setFeatureCommand(static_cast<uint8_t>(startupReport.report), startupReport.timeBetweenReports, 0, startupReport.batchInterval);
+	}
+}
+
+bool BNO080Base::parseProductIDResponse()
+{
+	if(rxShtpData[0] != SHTP_REPORT_PRODUCT_ID_RESPONSE)
+	{
+		return false;
+	}
+
+	majorSoftwareVersion = rxShtpData[2];
+	minorSoftwareVersion = rxShtpData[3];
+	patchSoftwareVersion = (rxShtpData[13] << 8) | rxShtpData[12];
+	partNumber = (rxShtpData[7] << 24) | (rxShtpData[6] << 16) | (rxShtpData[5] << 8) | rxShtpData[4];
+	buildNumber = (rxShtpData[11] << 24) | (rxShtpData[10] << 16) | (rxShtpData[9] << 8) | rxShtpData[8];
+
+#if BNO_DEBUG
+	_debugPort->printf("BNO080 reports as SW version %hhu.%hhu.%hu, build %lu, part no. %lu\n",
+					   majorSoftwareVersion, minorSoftwareVersion, patchSoftwareVersion,
+					   buildNumber, partNumber);
+#endif
+
+	return true;
+}
+
 // sizes of various sensor data packet elements
 #define SIZEOF_BASE_TIMESTAMP 5
 #define SIZEOF_TIMESTAMP_REBASE 5
@@ -568,47 +773,243 @@ void BNO080Base::processPacket()
 #define SIZEOF_STEP_COUNTER 12
 #define SIZEOF_SIGNIFICANT_MOTION 6
 #define SIZEOF_SHAKE_DETECTOR 6
+#define SIZEOF_RAW_ACCELEROMETER 16
+#define SIZEOF_RAW_GYROSCOPE 16
+#define SIZEOF_GYRO_INTEGRATED_ROTATION_VECTOR 14 // on CHANNEL_GYRO: no report ID, sequence, status or delay
+
+// size of a sensor data packet element by report ID, or 0 if we don't know the ID
+static size_t sensorReportSize(uint8_t reportID)
+{
+	switch(reportID)
+	{
+		case SENSOR_REPORTID_TIMESTAMP_REBASE: return SIZEOF_TIMESTAMP_REBASE;
+		case SENSOR_REPORTID_ACCELEROMETER: return SIZEOF_ACCELEROMETER;
+		case SENSOR_REPORTID_LINEAR_ACCELERATION: return SIZEOF_LINEAR_ACCELERATION;
+		case SENSOR_REPORTID_GRAVITY: return SIZEOF_LINEAR_ACCELERATION;
+		case SENSOR_REPORTID_GYROSCOPE_CALIBRATED: return SIZEOF_GYROSCOPE_CALIBRATED;
+		case SENSOR_REPORTID_MAGNETIC_FIELD_CALIBRATED: return SIZEOF_MAGNETIC_FIELD_CALIBRATED;
+		case SENSOR_REPORTID_MAGNETIC_FIELD_UNCALIBRATED: return SIZEOF_MAGNETIC_FIELD_UNCALIBRATED;
+		case SENSOR_REPORTID_ROTATION_VECTOR: return SIZEOF_ROTATION_VECTOR;
+		case SENSOR_REPORTID_GAME_ROTATION_VECTOR: return SIZEOF_GAME_ROTATION_VECTOR;
+		case SENSOR_REPORTID_GEOMAGNETIC_ROTATION_VECTOR: return SIZEOF_GEOMAGNETIC_ROTATION_VECTOR;
+		case SENSOR_REPORTID_TAP_DETECTOR: return SIZEOF_TAP_DETECTOR;
+		case SENSOR_REPORTID_STABILITY_CLASSIFIER: return SIZEOF_STABILITY_REPORT;
+		case SENSOR_REPORTID_STEP_DETECTOR: return SIZEOF_STEP_DETECTOR;
+		case SENSOR_REPORTID_STEP_COUNTER: return SIZEOF_STEP_COUNTER;
+		case SENSOR_REPORTID_SIGNIFICANT_MOTION: return SIZEOF_SIGNIFICANT_MOTION;
+		case SENSOR_REPORTID_SHAKE_DETECTOR: return SIZEOF_SHAKE_DETECTOR;
+		case SENSOR_REPORTID_RAW_ACCELEROMETER: return SIZEOF_RAW_ACCELEROMETER;
+		case SENSOR_REPORTID_RAW_GYROSCOPE: return SIZEOF_RAW_GYROSCOPE;
+		default: return 0;
+	}
+}
+
+// reportIndex() has to give each report it handles its own slot, and use every slot
+static constexpr bool reportIndicesAreDense()
+{
+	bool used[SENSOR_REPORT_COUNT] = {};
+	for(unsigned reportID = 0; reportID <= 0xFF; ++reportID)
+	{
+		uint8_t index = BNO080Base::reportIndex(static_cast<uint8_t>(reportID));
+		if(index == REPORT_INDEX_NONE)
+		{
+			continue;
+		}
+		if(index >= SENSOR_REPORT_COUNT || used[index])
+		{
+			return false;
+		}
+		used[index] = true;
+	}
+	for(bool slotUsed : used)
+	{
+		if(!slotUsed)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+static_assert(reportIndicesAreDense(), "reportIndex() must map the sensor reports one-to-one onto 0 .. SENSOR_REPORT_COUNT - 1");
+
+void BNO080Base::publishSnapshot()
+{
+	SensorSnapshot snapshot;
+
+	snapshot.packetCount = ++snapshotPacketCount;
+
+	for(uint16_t axis = 0; axis < 3; ++axis)
+	{
+		snapshot.totalAcceleration[axis] = totalAcceleration[axis];
+		snapshot.linearAcceleration[axis] = linearAcceleration[axis];
+		snapshot.gravityAcceleration[axis] = gravityAcceleration[axis];
+		snapshot.gyroRotation[axis] = gyroRotation[axis];
+		snapshot.magField[axis] = magField[axis];
+	}
+
+	const Quaternion * quaternions[] = {&rotationVector, &gameRotationVector, &geomagneticRotationVector};
+	float * destinations[] = {snapshot.rotationVector, snapshot.gameRotationVector, snapshot.geomagneticRotationVector};
+	for(size_t index = 0; index < 3; ++index)
+	{
+		destinations[index][0] = quaternions[index]->x();
+		destinations[index][1] = quaternions[index]->y();
+		destinations[index][2] = quaternions[index]->z();
+		destinations[index][3] = quaternions[index]->real();
+	}
+
+	snapshot.rotationAccuracy = rotationAccuracy;
+	snapshot.geomagneticRotationAccuracy = geomagneticRotationAccuracy;
+	snapshot.gyroIntegratedRotationVector[0] = gyroIntegratedRotationVector.x();
+	snapshot.gyroIntegratedRotationVector[1] = gyroIntegratedRotationVector.y();
+	snapshot.gyroIntegratedRotationVector[2] = gyroIntegratedRotationVector.z();
+	snapshot.gyroIntegratedRotationVector[3] = gyroIntegratedRotationVector.real();
+	for(uint16_t axis = 0; axis < 3; ++axis)
+	{
+		snapshot.gyroIntegratedAngularVelocity[axis] = gyroIntegratedAngularVelocity[axis];
+	}
+	snapshot.stepCount = stepCount;
+	snapshot.stability = stability;
+	memcpy(snapshot.reportTimestamp, reportTimestamp, sizeof(reportTimestamp));
+	memcpy(snapshot.reportStatus, reportStatus, sizeof(reportStatus));
+
+	latestSnapshot.write(snapshot);
+}
+
+void BNO080Base::queueSample(uint8_t reportNum, float x, float y, float z, float real, float accuracy)
+{
+	Sample sample;
+	uint8_t index = reportIndex(reportNum);
+	sample.report = static_cast<Report>(reportNum);
+	sample.status = reportStatus[index];
+	sample.timestamp = reportTimestamp[index];
+	sample.data[0] = x;
+	sample.data[1] = y;
+	sample.data[2] = z;
+	sample.data[3] = real;
+	sample.accuracy = accuracy;
+	sample.angularVelocity[0] = 0;
+	sample.angularVelocity[1] = 0;
+	sample.angularVelocity[2] = 0;
+
+	pushSample(sample);
+}
+
+void BNO080Base::pushSample(const Sample & sample)
+{
+	SPSCRingBase<Sample> * ring = sampleRings[reportIndex(sample.report)];
+	if(ring != nullptr)
+	{
+		// a full ring counts the overflow itself
+		ring->push(sample);
+		return;
+	}
+
+	if(sampleQueueCount == SAMPLE_QUEUE_LEN)
+	{
+		// full, so the oldest sample makes room
+		sampleQueueHead = (sampleQueueHead + 1) % SAMPLE_QUEUE_LEN;
+		--sampleQueueCount;
+		++droppedSampleCount;
+	}
+
+	sampleQueue[(sampleQueueHead + sampleQueueCount) % SAMPLE_QUEUE_LEN] = sample;
+	++sampleQueueCount;
+}
 
 void BNO080Base::parseSensorDataPacket()
 {
 	size_t currReportOffset = 0;
 
-	// every sensor data report first contains a timestamp offset to show how long it has been between when
-	// the host interrupt was sent and when the packet was transmitted.
-	// We don't use interrupts and don't care about times, so we can throw this out.
+	if(rxPacketLength < SIZEOF_BASE_TIMESTAMP)
+	{
+		// not even a whole base timestamp; the rest of the buffer is from an older packet
+		return;
+	}
+
+	// every sensor data packet first contains a base timestamp: how long before the host interrupt was asserted
+	// the reports in it were taken (SH-2 section 7.2.1).  Counting back from when we saw the INT edge puts the
+	// reports on the host clock.  All of these deltas are signed, in 100us ticks.
+	int32_t baseDelta = static_cast<int32_t>(static_cast<uint32_t>(rxShtpData[4]) << 24 | static_cast<uint32_t>(rxShtpData[3]) << 16
+			| static_cast<uint32_t>(rxShtpData[2]) << 8 | rxShtpData[1]);
+	uint32_t packetBaseTime = rxInterruptTime - static_cast<uint32_t>(baseDelta) * SHTP_TIMESTAMP_TICK_US;
+
+	// a timestamp rebase moves the base for the reports after it in the same packet, and rebases add up
+	uint32_t reportBaseTime = packetBaseTime;
+
 	currReportOffset += SIZEOF_BASE_TIMESTAMP;
 
-	while(currReportOffset < rxPacketLength)
+	// a batched packet holds many reports back to back; only parse what made it into the buffer
+	size_t packetLength = std::min<size_t>(rxPacketLength, SHTP_RX_PACKET_SIZE);
+	if(rxPacketLength > SHTP_RX_PACKET_SIZE)
 	{
+		_debugPort->printf("Error: sensor report longer than packet buffer! Some data was not read! Increase SHTP_RX_PACKET_SIZE or decrease the batch interval!\r\n");
+	}
+
+	while(currReportOffset < packetLength)
+	{
+		size_t reportSize = sensorReportSize(rxShtpData[currReportOffset]);
+		if(reportSize == 0)
+		{
+			_debugPort->printf("Error: unrecognized report ID in sensor report: %hhx.  Byte %u, length %hu\n", rxShtpData[currReportOffset], currReportOffset, rxPacketLength);
+			return;
+		}
+		if(currReportOffset + reportSize > packetLength)
+		{
+			// truncated report at the end of the buffer
+			return;
+		}
+
 		// lots of sensor reports use 3 16-bit numbers stored in bytes 4 through 9
 		// we can save some time by parsing those out here.
-		uint16_t data1 = (uint16_t)rxShtpData[currReportOffset + 5] << 8 | rxShtpData[currReportOffset + 4];
-		uint16_t data2 = (uint16_t)rxShtpData[currReportOffset + 7] << 8 | rxShtpData[currReportOffset + 6];
-		uint16_t data3 = (uint16_t)rxShtpData[currReportOffset + 9] << 8 | rxShtpData[currReportOffset + 8];
+		// Shorter reports (tap, stability, ...) don't have them, and at the end of a full buffer they'd be past it.
+		uint16_t data1 = 0, data2 = 0, data3 = 0;
+		if(reportSize >= 10)
+		{
+			data1 = (uint16_t)rxShtpData[currReportOffset + 5] << 8 | rxShtpData[currReportOffset + 4];
+			data2 = (uint16_t)rxShtpData[currReportOffset + 7] << 8 | rxShtpData[currReportOffset + 6];
+			data3 = (uint16_t)rxShtpData[currReportOffset + 9] << 8 | rxShtpData[currReportOffset + 8];
+		}
 
 		uint8_t reportNum = rxShtpData[currReportOffset];
+		uint8_t index = reportIndex(reportNum);
 
-		if(reportNum != SENSOR_REPORTID_TIMESTAMP_REBASE)
+		// every ID with a known size except the timestamp rebase is a sensor report with a slot
+		if(index != REPORT_INDEX_NONE)
 		{
 			// set status from byte 2
-			reportStatus[reportNum] = static_cast<uint8_t>(rxShtpData[currReportOffset + 2] & 0b11);
+			reportStatus[index] = static_cast<uint8_t>(rxShtpData[currReportOffset + 2] & 0b11);
 
 			// set updated flag
-			reportHasBeenUpdated[reportNum] = true;
+			reportHasBeenUpdated[index] = true;
+
+			// sample time: the (possibly rebased) base plus this report's 14-bit delay,
+			// whose top 6 bits share byte 2 with the status (SH-2 section 6.5.1)
+			uint16_t delayTicks = static_cast<uint16_t>((rxShtpData[currReportOffset + 2] & 0xFC) << 6 | rxShtpData[currReportOffset + 3]);
+			reportTimestamp[index] = reportBaseTime + delayTicks * SHTP_TIMESTAMP_TICK_US;
 		}
 
 		switch(rxShtpData[currReportOffset])
 		{
 			case SENSOR_REPORTID_TIMESTAMP_REBASE:
+			{
+				// relative to the base in force, so several in one packet accumulate (SH-2 section 7.2.2,
+				// and the SH-2 reference driver's referenceDelta += rebase)
+				int32_t rebaseDelta = static_cast<int32_t>(static_cast<uint32_t>(rxShtpData[currReportOffset + 4]) << 24
+						| static_cast<uint32_t>(rxShtpData[currReportOffset + 3]) << 16
+						| static_cast<uint32_t>(rxShtpData[currReportOffset + 2]) << 8 | rxShtpData[currReportOffset + 1]);
+				reportBaseTime += static_cast<uint32_t>(rebaseDelta) * SHTP_TIMESTAMP_TICK_US;
+
 				currReportOffset += SIZEOF_TIMESTAMP_REBASE;
+			}
 				break;
 
 			case SENSOR_REPORTID_ACCELEROMETER:
 
 				totalAcceleration = TVector3(
-						qToFloat(data1, ACCELEROMETER_Q_POINT),
-						qToFloat(data2, ACCELEROMETER_Q_POINT),
-				 		qToFloat(data3, ACCELEROMETER_Q_POINT));
+						qToFloat<ACCELEROMETER_Q_POINT>(data1),
+						qToFloat<ACCELEROMETER_Q_POINT>(data2),
+				 		qToFloat<ACCELEROMETER_Q_POINT>(data3));
+				queueSample(reportNum, totalAcceleration[0], totalAcceleration[1], totalAcceleration[2]);
 
 				currReportOffset += SIZEOF_ACCELEROMETER;
 				break;
@@ -616,9 +1017,10 @@ void BNO080Base::parseSensorDataPacket()
 			case SENSOR_REPORTID_LINEAR_ACCELERATION:
 
 				linearAcceleration = TVector3(
-						qToFloat(data1, ACCELEROMETER_Q_POINT),
-						qToFloat(data2, ACCELEROMETER_Q_POINT),
-						qToFloat(data3, ACCELEROMETER_Q_POINT));
+						qToFloat<ACCELEROMETER_Q_POINT>(data1),
+						qToFloat<ACCELEROMETER_Q_POINT>(data2),
+						qToFloat<ACCELEROMETER_Q_POINT>(data3));
+				queueSample(reportNum, linearAcceleration[0], linearAcceleration[1], linearAcceleration[2]);
 
 				currReportOffset += SIZEOF_LINEAR_ACCELERATION;
 				break;
@@ -626,9 +1028,10 @@ void BNO080Base::parseSensorDataPacket()
 			case SENSOR_REPORTID_GRAVITY:
 
 				gravityAcceleration = TVector3(
-						qToFloat(data1, ACCELEROMETER_Q_POINT),
-						qToFloat(data2, ACCELEROMETER_Q_POINT),
-						qToFloat(data3, ACCELEROMETER_Q_POINT));
+						qToFloat<ACCELEROMETER_Q_POINT>(data1),
+						qToFloat<ACCELEROMETER_Q_POINT>(data2),
+						qToFloat<ACCELEROMETER_Q_POINT>(data3));
+				queueSample(reportNum, gravityAcceleration[0], gravityAcceleration[1], gravityAcceleration[2]);
 
 				currReportOffset += SIZEOF_LINEAR_ACCELERATION;
 				break;
@@ -636,9 +1039,10 @@ void BNO080Base::parseSensorDataPacket()
 			case SENSOR_REPORTID_GYROSCOPE_CALIBRATED:
 
 				gyroRotation = TVector3(
-						qToFloat(data1, GYRO_Q_POINT),
-						qToFloat(data2, GYRO_Q_POINT),
-						qToFloat(data3, GYRO_Q_POINT));
+						qToFloat<GYRO_Q_POINT>(data1),
+						qToFloat<GYRO_Q_POINT>(data2),
+						qToFloat<GYRO_Q_POINT>(data3));
+				queueSample(reportNum, gyroRotation[0], gyroRotation[1], gyroRotation[2]);
 
 				currReportOffset += SIZEOF_GYROSCOPE_CALIBRATED;
 				break;
@@ -646,9 +1050,10 @@ void BNO080Base::parseSensorDataPacket()
 			case SENSOR_REPORTID_MAGNETIC_FIELD_CALIBRATED:
 
 				magField = TVector3(
-						qToFloat(data1, MAGNETOMETER_Q_POINT),
-						qToFloat(data2, MAGNETOMETER_Q_POINT),
-						qToFloat(data3, MAGNETOMETER_Q_POINT));
+						qToFloat<MAGNETOMETER_Q_POINT>(data1),
+						qToFloat<MAGNETOMETER_Q_POINT>(data2),
+						qToFloat<MAGNETOMETER_Q_POINT>(data3));
+				queueSample(reportNum, magField[0], magField[1], magField[2]);
 
 				currReportOffset += SIZEOF_MAGNETIC_FIELD_CALIBRATED;
 				break;
@@ -656,18 +1061,19 @@ void BNO080Base::parseSensorDataPacket()
 			case SENSOR_REPORTID_MAGNETIC_FIELD_UNCALIBRATED:
 			{
 				magFieldUncalibrated = TVector3(
-						qToFloat(data1, MAGNETOMETER_Q_POINT),
-						qToFloat(data2, MAGNETOMETER_Q_POINT),
-						qToFloat(data3, MAGNETOMETER_Q_POINT));
+						qToFloat<MAGNETOMETER_Q_POINT>(data1),
+						qToFloat<MAGNETOMETER_Q_POINT>(data2),
+						qToFloat<MAGNETOMETER_Q_POINT>(data3));
 
 				uint16_t ironOffsetXQ = (uint16_t) rxShtpData[currReportOffset + 11] << 8 | rxShtpData[currReportOffset + 10];
 				uint16_t ironOffsetYQ = (uint16_t) rxShtpData[currReportOffset + 13] << 8 | rxShtpData[currReportOffset + 12];
 				uint16_t ironOffsetZQ = (uint16_t) rxShtpData[currReportOffset + 15] << 8 | rxShtpData[currReportOffset + 14];
 
 				hardIronOffset = TVector3(
-						qToFloat(ironOffsetXQ, MAGNETOMETER_Q_POINT),
-					  	qToFloat(ironOffsetYQ, MAGNETOMETER_Q_POINT),
-	  					qToFloat(ironOffsetZQ, MAGNETOMETER_Q_POINT));
+						qToFloat<MAGNETOMETER_Q_POINT>(ironOffsetXQ),
+					  	qToFloat<MAGNETOMETER_Q_POINT>(ironOffsetYQ),
+	  					qToFloat<MAGNETOMETER_Q_POINT>(ironOffsetZQ));
+				queueSample(reportNum, magFieldUncalibrated[0], magFieldUncalibrated[1], magFieldUncalibrated[2]);
 
 				currReportOffset += SIZEOF_MAGNETIC_FIELD_UNCALIBRATED;
 			}
@@ -679,12 +1085,13 @@ void BNO080Base::parseSensorDataPacket()
 				uint16_t accuracyQ = (uint16_t) rxShtpData[currReportOffset + 13] << 8 | rxShtpData[currReportOffset + 12];
 
 				rotationVector = TVector4(
-						qToFloat(data1, ROTATION_Q_POINT),
-						qToFloat(data2, ROTATION_Q_POINT),
-						qToFloat(data3, ROTATION_Q_POINT),
-						qToFloat(realPartQ, ROTATION_Q_POINT));
+						qToFloat<ROTATION_Q_POINT>(data1),
+						qToFloat<ROTATION_Q_POINT>(data2),
+						qToFloat<ROTATION_Q_POINT>(data3),
+						qToFloat<ROTATION_Q_POINT>(realPartQ));
 
-				rotationAccuracy = qToFloat(accuracyQ, ROTATION_ACCURACY_Q_POINT);
+				rotationAccuracy = qToFloat<ROTATION_ACCURACY_Q_POINT>(accuracyQ);
+				queueSample(reportNum, rotationVector.x(), rotationVector.y(), rotationVector.z(), rotationVector.real(), rotationAccuracy);
 
 				currReportOffset += SIZEOF_ROTATION_VECTOR;
 			}
@@ -695,10 +1102,11 @@ void BNO080Base::parseSensorDataPacket()
 				uint16_t realPartQ = (uint16_t) rxShtpData[currReportOffset + 11] << 8 | rxShtpData[currReportOffset + 10];
 
 				gameRotationVector = TVector4(
-						qToFloat(data1, ROTATION_Q_POINT),
-						qToFloat(data2, ROTATION_Q_POINT),
-						qToFloat(data3, ROTATION_Q_POINT),
-						qToFloat(realPartQ, ROTATION_Q_POINT));
+						qToFloat<ROTATION_Q_POINT>(data1),
+						qToFloat<ROTATION_Q_POINT>(data2),
+						qToFloat<ROTATION_Q_POINT>(data3),
+						qToFloat<ROTATION_Q_POINT>(realPartQ));
+				queueSample(reportNum, gameRotationVector.x(), gameRotationVector.y(), gameRotationVector.z(), gameRotationVector.real());
 
 				currReportOffset += SIZEOF_GAME_ROTATION_VECTOR;
 			}
@@ -710,12 +1118,14 @@ void BNO080Base::parseSensorDataPacket()
 				uint16_t accuracyQ = (uint16_t) rxShtpData[currReportOffset + 13] << 8 | rxShtpData[currReportOffset + 12];
 
 				geomagneticRotationVector = TVector4(
-						qToFloat(data1, ROTATION_Q_POINT),
-						qToFloat(data2, ROTATION_Q_POINT),
-						qToFloat(data3, ROTATION_Q_POINT),
-						qToFloat(realPartQ, ROTATION_Q_POINT));
+						qToFloat<ROTATION_Q_POINT>(data1),
+						qToFloat<ROTATION_Q_POINT>(data2),
+						qToFloat<ROTATION_Q_POINT>(data3),
+						qToFloat<ROTATION_Q_POINT>(realPartQ));
 
-				geomagneticRotationAccuracy = qToFloat(accuracyQ, ROTATION_ACCURACY_Q_POINT);
+				geomagneticRotationAccuracy = qToFloat<ROTATION_ACCURACY_Q_POINT>(accuracyQ);
+				queueSample(reportNum, geomagneticRotationVector.x(), geomagneticRotationVector.y(), geomagneticRotationVector.z(),
+							geomagneticRotationVector.real(), geomagneticRotationAccuracy);
 
 				currReportOffset += SIZEOF_GEOMAGNETIC_ROTATION_VECTOR;
 			}
@@ -783,19 +1193,83 @@ void BNO080Base::parseSensorDataPacket()
 				currReportOffset += SIZEOF_SHAKE_DETECTOR;
 
 				break;
-				
+
+			case SENSOR_REPORTID_RAW_ACCELEROMETER:
+
+				// ADC counts, so no Q point.  The sensor's own microsecond timestamp in bytes 12-15 isn't used.
+				rawAcceleration[0] = static_cast<int16_t>(data1);
+				rawAcceleration[1] = static_cast<int16_t>(data2);
+				rawAcceleration[2] = static_cast<int16_t>(data3);
+				queueSample(reportNum, rawAcceleration[0], rawAcceleration[1], rawAcceleration[2]);
+
+				currReportOffset += SIZEOF_RAW_ACCELEROMETER;
+				break;
+
+			case SENSOR_REPORTID_RAW_GYROSCOPE:
+
+				// as above; bytes 10-11 hold the gyro's temperature
+				rawGyroRotation[0] = static_cast<int16_t>(data1);
+				rawGyroRotation[1] = static_cast<int16_t>(data2);
+				rawGyroRotation[2] = static_cast<int16_t>(data3);
+				queueSample(reportNum, rawGyroRotation[0], rawGyroRotation[1], rawGyroRotation[2]);
+
+				currReportOffset += SIZEOF_RAW_GYROSCOPE;
+				break;
+
 			default:
 				_debugPort->printf("Error: unrecognized report ID in sensor report: %hhx.  Byte %u, length %hu\n", rxShtpData[currReportOffset], currReportOffset, rxPacketLength);
 				return;
 		}
+	}
 
-		if(currReportOffset >= SHTP_RX_PACKET_SIZE)
+}
+
+void BNO080Base::parseGyroIntegratedRotationPacket()
+{
+	// This report comes at up to 1kHz, so it skips the generic report machinery: no report ID to look up, no base
+	// timestamp, just i, j, k, real (Q14) and the angular velocity (Q10) as little-endian words (SH-2 section 6.5.44).
+	// The IMU sends one sample per packet; the loop only matters if it ever sends more.
+	// It has no status field either, so its reportStatus entry stays 0 (unreliable) as documented for the Report.
+	constexpr uint8_t index = reportIndex(SENSOR_REPORTID_GYRO_INTEGRATED_ROTATION_VECTOR);
+	size_t packetLength = std::min<size_t>(rxPacketLength, SHTP_RX_PACKET_SIZE);
+
+	for(size_t offset = 0; offset + SIZEOF_GYRO_INTEGRATED_ROTATION_VECTOR <= packetLength; offset += SIZEOF_GYRO_INTEGRATED_ROTATION_VECTOR)
+	{
+		const uint8_t * report = rxShtpData + offset;
+		int16_t words[7];
+		for(size_t word = 0; word < 7; ++word)
 		{
-			_debugPort->printf("Error: sensor report longer than packet buffer! Some data was not read! Increase buffer size or decrease number of reports!\r\n");
-			return;
+			words[word] = static_cast<int16_t>(report[2 * word + 1] << 8 | report[2 * word]);
 		}
-	}
 
+		gyroIntegratedRotationVector = TVector4(
+				qToFloat<ROTATION_Q_POINT>(words[0]),
+				qToFloat<ROTATION_Q_POINT>(words[1]),
+				qToFloat<ROTATION_Q_POINT>(words[2]),
+				qToFloat<ROTATION_Q_POINT>(words[3]));
+		gyroIntegratedAngularVelocity = TVector3(
+				qToFloat<ANGULAR_VELOCITY_Q_POINT>(words[4]),
+				qToFloat<ANGULAR_VELOCITY_Q_POINT>(words[5]),
+				qToFloat<ANGULAR_VELOCITY_Q_POINT>(words[6]));
+
+		// nothing says how old the sample is, so the interrupt is the best timestamp there is
+		reportHasBeenUpdated[index] = true;
+		reportTimestamp[index] = rxInterruptTime;
+
+		Sample sample;
+		sample.report = GYRO_INTEGRATED_ROTATION;
+		sample.status = reportStatus[index];
+		sample.timestamp = rxInterruptTime;
+		sample.data[0] = gyroIntegratedRotationVector.x();
+		sample.data[1] = gyroIntegratedRotationVector.y();
+		sample.data[2] = gyroIntegratedRotationVector.z();
+		sample.data[3] = gyroIntegratedRotationVector.real();
+		sample.accuracy = 0;
+		sample.angularVelocity[0] = gyroIntegratedAngularVelocity[0];
+		sample.angularVelocity[1] = gyroIntegratedAngularVelocity[1];
+		sample.angularVelocity[2] = gyroIntegratedAngularVelocity[2];
+		pushSample(sample);
+	}
 }
 
 bool BNO080Base::waitForPacket(int channel, uint8_t reportID, std::chrono::milliseconds timeout)
@@ -833,30 +1307,24 @@ bool BNO080Base::waitForPacket(int channel, uint8_t reportID, std::chrono::milli
 //See https://en.wikipedia.org/wiki/Q_(number_format)
 float BNO080Base::qToFloat(int16_t fixedPointValue, uint8_t qPoint)
 {
-	float qFloat = fixedPointValue;
-	qFloat *= pow(2.0f, qPoint * -1);
-	return (qFloat);
+	return QFormat::toFloat(fixedPointValue, qPoint);
 }
 
 float BNO080Base::qToFloat_dword(uint32_t fixedPointValue, int16_t qPoint)
 {
-	float qFloat = fixedPointValue;
-	qFloat *= pow(2.0f, qPoint * -1);
-	return (qFloat);
+	return QFormat::toFloat(fixedPointValue, qPoint);
 }
 
 //Given a floating point value and a Q point, convert to Q
 //See https://en.wikipedia.org/wiki/Q_(number_format)
 int16_t BNO080Base::floatToQ(float qFloat, uint8_t qPoint)
 {
-	int16_t qVal = static_cast<int16_t>(qFloat * pow(2.0f, qPoint));
-	return qVal;
+	return static_cast<int16_t>(QFormat::fromFloat(qFloat, qPoint));
 }
 
 int32_t BNO080Base::floatToQ_dword(float qFloat, uint16_t qPoint)
 {
-	int32_t qVal = static_cast<int32_t>(qFloat * pow(2.0f, qPoint));
-	return qVal;
+	return QFormat::fromFloat(qFloat, qPoint);
 }
 //Tell the sensor to do a command
 //See 6.3.8 page 41, Command request
@@ -884,11 +1352,12 @@ void BNO080Base::sendCommand(uint8_t command)
 
 //Given a sensor's report ID, this tells the BNO080 to begin reporting the values
 //Also sets the specific config word. Useful for personal activity classifier
-void BNO080Base::setFeatureCommand(uint8_t reportID, uint16_t timeBetweenReports, uint32_t specificConfig)
+void BNO080Base::setFeatureCommand(uint8_t reportID, uint16_t timeBetweenReports, uint32_t specificConfig, uint16_t batchInterval)
 {
 	uint32_t microsBetweenReports = static_cast<uint32_t>(timeBetweenReports * 1000);
 
-	const uint32_t batchMicros = 0;
+	// nonzero lets the IMU hold samples in its FIFO for up to this long and send them together
+	uint32_t batchMicros = static_cast<uint32_t>(batchInterval) * 1000;
 
 	txShtpData[0] = SHTP_REPORT_SET_FEATURE_COMMAND; //Set feature command. Reference page 55
 	txShtpData[1] = reportID; //Feature Report ID. 0x01 = Accelerometer, 0x05 = Rotation vector
@@ -1228,7 +1697,7 @@ bool BNO080Base::loadReportMetadata(BNO080Base::Report report)
 	switch(report)
 	{
 		case TOTAL_ACCELERATION:
-			reportMetaRecord = 0xE301;
+			reportMetaRecord = 0xE302;
 			break;
 		case LINEAR_ACCELERATION:
 			reportMetaRecord = 0xE303;
@@ -1272,6 +1741,20 @@ bool BNO080Base::loadReportMetadata(BNO080Base::Report report)
 		case SHAKE_DETECTOR:
 			reportMetaRecord = 0xE318;
 			break;
+		case RAW_ACCELEROMETER:
+			reportMetaRecord = 0xE301;
+			break;
+		case RAW_GYROSCOPE:
+			reportMetaRecord = 0xE305;
+			break;
+		case GYRO_INTEGRATED_ROTATION:
+			// not one of the sensor metadata records above
+			break;
+	}
+
+	if(reportMetaRecord == 0)
+	{
+		return false;
 	}
 
 	// if we already have that data stored, everything's OK
@@ -1280,8 +1763,27 @@ bool BNO080Base::loadReportMetadata(BNO080Base::Report report)
 		return true;
 	}
 
+	// next, try the cache.  It only counts if it came from this firmware build, which we know once begin() has run.
+	uint8_t cacheIndex = static_cast<uint8_t>((reportMetaRecord & 0xFF) - 1);
+	bool cacheUsable = metadataCache != nullptr && buildNumber != 0;
+
+	if(cacheUsable && metadataCache->magic == METADATA_CACHE_MAGIC && metadataCache->buildNumber == buildNumber
+		&& (metadataCache->validRecords & (1UL << cacheIndex)))
+	{
+		memcpy(metadataRecord, metadataCache->records[cacheIndex], sizeof(metadataRecord));
+		bufferMetadataRecord = reportMetaRecord;
+		++bootTiming.metadataCacheHits;
+
+		return true;
+	}
+
 	// now, load the metadata into the buffer
-	if(!readFRSRecord(reportMetaRecord, metadataRecord, METADATA_BUFFER_LEN))
+	uint32_t readStartTime = us_ticker_read();
+	bool readOK = readFRSRecord(reportMetaRecord, metadataRecord, METADATA_BUFFER_LEN);
+	bootTiming.metadataReadTime += us_ticker_read() - readStartTime;
+	++bootTiming.metadataReads;
+
+	if(!readOK)
 	{
 		// clear this so future calls won't try to use the cached version
 		bufferMetadataRecord = 0;
@@ -1291,6 +1793,21 @@ bool BNO080Base::loadReportMetadata(BNO080Base::Report report)
 
 	bufferMetadataRecord = reportMetaRecord;
 
+	if(cacheUsable)
+	{
+		if(metadataCache->magic != METADATA_CACHE_MAGIC || metadataCache->buildNumber != buildNumber)
+		{
+			// empty, or from other firmware whose metadata may differ: start over
+			memset(metadataCache, 0, sizeof(MetadataCache));
+			metadataCache->magic = METADATA_CACHE_MAGIC;
+			metadataCache->buildNumber = buildNumber;
+		}
+
+		memcpy(metadataCache->records[cacheIndex], metadataRecord, sizeof(metadataRecord));
+		metadataCache->validRecords |= 1UL << cacheIndex;
+		metadataCacheDirty = true;
+	}
+
 	return true;
 }
 
@@ -1356,30 +1873,18 @@ bool BNO080I2C::receivePacket(std::chrono::milliseconds timeout)
 
 	}
 
-	// start the transaction and contact the IMU
-	_i2cPort.start();
-
-	// to indicate an i2c read, shift the 7 bit address up 1 bit and set bit 0 to a 1
-	int writeResult = _i2cPort.write((_i2cAddress << 1) | 0x1);
+	latchInterruptTime();
 
-	if(writeResult != 1)
+	// Per SHTP section 2.3.2, an I2C read always starts with the packet header.  Reading just the header
+	// first tells us how long the packet is; the IMU then sends the rest as a continuation, which starts
+	// with the header again (continuation bit set) followed by the data.
+	// Both reads are single block transfers rather than a HAL call per byte.
+	if(!i2cReadAndWait(rxPacketBuffer, SHTP_HEADER_SIZE))
 	{
 		_debugPort->printf("BNO I2C read failed!\n");
 		return false;
 	}
 
-	//Get the first four bytes, aka the packet header
-	uint8_t packetLSB = static_cast<uint8_t>(_i2cPort.read(true));
-	uint8_t packetMSB = static_cast<uint8_t>(_i2cPort.read(true));
-	uint8_t channelNumber = static_cast<uint8_t>(_i2cPort.read(true));
-	uint8_t sequenceNum = static_cast<uint8_t>(_i2cPort.read(true)); //Not sure if we need to store this or not
-
-	//Store the header info
-	rxShtpHeader[0] = packetLSB;
-	rxShtpHeader[1] = packetMSB;
-	rxShtpHeader[2] = channelNumber;
-	rxShtpHeader[3] = sequenceNum;
-
 	if(rxShtpHeader[0] == 0xFF && rxShtpHeader[1] == 0xFF)
 	{
 		// invalid according to BNO080 datasheet section 1.4.1
@@ -1391,107 +1896,103 @@ bool BNO080I2C::receivePacket(std::chrono::milliseconds timeout)
 	}
 
 	//Calculate the number of data bytes in this packet
-	rxPacketLength = (static_cast<uint16_t>(packetMSB) << 8 | packetLSB);
+	uint16_t totalLength = (static_cast<uint16_t>(rxShtpHeader[1]) << 8 | rxShtpHeader[0]);
 
 	// Clear the MSbit.
-	// This bit indicates if this package is a continuation of the last. TBH, I don't really know what this means (it's not really explained in the datasheet)
-	// but we don't actually care about any of the advertisement packets
-	// that use this, so we can just cut off the rest of the packet by releasing chip select.
-	rxPacketLength &= ~(1 << 15);
+	// This bit indicates if this package is a continuation of the last.  processPacket() ignores continuations,
+	// so a packet that didn't fit in the buffer loses its tail rather than being misparsed.
+	totalLength &= ~(1 << 15);
 
-	if (rxPacketLength == 0)
+	if (totalLength < SHTP_HEADER_SIZE)
 	{
-		// Packet is empty
+		// Packet is empty (or too short to hold its own header, which would underflow rxPacketLength)
 		return (false); //All done
 	}
 
-	rxPacketLength -= 4; //Remove the header bytes from the data count
+	rxPacketLength = totalLength - SHTP_HEADER_SIZE; //Remove the header bytes from the data count
 
-	//Read incoming data into the shtpData array
-	for (uint16_t dataSpot = 0 ; dataSpot < rxPacketLength ; dataSpot++)
+	if(rxPacketLength == 0)
 	{
-		bool sendACK = dataSpot < rxPacketLength - 1;
+		// header only, nothing more to read
+		return true;
+	}
 
-		// per the datasheet, 0xFF is used as filler for the receiver to transmit back
-		uint8_t incoming = static_cast<uint8_t>(_i2cPort.read(sendACK));
-		if (dataSpot < (sizeof(rxPacketBuffer) - SHTP_HEADER_SIZE)) //BNO080 can respond with upto 270 bytes, avoid overflow
-			rxShtpData[dataSpot] = incoming; //Store data into the shtpData array
+	// only receive as many bytes as we can fit.  The IMU sends whatever we don't read as another continuation.
+	size_t receiveLength = std::min<size_t>(totalLength, SHTP_HEADER_SIZE + SHTP_RX_PACKET_SIZE);
+	if(totalLength > receiveLength)
+	{
+		_debugPort->printf("Packet too long (%" PRIu16 " bytes), increase SHTP_RX_PACKET_SIZE\n", rxPacketLength);
 	}
 
-	_i2cPort.stop();
+	// read the repeated header and the data, then put the original header back
+	// (the repeat has the continuation bit set)
+	uint8_t header[SHTP_HEADER_SIZE];
+	memcpy(header, rxShtpHeader, SHTP_HEADER_SIZE);
 
-	/*
-	// first read the header to get the length of the packet
-	int i2cResult;
-	i2cResult = _i2cPort.read(_i2cAddress << 1, reinterpret_cast<char*>(packetBuffer), SHTP_HEADER_SIZE, false);
-	if(i2cResult != 0)
+	if(!i2cReadAndWait(rxPacketBuffer, receiveLength))
 	{
-		_debugPort->printf("BNO I2C length read failed!\n");
+		_debugPort->printf("BNO I2C read failed!\n");
 		return false;
 	}
 
-	if(shtpHeader[0] == 0xFF && shtpHeader[1] == 0xFF)
-	{
-		// invalid according to BNO080 datasheet section 1.4.1
+	memcpy(rxShtpHeader, header, SHTP_HEADER_SIZE);
+
 #if BNO_DEBUG
-		_debugPort->printf("Recieved 0xFFFF packet length, protocol error!\n");
+	_debugPort->printf("Recieved packet: ----------------\n");
+	printPacket(rxPacketBuffer); // note: add 4 for the header length
 #endif
-		return false;
-	}
 
-	//Calculate the number of data bytes in this packet
-	uint16_t totalLength = (static_cast<uint16_t>(shtpHeader[1]) << 8 | shtpHeader[0]);
+	return (true); //We're done!
+}
 
-	// Clear the MSbit.
-	// This bit indicates if this package is a continuation of the last. TBH, I don't really know what this means (it's not really explained in the datasheet)
-	// but we don't actually care about any of the advertisement packets
-	// that use this, so we can just cut off the rest of the packet by releasing chip select.
-	totalLength &= ~(1 << 15);
+#if USE_ASYNC_I2C
 
-	if (totalLength == 0)
-	{
-		// Packet is empty
-		return (false); //All done
-	}
+bool BNO080I2C::i2cReadAndWait(uint8_t * buffer, int length)
+{
+	i2cCompleteFlag.clear();
 
-	// only receive as many bytes as we can fit
-	if(totalLength > sizeof(packetBuffer))
+	if(_i2cPort.transfer(_i2cAddress << 1, nullptr, 0, reinterpret_cast<char*>(buffer), length,
+						 callback(this, &BNO080I2C::onI2CTransferComplete), I2C_EVENT_ALL) != 0)
 	{
-		totalLength = sizeof(packetBuffer);
+		// bus busy
+		return false;
 	}
 
-	packetLength = totalLength - 4; //Remove the header bytes from the data count
-
-	waitStartTime.reset();
-
-	while(_int.read() != 0)
+	// a stuck bus or a lost completion interrupt must not hang the driver thread
+	uint32_t timeoutMs = static_cast<uint32_t>((length + 1) * 9 * 1000 / _i2cPortSpeed + 1 + (BNO080_I2C_TRANSFER_MARGIN).count());
+	uint32_t waitResult = i2cCompleteFlag.wait_any(I2C_EVENT_ALL, timeoutMs);
+	if(waitResult & osFlagsError)
 	{
-		if(waitStartTime.elapsed_time() > timeout)
-		{
-			_debugPort->printf("BNO I2C wait timeout\n");
-			return false;
-		}
-
+		// on timeout, wait_any() returns an error code with the top bit set.
+		// A completion that races the abort is cleared before the next transfer.
+		_i2cPort.abort_transfer();
+		_debugPort->printf("BNO Async I2C timed out after %" PRIu32 " ms\n", timeoutMs);
+		return false;
 	}
-
-	//Read the actual packet bytes
-	_debugPort->printf("Attempting to read %" PRIu16 " bytes\n", totalLength);
-	i2cResult = _i2cPort.read(_i2cAddress << 1, reinterpret_cast<char*>(packetBuffer), totalLength);
-	if(i2cResult != 0)
+	if(!(waitResult & I2C_EVENT_TRANSFER_COMPLETE) || (waitResult & (I2C_EVENT_ERROR | I2C_EVENT_ERROR_NO_SLAVE)))
 	{
-		_debugPort->printf("BNO I2C read failed!\n");
+		// at least let the user know the error happened...
+		_debugPort->printf("BNO Async I2C Error %" PRIu32 "\n", waitResult);
 		return false;
 	}
-	*/
 
-#if BNO_DEBUG
-	_debugPort->printf("Recieved packet: ----------------\n");
-	printPacket(rxPacketBuffer); // note: add 4 for the header length
-#endif
+	return true;
+}
 
-	return (true); //We're done!
+void BNO080I2C::onI2CTransferComplete(int event)
+{
+	i2cCompleteFlag.set(event);
 }
 
+#else
+
+bool BNO080I2C::i2cReadAndWait(uint8_t * buffer, int length)
+{
+	return _i2cPort.read(_i2cAddress << 1, reinterpret_cast<char*>(buffer), length) == 0;
+}
+
+#endif
+
 BNO080SPI::BNO080SPI(Stream *debugPort, PinName rstPin, PinName intPin, PinName wakePin, PinName misoPin,
 					 PinName mosiPin, PinName sclkPin, PinName csPin, int spiSpeed):
 BNO080Base(debugPort, intPin, rstPin),
@@ -1531,6 +2032,9 @@ bool BNO080SPI::sendPacket(uint8_t channelNumber, uint8_t dataLength)
 		_wakePin = 1;
 	}
 
+	// this transfer may also receive a packet, announced by the same INT edge
+	latchInterruptTime();
+
 	uint16_t totalLength = dataLength + 4; //Add four bytes for the header
 
 	txShtpHeader[0] = totalLength & 0xFF;
@@ -1587,6 +2091,8 @@ bool BNO080SPI::receivePacket(std::chrono::milliseconds timeout)
 
 	}
 
+	latchInterruptTime();
+
 	// read the header bytes first.
 	spiTransferAndWait(nullptr, 0, rxPacketBuffer, SHTP_HEADER_SIZE);
 
@@ -1614,9 +2120,9 @@ bool BNO080SPI::receiveCompletePacket(size_t bytesRead, std::chrono::millisecond
 	// Clear the MSbit.
 	totalLength &= ~(1 << 15);
 
-	if (totalLength == 0)
+	if (totalLength < SHTP_HEADER_SIZE)
 	{
-		// Packet is empty
+		// Packet is empty (or too short to hold its own header, which would underflow rxPacketLength)
 		return (false); //All done
 	}
 
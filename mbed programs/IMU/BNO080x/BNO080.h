@@ -26,6 +26,9 @@
 #include <quaternion.h>
 
 #include "BNO080Constants.h"
+#include "SampleRing.h"
+#include "Seqlock.h"
+#include "QFormat.h"
 
 // useful define when working with orientation quaternions
 #define SQRT_2 1.414213562f
@@ -41,6 +44,12 @@
 
 // Note: I filed a bug about the SPI fill char issue: https://github.com/ARMmbed/mbed-os/issues/13941
 
+// Enable this to read I2C packets with Mbed's asynchronous I2C transfer API (interrupt or DMA driven,
+// depending on the target HAL).  The calling thread sleeps until the transfer completes instead of
+// busy-waiting on every byte, so other threads can run during the ~5ms a 272 byte packet takes at 400kHz.
+// Requires an RTOS and a target with DEVICE_I2C_ASYNCH.
+#define USE_ASYNC_I2C 0
+
 /**
   Class to drive the BNO080 9-axis IMU.
   
@@ -55,8 +64,8 @@ protected:
 	Stream * _debugPort;
 
 	/// Interrupt pin -- signals to the host that the IMU has data to send
-	// Note: only ever used as a digital input by BNO080.
-	// Used for interrupts by BNO080Async.
+	// Note: used as a digital input by BNO080, plus a falling edge interrupt to timestamp packets.
+	// Also used for wakeup interrupts by BNO080Async.
 	InterruptIn _int;
 	
 	// Reset pin -- resets IMU when held low.
@@ -69,8 +78,12 @@ protected:
 
 	// Size of the largest individual packet we can receive.
 	// Min value is set by the advertisement packet (272 bytes)
-	// If you enable lots of sensor reports and get an error, you might need to increase this.
+	// If you enable lots of sensor reports or batching and get an error, you might need to increase this.
+	// Can be overridden from mbed_app.json, e.g. "macros": ["SHTP_RX_PACKET_SIZE=512"].
+	// A batched packet holds (this - 5) / (report size) samples, e.g. 42 game rotation vectors (12 bytes) at 512.
+#ifndef SHTP_RX_PACKET_SIZE
 #define SHTP_RX_PACKET_SIZE 272
+#endif
 
 	// Size of largest packet that we need to transmit (not including header)
 #define SHTP_MAX_TX_PACKET_SIZE 17
@@ -112,17 +125,49 @@ protected:
 	/// Buffer for current metadata record.
 	uint32_t metadataRecord[METADATA_BUFFER_LEN];
 
+	/// Number of sensor metadata records, IDs 0xE301 to 0xE318 (SH-2 section 5.1)
+#define METADATA_RECORD_COUNT 0x18
+
+	/// Magic number at the start of a MetadataCache written by this driver
+#define METADATA_CACHE_MAGIC 0xB0800001
+
 	// data storage
 	//-----------------------------------------------------------------------------------------------------------------
 
-	// 1 larger than the largest sensor report ID
-#define STATUS_ARRAY_LEN MAX_SENSOR_REPORTID + 1
-
-	/// stores status of each sensor, indexed by report ID
-	uint8_t reportStatus[STATUS_ARRAY_LEN];
+	/// stores status of each sensor, indexed by reportIndex()
+	uint8_t reportStatus[SENSOR_REPORT_COUNT];
 
 	/// stores whether a sensor has been updated since the last call to hasNewData()
-	bool reportHasBeenUpdated[STATUS_ARRAY_LEN];
+	bool reportHasBeenUpdated[SENSOR_REPORT_COUNT];
+
+	/// stores the host time (us_ticker_read() microseconds) at which each sensor's latest sample was taken, indexed by reportIndex()
+	uint32_t reportTimestamp[SENSOR_REPORT_COUNT];
+
+	// packet timing
+	//-----------------------------------------------------------------------------------------------------------------
+
+	/// us_ticker_read() time of the latest falling edge on _int.  Written from the interrupt handler.
+	volatile uint32_t intEdgeTime;
+
+	/// Number of falling edges seen on _int.  Lets a packet tell whether its own edge was caught.
+	volatile uint32_t intEdgeCount;
+
+	/// Host time of the interrupt edge for the packet in the RX buffer, latched when its transfer started.
+	/// This is the reference point that the base timestamp of a sensor data packet counts back from.
+	uint32_t rxInterruptTime;
+
+	/// Value of intEdgeCount when rxInterruptTime was last latched
+	uint32_t rxLatchedEdgeCount;
+
+	// sample queue
+	//-----------------------------------------------------------------------------------------------------------------
+
+	// Number of samples held between calls to readSample().  When batching, make this at least the number
+	// of samples one batch can deliver, or older samples get dropped.
+	// Can be overridden from mbed_app.json like SHTP_RX_PACKET_SIZE.
+#ifndef SAMPLE_QUEUE_LEN
+#define SAMPLE_QUEUE_LEN 32
+#endif
 
 public:
 
@@ -224,7 +269,28 @@ public:
 		 * Detects when the IMU is being shaken.
 		 * See BNO datasheet section 2.4.7
 		 */
-		SHAKE_DETECTOR = SENSOR_REPORTID_SHAKE_DETECTOR
+		SHAKE_DETECTOR = SENSOR_REPORTID_SHAKE_DETECTOR,
+
+		/**
+		 * Accelerometer readings straight from the sensor's ADC, with no calibration or scaling.
+		 * See SH-2 section 6.5.8
+		 */
+		RAW_ACCELEROMETER = SENSOR_REPORTID_RAW_ACCELEROMETER,
+
+		/**
+		 * Gyroscope readings straight from the sensor's ADC, with no calibration or scaling.
+		 * See SH-2 section 6.5.12
+		 */
+		RAW_GYROSCOPE = SENSOR_REPORTID_RAW_GYROSCOPE,
+
+		/**
+		 * The game rotation vector brought up to date with the gyro at the gyro's rate (up to 1kHz), plus
+		 * the angular velocity, for control loops that need orientation with the least latency.
+		 * The IMU sends it on its own SHTP channel, one short packet per sample with no status or timestamp
+		 * fields: getReportStatus() stays 0 and samples are timed by the packet's interrupt.
+		 * See SH-2 section 6.5.44 and BNO080 datasheet section 2.2.3
+		 */
+		GYRO_INTEGRATED_ROTATION = SENSOR_REPORTID_GYRO_INTEGRATED_ROTATION_VECTOR
 	};
 
 	// data variables to read reports from
@@ -313,6 +379,30 @@ public:
 	 */
 	float geomagneticRotationAccuracy;
 
+	/**
+	 * Readout from the Gyro-Integrated Rotation Vector report.
+	 * Represents the rotation of the IMU in radians, referenced like the game rotation vector.
+	 */
+	Quaternion gyroIntegratedRotationVector;
+
+	/**
+	 * Auxiliary readout from the Gyro-Integrated Rotation Vector report.
+	 * Represents the angular velocities of the chip in rad/s in the X, Y, and Z axes.
+	 */
+	TVector3 gyroIntegratedAngularVelocity;
+
+	/**
+	 * Readout from the Raw Accelerometer report.
+	 * ADC counts in the X, Y, and Z axes, as the sensor measured them.
+	 */
+	int16_t rawAcceleration[3];
+
+	/**
+	 * Readout from the Raw Gyroscope report.
+	 * ADC counts in the X, Y, and Z axes, as the sensor measured them.
+	 */
+	int16_t rawGyroRotation[3];
+
 	/**
 	 * Tap readout from the Tap Detector report.  This flag is set to true whenever a tap is detected, and you should
 	 * manually clear it when you have processed the tap.
@@ -385,6 +475,193 @@ public:
 	bool zAxisShake;
 	// @}
 
+	/**
+	 * One timestamped sample from a vector or rotation report.
+	 *
+	 * The readouts above only hold the latest value of each report, so when the IMU batches several samples
+	 * into one packet all but the last would be lost.  Every sample of those reports is also queued in order
+	 * as one of these; read them back with readSample().
+	 */
+	struct Sample
+	{
+		/// Report the sample belongs to.
+		Report report;
+
+		/// Status of the report when the sample was taken, as getReportStatus().
+		uint8_t status;
+
+		/// Host time at which the IMU took the sample, as getReportTimestamp().
+		uint32_t timestamp;
+
+		/// x, y, z of the vector, or i, j, k, real of the rotation quaternion.  Units as the matching readout above.
+		float data[4];
+
+		/// Accuracy estimate in radians for the rotation and geomagnetic rotation vectors, 0 otherwise.
+		float accuracy;
+
+		/// x, y, z angular velocity in rad/s for the gyro-integrated rotation vector, 0 otherwise.
+		float angularVelocity[3];
+	};
+
+	/**
+	 * A ring buffer of one report's samples that a consumer thread can read without locking the driver.
+	 * Declare one with the capacity you need (a power of two) and hand it to attachSampleRing():
+	 *
+	 *     BNO080::SampleRing<64> gyroSamples;
+	 *     imu.attachSampleRing(BNO080::GYROSCOPE, gyroSamples);
+	 *     ...
+	 *     BNO080::Sample sample;
+	 *     while(gyroSamples.pop(sample)) { ... }
+	 */
+	template <uint32_t Capacity>
+	using SampleRing = SPSCRing<Sample, Capacity>;
+
+	/**
+	 * Copy of the latest readouts, all from the same moment: published whole after every sensor packet,
+	 * so it never mixes one packet's gyro with the next packet's rotation.  See getSnapshot().
+	 * Vectors are x, y, z; quaternions are i, j, k, real.
+	 */
+	struct SensorSnapshot
+	{
+		/// Number of sensor packets published so far.  Changes whenever the snapshot does.
+		uint32_t packetCount;
+
+		float totalAcceleration[3];
+		float linearAcceleration[3];
+		float gravityAcceleration[3];
+		float gyroRotation[3];
+		float magField[3];
+		float rotationVector[4];
+		float rotationAccuracy;
+		float gameRotationVector[4];
+		float geomagneticRotationVector[4];
+		float geomagneticRotationAccuracy;
+		float gyroIntegratedRotationVector[4];
+		float gyroIntegratedAngularVelocity[3];
+		uint32_t stepCount;
+		Stability stability;
+
+		/// Sample time of each report, indexed by reportIndex(), as getReportTimestamp()
+		uint32_t reportTimestamp[SENSOR_REPORT_COUNT];
+
+		/// Status of each report, indexed by reportIndex(), as getReportStatus()
+		uint8_t reportStatus[SENSOR_REPORT_COUNT];
+	};
+
+	/**
+	 * Sensor metadata records kept between boots, so that getMinPeriod() and friends don't need an FRS read
+	 * (up to 300ms each) after every reset.  It's a plain struct: keep it in flash (e.g. with KVStore) and hand
+	 * it back with setMetadataCache() before begin().  Records are only used while the IMU reports the
+	 * firmware build they were read from; a different build starts the cache over.
+	 */
+	struct MetadataCache
+	{
+		/// METADATA_CACHE_MAGIC once the driver has written to it
+		uint32_t magic;
+
+		/// Firmware build number (see buildNumber) of the IMU the records were read from
+		uint32_t buildNumber;
+
+		/// Bit n is set if records[n] holds metadata record 0xE301 + n
+		uint32_t validRecords;
+
+		/// First METADATA_BUFFER_LEN words of each metadata record
+		uint32_t records[METADATA_RECORD_COUNT][METADATA_BUFFER_LEN];
+	};
+
+	/**
+	 * Where the time went during the last begin(), in microseconds.  See getBootTiming().
+	 * Any step that wasn't seen (e.g. begin() failed first) reads 0.
+	 */
+	struct BootTiming
+	{
+		/// us_ticker_read() when begin() was called, i.e. time since the processor came out of reset
+		uint32_t beginTime;
+
+		/// Reset released until the IMU pulled INT low, i.e. the IMU's boot
+		uint32_t resetToInterrupt;
+
+		/// INT low until the initialize response: advertisement and sensor hub startup
+		uint32_t interruptToInitialized;
+
+		/// Initialize response until the product ID response
+		uint32_t initializedToProductID;
+
+		/// The whole begin() call
+		uint32_t beginTotal;
+
+		/// begin() called until the first sensor data packet was parsed
+		uint32_t beginToFirstData;
+
+		/// Time spent reading metadata from the FRS since begin()
+		uint32_t metadataReadTime;
+
+		/// Metadata records read from the FRS since begin()
+		uint16_t metadataReads;
+
+		/// Metadata records served from the MetadataCache since begin()
+		uint16_t metadataCacheHits;
+	};
+
+	/**
+	 * A report for begin() to enable as soon as the IMU is up.  See setStartupReports().
+	 */
+	struct StartupReport
+	{
+		Report report;
+
+		/// As enableReport()
+		uint16_t timeBetweenReports;
+
+		/// As enableReport()
+		uint16_t batchInterval;
+	};
+
+protected:
+
+	/// Latest readouts, republished after each sensor packet
+	Seqlock<SensorSnapshot> latestSnapshot;
+
+	/// Sensor packets published into latestSnapshot
+	uint32_t snapshotPacketCount;
+
+	/// Ring attached to each report by attachSampleRing(), indexed by reportIndex(), or nullptr
+	SPSCRingBase<Sample> * sampleRings[SENSOR_REPORT_COUNT];
+
+	/// Circular buffer of samples not yet read, oldest at sampleQueueHead
+	Sample sampleQueue[SAMPLE_QUEUE_LEN];
+	uint16_t sampleQueueHead;
+	uint16_t sampleQueueCount;
+
+	/// Samples overwritten because the queue was full
+	uint32_t droppedSampleCount;
+
+	// startup
+	//-----------------------------------------------------------------------------------------------------------------
+
+	/// Metadata records kept between boots, set by setMetadataCache(), or nullptr
+	MetadataCache * metadataCache;
+
+	/// Whether metadataCache has changed since it was set or markMetadataCacheSaved() was called
+	bool metadataCacheDirty;
+
+	/// Reports for begin() to enable, set by setStartupReports()
+	const StartupReport * startupReports;
+	size_t startupReportCount;
+
+	/// Timing of the last begin()
+	BootTiming bootTiming;
+
+	/// Whether the first sensor data packet since begin() is still to come
+	bool awaitingFirstData;
+
+	/// us_ticker_read() times at which the reset was released and INT first fell after it.
+	/// Written by whichever thread resets the IMU, 0 until then.
+	volatile uint32_t resetReleaseTime;
+	volatile uint32_t startupEdgeTime;
+
+public:
+
 	// Management functions
 	//-----------------------------------------------------------------------------------------------------------------
 
@@ -407,11 +684,54 @@ public:
 	 * If this function is failing, it would be a good idea to turn on BNO_DEBUG in the cpp file to get detailed output.
 	 *
 	 * Note: this function takes several hundred ms to execute, mainly due to waiting for the BNO to boot.
+	 * getBootTiming() breaks that time down afterwards.
+	 *
+	 * Any reports given to setStartupReports() are enabled as soon as the IMU has initialized, in the same
+	 * burst as the product ID request, so data is already streaming when this returns.
 	 *
 	 * @return whether or not initialization was successful
 	 */
 	virtual bool begin();
 
+	/**
+	 * Sets reports for begin() to enable.  They are sent back to back without waiting for acknowledgements,
+	 * as enableReport() does.  Unlike enableReport(), their periods are not checked against the metadata.
+	 *
+	 * @param reports Reports to enable.  Must stay valid until begin() returns (a static array is fine).
+	 * @param count Number of reports in the array.
+	 */
+	void setStartupReports(const StartupReport * reports, size_t count);
+
+	/**
+	 * Gives the driver somewhere to keep sensor metadata between boots.  Metadata lookups (getRange(),
+	 * getMinPeriod() etc.) are served from it when it holds records for the IMU's firmware build, and
+	 * records read from the FRS are added to it.  When isMetadataCacheDirty() says so, save it back.
+	 *
+	 * @param cache The cache, loaded from wherever it is kept (zeroed if there's nothing saved), or nullptr for none.
+	 * Must outlive the driver or be removed first.
+	 */
+	void setMetadataCache(MetadataCache * cache);
+
+	/**
+	 * @return Whether the metadata cache has new records that need saving.
+	 */
+	bool isMetadataCacheDirty() const {return metadataCacheDirty;}
+
+	/**
+	 * Call once the metadata cache has been saved.
+	 */
+	void markMetadataCacheSaved() {metadataCacheDirty = false;}
+
+	/**
+	 * @return Timing of the last begin(), plus the first data and metadata reads since.
+	 */
+	const BootTiming & getBootTiming() const {return bootTiming;}
+
+	/**
+	 * Prints getBootTiming() to the debug port.
+	 */
+	void printBootTiming();
+
 	/**
 	 * Tells the IMU to use its current rotation vector as the "zero" rotation vector and to reorient
 	 * all outputs accordingly.
@@ -511,6 +831,38 @@ public:
 	 */
 	virtual bool updateData();
 
+	/**
+	 * Maps a report to its slot in the per-report arrays, e.g. SensorSnapshot::reportStatus.
+	 * Report IDs run up to 0x2A with gaps, so the arrays are indexed densely instead of by ID.
+	 * @param report Report, or any report ID
+	 * @return Index below SENSOR_REPORT_COUNT, or REPORT_INDEX_NONE if the driver doesn't handle the ID
+	 */
+	static constexpr uint8_t reportIndex(uint8_t report)
+	{
+		switch(report)
+		{
+			case SENSOR_REPORTID_ACCELEROMETER: return 0;
+			case SENSOR_REPORTID_GYROSCOPE_CALIBRATED: return 1;
+			case SENSOR_REPORTID_MAGNETIC_FIELD_CALIBRATED: return 2;
+			case SENSOR_REPORTID_LINEAR_ACCELERATION: return 3;
+			case SENSOR_REPORTID_ROTATION_VECTOR: return 4;
+			case SENSOR_REPORTID_GRAVITY: return 5;
+			case SENSOR_REPORTID_GAME_ROTATION_VECTOR: return 6;
+			case SENSOR_REPORTID_GEOMAGNETIC_ROTATION_VECTOR: return 7;
+			case SENSOR_REPORTID_MAGNETIC_FIELD_UNCALIBRATED: return 8;
+			case SENSOR_REPORTID_TAP_DETECTOR: return 9;
+			case SENSOR_REPORTID_STEP_COUNTER: return 10;
+			case SENSOR_REPORTID_SIGNIFICANT_MOTION: return 11;
+			case SENSOR_REPORTID_STABILITY_CLASSIFIER: return 12;
+			case SENSOR_REPORTID_RAW_ACCELEROMETER: return 13;
+			case SENSOR_REPORTID_RAW_GYROSCOPE: return 14;
+			case SENSOR_REPORTID_STEP_DETECTOR: return 15;
+			case SENSOR_REPORTID_SHAKE_DETECTOR: return 16;
+			case SENSOR_REPORTID_GYRO_INTEGRATED_ROTATION_VECTOR: return 17;
+			default: return REPORT_INDEX_NONE;
+		}
+	}
+
 	/**
 	 * Gets the status of a report as a 2 bit number.
 	 * per SH-2 section 6.5.1, this is interpreted as: <br>
@@ -537,14 +889,83 @@ public:
 	 */
 	bool hasNewData(Report report);
 
+	/**
+	 * Gets the time at which the IMU took the latest sample of a report, on the host's us_ticker clock.
+	 *
+	 * This is worked out from the time the INT line fell for the packet, minus the packet's base timestamp,
+	 * plus any timestamp rebase and the report's own delay field (see SH-2 section 7.2), so it is the time
+	 * the sensor measured the data rather than the time the host got around to reading it.
+	 * Compare it against us_ticker_read() with unsigned subtraction; the clock wraps every ~71 minutes.
+	 *
+	 * @param report The report to check.
+	 * @return Sample time in microseconds, or 0 if the report has never been received.
+	 */
+	uint32_t getReportTimestamp(Report report);
+
+	/**
+	 * Takes the oldest queued sample of the vector and rotation reports, in the order the IMU sent them.
+	 * Call it until it returns false after each updateData().  If the queue fills up, the oldest samples
+	 * are overwritten and counted by getDroppedSampleCount().
+	 *
+	 * @param sample Filled in with the sample.
+	 * @return Whether there was a sample to read.
+	 */
+	bool readSample(Sample & sample);
+
+	/**
+	 * @return The number of samples waiting in the queue.
+	 */
+	uint16_t getQueuedSampleCount() {return sampleQueueCount;}
+
+	/**
+	 * @return The number of samples lost to a full queue since startup.
+	 */
+	uint32_t getDroppedSampleCount() {return droppedSampleCount;}
+
+	/**
+	 * Sends every sample of a vector or rotation report to its own ring buffer instead of the shared queue behind
+	 * readSample().  The thread running the driver pushes and one consumer thread pops, without a mutex, so
+	 * a slow consumer never holds up the driver (on BNO080Async, no need to lock bnoDataMutex to pop).
+	 * When the ring is full, new samples are dropped and counted by the ring's overflowCount().
+	 *
+	 * The latest-value readouts above and hasNewData() keep working as before.
+	 * Attach before enabling the report.  The ring must outlive the driver or be detached first.
+	 *
+	 * @param report The report to buffer.
+	 * @param ring Ring to push the report's samples into, or nullptr to go back to the shared queue.
+	 */
+	void attachSampleRing(Report report, SPSCRingBase<Sample> * ring);
+
+	/// @copydoc attachSampleRing(Report, SPSCRingBase<Sample>*)
+	void attachSampleRing(Report report, SPSCRingBase<Sample> & ring) {attachSampleRing(report, &ring);}
+
+	/**
+	 * Gets a consistent copy of the latest readouts without locking the driver.
+	 *
+	 * On BNO080Async and BNO080AsyncI2C, reading the readout fields directly needs bnoDataMutex, which
+	 * keeps the driver thread from servicing the IMU for as long as it is held.  This doesn't: the driver
+	 * thread publishes a snapshot after each sensor packet through a seqlock and never waits for readers.
+	 * If a packet is being published right now, this retries until it's done (a few microseconds), so
+	 * don't call it from a thread with a higher priority than the driver thread.
+	 *
+	 * @param snapshot Filled in with the latest readouts.
+	 */
+	void getSnapshot(SensorSnapshot & snapshot) const {latestSnapshot.read(snapshot);}
+
 	/**
 	 * Enable a data report from the IMU.  Look at the comments above to see what the reports do.
 	 * This function checks your polling period against the report's max speed in the IMU's metadata,
 	 * and reports an error if you're trying to poll too fast.
 	 *
+	 * With a batch interval, the IMU keeps samples of this report in its FIFO and only interrupts
+	 * the host when the oldest one is that old, sending them all in one packet.  That saves one bus
+	 * transaction per sample at high rates.  Every sample still arrives, timestamped, through readSample().
+	 * Keep the batch small enough to fit in SHTP_RX_PACKET_SIZE and SAMPLE_QUEUE_LEN.
+	 *
 	 * @param timeBetweenReports time in milliseconds between data updates.
+	 * @param batchInterval longest time in milliseconds a sample may wait in the IMU before being sent.  0 sends each sample at once.
 	 */
-	void enableReport(Report report, uint16_t timeBetweenReports);
+	void enableReport(Report report, uint16_t timeBetweenReports, uint16_t batchInterval = 0);
 
 	/**
 	 * Disable a data report from the IMU.
@@ -641,12 +1062,70 @@ protected:
 	 */
 	void processPacket();
 
+	/**
+	 * Clears bootTiming and starts timing a begin() call.  Call before resetting the IMU.
+	 */
+	void startBootTiming();
+
+	/**
+	 * Fills in the startup steps of bootTiming once begin() has finished.
+	 * @param initializedTime us_ticker_read() time of the initialize response, 0 if it never came
+	 * @param productIDTime us_ticker_read() time of the product ID response, 0 if it never came
+	 */
+	void finishBootTiming(uint32_t initializedTime, uint32_t productIDTime);
+
+	/**
+	 * Sends the product ID request, then enables the startup reports, without waiting in between.
+	 */
+	void sendStartupRequests();
+
+	/**
+	 * Reads the version info out of the product ID response in the RX buffer.
+	 * @return false if the RX buffer doesn't hold a product ID response
+	 */
+	bool parseProductIDResponse();
+
+	/**
+	 * Falling edge handler for _int.  Records when the IMU asserted its interrupt.
+	 * Runs in interrupt context.
+	 */
+	void onInterruptEdge();
+
+	/**
+	 * Call when INT has been seen low and a packet is about to be read.  Saves the time of the
+	 * edge that announced it into rxInterruptTime, before the next packet's edge can overwrite it.
+	 */
+	void latchInterruptTime();
+
 	/**
 	 * Processes the sensor data packet currently stored in the buffer.
 	 * Only called from processPacket()
 	 */
 	void parseSensorDataPacket();
 
+	/**
+	 * Processes the gyro-integrated rotation vector packet currently stored in the buffer.
+	 * Only called from processPacket()
+	 */
+	void parseGyroIntegratedRotationPacket();
+
+	/**
+	 * Copies the readouts into latestSnapshot.  Called after each sensor data packet.
+	 */
+	void publishSnapshot();
+
+	/**
+	 * Adds a sample of a report to its ring if one is attached, otherwise to the shared sample queue,
+	 * using the status and timestamp just parsed for it.
+	 * Overwrites the oldest sample if the shared queue is full.
+	 */
+	void queueSample(uint8_t reportNum, float x, float y, float z, float real = 0, float accuracy = 0);
+
+	/**
+	 * Adds a complete sample to its report's ring if one is attached, otherwise to the shared sample queue.
+	 */
+	void pushSample(const Sample & sample);
+
 	/**
 	 * Call to wait for a packet with the given parameters to come in.
 	 *
@@ -669,6 +1148,15 @@ protected:
 	 */
 	float qToFloat(int16_t fixedPointValue, uint8_t qPoint);
 
+	/**
+	 * Given a Q value known at compile time, converts fixed point floating to regular floating point number.
+	 * The scale is a constant, so this is just a multiply.  Use this version when parsing sensor reports.
+	 * @param fixedPointValue
+	 * @return
+	 */
+	template <uint8_t qPoint>
+	static float qToFloat(int16_t fixedPointValue) {return QFormat::toFloat<qPoint>(fixedPointValue);}
+
 	/**
 	 * Given a Q value, converts fixed point floating to regular floating point number.
 	 * This version is used for the unsigned 32-bit values in metadata records.
@@ -712,8 +1200,9 @@ protected:
 	 * @param reportID
 	 * @param timeBetweenReports
 	 * @param specificConfig the specific config word. Useful for personal activity classifier.
+	 * @param batchInterval maximum time in milliseconds the IMU may hold a sample before sending it.  0 disables batching.
 	 */
-	void setFeatureCommand(uint8_t reportID, uint16_t timeBetweenReports, uint32_t specificConfig = 0);
+	void setFeatureCommand(uint8_t reportID, uint16_t timeBetweenReports, uint32_t specificConfig = 0, uint16_t batchInterval = 0);
 
 	/**
 	 * Read a record from the FRS (Flash Record System) on the IMU.  FRS records are composed of 32-bit words,
@@ -774,7 +1263,8 @@ protected:
 	 virtual void clearSendBuffer();
 
 	 /**
-	  * Loads the metadata for this report into the metadata buffer.
+	  * Loads the metadata for this report into the metadata buffer, from the metadata cache if it holds it,
+	  * otherwise from the FRS (adding it to the cache).
 	  * @param report
 	  * @return Whether the operation succeeded.
 	  */
@@ -817,11 +1307,31 @@ public:
 	 */
 	BNO080I2C(Stream *debugPort, PinName user_SDApin, PinName user_SCLpin, PinName user_INTPin, PinName user_RSTPin, uint8_t i2cAddress=0x4a, int i2cPortSpeed=400000);
 
-private:
+protected:
 
 	bool receivePacket(std::chrono::milliseconds timeout=200ms) override;
 
 	bool sendPacket(uint8_t channelNumber, uint8_t dataLength) override;
+
+	/**
+	 * Read a block of bytes from the IMU in one I2C transaction (start, address, length bytes, stop).
+	 * With USE_ASYNC_I2C, suspends the current thread until the transfer is complete, or aborts it
+	 * if it hasn't completed within its bus time plus BNO080_I2C_TRANSFER_MARGIN.
+	 * @param buffer Buffer to read into
+	 * @param length Number of bytes to read
+	 * @return whether the IMU ACKed and the transfer completed
+	 */
+	bool i2cReadAndWait(uint8_t * buffer, int length);
+
+#if USE_ASYNC_I2C
+
+	// callback for finished I2C transfers
+	void onI2CTransferComplete(int event);
+
+	// Signal whan an I2C transfer is complete.
+	EventFlags i2cCompleteFlag;
+
+#endif
 };
 
 // typedef for compatibility with old version of driver where there was no SPI
@@ -26,11 +26,16 @@ bool BNO080Async::commLoop()
 	_rst = 0; // Reset BNO080
 	ThisThread::sleep_for(1ms); // Min length not specified in datasheet?
 	_rst = 1; // Bring out of reset
+	resetReleaseTime = us_ticker_read();
 
 	// wait for a falling edge (NOT just a low) on the INT pin to denote startup
 	{
 		EventFlags edgeWaitFlags;
-		_int.fall(callback([&](){edgeWaitFlags.set(1);}));
+		_int.fall(callback([&]()
+		{
+			startupEdgeTime = us_ticker_read();
+			edgeWaitFlags.set(1);
+		}));
 
 		// have the RTOS wait until an edge is detected or the timeout is hit
 		uint32_t edgeWaitEvent = edgeWaitFlags.wait_any(1, (BNO080_RESET_TIMEOUT).count());
@@ -50,6 +55,9 @@ bool BNO080Async::commLoop()
 	// configure interrupt to send the event flag
 	_int.fall(callback([&]()
 	{
+		// keep timestamping packets (replaces the base class handler)
+		onInterruptEdge();
+
 		if(!inTXRX)
 		{
 			wakeupFlags.set(EF_INTERRUPT);
@@ -227,6 +235,11 @@ BNO080Async::BNO080Async(Stream *debugPort, PinName rstPin, PinName intPin, PinN
 
 bool BNO080Async::begin()
 {
+	// before the thread resets the IMU, so it can fill in the reset times
+	bnoDataMutex.lock();
+	startBootTiming();
+	bnoDataMutex.unlock();
+
 	// shut down thread if it's running
 	if(commThread.get_state() == Thread::Deleted)
 	{
@@ -247,6 +260,7 @@ bool BNO080Async::begin()
 		if(!waitForPacket(CHANNEL_EXECUTABLE, EXECUTABLE_REPORTID_RESET, 1s))
 		{
 			_debugPort->printf("No initialization report from BNO080.\n");
+			finishBootTiming(0, 0);
 			return false;
 		}
 		else
@@ -255,35 +269,22 @@ bool BNO080Async::begin()
 			_debugPort->printf("BNO080 reports initialization successful!\n");
 #endif
 		}
+		uint32_t initializedTime = us_ticker_read();
 
 		// Finally, we want to interrogate the device about its model and version.
-		clearSendBuffer();
-		txShtpData[0] = SHTP_REPORT_PRODUCT_ID_REQUEST; //Request the product ID and reset info
-		txShtpData[1] = 0; //Reserved
-		sendPacket(CHANNEL_CONTROL, 2);
+		// The startup reports go out right behind the request, so the IMU starts sampling while we wait.
+		sendStartupRequests();
 
 		waitForPacket(CHANNEL_CONTROL, SHTP_REPORT_PRODUCT_ID_RESPONSE);
 
-		if (rxShtpData[0] == SHTP_REPORT_PRODUCT_ID_RESPONSE)
-		{
-			majorSoftwareVersion = rxShtpData[2];
-			minorSoftwareVersion = rxShtpData[3];
-			patchSoftwareVersion = (rxShtpData[13] << 8) | rxShtpData[12];
-			partNumber = (rxShtpData[7] << 24) | (rxShtpData[6] << 16) | (rxShtpData[5] << 8) | rxShtpData[4];
-			buildNumber = (rxShtpData[11] << 24) | (rxShtpData[10] << 16) | (rxShtpData[9] << 8) | rxShtpData[8];
-
-#if BNO_DEBUG
-			_debugPort->printf("BNO080 reports as SW version %hhu.%hhu.%hu, build %lu, part no. %lu\n",
-						   majorSoftwareVersion, minorSoftwareVersion, patchSoftwareVersion,
-						   buildNumber, partNumber);
-#endif
-
-		}
-		else
+		if(!parseProductIDResponse())
 		{
 			_debugPort->printf("Bad response from product ID command.\n");
+			finishBootTiming(initializedTime, 0);
 			return false;
 		}
+
+		finishBootTiming(initializedTime, us_ticker_read());
 	}
 
 
@@ -298,8 +299,271 @@ bool BNO080Async::updateData()
 	return newData;
 }
 
+// I2C version
+//-----------------------------------------------------------------------------------------------------------------
+
+// event flag set by BNO080AsyncI2C once it has processed new packets
+#define EF_SAMPLES 0b1
+
+void BNO080AsyncI2C::threadMain()
+{
+	while(commLoop())
+	{
+		// loop forever
+	}
+}
+
+bool BNO080AsyncI2C::commLoop()
+{
+	_rst = 0; // Reset BNO080
+	ThisThread::sleep_for(1ms); // Min length not specified in datasheet?
+	_rst = 1; // Bring out of reset
+	resetReleaseTime = us_ticker_read();
+
+	// wait for a falling edge (NOT just a low) on the INT pin to denote startup
+	{
+		EventFlags edgeWaitFlags;
+		_int.fall(callback([&]()
+		{
+			startupEdgeTime = us_ticker_read();
+			edgeWaitFlags.set(1);
+		}));
+
+		// have the RTOS wait until an edge is detected or the timeout is hit
+		uint32_t edgeWaitEvent = edgeWaitFlags.wait_any(1, (BNO080_RESET_TIMEOUT).count());
+
+		// on timeout, wait_any() returns an error code with the top bit set
+		if(edgeWaitEvent & osFlagsError)
+		{
+			_debugPort->printf("Error: BNO080 reset timed out, chip not detected.\n");
+		}
+
+		// the handler refers to edgeWaitFlags, which goes away with this block
+		_int.fall(nullptr);
+	}
+
+#if BNO_ASYNC_DEBUG
+	_debugPort->printf("BNO080 detected!\r\n");
+#endif
+
+	// the startup edge has gone to the flags above, so the advertisement packet is already waiting
+	wakeupFlags.set(EF_INTERRUPT);
+
+	// configure interrupt to timestamp the packet and wake the thread
+	_int.fall(callback([&]()
+	{
+		onInterruptEdge();
+		wakeupFlags.set(EF_INTERRUPT);
+	}));
+
+	while(true)
+	{
+		uint32_t wakeupEvent = wakeupFlags.wait_any(EF_INTERRUPT | EF_SHUTDOWN | EF_RESTART);
+
+		if(wakeupEvent & EF_SHUTDOWN)
+		{
+			// shutdown thread permanently
+			return false;
+		}
+		else if(wakeupEvent & EF_RESTART)
+		{
+			// restart thread
+			return true;
+		}
+
+		// lock the mutex to handle remaining cases
+		bnoDataMutex.lock();
+
+		bool packetsProcessed = false;
+		bool readFailed = false;
+
+		// I2C reads release INT as soon as they start, so keep going while the IMU has more packets queued
+		while(_int == 0)
+		{
+			if(!BNO080I2C::receivePacket())
+			{
+				// bus busy, NAK or timeout: INT is still low, so no new edge will come to wake us
+				readFailed = true;
+				break;
+			}
+
+			// update received flag
+			dataReceived = true;
+
+			// check if this packet is being waited on.
+			if (waitingForPacket && waitingForReportID == rxShtpData[0] && waitingForChannel == rxShtpHeader[2])
+			{
+				// unblock the waiting thread so it can process this packet
+				waitingPacketArrived = true;
+				waitingPacketArrivedCV.notify_all();
+
+				// unlock mutex and wait until the waiting thread says it's OK to receive another packet
+				clearToRxNextPacket = false;
+				waitingPacketProcessedCV.wait([&]() { return clearToRxNextPacket; });
+			}
+			else
+			{
+				processPacket();
+				packetsProcessed = true;
+			}
+
+			// clear the interrupt flag if it has been set because we're about to check _int anyway.
+			// Prevents spurious wakeups.
+			wakeupFlags.clear(EF_INTERRUPT);
+		}
+
+		// unlock data mutex before waiting for flags
+		bnoDataMutex.unlock();
+
+		if(packetsProcessed)
+		{
+			sampleFlags.set(EF_SAMPLES);
+		}
+
+		if(readFailed)
+		{
+			// back off so a stuck bus doesn't keep this thread busy, then try the packet again
+			ThisThread::sleep_for(BNO080_I2C_RETRY_DELAY);
+			wakeupFlags.set(EF_INTERRUPT);
+		}
+	}
+}
+
+bool BNO080AsyncI2C::sendPacket(uint8_t channelNumber, uint8_t dataLength)
+{
+	// first make sure mutex is locked
+	if(bnoDataMutex.get_owner() != ThisThread::get_id())
+	{
+		_debugPort->printf("IMU communication function called without bnoDataMutex locked!\n");
+		return false;
+	}
+
+	// I2C writes don't need the IMU to be awake first, and holding the mutex keeps the thread off the bus
+	return BNO080I2C::sendPacket(channelNumber, dataLength);
+}
+
+bool BNO080AsyncI2C::waitForPacket(int channel, uint8_t reportID, std::chrono::milliseconds timeout)
+{
+	// first make sure mutex is locked
+	if(bnoDataMutex.get_owner() != ThisThread::get_id())
+	{
+		_debugPort->printf("IMU communication function called without bnoDataMutex locked!\n");
+		return false;
+	}
 
+	// send information to thread
+	waitingForPacket = true;
+	waitingForChannel = channel;
+	waitingForReportID = reportID;
+	waitingPacketArrived = false;
 
+	// now unlock mutex and allow thread to run and receive packets
+	waitingPacketArrivedCV.wait_for(timeout, [&]() {return waitingPacketArrived;});
 
+	// stop waiting either way, so the thread doesn't hold a late packet for us
+	waitingForPacket = false;
 
+	if(!waitingPacketArrived)
+	{
+		_debugPort->printf("Packet wait timeout.\n");
+		return false;
+	}
+
+	// Packet we are waiting for is now in the buffer, and stays there until bnoDataMutex is released
+	// (see BNO080Async::waitForPacket()).
+	clearToRxNextPacket = true;
+	waitingPacketProcessedCV.notify_all();
+
+	return true;
+}
+
+BNO080AsyncI2C::BNO080AsyncI2C(Stream *debugPort, PinName user_SDApin, PinName user_SCLpin, PinName user_INTPin, PinName user_RSTPin,
+							   uint8_t i2cAddress, int i2cPortSpeed, osPriority_t threadPriority):
+ BNO080I2C(debugPort, user_SDApin, user_SCLpin, user_INTPin, user_RSTPin, i2cAddress, i2cPortSpeed),
+ commThread(threadPriority),
+ waitingPacketArrivedCV(bnoDataMutex),
+ waitingPacketProcessedCV(bnoDataMutex)
+{
 
+}
+
+BNO080AsyncI2C::~BNO080AsyncI2C()
+{
+	if(commThread.get_state() != Thread::Deleted)
+	{
+		wakeupFlags.set(EF_SHUTDOWN);
+		commThread.join();
+	}
+}
+
+bool BNO080AsyncI2C::begin()
+{
+	// before the thread resets the IMU, so it can fill in the reset times
+	bnoDataMutex.lock();
+	startBootTiming();
+	bnoDataMutex.unlock();
+
+	// shut down thread if it's running
+	if(commThread.get_state() == Thread::Deleted)
+	{
+		// start thread for the first time
+		commThread.start(callback(this, &BNO080AsyncI2C::threadMain));
+	}
+	else
+	{
+		// restart thread
+		wakeupFlags.set(EF_RESTART);
+	}
+
+	{
+		ScopedLock<Mutex> lock(bnoDataMutex);
+
+		// once the thread starts it, the BNO will send an Unsolicited Initialize response (SH-2 section 6.4.5.2), and an Executable Reset command
+		if(!waitForPacket(CHANNEL_EXECUTABLE, EXECUTABLE_REPORTID_RESET, 1s))
+		{
+			_debugPort->printf("No initialization report from BNO080.\n");
+			finishBootTiming(0, 0);
+			return false;
+		}
+		else
+		{
+#if BNO_DEBUG
+			_debugPort->printf("BNO080 reports initialization successful!\n");
+#endif
+		}
+		uint32_t initializedTime = us_ticker_read();
+
+		// Finally, we want to interrogate the device about its model and version.
+		// The startup reports go out right behind the request, so the IMU starts sampling while we wait.
+		sendStartupRequests();
+
+		waitForPacket(CHANNEL_CONTROL, SHTP_REPORT_PRODUCT_ID_RESPONSE);
+
+		if(!parseProductIDResponse())
+		{
+			_debugPort->printf("Bad response from product ID command.\n");
+			finishBootTiming(initializedTime, 0);
+			return false;
+		}
+
+		finishBootTiming(initializedTime, us_ticker_read());
+	}
+
+	// successful init
+	return true;
+}
+
+bool BNO080AsyncI2C::updateData()
+{
+	bool newData = dataReceived;
+	dataReceived = false;
+	return newData;
+}
+
+bool BNO080AsyncI2C::waitForSamples(std::chrono::milliseconds timeout)
+{
+	uint32_t flags = sampleFlags.wait_any(EF_SAMPLES, timeout.count());
+
+	// on timeout, wait_any() returns an error code with the top bit set
+	return !(flags & osFlagsError) && (flags & EF_SAMPLES);
+}
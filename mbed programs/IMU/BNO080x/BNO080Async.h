@@ -22,6 +22,7 @@ public:
 	// Mutex protecting all sensor data in the driver.
 	// You must lock this while reading data and unlock it when done.
 	// While this is locked, the background thread is prevented from running.
+	// getSnapshot() reads the latest data without it.
 	Mutex bnoDataMutex;
 
 private:
@@ -137,6 +138,137 @@ public:
 	}
 };
 
+/**
+ * Asynchronous version of the I2C BNO080 driver.
+ *
+ * An internal thread sleeps until the IMU pulls INT low, reads every packet it has waiting and
+ * publishes the samples (into the readouts, the sample queue and any attached sample rings), then
+ * sleeps again.  The application never polls or busy-waits on the IMU: it can block in
+ * waitForSamples() and pick up each batch as soon as it has been parsed.
+ *
+ * Unlike SPI, the I2C interface needs no wake pin, so commands are written straight to the bus from
+ * the calling thread, under bnoDataMutex.
+ *
+ * Note: the internal thread is started the first time begin() is called,
+ * and is shut down when the class is destroyed.
+ */
+class BNO080AsyncI2C : public BNO080I2C
+{
+public:
+	// Mutex protecting all sensor data in the driver.
+	// You must lock this while reading data fields or configuring the IMU, and unlock it when done.
+	// While this is locked, the background thread is prevented from running.
+	// Sample rings and getSnapshot() don't need it.
+	Mutex bnoDataMutex;
+
+private:
+	// thread in charge of communicating with the BNO
+	Thread commThread;
+
+	// EventFlags to allow signalling the thread to wake up
+	EventFlags wakeupFlags;
+
+	// EventFlags set by the thread once it has processed new packets
+	EventFlags sampleFlags;
+
+	// main function for the thread.
+	// Handles starting the comm loop.
+	void threadMain();
+
+	// Code loop to communicate with the BNO.
+	// Runs forever in normal operation.
+	// Returns true to request a restart.
+	// Returns false to request the thread to shutdown.
+	bool commLoop();
+
+	// flag used for updateData() return value.
+	// True if any data packets have been received since the last update.
+	bool dataReceived = false;
+
+	bool sendPacket(uint8_t channelNumber, uint8_t dataLength) override;
+
+	// waiting for packet state info
+	bool waitingForPacket = false;
+	uint8_t waitingForChannel;
+	uint8_t waitingForReportID;
+	bool waitingPacketArrived = false;
+	bool clearToRxNextPacket = false;
+
+	ConditionVariable waitingPacketArrivedCV;
+	ConditionVariable waitingPacketProcessedCV;
+
+	bool waitForPacket(int channel, uint8_t reportID, std::chrono::milliseconds timeout = 125ms) override;
+
+public:
+	/**
+	 * Construct a BNO080AsyncI2C.
+	 * This doesn't actually initialize the chip, you will need to call begin() for that.
+	 *
+	 * NOTE: while some schematics tell you to connect the BOOTN pin to the processor, this driver does not use or require it.
+	 * Just tie it to VCC per the datasheet.
+	 *
+	 * @param debugPort Serial port to write output to.  Cannot be nullptr.
+	 * @param user_SDApin Hardware I2C SDA pin connected to the IMU
+	 * @param user_SCLpin Hardware I2C SCL pin connected to the IMU
+	 * @param user_INTPin Input pin connected to HINTN
+	 * @param user_RSTPin Output pin connected to NRST
+	 * @param i2cAddress I2C address.  The BNO defaults to 0x4a, but can also be set to 0x4b via a pin.
+	 * @param i2cPortSpeed I2C frequency.  The BNO's max is 400kHz.
+	 * @param threadPriority Priority to give the internal thread.  Defaults to AboveNormal so it will run whenever it can.
+	 */
+	BNO080AsyncI2C(Stream *debugPort, PinName user_SDApin, PinName user_SCLpin, PinName user_INTPin, PinName user_RSTPin,
+				   uint8_t i2cAddress=0x4a, int i2cPortSpeed=400000, osPriority threadPriority=osPriorityAboveNormal);
+
+	/**
+	 * Stops the internal thread.
+	 */
+	~BNO080AsyncI2C();
+
+	/**
+	 * Resets and connects to the IMU.  Verifies that it's connected, and reads out its version
+	 * info into the class variables above.
+	 *
+	 * Also starts the internal communication thread, restarting it if it's already started.
+	 *
+	 * @return whether or not initialization was successful
+	 */
+	bool begin() override;
+
+	/**
+	 * There is no need to call updateData() in order to get new results, but this call is provided for compatibility.
+	 *
+	 * It maintains its behavior of returning true iff packets have been received since the last call.
+	 * You must lock bnoDataMutex to call this.
+	 * @return
+	 */
+	bool updateData() override;
+
+	/**
+	 * Blocks the calling thread until the internal thread has processed new sensor packets, or the timeout passes.
+	 * Does not need bnoDataMutex.  Wakes once per batch of packets, however many samples it held.
+	 *
+	 * @param timeout How long to wait.
+	 * @return Whether new packets were processed.
+	 */
+	bool waitForSamples(std::chrono::milliseconds timeout);
+
+	/**
+	 * Locks the data mutex.
+	 */
+	void lockMutex() override
+	{
+		bnoDataMutex.lock();
+	}
+
+	/**
+	 * Unlocks the data mutex.
+	 */
+	void unlockMutex() override
+	{
+		bnoDataMutex.unlock();
+	}
+};
+
 #endif
 
 
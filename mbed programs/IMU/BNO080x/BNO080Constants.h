@@ -52,11 +52,21 @@
 #define SENSOR_REPORTID_STEP_COUNTER 0x11
 #define SENSOR_REPORTID_SIGNIFICANT_MOTION 0x12
 #define SENSOR_REPORTID_STABILITY_CLASSIFIER 0x13
+#define SENSOR_REPORTID_RAW_ACCELEROMETER 0x14
+#define SENSOR_REPORTID_RAW_GYROSCOPE 0x15
 #define SENSOR_REPORTID_STEP_DETECTOR 0x18
 #define SENSOR_REPORTID_SHAKE_DETECTOR 0x19
+#define SENSOR_REPORTID_GYRO_INTEGRATED_ROTATION_VECTOR 0x2A
 
 // sensor report ID with the largest numeric value
-#define MAX_SENSOR_REPORTID SENSOR_REPORTID_SHAKE_DETECTOR
+#define MAX_SENSOR_REPORTID SENSOR_REPORTID_GYRO_INTEGRATED_ROTATION_VECTOR
+
+// number of sensor reports the driver handles, i.e. the length of the per-report arrays.
+// The IDs are sparse (18 of them up to 0x2A), so those arrays are indexed by BNO080Base::reportIndex().
+#define SENSOR_REPORT_COUNT 18
+
+// reportIndex() of an ID that isn't a sensor report the driver handles
+#define REPORT_INDEX_NONE 0xFF
 
 // Q points for various sensor data elements
 #define ACCELEROMETER_Q_POINT 8 // for accelerometer based data
@@ -64,10 +74,15 @@
 #define MAGNETOMETER_Q_POINT 4 // for magnetometer data
 #define ROTATION_Q_POINT 14 // for rotation data
 #define ROTATION_ACCURACY_Q_POINT 12 // for rotation accuracy data
+#define ANGULAR_VELOCITY_Q_POINT 10 // for the angular velocity in the gyro-integrated rotation vector
 #define POWER_Q_POINT 10 // for power information in the metadata
 #define ORIENTATION_QUAT_Q_POINT 14 // for the set orientation command
 #define FRS_ORIENTATION_Q_POINT 30 // for the sensor orientation FRS record
 
+// Sensor report timestamps (base delta, rebase delta and per-report delay) count in 100us ticks
+// See SH-2 sections 6.5.1, 7.2.1 and 7.2.2
+#define SHTP_TIMESTAMP_TICK_US 100
+
 // Report IDs on the Executable channel
 // See Figure 1-27 in the BNO080 datasheet
 #define EXECUTABLE_REPORTID_RESET 0x1
@@ -104,4 +119,12 @@
 // within the allowed range.
 #define BNO080_RESET_TIMEOUT 180ms
 
+// timing for asynchronous I2C reads
+// An I2C read takes 9 clocks per byte, address byte included: a 272 byte packet is ~6ms at 400kHz.
+// Wait that long plus this margin for the completion callback before giving up on the transfer.
+#define BNO080_I2C_TRANSFER_MARGIN 5ms
+
+// after a failed I2C read with INT still low, BNO080AsyncI2C waits this long before trying again
+#define BNO080_I2C_RETRY_DELAY 1ms
+
 #endif //HAMSTER_BNO080CONSTANTS_H
@@ -0,0 +1,65 @@
+#ifndef BNO080_QFORMAT_H
+#define BNO080_QFORMAT_H
+
+/**
+ * @file QFormat.h
+ *
+ * @brief Conversions between floats and the BNO080's Q-point fixed point values.
+ *
+ * A Q n value is an integer scaled by 2^n (see https://en.wikipedia.org/wiki/Q_(number_format)).
+ * Scaling by a power of two only moves the float's exponent, so there is no need for pow():
+ * when the Q point is known at compile time the scale is a constant and a conversion is one
+ * int-to-float and one multiply; otherwise ldexpf() adjusts the exponent directly.  Both give
+ * exactly the same result as multiplying by pow(2, -n).
+ */
+
+#include <cmath>
+#include <cstdint>
+
+namespace QFormat
+{
+	/**
+	 * @return 2^-qPoint, the value of one count of a Q qPoint number.
+	 */
+	template <uint8_t qPoint>
+	constexpr float scale()
+	{
+		static_assert(qPoint < 32, "Q point out of range");
+		return 1.0f / static_cast<float>(1UL << qPoint);
+	}
+
+	/**
+	 * Converts a signed 16-bit Q qPoint value (the format of sensor report data) to float.
+	 */
+	template <uint8_t qPoint>
+	inline float toFloat(int16_t fixedPointValue)
+	{
+		return static_cast<float>(fixedPointValue) * scale<qPoint>();
+	}
+
+	/**
+	 * Converts a signed 16-bit value with a Q point only known at runtime to float.
+	 */
+	inline float toFloat(int16_t fixedPointValue, int qPoint)
+	{
+		return ldexpf(static_cast<float>(fixedPointValue), -qPoint);
+	}
+
+	/**
+	 * Converts an unsigned 32-bit value with a Q point only known at runtime (as in metadata records) to float.
+	 */
+	inline float toFloat(uint32_t fixedPointValue, int qPoint)
+	{
+		return ldexpf(static_cast<float>(fixedPointValue), -qPoint);
+	}
+
+	/**
+	 * Converts a float to a Q qPoint value, truncating towards zero.
+	 */
+	inline int32_t fromFloat(float value, int qPoint)
+	{
+		return static_cast<int32_t>(ldexpf(value, qPoint));
+	}
+}
+
+#endif //BNO080_QFORMAT_H
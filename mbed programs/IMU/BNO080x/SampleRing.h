@@ -0,0 +1,134 @@
+#ifndef BNO080_SAMPLERING_H
+#define BNO080_SAMPLERING_H
+
+/**
+ * @file SampleRing.h
+ *
+ * @brief Fixed-capacity single-producer single-consumer ring buffers.
+ *
+ * One thread pushes (the thread running the BNO080 driver) and one thread pops, with no mutex:
+ * the producer only writes the head index and the consumer only writes the tail index, and each
+ * publishes its index with a release store after it has finished with the slot.  Neither side ever
+ * blocks, so the consumer can be a lower priority thread without holding up the driver.
+ *
+ * When the ring is full, push() refuses the new item and counts it as an overflow (the producer
+ * can't take an item back from under the consumer).
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Ring buffer operations, independent of the capacity so the driver can keep a plain pointer to any ring.
+ * Create rings as SPSCRing<T, Capacity>.
+ */
+template <typename T>
+class SPSCRingBase
+{
+	/// Slot storage, owned by the derived class
+	T * const slots;
+
+	/// Capacity - 1; the capacity is a power of two so indices wrap with a mask
+	const uint32_t mask;
+
+	/// Count of items pushed.  Written only by the producer.
+	std::atomic<uint32_t> head;
+
+	/// Count of items popped.  Written only by the consumer.
+	std::atomic<uint32_t> tail;
+
+	/// Count of items refused because the ring was full.  Written only by the producer.
+	std::atomic<uint32_t> overflows;
+
+protected:
+	SPSCRingBase(T * storage, uint32_t capacity) :
+		slots(storage),
+		mask(capacity - 1),
+		head(0),
+		tail(0),
+		overflows(0)
+	{}
+
+public:
+	SPSCRingBase(const SPSCRingBase &) = delete;
+	SPSCRingBase & operator=(const SPSCRingBase &) = delete;
+
+	/**
+	 * Adds an item.  Producer thread only.
+	 * @return false if the ring was full; the item is dropped and counted by overflowCount().
+	 */
+	bool push(const T & item)
+	{
+		uint32_t currHead = head.load(std::memory_order_relaxed);
+		if(currHead - tail.load(std::memory_order_acquire) > mask)
+		{
+			overflows.store(overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		slots[currHead & mask] = item;
+		head.store(currHead + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Takes the oldest item.  Consumer thread only.
+	 * @return false if the ring was empty.
+	 */
+	bool pop(T & item)
+	{
+		uint32_t currTail = tail.load(std::memory_order_relaxed);
+		if(currTail == head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		item = slots[currTail & mask];
+		tail.store(currTail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @return Number of items waiting.  Exact from the consumer thread, a snapshot from anywhere else.
+	 */
+	uint32_t size() const
+	{
+		return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @return The number of items this ring can hold.
+	 */
+	uint32_t capacity() const
+	{
+		return mask + 1;
+	}
+
+	/**
+	 * @return The number of items dropped because the ring was full, since it was created.
+	 */
+	uint32_t overflowCount() const
+	{
+		return overflows.load(std::memory_order_relaxed);
+	}
+};
+
+/**
+ * Ring buffer holding up to Capacity items of type T, stored inline (no dynamic allocation).
+ * Capacity must be a power of two.
+ */
+template <typename T, uint32_t Capacity>
+class SPSCRing : public SPSCRingBase<T>
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SPSCRing capacity must be a power of two");
+
+	T storage[Capacity];
+
+public:
+	SPSCRing() :
+		SPSCRingBase<T>(storage, Capacity)
+	{}
+};
+
+#endif //BNO080_SAMPLERING_H
@@ -0,0 +1,122 @@
+#ifndef BNO080_SEQLOCK_H
+#define BNO080_SEQLOCK_H
+
+/**
+ * @file Seqlock.h
+ *
+ * @brief Single-writer sequence lock for publishing a small struct to any number of readers.
+ *
+ * The writer never waits: it makes the sequence number odd, stores the value, and makes it even
+ * again.  A reader copies the value between two loads of the sequence number and keeps the copy
+ * only if both loads saw the same even number, i.e. no write overlapped the copy.  Readers never
+ * block the writer and never see half of one write and half of another.
+ *
+ * The value is held as an array of atomic words and copied with relaxed loads and stores, ordered
+ * by the fences around them, so the racing copy is well defined in C++ (and clean under
+ * ThreadSanitizer) rather than relying on a plain memcpy racing with the writer.
+ *
+ * On a single core RTOS, a reader spinning in read() only makes progress once the writer finishes,
+ * so don't give a reader a higher priority than the writer, or use tryRead() and retry later.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+template <typename T>
+class Seqlock
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Seqlock can only hold trivially copyable types");
+
+	/// Number of 32-bit words the value occupies
+	static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+	/// Odd while a write is in progress; advances by 2 per write
+	std::atomic<uint32_t> sequence;
+
+	/// The value, word by word
+	std::atomic<uint32_t> words[WORDS];
+
+public:
+	Seqlock() :
+		sequence(0)
+	{
+		for(size_t i = 0; i < WORDS; ++i)
+		{
+			words[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	Seqlock(const Seqlock &) = delete;
+	Seqlock & operator=(const Seqlock &) = delete;
+
+	/**
+	 * Publishes a new value.  Only one thread may write.  Never blocks.
+	 */
+	void write(const T & value)
+	{
+		uint32_t buffer[WORDS] = {};
+		memcpy(buffer, &value, sizeof(T));
+
+		uint32_t seq = sequence.load(std::memory_order_relaxed);
+		sequence.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for(size_t i = 0; i < WORDS; ++i)
+		{
+			words[i].store(buffer[i], std::memory_order_relaxed);
+		}
+
+		sequence.store(seq + 2, std::memory_order_release);
+	}
+
+	/**
+	 * Copies the latest value, unless a write is in progress.
+	 * @return false if a write overlapped the copy; value is left unchanged.
+	 */
+	bool tryRead(T & value) const
+	{
+		uint32_t before = sequence.load(std::memory_order_acquire);
+		if(before & 1)
+		{
+			return false;
+		}
+
+		uint32_t buffer[WORDS];
+		for(size_t i = 0; i < WORDS; ++i)
+		{
+			buffer[i] = words[i].load(std::memory_order_relaxed);
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(sequence.load(std::memory_order_relaxed) != before)
+		{
+			return false;
+		}
+
+		memcpy(&value, buffer, sizeof(T));
+		return true;
+	}
+
+	/**
+	 * Copies the latest value, retrying until no write overlaps the copy.
+	 */
+	void read(T & value) const
+	{
+		while(!tryRead(value))
+		{
+		}
+	}
+
+	/**
+	 * @return The number of writes completed so far.
+	 */
+	uint32_t writeCount() const
+	{
+		return sequence.load(std::memory_order_acquire) / 2;
+	}
+};
+
+#endif //BNO080_SEQLOCK_H
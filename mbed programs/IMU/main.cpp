@@ -1,11 +1,30 @@
 #include <mbed.h>
 #include <BNO080.h>
+#include <BNO080Async.h>
 #include <iostream>
+#include <algorithm>
 #include <SerialStream.h>
+#include "kvstore_global_api.h"
 
 #define i2cadd 0x4A    //I2C Address
 #define i2cportspeed 400000
 
+// --- Report rate and batching ---
+// With a batch interval the IMU collects samples in its FIFO and sends them in one packet,
+// instead of one I2C transaction per sample.
+// Set BATCH_INTERVAL_MS to 0 to compare against one packet per sample.
+#define REPORT_INTERVAL_MS 5        // 200 Hz game rotation vector
+#define BATCH_INTERVAL_MS 20        // Up to 4 samples per packet
+#define STATS_PERIOD_US 1000000     // Print orientation and timing once per second
+
+// IMU metadata kept in internal flash (see storage settings in mbed_app.json), so reboots skip the FRS reads
+#define METADATA_KEY "/kv/bno080_metadata"
+
+// I2C bytes per packet besides the samples: address and header to get the length,
+// then address, repeated header and base timestamp
+#define PACKET_OVERHEAD_BYTES (1 + 4 + 1 + 4 + 5)
+#define GAME_ROTATION_BYTES 12
+
 // defining hardware pins
 PinName SCL = PB_10;
 PinName SDA = PB_11;
@@ -14,14 +33,35 @@ PinName RSTPin = PE_14;
 
 BufferedSerial serial(USBTX, USBRX, 115200);
 SerialStream<BufferedSerial> debugport(serial);
-BNO080I2C imu(&debugport, SDA, SCL, INTPin, RSTPin, i2cadd, i2cportspeed);
+// The driver's own thread reads the IMU when INT falls; this thread only waits for samples
+BNO080AsyncI2C imu(&debugport, SDA, SCL, INTPin, RSTPin, i2cadd, i2cportspeed);
+BNO080::SampleRing<32> gameRotationSamples;     // Popped here without locking the driver
+BNO080::MetadataCache metadataCache;
+
+// Enabled by begin() as soon as the IMU is up, instead of after it returns
+const BNO080::StartupReport startupReports[] = {
+    {BNO080::GAME_ROTATION, REPORT_INTERVAL_MS, BATCH_INTERVAL_MS},
+};
 
 
 int main() {
 
     debugport.printf("============================================\n");
 
-    if(imu.begin()) {
+    // Whatever was saved last boot; the driver ignores it if the IMU firmware has changed
+    size_t metadataSize = 0;
+    if (kv_get(METADATA_KEY, &metadataCache, sizeof(metadataCache), &metadataSize) != MBED_SUCCESS
+        || metadataSize != sizeof(metadataCache)) {
+        memset(&metadataCache, 0, sizeof(metadataCache));
+    }
+    imu.setMetadataCache(&metadataCache);
+
+    // Configure IMU reports
+    imu.attachSampleRing(BNO080::GAME_ROTATION, gameRotationSamples);
+    imu.setStartupReports(startupReports, sizeof(startupReports) / sizeof(startupReports[0]));
+
+    bool imuReady = imu.begin();
+    if(imuReady) {
 
         printf("Initialization Success!\n"); // check that the initialization succeeded
         //imu.setSensorOrientation(Quaternion orientation)  // sets the IMU coordinate frame to the Platform' coordinate frame
@@ -29,30 +69,86 @@ int main() {
 
     else printf("Initialization Failed!\n");
 
+    if (imuReady) {
+        // check the requested rate against what the IMU supports (from the cache after the first boot)
+        imu.lockMutex();
+        float minPeriod_s = imu.getMinPeriod(BNO080::GAME_ROTATION);
+        imu.unlockMutex();
+        if (REPORT_INTERVAL_MS / 1000.0f < minPeriod_s) {
+            debugport.printf("Report interval %d ms is below the IMU's minimum of %.3f ms\n", REPORT_INTERVAL_MS, minPeriod_s * 1000.0f);
+        }
 
-    // Configure IMU reports
-    imu.enableReport(BNO080::GAME_ROTATION, 20);
+        if (imu.isMetadataCacheDirty()) {
+            if (kv_set(METADATA_KEY, &metadataCache, sizeof(metadataCache), 0) == MBED_SUCCESS) {
+                imu.markMetadataCacheSaved();
+            } else {
+                debugport.printf("Couldn't save IMU metadata\n");
+            }
+        }
+    }
+    bool bootTimingPrinted = false;
+
+    // bus time per sample, worked out from what goes over the wire (9 clocks per byte with the ACK)
+    int samplesPerPacket = BATCH_INTERVAL_MS > REPORT_INTERVAL_MS ? BATCH_INTERVAL_MS / REPORT_INTERVAL_MS : 1;
+    float busPerSample_us = (PACKET_OVERHEAD_BYTES + samplesPerPacket * GAME_ROTATION_BYTES) * 9 * 1e6f
+                          / (i2cportspeed * static_cast<float>(samplesPerPacket));
+
+    uint32_t statsStart_us = us_ticker_read();
+    uint32_t sampleCount = 0;
+    uint64_t latencySum_us = 0;
+    uint32_t latencyMax_us = 0;
+    uint32_t overflowsReported = 0;     // ring overflows up to the last printout
+    BNO080::Sample latest;
 
     while (true) {
 
-       // std::cout << "\033[2J\033[H";       
-         
-        if (imu.updateData()) {
-
-            if (imu.hasNewData(BNO080::GAME_ROTATION)) {
-                
-                TVector3 eulerDegrees = imu.gameRotationVector.euler() * (180.0 / M_PI);
-                float roll = eulerDegrees[0];               //x-axis
-                float pitch = eulerDegrees[1];              //y-axis
-                float yaw = eulerDegrees[2];                //z-axis
-
-                debugport.printf("Roll: %.2f\n", roll);
-                debugport.printf("Pitch: %.2f\n", pitch);
-                debugport.printf("Yaw: %.2f\n", yaw);
-                debugport.printf("\n");
+        // sleeps until the driver thread has parsed a packet
+        if (imu.waitForSamples(100ms)) {
+
+            BNO080::Sample sample;
+            while (gameRotationSamples.pop(sample)) {
+
+                // from when the IMU took the sample to when this thread has it
+                uint32_t latency_us = us_ticker_read() - sample.timestamp;
+                latencySum_us += latency_us;
+                latencyMax_us = std::max(latencyMax_us, latency_us);
+
+                latest = sample;
+                ++sampleCount;
             }
         }
 
-       ThisThread::sleep_for(2ms);eee
+        if (us_ticker_read() - statsStart_us >= STATS_PERIOD_US && sampleCount > 0) {
+
+            Quaternion rotation(latest.data[0], latest.data[1], latest.data[2], latest.data[3]);
+            TVector3 eulerDegrees = rotation.euler() * (180.0 / M_PI);
+            float roll = eulerDegrees[0];               //x-axis
+            float pitch = eulerDegrees[1];              //y-axis
+            float yaw = eulerDegrees[2];                //z-axis
+
+            debugport.printf("Roll: %.2f\n", roll);
+            debugport.printf("Pitch: %.2f\n", pitch);
+            debugport.printf("Yaw: %.2f\n", yaw);
+
+            uint32_t overflows = gameRotationSamples.overflowCount();
+            debugport.printf("Samples: %lu, dropped: %lu\n", static_cast<unsigned long>(sampleCount),
+                             static_cast<unsigned long>(overflows - overflowsReported));
+            debugport.printf("Sample to pickup: %lu us mean, %lu us max\n",
+                             static_cast<unsigned long>(latencySum_us / sampleCount), static_cast<unsigned long>(latencyMax_us));
+            debugport.printf("Bus per sample: %.1f us\n", busPerSample_us);
+
+            // once there's been data, so it includes the time to the first sample
+            if (!bootTimingPrinted) {
+                imu.printBootTiming();
+                bootTimingPrinted = true;
+            }
+            debugport.printf("\n");
+
+            statsStart_us = us_ticker_read();
+            sampleCount = 0;
+            latencySum_us = 0;
+            latencyMax_us = 0;
+            overflowsReported = overflows;
+        }
     }
 }
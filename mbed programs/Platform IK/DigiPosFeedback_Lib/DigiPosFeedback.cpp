@@ -31,7 +31,10 @@ void DigitalPosFeedback::setState(ActuatorState newState) {
     if (state == newState) return; // No change
 
     state = newState;
+    writePwm();
+}
 
+void DigitalPosFeedback::writePwm() {
     switch (state) {
         case ActuatorState::EXTENDING:
             LPWM.write(DUTY_CYCLE);
@@ -54,8 +57,8 @@ void DigitalPosFeedback::setDuty_Cycle(float duty) {
     if (duty < 0.0f) duty = 0.0f;
     if (duty > 1.0f) duty = 1.0f;
     DUTY_CYCLE = duty;
-    // Re-apply PWM if motor is currently moving
-    setState(state);
+    // Re-apply PWM if motor is currently moving (setState() ignores an unchanged state)
+    writePwm();
 }
 
 void DigitalPosFeedback::setActuatorSpeed(float speed) {
@@ -6,6 +6,13 @@
 #include <cmath> // For fabsf
 
 class DigitalPosFeedback {
+public:
+    enum class ActuatorState {
+        EXTENDING,
+        RETRACTING,
+        STOPPED
+    };
+
 private:
     float DUTY_CYCLE = 1.0f;            // Default duty cycle (can be overridden)
     float ACTUATOR_SPEED = 30.6827057f; // Default speed in mm/s (can be overridden)
@@ -19,6 +26,7 @@ private:
 
     // Internal state update based on commands
     void setState(ActuatorState newState);
+    void writePwm();                    // Drive the outputs for the current state and duty cycle
 
 public:
     // Made MAX_STROKE public const for access in main, ensure it's correct for your actuators
@@ -28,12 +36,6 @@ public:
     float targetPosition = 0.0f;        // Target position (STROKE) to move toward
     float tolerance = 10.0f;            // Acceptable error margin (STROKE) in mm
 
-    enum class ActuatorState {
-        EXTENDING,
-        RETRACTING,
-        STOPPED
-    };
-
     ActuatorState state = ActuatorState::STOPPED;
 
     // Constructor with optional speed and duty cycle
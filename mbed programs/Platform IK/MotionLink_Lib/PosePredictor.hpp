@@ -0,0 +1,298 @@
+#ifndef POSE_PREDICTOR_HPP
+#define POSE_PREDICTOR_HPP
+
+// --- Latency-Compensating Pose Predictor ---
+// A pose commanded now only shows up in the platform's motion after the serial link, the parse,
+// the wait for the next control cycle and the actuators' own response. The predictor
+// extrapolates the stream of host poses forward by that much so the platform moves where the
+// aircraft will be rather than where it was.
+//
+// Each pose axis picks its own model (PredictMode):
+//   HOLD          newest pose as is (what the loop did before)
+//   VELOCITY      constant velocity through the last two poses
+//   ACCELERATION  constant acceleration through the last three
+//   KALMAN        constant-velocity Kalman filter (position, velocity); processNoise is the
+//                 acceleration noise density, higher follows manoeuvres faster but smooths less
+//
+// Samples are timed with the host's own timestamps (MotionFrame::hostTime_us), so link jitter
+// does not show up as velocity. Predictions are asked for in the same clock; the caller adds the
+// latency it measured to the sample's host time.
+//
+// Every prediction is scored once the pose for that time has actually arrived (interpolated
+// between the two samples around it), against both the prediction and the pose the loop would
+// have used without one, so the statistics say directly whether prediction is helping an axis.
+//
+// Fixed-size state, no allocation, no OS headers: shared between the firmware and the host.
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include "ConfigProtocol.hpp"
+#include "LatencyTrace.hpp"
+
+namespace MotionLink {
+
+enum PredictMode : uint8_t {
+    PREDICT_HOLD         = 0,
+    PREDICT_VELOCITY     = 1,
+    PREDICT_ACCELERATION = 2,
+    PREDICT_KALMAN       = 3,
+    PREDICT_MODES
+};
+
+constexpr uint32_t PREDICT_STALE_US = 200000;       // No pose for this long: hold it and start over
+constexpr uint32_t PREDICT_MAX_LEAD_US = 150000;    // Never extrapolate further than this past a sample
+constexpr size_t PREDICT_PENDING = 16;              // Predictions waiting to be scored
+
+// Running error statistics of one axis (mean squares kept incrementally, so they stay accurate
+// in float over hours)
+struct PredictionStats {
+    uint32_t count = 0;
+    float meanSqPredicted = 0.0f;
+    float meanSqHeld = 0.0f;
+    float maxPredicted = 0.0f;
+    float maxHeld = 0.0f;
+
+    void add(float predictedError, float heldError) {
+        ++count;
+        meanSqPredicted += (predictedError * predictedError - meanSqPredicted) / count;
+        meanSqHeld += (heldError * heldError - meanSqHeld) / count;
+        maxPredicted = fmaxf(maxPredicted, fabsf(predictedError));
+        maxHeld = fmaxf(maxHeld, fabsf(heldError));
+    }
+
+    float rmsPredicted() const { return sqrtf(meanSqPredicted); }
+    float rmsHeld() const { return sqrtf(meanSqHeld); }
+};
+
+// --- One axis ---
+class AxisPredictor {
+public:
+    void configure(PredictMode newMode, float newProcessNoise, float newMeasurementNoise) {
+        mode = newMode;
+        processNoise = newProcessNoise;
+        measurementNoise = newMeasurementNoise;
+        reset();
+    }
+
+    void reset() { samples = 0; }
+
+    PredictMode currentMode() const { return mode; }
+    float currentProcessNoise() const { return processNoise; }
+
+    void addSample(float value, uint32_t time_us) {
+        if (samples > 0) {
+            int32_t gap = elapsed_us(time_us, sampleTime_us[0]);
+            if (gap <= 0) {
+                sampleValue[0] = value;      // Same or older timestamp: just take the newer value
+                return;
+            }
+            if (static_cast<uint32_t>(gap) > PREDICT_STALE_US) {
+                samples = 0;
+            }
+        }
+        if (mode == PREDICT_KALMAN) {
+            kalmanUpdate(value, time_us);
+        }
+        sampleValue[2] = sampleValue[1]; sampleTime_us[2] = sampleTime_us[1];
+        sampleValue[1] = sampleValue[0]; sampleTime_us[1] = sampleTime_us[0];
+        sampleValue[0] = value;     sampleTime_us[0] = time_us;
+        if (samples < 3) ++samples;
+    }
+
+    float latest() const { return samples > 0 ? sampleValue[0] : 0.0f; }
+    uint32_t latestTime_us() const { return sampleTime_us[0]; }
+    bool hasSample() const { return samples > 0; }
+
+    // Value between the two newest samples at time_us (for scoring)
+    float interpolate(uint32_t time_us) const {
+        if (samples < 2) return sampleValue[0];
+        float span = static_cast<float>(elapsed_us(sampleTime_us[0], sampleTime_us[1]));
+        float t = static_cast<float>(elapsed_us(time_us, sampleTime_us[1])) / span;
+        return sampleValue[1] + t * (sampleValue[0] - sampleValue[1]);
+    }
+
+    uint32_t previousTime_us() const { return sampleTime_us[1]; }
+    size_t sampleCount() const { return samples; }
+
+    float predict(uint32_t time_us) const {
+        if (samples == 0) return 0.0f;
+        int32_t lead = elapsed_us(time_us, sampleTime_us[0]);
+        if (lead <= 0 || static_cast<uint32_t>(lead) > PREDICT_STALE_US) {
+            return sampleValue[0];
+        }
+        float h = 1e-6f * static_cast<float>(lead > static_cast<int32_t>(PREDICT_MAX_LEAD_US)
+                                             ? static_cast<int32_t>(PREDICT_MAX_LEAD_US) : lead);
+        switch (mode) {
+            case PREDICT_VELOCITY:
+                return samples >= 2 ? sampleValue[0] + h * slope(0, 1) : sampleValue[0];
+
+            case PREDICT_ACCELERATION: {
+                if (samples < 3) {
+                    return samples >= 2 ? sampleValue[0] + h * slope(0, 1) : sampleValue[0];
+                }
+                // Parabola through the last three samples, evaluated h past the newest
+                float v01 = slope(0, 1), v12 = slope(1, 2);
+                float midSpan = 0.5e-6f * static_cast<float>(elapsed_us(sampleTime_us[0], sampleTime_us[2]));
+                float accel = (v01 - v12) / midSpan;
+                float dt01 = 1e-6f * static_cast<float>(elapsed_us(sampleTime_us[0], sampleTime_us[1]));
+                float velocity = v01 + 0.5f * accel * dt01;   // at the newest sample
+                return sampleValue[0] + h * velocity + 0.5f * accel * h * h;
+            }
+
+            case PREDICT_KALMAN:
+                return kalmanPosition + h * kalmanVelocity;
+
+            case PREDICT_HOLD:
+            default:
+                return sampleValue[0];
+        }
+    }
+
+private:
+    float slope(int newer, int older) const {
+        float dt = 1e-6f * static_cast<float>(elapsed_us(sampleTime_us[newer], sampleTime_us[older]));
+        return (sampleValue[newer] - sampleValue[older]) / dt;
+    }
+
+    void kalmanUpdate(float z, uint32_t time_us) {
+        if (samples == 0) {
+            kalmanPosition = z;
+            kalmanVelocity = 0.0f;
+            p00 = measurementNoise;
+            p01 = 0.0f;
+            p11 = processNoise;     // Unknown velocity: about a second of manoeuvre noise, settles in a few samples
+            return;
+        }
+        // Predict to this sample: x = F x, P = F P F' + Q (white-noise acceleration)
+        float dt = 1e-6f * static_cast<float>(elapsed_us(time_us, sampleTime_us[0]));
+        kalmanPosition += dt * kalmanVelocity;
+        float q = processNoise;
+        p00 += dt * (2.0f * p01 + dt * p11) + q * dt * dt * dt / 3.0f;
+        p01 += dt * p11 + q * dt * dt / 2.0f;
+        p11 += q * dt;
+
+        // Update with the measured position
+        float s = p00 + measurementNoise;
+        float k0 = p00 / s, k1 = p01 / s;
+        float innovation = z - kalmanPosition;
+        kalmanPosition += k0 * innovation;
+        kalmanVelocity += k1 * innovation;
+        p11 -= k1 * p01;
+        p01 -= k0 * p01;
+        p00 -= k0 * p00;
+    }
+
+    PredictMode mode = PREDICT_HOLD;
+    float processNoise = 1.0f;
+    float measurementNoise = 1.0f;
+
+    // Newest sample first
+    float sampleValue[3] = { 0.0f, 0.0f, 0.0f };
+    uint32_t sampleTime_us[3] = { 0, 0, 0 };
+    size_t samples = 0;
+
+    // Kalman state and covariance
+    float kalmanPosition = 0.0f, kalmanVelocity = 0.0f;
+    float p00 = 0.0f, p01 = 0.0f, p11 = 0.0f;
+};
+
+// --- Whole pose (POSE_* axis order) ---
+class PosePredictor {
+public:
+    PosePredictor() {
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            // Process noise of a moderate manoeuvre (mm^2/s^3, deg^2/s^3)
+            axes[axis].configure(PREDICT_HOLD, axis >= POSE_ROLL_DEG ? 2000.0f : 200000.0f, measurementNoise(axis));
+        }
+    }
+
+    void setMode(size_t axis, PredictMode mode) {
+        AxisPredictor& a = axes[axis];
+        a.configure(mode, a.currentProcessNoise(), measurementNoise(axis));
+        axisStats[axis] = PredictionStats();    // Old numbers belong to the old mode
+    }
+
+    void setProcessNoise(size_t axis, float noise) {
+        AxisPredictor& a = axes[axis];
+        a.configure(a.currentMode(), noise, measurementNoise(axis));
+        axisStats[axis] = PredictionStats();
+    }
+
+    PredictMode mode(size_t axis) const { return axes[axis].currentMode(); }
+    float processNoise(size_t axis) const { return axes[axis].currentProcessNoise(); }
+    const PredictionStats& stats(size_t axis) const { return axisStats[axis]; }
+
+    // Forget the pose stream (the pose now comes from somewhere else); statistics are kept
+    void reset() {
+        for (AxisPredictor& a : axes) a.reset();
+        pendingCount = 0;
+    }
+
+    // A new host pose, taken at time_us on the host clock. Scores every earlier prediction
+    // whose time has now been reached.
+    void addSample(const float pose[POSE_AXES], uint32_t time_us) {
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            axes[axis].addSample(pose[axis], time_us);
+        }
+        const AxisPredictor& ref = axes[0];
+        while (pendingCount > 0) {
+            Pending& p = pending[pendingHead];
+            if (elapsed_us(p.time_us, ref.latestTime_us()) > 0) {
+                break;      // Not reached yet
+            }
+            if (ref.sampleCount() >= 2 && elapsed_us(p.time_us, ref.previousTime_us()) >= 0) {
+                for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+                    float actual = axes[axis].interpolate(p.time_us);
+                    axisStats[axis].add(p.predicted[axis] - actual, p.held[axis] - actual);
+                }
+            }
+            pendingHead = (pendingHead + 1) % PREDICT_PENDING;
+            --pendingCount;
+        }
+    }
+
+    // Pose for time_us (host clock, newest sample's time plus the latency to cover). Returns
+    // false, with pose untouched, before the first sample.
+    bool predict(uint32_t time_us, float pose[POSE_AXES]) {
+        if (!axes[0].hasSample()) {
+            return false;
+        }
+        Pending& p = pending[(pendingHead + pendingCount) % PREDICT_PENDING];
+        bool fresh = static_cast<uint32_t>(elapsed_us(time_us, axes[0].latestTime_us())) <= PREDICT_STALE_US;
+        for (size_t axis = 0; axis < POSE_AXES; ++axis) {
+            pose[axis] = axes[axis].predict(time_us);
+            p.predicted[axis] = pose[axis];
+            p.held[axis] = axes[axis].latest();
+        }
+        if (fresh) {
+            p.time_us = time_us;
+            if (pendingCount == PREDICT_PENDING) {
+                pendingHead = (pendingHead + 1) % PREDICT_PENDING;  // Full: drop the oldest
+            } else {
+                ++pendingCount;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Pending {
+        uint32_t time_us;
+        float predicted[POSE_AXES];
+        float held[POSE_AXES];
+    };
+
+    // About the FINE quantization step squared (mm^2, deg^2)
+    static float measurementNoise(size_t axis) { return axis >= POSE_ROLL_DEG ? 1e-4f : 1e-2f; }
+
+    AxisPredictor axes[POSE_AXES];
+    PredictionStats axisStats[POSE_AXES];
+    Pending pending[PREDICT_PENDING];
+    size_t pendingHead = 0;
+    size_t pendingCount = 0;
+};
+
+} // namespace MotionLink
+
+#endif // POSE_PREDICTOR_HPP
@@ -0,0 +1,144 @@
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+// --- Platform Telemetry ---
+// Per-cycle actuator state and control-loop timing, sent platform -> host in batches so one
+// frame carries several control cycles. The control loop only copies floats into a
+// TelemetryRecord; quantizing and framing happen in buildTelemetryFrame(), which the firmware
+// calls from a background thread.
+//
+// Payload layout (little-endian):
+//   uint8   record count (1 .. TELEMETRY_MAX_RECORDS)
+//   uint8   decimation (records are every Nth control cycle)
+//   uint16  records dropped on the platform so far (telemetry queue full)
+//   then per record:
+//     uint32  cycle number
+//     uint32  cycle start time              (us, platform clock)
+//     uint16  time since previous cycle start (us, saturates)
+//     uint16  time spent working this cycle   (us, saturates)
+//     uint16  sequence of the pose being tracked
+//     x 6 actuators:
+//       int16   target stroke                (1/64 mm)
+//       int16   estimated stroke             (1/64 mm)
+//       uint8   state                        (DigitalPosFeedback::ActuatorState)
+//       uint8   duty cycle                   (0-255 = 0-100 %)
+//
+// 50 bytes per record, 5 records per frame: 259 B on the wire for 5 cycles, vs ~400 B of
+// printf text for one.
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include "MotionLink.hpp"
+#include "MotionSchema.hpp"
+
+namespace MotionLink {
+
+constexpr size_t TELEMETRY_ACTUATORS = 6;
+constexpr size_t TELEMETRY_HEADER_SIZE = 4;
+constexpr size_t TELEMETRY_RECORD_SIZE = 14 + TELEMETRY_ACTUATORS * 6;
+constexpr size_t TELEMETRY_MAX_RECORDS = (MAX_PAYLOAD - TELEMETRY_HEADER_SIZE) / TELEMETRY_RECORD_SIZE;
+
+// Strokes are 0-300 mm, so 1/64 mm in an int16
+using StrokeField = MotionSchema::FixedField<int16_t, 300>;
+
+struct ActuatorTelemetry {
+    float target_mm = 0.0f;
+    float estimate_mm = 0.0f;
+    uint8_t state = 0;
+    float duty = 0.0f;
+};
+
+struct TelemetryRecord {
+    uint32_t cycle = 0;
+    uint32_t cycleStart_us = 0;
+    uint32_t period_us = 0;
+    uint32_t work_us = 0;
+    uint16_t poseSequence = 0;
+    ActuatorTelemetry actuators[TELEMETRY_ACTUATORS];
+};
+
+struct TelemetryBatch {
+    uint8_t count = 0;
+    uint8_t decimation = 1;
+    uint16_t recordsDropped = 0;
+    TelemetryRecord records[TELEMETRY_MAX_RECORDS];
+};
+
+inline uint16_t saturate16(uint32_t value) {
+    return value > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(value);
+}
+
+// Writes a complete frame to out (MAX_FRAME_SIZE is always enough). Returns the bytes written.
+inline size_t buildTelemetryFrame(const TelemetryBatch& batch, uint8_t* out) {
+    using MotionSchema::putLE;
+    uint8_t count = batch.count > TELEMETRY_MAX_RECORDS ? static_cast<uint8_t>(TELEMETRY_MAX_RECORDS) : batch.count;
+
+    uint8_t* p = out + HEADER_SIZE;
+    p = putLE(p, count);
+    p = putLE(p, batch.decimation);
+    p = putLE(p, batch.recordsDropped);
+    for (uint8_t r = 0; r < count; ++r) {
+        const TelemetryRecord& record = batch.records[r];
+        p = putLE(p, record.cycle);
+        p = putLE(p, record.cycleStart_us);
+        p = putLE(p, saturate16(record.period_us));
+        p = putLE(p, saturate16(record.work_us));
+        p = putLE(p, record.poseSequence);
+        for (const ActuatorTelemetry& actuator : record.actuators) {
+            float duty = actuator.duty < 0.0f ? 0.0f : (actuator.duty > 1.0f ? 1.0f : actuator.duty);
+            p = putLE(p, StrokeField::encode(actuator.target_mm));
+            p = putLE(p, StrokeField::encode(actuator.estimate_mm));
+            p = putLE(p, actuator.state);
+            p = putLE(p, static_cast<uint8_t>(lrintf(duty * 255.0f)));
+        }
+    }
+    uint8_t length = static_cast<uint8_t>(p - (out + HEADER_SIZE));
+    return buildFrame(MSG_TELEMETRY, out + HEADER_SIZE, length, out);
+}
+
+// Decodes a telemetry payload. Returns false if the length doesn't match the record count.
+inline bool decodeTelemetry(const uint8_t* in, size_t length, TelemetryBatch& batch) {
+    using MotionSchema::getLE;
+    if (length < TELEMETRY_HEADER_SIZE) return false;
+
+    in = getLE(in, batch.count);
+    in = getLE(in, batch.decimation);
+    in = getLE(in, batch.recordsDropped);
+    if (batch.count > TELEMETRY_MAX_RECORDS ||
+        length != TELEMETRY_HEADER_SIZE + batch.count * TELEMETRY_RECORD_SIZE) {
+        return false;
+    }
+
+    for (uint8_t r = 0; r < batch.count; ++r) {
+        TelemetryRecord& record = batch.records[r];
+        uint16_t period, work;
+        in = getLE(in, record.cycle);
+        in = getLE(in, record.cycleStart_us);
+        in = getLE(in, period);
+        in = getLE(in, work);
+        in = getLE(in, record.poseSequence);
+        record.period_us = period;
+        record.work_us = work;
+        for (ActuatorTelemetry& actuator : record.actuators) {
+            int16_t target, estimate;
+            uint8_t duty;
+            in = getLE(in, target);
+            in = getLE(in, estimate);
+            in = getLE(in, actuator.state);
+            in = getLE(in, duty);
+            actuator.target_mm = StrokeField::decode(target);
+            actuator.estimate_mm = StrokeField::decode(estimate);
+            actuator.duty = duty / 255.0f;
+        }
+    }
+    return true;
+}
+
+static_assert(TELEMETRY_RECORD_SIZE == 50, "Telemetry record size");
+static_assert(TELEMETRY_MAX_RECORDS == 5, "Telemetry records per frame");
+static_assert(StrokeField::FRAC_BITS == 6, "Strokes should be 1/64 mm/count");
+
+} // namespace MotionLink
+
+#endif // TELEMETRY_HPP
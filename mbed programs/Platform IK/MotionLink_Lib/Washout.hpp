@@ -0,0 +1,244 @@
+#ifndef WASHOUT_HPP
+#define WASHOUT_HPP
+
+// --- Classical Washout Motion Cueing ---
+// Turns aircraft specific forces and angular rates into a platform pose that fits in the
+// workspace (Reid & Nahon's classical algorithm, without the frame transforms, which are close
+// to identity for the small angles this platform can reach):
+//
+//   specific force x,y --scale--> HP2 -> HP1 --integrate x2--> surge / sway translation
+//                      \-scale--> LP2 --asin(f/g), rate limit--> tilt coordination (pitch / roll)
+//   specific force z   --scale--> (f - g) -> HP2 -> HP1 --integrate x2--> heave translation
+//   angular rates      --scale--> HP2 --integrate--> roll / pitch / yaw
+//
+// Onsets come through the high-pass channels as real motion and are then washed out back to
+// neutral; sustained forces (braking, a long turn) come through the low-pass channel as a slow
+// tilt, so gravity supplies the sustained part. The tilt is rate limited below what the inner ear
+// notices as rotation.
+//
+// Axes follow FlightData: x forward, y right, z up; pitch positive nose up, roll positive right
+// side down. Specific force is what an accelerometer in the seat reads, about (0, 0, +9.81) in
+// level flight.
+//
+// Every filter is a biquad with its coefficients worked out once by configure() for a fixed step
+// (bilinear transform), so step() is about a hundred float multiply-adds plus two asinf(), with no
+// allocation, no trig on the filter path and no state beyond this object. Shared between the
+// mbed firmware and the host bridge, so no mbed.h / OS headers in here.
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+namespace MotionCue {
+
+constexpr float GRAVITY = 9.80665f;
+constexpr float RAD_TO_DEG = 57.2957795f;
+constexpr float DEG_TO_RAD = 0.0174532925f;
+
+// --- Biquad (transposed direct form II) ---
+struct Biquad {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    float z1 = 0.0f, z2 = 0.0f;
+
+    float step(float x) {
+        float y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+
+    void reset() { z1 = z2 = 0.0f; }
+
+    // Coefficients from the bilinear transform s = K (1 - z^-1) / (1 + z^-1), K = 2 / dt
+
+    // s^2 / (s^2 + 2 zeta w s + w^2)
+    static Biquad highPass2(float w, float zeta, float dt) {
+        float K = 2.0f / dt;
+        float a0 = K * K + 2.0f * zeta * w * K + w * w;
+        Biquad f;
+        f.b0 = K * K / a0;
+        f.b1 = -2.0f * K * K / a0;
+        f.b2 = K * K / a0;
+        f.a1 = (2.0f * w * w - 2.0f * K * K) / a0;
+        f.a2 = (K * K - 2.0f * zeta * w * K + w * w) / a0;
+        return f;
+    }
+
+    // w^2 / (s^2 + 2 zeta w s + w^2)
+    static Biquad lowPass2(float w, float zeta, float dt) {
+        float K = 2.0f / dt;
+        float a0 = K * K + 2.0f * zeta * w * K + w * w;
+        Biquad f;
+        f.a1 = (2.0f * w * w - 2.0f * K * K) / a0;
+        f.a2 = (K * K - 2.0f * zeta * w * K + w * w) / a0;
+        f.b0 = w * w / a0;
+        f.b1 = 2.0f * w * w / a0;
+        f.b2 = w * w / a0;
+        return f;
+    }
+
+    // s / (s + w)
+    static Biquad highPass1(float w, float dt) {
+        float K = 2.0f / dt;
+        float a0 = K + w;
+        Biquad f;
+        f.b0 = K / a0;
+        f.b1 = -K / a0;
+        f.a1 = (w - K) / a0;
+        return f;
+    }
+};
+
+// Trapezoidal integrator
+struct Integrator {
+    float value = 0.0f;
+    float previous = 0.0f;
+
+    float step(float x, float dt) {
+        value += 0.5f * (x + previous) * dt;
+        previous = x;
+        return value;
+    }
+
+    void reset() { value = previous = 0.0f; }
+};
+
+// --- Tuning ---
+// Defaults suit this platform: roughly +/-100 mm of usable travel around mid-stroke and about
+// +/-15 deg of tilt. Frequencies in rad/s.
+struct WashoutParams {
+    // Translational (surge, sway, heave) high-pass channel
+    float translationScale = 0.2f;      // fraction of the aircraft's specific force
+    float translationHpFreq = 4.0f;     // second-order break
+    float translationHpDamping = 1.0f;
+    float translationHpReturn = 0.5f;   // first-order break that brings the position back to zero
+    float translationLimit_mm = 100.0f;
+
+    // Tilt coordination (sustained surge / sway force as a slow tilt)
+    float tiltScale = 0.4f;
+    float tiltLpFreq = 4.0f;
+    float tiltLpDamping = 1.0f;
+    float tiltRateLimit_dps = 3.0f;     // below the vestibular threshold for rotation
+    float tiltLimit_deg = 10.0f;
+
+    // Rotational (roll, pitch, yaw) high-pass channel
+    float rotationScale = 0.5f;
+    float rotationHpFreq = 1.0f;
+    float rotationHpDamping = 1.0f;
+    float angleLimit_deg = 15.0f;       // roll / pitch, tilt included
+    float yawLimit_deg = 15.0f;
+};
+
+struct WashoutInput {
+    float specificForce_mps2[3] = { 0.0f, 0.0f, GRAVITY };  // x, y, z
+    float rate_dps[3] = { 0.0f, 0.0f, 0.0f };               // roll (about x), pitch (about y), yaw (about z)
+};
+
+struct WashoutOutput {
+    float translation_mm[3] = { 0.0f, 0.0f, 0.0f };         // surge, sway, heave
+    float roll_deg = 0.0f;
+    float pitch_deg = 0.0f;
+    float yaw_deg = 0.0f;
+    bool limited = false;               // some axis hit its limit this step
+};
+
+class ClassicalWashout {
+public:
+    ClassicalWashout() { configure(WashoutParams(), 0.005f); }
+
+    // Works out every filter's coefficients for a fixed step of dt seconds and resets the state
+    void configure(const WashoutParams& p, float dt) {
+        params = p;
+        step_s = dt;
+        for (int axis = 0; axis < 3; ++axis) {
+            translationHp2[axis] = Biquad::highPass2(p.translationHpFreq, p.translationHpDamping, dt);
+            translationHp1[axis] = Biquad::highPass1(p.translationHpReturn, dt);
+            rotationHp[axis] = Biquad::highPass2(p.rotationHpFreq, p.rotationHpDamping, dt);
+        }
+        for (int axis = 0; axis < 2; ++axis) {
+            tiltLp[axis] = Biquad::lowPass2(p.tiltLpFreq, p.tiltLpDamping, dt);
+        }
+        reset();
+    }
+
+    // Back to neutral with the aircraft in level, unaccelerated flight
+    void reset() {
+        for (int axis = 0; axis < 3; ++axis) {
+            translationHp2[axis].reset();
+            translationHp1[axis].reset();
+            velocity[axis].reset();
+            position[axis].reset();
+            rotationHp[axis].reset();
+            angle[axis].reset();
+        }
+        for (int axis = 0; axis < 2; ++axis) {
+            tiltLp[axis].reset();
+            tilt_deg[axis] = 0.0f;
+        }
+    }
+
+    float dt() const { return step_s; }
+    const WashoutParams& parameters() const { return params; }
+
+    // Advances every channel by one dt
+    void step(const WashoutInput& in, WashoutOutput& out) {
+        out.limited = false;
+
+        // --- Translational channel ---
+        for (int axis = 0; axis < 3; ++axis) {
+            float f = in.specificForce_mps2[axis];
+            if (axis == 2) {
+                f -= GRAVITY;   // Heave sees only the change from 1 g
+            }
+            float a = translationHp1[axis].step(translationHp2[axis].step(params.translationScale * f));
+            float x_mm = 1000.0f * position[axis].step(velocity[axis].step(a, step_s), step_s);
+            out.translation_mm[axis] = clamp(x_mm, params.translationLimit_mm, out.limited);
+        }
+
+        // --- Tilt coordination: pitch from surge force, roll from sway force ---
+        float maxChange = params.tiltRateLimit_dps * step_s;
+        for (int axis = 0; axis < 2; ++axis) {
+            float f = tiltLp[axis].step(params.tiltScale * in.specificForce_mps2[axis]) / GRAVITY;
+            f = f > 1.0f ? 1.0f : (f < -1.0f ? -1.0f : f);
+            // Seat pushed forward (+x) = nose up; seat pushed right (+y) = left side down
+            float target = RAD_TO_DEG * asinf(axis == 0 ? f : -f);
+            bool unused = false;
+            target = clamp(target, params.tiltLimit_deg, unused);
+            float change = target - tilt_deg[axis];
+            change = change > maxChange ? maxChange : (change < -maxChange ? -maxChange : change);
+            tilt_deg[axis] += change;
+        }
+
+        // --- Rotational channel ---
+        float hp_deg[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            hp_deg[axis] = angle[axis].step(rotationHp[axis].step(params.rotationScale * in.rate_dps[axis]), step_s);
+        }
+        out.roll_deg = clamp(hp_deg[0] + tilt_deg[1], params.angleLimit_deg, out.limited);
+        out.pitch_deg = clamp(hp_deg[1] + tilt_deg[0], params.angleLimit_deg, out.limited);
+        out.yaw_deg = clamp(hp_deg[2], params.yawLimit_deg, out.limited);
+    }
+
+private:
+    static float clamp(float value, float limit, bool& limited) {
+        if (value > limit) { limited = true; return limit; }
+        if (value < -limit) { limited = true; return -limit; }
+        return value;
+    }
+
+    WashoutParams params;
+    float step_s = 0.005f;
+
+    Biquad translationHp2[3];
+    Biquad translationHp1[3];
+    Integrator velocity[3];
+    Integrator position[3];
+    Biquad tiltLp[2];
+    float tilt_deg[2] = { 0.0f, 0.0f };     // pitch (from x), roll (from y)
+    Biquad rotationHp[3];
+    Integrator angle[3];
+};
+
+} // namespace MotionCue
+
+#endif // WASHOUT_HPP
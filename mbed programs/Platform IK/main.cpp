@@ -5,6 +5,15 @@
 #include <Eigen/Dense>
 #include <array>
 #include "DigiPosFeedback_Lib/DigiPosFeedback.hpp" // Correct path assumed
+#include "MotionLink_Lib/MotionReceiver.hpp"
+#include "MotionLink_Lib/LatencyTrace.hpp"
+#include "MotionLink_Lib/Telemetry.hpp"
+#include "MotionLink_Lib/ConfigProtocol.hpp"
+#include "MotionLink_Lib/PlatformGeometry.hpp"
+#include "MotionLink_Lib/StrokeCommand.hpp"
+#include "MotionLink_Lib/Washout.hpp"
+#include "MotionLink_Lib/PosePredictor.hpp"
+#include "MotionLink_Lib/PoseTrajectory.hpp"
 
 using namespace std; // For std::array, std::pair etc.
 using namespace Eigen;
@@ -15,12 +24,397 @@ using namespace Eigen;
 
 // --- Physical Constants ---
 // !!! VERIFIED VALUE FOR YOUR ACTUATORS !!!
-const float BASE_ACTUATOR_LENGTH = 500.0f; // Minimum length (mm) when stroke is 0 (including joints)
+const float BASE_ACTUATOR_LENGTH = PlatformGeometry::BASE_ACTUATOR_LENGTH; // Minimum length (mm) when stroke is 0 (including joints)
 const float ACTUATOR_SPEED_MM_PER_S = 30.6827057f;
 // Default duty cycles will be set individually below
 const float CONTROL_LOOP_PERIOD_MS = 20; // Control loop frequency (50 Hz)
 const float INITIAL_ACTUATOR_STROKE = 100.0f; // Initial stroke position (mm)
 
+// --- Host Link ---
+// Motion frames (poses), stroke commands (host-side IK) and config requests from the host bridge
+// come in on the ST-Link virtual COM port; latency traces, telemetry and replies go back out on
+// it. printf() is routed through the same BufferedSerial (mbed_override_console below) so status
+// text and binary frames never fight over the UART; the host's frame parser simply skips the
+// text. Everything received is parsed and answered by linkThread, outside the control loop.
+#define LINK_BAUD_RATE 115200   // MUST match the MotionBridge side
+#define RX_CHUNK_SIZE 64
+#define LINK_RX_FLAG 0x1
+
+static BufferedSerial link_port(USBTX, USBRX, LINK_BAUD_RATE);
+
+FileHandle* mbed::mbed_override_console(int fd) {
+    return &link_port;
+}
+
+// Time (us) the first byte of the current RX batch landed in the serial buffer. BufferedSerial
+// calls sigio from the RX interrupt when its buffer goes from empty to non-empty, and the link
+// thread drains the buffer every time it wakes, so this is the arrival time of the oldest
+// unread frame.
+static volatile uint32_t rxArrival_us = 0;
+static EventFlags linkFlags;
+
+static void onLinkReadable() {
+    rxArrival_us = us_ticker_read();
+    linkFlags.set(LINK_RX_FLAG);    // Wake the link thread
+}
+
+// --- Telemetry ---
+// Per-cycle actuator state and loop timing for the host (MotionBridge/TelemetryLog). The control
+// loop only copies numbers into a TelemetryRecord; when a batch is full it is handed to a
+// low-priority thread that quantizes and frames it and passes the whole frame to the UART in one
+// write(). BufferedSerial sends it from its TX buffer under interrupts, so neither the control
+// loop nor the telemetry thread waits for the line.
+#define TELEMETRY_DECIMATION 1      // Record every Nth control cycle (1 = every cycle), tunable at runtime
+#define TELEMETRY_BATCH_RECORDS 5   // Records per frame, at most MotionLink::TELEMETRY_MAX_RECORDS
+#define TELEMETRY_QUEUE_DEPTH 4     // Batches waiting for the telemetry thread
+#define STATUS_PRINTF 0             // 1 = also print the old once-per-second text status
+
+// --- Motion Cueing ---
+// Normally the host bridge runs the washout and sends finished poses. With WASHOUT_ON_MCU the
+// loop runs MotionLink_Lib/Washout.hpp itself, once per control cycle, on the specific forces and
+// rates carried in each motion frame (run the host with --cue raw so it does not filter them
+// twice); the frame's pose fields are then ignored. Start-up prints what one step costs here.
+#define WASHOUT_ON_MCU 0            // 1 = washout in the control loop instead of on the host
+#define WASHOUT_BENCH_STEPS 1000    // Steps timed at start-up
+
+// --- Pose Prediction ---
+// Host poses are extrapolated (MotionLink_Lib/PosePredictor.hpp) to the time they will actually
+// be acted on: the sample's host time plus what this end measured since its first byte landed
+// (parse, waiting for the cycle) plus a fixed lead for the link before that byte and the
+// actuators' response. Mode, Kalman noise and the fixed lead are runtime parameters (ConfigTool
+// predict / noise / lead), and the RMS error with and without prediction can be read back
+// (prederr / holderr). Stroke commands and the on-MCU washout are used as they are.
+#define PREDICT_MODE MotionLink::PREDICT_KALMAN
+#define PREDICT_LEAD_MS 2.0f
+
+// --- Trajectory ---
+// Whatever pose the loop ends up with (host, prediction, washout or a config setpoint) is
+// reached through MotionLink_Lib/PoseTrajectory.hpp rather than stepped into, so a jump in the
+// pose no longer sends every leg off at full duty. It keeps each leg under the slowest actuator
+// speed parameter (with a margin so the bang-bang feedback can keep up) and under the
+// acceleration and jerk below, replanning from where it is every cycle. Stroke commands from the
+// host are used as they are.
+#define TRAJECTORY_ENABLED 1
+const float TRAJECTORY_SPEED_MARGIN = 0.9f;         // Of the slowest actuator's speed
+const float TRAJECTORY_ACCEL_MM_PER_S2 = 100.0f;
+const float TRAJECTORY_JERK_MM_PER_S3 = 1000.0f;
+
+static Mail<MotionLink::TelemetryBatch, TELEMETRY_QUEUE_DEPTH> telemetryMail;
+static Thread telemetryThread(osPriorityBelowNormal, 2048);
+
+static void telemetryTask() {
+    uint8_t frame[MotionLink::MAX_FRAME_SIZE];
+    while (true) {
+        MotionLink::TelemetryBatch* batch = telemetryMail.try_get_for(Kernel::wait_for_u32_forever);
+        if (batch == nullptr) {
+            continue;
+        }
+        size_t frameLength = MotionLink::buildTelemetryFrame(*batch, frame);
+        telemetryMail.free(batch);
+        link_port.write(frame, frameLength);
+    }
+}
+
+// --- Runtime Parameters ---
+// Everything the host can tune without a reflash (MotionLink_Lib/ConfigProtocol.hpp, host side is
+// MotionBridge/ConfigTool). The link thread edits stagedParams under paramsMutex; the control loop
+// copies it out once at the start of every cycle, so each cycle runs with one consistent set and
+// a change always lands between cycles, never half way through an IK/PWM update.
+const float MAX_ACTUATOR_SPEED_MM_PER_S = 100.0f; // Sanity limit for the speed parameter
+
+struct ControlParams {
+    float tolerance_mm[6];
+    float dutyCycle[6];
+    float actuatorSpeed_mm_per_s[6];
+    float pose[MotionLink::POSE_AXES];  // X, Y, Z (mm), roll, pitch, yaw (deg)
+    uint8_t telemetryDecimation;
+
+    // Offload mode: the host ran the IK and sent the strokes, so the loop skips its own IK.
+    // Whichever came last wins: a stroke command sets it, a motion frame or a pose set clears it.
+    bool hostStrokes;
+    float stroke_mm[6];
+
+    // Set by the link thread when a motion frame / stroke command arrived, cleared when the loop takes it
+    bool newPose;
+    MotionLink::LatencyTrace trace;     // Pipeline timestamps of the newest motion frame
+
+    // Aircraft specific forces and rates of the newest motion frame (washout input, WASHOUT_ON_MCU)
+    MotionCue::WashoutInput cueInput;
+
+    // Pose prediction. poseFromFrame: the pose is a motion frame stream (predictable), not a
+    // config setpoint. The error statistics are written back by the control loop.
+    bool poseFromFrame;
+    float predictMode[MotionLink::POSE_AXES];
+    float predictNoise[MotionLink::POSE_AXES];
+    float predictLead_ms;
+    float predictError[MotionLink::POSE_AXES];
+    float predictHoldError[MotionLink::POSE_AXES];
+};
+
+static Mutex paramsMutex;
+static ControlParams stagedParams = {
+    { 15.0f, 15.0f, 15.0f, 15.0f, 15.0f, 15.0f },   // Tolerance for position error (adjust as needed)
+    { 0.6f, 0.6f, 1.0f, 1.0f, 1.0f, 1.0f },         // Actuator 1-6 duty cycles
+    { ACTUATOR_SPEED_MM_PER_S, ACTUATOR_SPEED_MM_PER_S, ACTUATOR_SPEED_MM_PER_S,
+      ACTUATOR_SPEED_MM_PER_S, ACTUATOR_SPEED_MM_PER_S, ACTUATOR_SPEED_MM_PER_S },
+    { 0.0f, 0.0f, 0.0f, 0.0f, 30.0f, 0.0f },        // Example: Pitch 30 degrees until the host sends a pose
+    TELEMETRY_DECIMATION,
+    false,
+    {},
+    false,
+    {},
+    {},
+    false,
+    { PREDICT_MODE, PREDICT_MODE, PREDICT_MODE, PREDICT_MODE, PREDICT_MODE, PREDICT_MODE },
+    { 200000.0f, 200000.0f, 200000.0f, 2000.0f, 2000.0f, 2000.0f },  // mm^2/s^3, deg^2/s^3
+    PREDICT_LEAD_MS,
+    {},
+    {}
+};
+
+#if TRAJECTORY_ENABLED
+// Leg limits for the trajectory from this cycle's parameters
+static MotionLink::TrajectoryLimits trajectoryLimits(const ControlParams& p) {
+    MotionLink::TrajectoryLimits limits;
+    limits.speed_mm_s = p.actuatorSpeed_mm_per_s[0];
+    for (size_t i = 1; i < 6; ++i) {
+        limits.speed_mm_s = fminf(limits.speed_mm_s, p.actuatorSpeed_mm_per_s[i]);
+    }
+    limits.speed_mm_s *= TRAJECTORY_SPEED_MARGIN;
+    limits.accel_mm_s2 = TRAJECTORY_ACCEL_MM_PER_S2;
+    limits.jerk_mm_s3 = TRAJECTORY_JERK_MM_PER_S3;
+    return limits;
+}
+#endif
+
+// Executes one get/set against stagedParams. Caller holds paramsMutex.
+static MotionLink::ConfigReply handleConfigRequest(bool isSet, const MotionLink::ConfigRequest& request) {
+    using namespace MotionLink;
+    ConfigReply reply;
+    reply.id = request.id;
+    reply.param = request.param;
+    reply.index = request.index;
+    reply.value = request.value;
+
+    if (request.param == PARAM_TELEMETRY_DECIMATION) {
+        if (request.index != 0 && request.index != INDEX_ALL) {
+            reply.status = CONFIG_BAD_INDEX;
+        } else if (isSet && !(request.value >= 1.0f && request.value <= 255.0f)) { // Written so NaN fails too
+            reply.status = CONFIG_OUT_OF_RANGE;
+        } else if (isSet) {
+            stagedParams.telemetryDecimation = static_cast<uint8_t>(lrintf(request.value));
+        }
+        reply.value = stagedParams.telemetryDecimation;
+        return reply;
+    }
+
+    if (request.param == PARAM_PREDICT_LEAD_MS) {
+        if (request.index != 0 && request.index != INDEX_ALL) {
+            reply.status = CONFIG_BAD_INDEX;
+        } else if (isSet && !(request.value >= 0.0f && request.value <= PREDICT_MAX_LEAD_US / 1000.0f)) {
+            reply.status = CONFIG_OUT_OF_RANGE;
+        } else if (isSet) {
+            stagedParams.predictLead_ms = request.value;
+        }
+        reply.value = stagedParams.predictLead_ms;
+        return reply;
+    }
+
+    if (request.param == PARAM_PREDICT_ERROR || request.param == PARAM_PREDICT_HOLD_ERROR) {
+        if (isSet) {
+            reply.status = CONFIG_READ_ONLY;
+        } else if (request.index >= POSE_AXES) {
+            reply.status = CONFIG_BAD_INDEX;
+        } else {
+            const float* errors = request.param == PARAM_PREDICT_ERROR ? stagedParams.predictError
+                                                                       : stagedParams.predictHoldError;
+            reply.value = errors[request.index];
+        }
+        return reply;
+    }
+
+    // Every other parameter is an array of floats with one valid range
+    float* slots = nullptr;
+    float minValue = 0.0f;
+    float maxValue = 0.0f;
+    switch (request.param) {
+        case PARAM_TOLERANCE_MM:
+            slots = stagedParams.tolerance_mm;
+            maxValue = DigitalPosFeedback::MAX_STROKE;
+            break;
+        case PARAM_DUTY_CYCLE:
+            slots = stagedParams.dutyCycle;
+            maxValue = 1.0f;
+            break;
+        case PARAM_ACTUATOR_SPEED:
+            slots = stagedParams.actuatorSpeed_mm_per_s;
+            maxValue = MAX_ACTUATOR_SPEED_MM_PER_S;
+            break;
+        case PARAM_POSE: {
+            bool angle = request.index >= POSE_ROLL_DEG && request.index != INDEX_ALL;
+            slots = stagedParams.pose;
+            maxValue = angle ? MotionSchema::ATTITUDE_RANGE_DEG : MotionSchema::TRANSLATION_RANGE_MM;
+            minValue = -maxValue;
+            break;
+        }
+        case PARAM_PREDICT_MODE:
+            slots = stagedParams.predictMode;
+            maxValue = PREDICT_MODES - 1;
+            break;
+        case PARAM_PREDICT_NOISE:
+            slots = stagedParams.predictNoise;
+            maxValue = 1e9f;
+            break;
+        default:
+            reply.status = CONFIG_UNKNOWN_PARAM;
+            return reply;
+    }
+
+    // Setting every pose axis to one value makes no sense, so INDEX_ALL is for per-actuator params
+    if ((request.index >= 6 && request.index != INDEX_ALL) ||
+        (request.index == INDEX_ALL && (!isSet || request.param == PARAM_POSE))) {
+        reply.status = CONFIG_BAD_INDEX;
+        return reply;
+    }
+
+    if (isSet) {
+        if (request.value < minValue || request.value > maxValue || request.value != request.value) {
+            reply.status = CONFIG_OUT_OF_RANGE;
+            return reply;
+        }
+        if (request.index == INDEX_ALL) {
+            for (size_t i = 0; i < 6; ++i) slots[i] = request.value;
+        } else {
+            slots[request.index] = request.value;
+        }
+        if (request.param == PARAM_POSE) {
+            stagedParams.hostStrokes = false;   // A pose setpoint goes through the on-MCU IK
+            stagedParams.poseFromFrame = false; // and is held, not extrapolated
+        }
+    }
+    reply.value = slots[request.index == INDEX_ALL ? 0 : request.index];
+    return reply;
+}
+
+// --- Link Thread ---
+// Parses everything the host sends and answers requests. Handlers only touch stagedParams (under
+// paramsMutex, held for a few copies) and write replies, so nothing here waits on the control
+// loop and the control loop never waits on the link.
+class HostLinkHandler : public MotionLink::MessageHandler {
+public:
+    void onMotionFrame(const MotionSchema::MotionFrame& frame, uint32_t arrival_us) override {
+        uint32_t parsed_us = us_ticker_read();
+        ScopedLock<Mutex> lock(paramsMutex);
+        stagedParams.pose[MotionLink::POSE_X_MM] = frame.translationX_mm;
+        stagedParams.pose[MotionLink::POSE_Y_MM] = frame.translationY_mm;
+        stagedParams.pose[MotionLink::POSE_Z_MM] = frame.translationZ_mm;
+        stagedParams.pose[MotionLink::POSE_ROLL_DEG]  = frame.roll_deg;
+        stagedParams.pose[MotionLink::POSE_PITCH_DEG] = frame.pitch_deg;
+        stagedParams.pose[MotionLink::POSE_YAW_DEG]   = frame.yaw_deg;
+        stagedParams.cueInput.specificForce_mps2[0] = frame.specificForceX_mps2;
+        stagedParams.cueInput.specificForce_mps2[1] = frame.specificForceY_mps2;
+        stagedParams.cueInput.specificForce_mps2[2] = frame.specificForceZ_mps2;
+        stagedParams.cueInput.rate_dps[0] = frame.rollRate_dps;
+        stagedParams.cueInput.rate_dps[1] = frame.pitchRate_dps;
+        stagedParams.cueInput.rate_dps[2] = frame.yawRate_dps;
+        stagedParams.hostStrokes = false;
+        stagedParams.poseFromFrame = true;
+        stageTrace(frame.sequence, frame.hostTime_us, arrival_us, parsed_us);
+    }
+
+    void onOtherFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint32_t arrival_us) override {
+        switch (type) {
+            case MotionLink::MSG_STROKE_COMMAND:
+                stageStrokes(payload, length, arrival_us);
+                break;
+            case MotionLink::MSG_TIME_SYNC_REQUEST:
+                replyTimeSync(payload, length, arrival_us);
+                break;
+            case MotionLink::MSG_CONFIG_GET:
+            case MotionLink::MSG_CONFIG_SET:
+                replyConfig(type == MotionLink::MSG_CONFIG_SET, payload, length);
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    // Caller holds paramsMutex. If several frames arrive in one cycle only the newest is used,
+    // so only it is traced.
+    void stageTrace(uint16_t sequence, uint32_t hostTime_us, uint32_t arrival_us, uint32_t parsed_us) {
+        stagedParams.newPose = true;
+        stagedParams.trace.sequence = sequence;
+        stagedParams.trace.hostTime_us = hostTime_us;
+        stagedParams.trace.arrival_us = arrival_us;
+        stagedParams.trace.parsed_us = parsed_us;
+    }
+
+    void stageStrokes(const uint8_t* payload, uint8_t length, uint32_t arrival_us) {
+        MotionLink::StrokeCommand command;
+        if (!MotionLink::decodeStrokeCommand(payload, length, command)) {
+            return;
+        }
+        uint32_t parsed_us = us_ticker_read();
+        ScopedLock<Mutex> lock(paramsMutex);
+        for (size_t i = 0; i < 6; ++i) {
+            stagedParams.stroke_mm[i] = command.stroke_mm[i];
+        }
+        stagedParams.hostStrokes = true;
+        stageTrace(command.sequence, command.hostTime_us, arrival_us, parsed_us);
+    }
+
+    void replyTimeSync(const uint8_t* payload, uint8_t length, uint32_t arrival_us) {
+        MotionLink::TimeSyncRequest request;
+        if (!MotionLink::decodeTimeSyncRequest(payload, length, request)) {
+            return;
+        }
+        MotionLink::TimeSyncReply reply;
+        reply.id = request.id;
+        reply.t1_us = request.t1_us;
+        reply.t2_us = arrival_us;
+        reply.t3_us = us_ticker_read();
+        uint8_t frame[MotionLink::frameSize(MotionLink::TIME_SYNC_REPLY_SIZE)];
+        size_t frameLength = MotionLink::buildTimeSyncReply(reply, frame);
+        link_port.write(frame, frameLength);
+    }
+
+    void replyConfig(bool isSet, const uint8_t* payload, uint8_t length) {
+        MotionLink::ConfigRequest request;
+        if (!MotionLink::decodeConfigRequest(payload, length, request)) {
+            return;
+        }
+        MotionLink::ConfigReply reply;
+        {
+            ScopedLock<Mutex> lock(paramsMutex);
+            reply = handleConfigRequest(isSet, request);
+        }
+        uint8_t frame[MotionLink::frameSize(MotionLink::CONFIG_REPLY_SIZE)];
+        size_t frameLength = MotionLink::buildConfigReply(reply, frame);
+        link_port.write(frame, frameLength);
+    }
+};
+
+static HostLinkHandler hostLink;
+static MotionLink::MotionReceiver receiver(hostLink);
+static Thread linkThread(osPriorityAboveNormal, 4096);
+
+static void linkTask() {
+    uint8_t rx_chunk[RX_CHUNK_SIZE];
+    while (true) {
+        linkFlags.wait_any(LINK_RX_FLAG);
+
+        uint32_t batchArrival_us = rxArrival_us;
+        while (link_port.readable()) {
+            ssize_t num_bytes_read = link_port.read(rx_chunk, RX_CHUNK_SIZE);
+            if (num_bytes_read <= 0) {
+                break;
+            }
+            receiver.push(rx_chunk, static_cast<size_t>(num_bytes_read), batchArrival_us);
+        }
+    }
+}
+
 // --- Function Declarations ---
 Matrix3f getRotationMatrix(float roll_deg, float pitch_deg, float yaw_deg);
 
@@ -32,6 +426,10 @@ int main()
     // REMOVED: cout.rdbuf(pc.rdbuf()); // Redirect std::cout - Not the standard Mbed OS 6 way
                                         // printf() will output to console via USBTX/USBRX by default
 
+    link_port.sigio(onLinkReadable);
+    linkThread.start(linkTask);
+    telemetryThread.start(telemetryTask);
+
     printf("--- Stewart Platform Control Initializing ---\n");
     printf("Base Actuator Length (Retracted + Joints): %.2f mm\n", BASE_ACTUATOR_LENGTH);
 
@@ -48,12 +446,17 @@ int main()
     };
 
     // Set initial estimated stroke position and specific duty cycles for all actuators
-    actuators[0].setDuty_Cycle(0.6f); // Actuator 1 duty cycle
-    actuators[1].setDuty_Cycle(0.6f); // Actuator 2 duty cycle
-    actuators[2].setDuty_Cycle(1.0f); // Actuator 3 duty cycle
-    actuators[3].setDuty_Cycle(1.0f); // Actuator 4 duty cycle
-    actuators[4].setDuty_Cycle(1.0f); // Actuator 5 duty cycle
-    actuators[5].setDuty_Cycle(1.0f); // Actuator 6 duty cycle
+    // (defaults live in stagedParams so the host can change them at runtime)
+    ControlParams params;
+    {
+        ScopedLock<Mutex> lock(paramsMutex);
+        params = stagedParams;
+    }
+    for (size_t i = 0; i < 6; ++i) {
+        actuators[i].setDuty_Cycle(params.dutyCycle[i]);
+        actuators[i].setActuatorSpeed(params.actuatorSpeed_mm_per_s[i]);
+        actuators[i].setTolerance(params.tolerance_mm[i]);
+    }
 
     printf("Actuator Duty Cycles: A1=%.1f, A2=%.1f, A3=%.1f, A4=%.1f, A5=%.1f, A6=%.1f\n",
            actuators[0].getDutyCycle(), actuators[1].getDutyCycle(), actuators[2].getDutyCycle(),
@@ -62,50 +465,37 @@ int main()
 
     for (auto& act : actuators) {
         act.currentPosition = INITIAL_ACTUATOR_STROKE;
-        act.tolerance = 15.0f; // Tolerance for position error (adjust as needed)
     }
     printf("Actuators initialized. Initial stroke set to %.2f mm.\n", INITIAL_ACTUATOR_STROKE);
 
 
-    // --- Define Base and Platform Geometry (Matches MATLAB Output) ---
-    const array<Vector3f, 6> base_joints = {
-        /*b1*/ Vector3f(-293.2250f, -227.0286f, 0.0f), // Index 0
-        /*b2*/ Vector3f( 293.2250f, -227.0286f, 0.0f), // Index 1
-        /*b3*/ Vector3f( 343.2250f, -140.4260f, 0.0f), // Index 2
-        /*b4*/ Vector3f(  50.0000f,  367.4546f, 0.0f), // Index 3
-        /*b5*/ Vector3f( -50.0000f,  367.4546f, 0.0f), // Index 4
-        /*b6*/ Vector3f(-343.2250f, -140.4260f, 0.0f)  // Index 5
-    };
-
-    // Platform joints defined at their 'home' pose (after 180-degree rotation from MATLAB script)
-    const array<Vector3f, 6> platform_joints_home_rotated = {
-        /*p1*/ Vector3f( -50.0000f,  -286.1637f, 458.5300f), // Index 0
-        /*p2*/ Vector3f(  50.0000f,  -286.1637f, 458.5300f), // Index 1
-        /*p3*/ Vector3f( 272.8250f,    99.7806f, 458.5300f), // Index 2
-        /*p4*/ Vector3f( 222.8250f,   186.3831f, 458.5300f), // Index 3
-        /*p5*/ Vector3f(-222.8250f,   186.3831f, 458.5300f), // Index 4
-        /*p6*/ Vector3f(-272.8250f,    99.7806f, 458.5300f)  // Index 5
-    };
+    // --- Base and Platform Geometry (MotionLink_Lib/PlatformGeometry.hpp, matches MATLAB output) ---
+    // Shared with the host-side IK, so offloaded strokes and this IK agree to well under a micron.
+    array<Vector3f, 6> base_joints;
+    array<Vector3f, 6> platform_joints_home_rotated;
+    for (size_t i = 0; i < PlatformGeometry::LEGS; ++i) {
+        const float* b = PlatformGeometry::BASE_JOINTS[i];
+        const float* p = PlatformGeometry::PLATFORM_JOINTS_HOME[i];
+        base_joints[i] = Vector3f(b[0], b[1], b[2]);
+        platform_joints_home_rotated[i] = Vector3f(p[0], p[1], p[2]);
+    }
 
-    // --- Define Actuator Connectivity (Indices for base_joints and platform_joints_home_rotated) ---
-    // Maps Actuator Index (0-5 corresponding to actuators array) to Base/Platform Joint Indices
-    const array<pair<int, int>, 6> actuator_connections = {
-        /* Actuator 0 (A1) */ make_pair(4, 1), // Base joint b5 (index 4), Platform joint p2 (index 1)
-        /* Actuator 1 (A2) */ make_pair(3, 0), // Base joint b4 (index 3), Platform joint p1 (index 0)
-        /* Actuator 2 (A3) */ make_pair(2, 5), // Base joint b3 (index 2), Platform joint p6 (index 5)
-        /* Actuator 3 (A4) */ make_pair(1, 4), // Base joint b2 (index 1), Platform joint p5 (index 4)
-        /* Actuator 4 (A5) */ make_pair(0, 3), // Base joint b1 (index 0), Platform joint p4 (index 3)
-        /* Actuator 5 (A6) */ make_pair(5, 2)  // Base joint b6 (index 5), Platform joint p3 (index 2)
-    };
+    // --- Actuator Connectivity ---
+    // Maps Actuator Index (0-5 corresponding to actuators array) to Base/Platform Joint Indices,
+    // e.g. A1 runs from base joint b5 to platform joint p2
+    array<pair<int, int>, 6> actuator_connections;
+    for (size_t i = 0; i < PlatformGeometry::LEGS; ++i) {
+        actuator_connections[i] = make_pair(PlatformGeometry::ACTUATOR_BASE[i], PlatformGeometry::ACTUATOR_PLATFORM[i]);
+    }
 
 
-    // --- Platform Pose Input (Example: Pitch 30 degrees) ---
-    float translationX_mm = 0.0f;
-    float translationY_mm = 0.0f;
-    float translationZ_mm = 0.0f;
-    float roll_deg  = 0.0f;
-    float pitch_deg = 30.0f;
-    float yaw_deg   = 0.0f;
+    // --- Platform Pose Input (from params: the host's motion frames or a config setpoint) ---
+    float translationX_mm = params.pose[MotionLink::POSE_X_MM];
+    float translationY_mm = params.pose[MotionLink::POSE_Y_MM];
+    float translationZ_mm = params.pose[MotionLink::POSE_Z_MM];
+    float roll_deg  = params.pose[MotionLink::POSE_ROLL_DEG];
+    float pitch_deg = params.pose[MotionLink::POSE_PITCH_DEG];
+    float yaw_deg   = params.pose[MotionLink::POSE_YAW_DEG];
 
     printf("Target Pose: T=[%.1f, %.1f, %.1f] mm, RPY=[%.1f, %.1f, %.1f] deg\n",
            translationX_mm, translationY_mm, translationZ_mm, roll_deg, pitch_deg, yaw_deg);
@@ -118,49 +508,181 @@ int main()
     }
     center_P_home /= platform_joints_home_rotated.size();
 
+#if WASHOUT_ON_MCU
+    // --- Washout (one step per control cycle) ---
+    MotionCue::ClassicalWashout washout;
+    MotionCue::WashoutOutput cue;
+    washout.configure(MotionCue::WashoutParams(), CONTROL_LOOP_PERIOD_MS / 1000.0f);
+    {
+        // Time the step on a varying input, then start the real one from neutral
+        MotionCue::WashoutInput benchInput;
+        uint32_t benchStart_us = us_ticker_read();
+        for (int i = 0; i < WASHOUT_BENCH_STEPS; ++i) {
+            benchInput.specificForce_mps2[0] = 0.01f * (i % 200);
+            benchInput.rate_dps[0] = 5.0f - 0.05f * (i % 200);
+            washout.step(benchInput, cue);
+        }
+        float perStep_us = static_cast<float>(us_ticker_read() - benchStart_us) / WASHOUT_BENCH_STEPS;
+        printf("Washout: %.2f us per step, %.3f %% of the %.0f ms cycle\n",
+               perStep_us, 100.0f * perStep_us / (CONTROL_LOOP_PERIOD_MS * 1000.0f), CONTROL_LOOP_PERIOD_MS);
+        washout.reset();
+    }
+#endif
+
     printf("--- Starting Control Loop ---\n");
 
     // --- Continuous Control Loop ---
+    uint32_t cycle = 0;
+    uint32_t previousCycleStart_us = us_ticker_read();
+    MotionLink::TelemetryBatch* telemetryBatch = nullptr;
+    uint16_t telemetryRecordsDropped = 0;
+    MotionLink::LatencyTrace trace;
+    MotionLink::PosePredictor predictor;
+#if TRAJECTORY_ENABLED
+    MotionLink::PoseTrajectory trajectory;
+    trajectory.configure(trajectoryLimits(params), CONTROL_LOOP_PERIOD_MS / 1000.0f);
+    trajectory.reset(params.pose);
+#endif
+
     while (true) {
-        // 1. Calculate Target Pose Transformation
-        Matrix3f R = getRotationMatrix(roll_deg, pitch_deg, yaw_deg);
-        Vector3f T(translationX_mm, translationY_mm, translationZ_mm);
+        uint32_t cycleStart_us = us_ticker_read();
+
+        // 0. Take this cycle's parameters and pose in one go (cycle boundary)
+        {
+            ScopedLock<Mutex> lock(paramsMutex);
+            params = stagedParams;
+            stagedParams.newPose = false;
+            for (size_t axis = 0; axis < MotionLink::POSE_AXES; ++axis) {
+                stagedParams.predictError[axis] = predictor.stats(axis).rmsPredicted();
+                stagedParams.predictHoldError[axis] = predictor.stats(axis).rmsHeld();
+            }
+        }
+        if (params.newPose) {
+            trace = params.trace;
+            trace.pickup_us = us_ticker_read();
+        }
 
-        // 2. Calculate Transformed Platform Joint Positions in World Frame
-        array<Vector3f, 6> platform_joints_world;
-        for (size_t i = 0; i < platform_joints_home_rotated.size(); ++i) {
-            platform_joints_world[i] = R * (platform_joints_home_rotated[i] - center_P_home) + center_P_home + T;
+        for (size_t i = 0; i < 6; ++i) {
+            if (params.dutyCycle[i] != actuators[i].getDutyCycle()) {
+                actuators[i].setDuty_Cycle(params.dutyCycle[i]); // Rewrites the PWM, so only on change
+            }
+            actuators[i].setActuatorSpeed(params.actuatorSpeed_mm_per_s[i]);
+            actuators[i].setTolerance(params.tolerance_mm[i]);
         }
+        translationX_mm = params.pose[MotionLink::POSE_X_MM];
+        translationY_mm = params.pose[MotionLink::POSE_Y_MM];
+        translationZ_mm = params.pose[MotionLink::POSE_Z_MM];
+        roll_deg  = params.pose[MotionLink::POSE_ROLL_DEG];
+        pitch_deg = params.pose[MotionLink::POSE_PITCH_DEG];
+        yaw_deg   = params.pose[MotionLink::POSE_YAW_DEG];
+
+        // Pose prediction: apply setting changes (each restarts that axis' statistics), feed the
+        // newest host pose, then ask for the pose at the time this cycle's command takes effect
+        for (size_t axis = 0; axis < MotionLink::POSE_AXES; ++axis) {
+            MotionLink::PredictMode mode = static_cast<MotionLink::PredictMode>(lrintf(params.predictMode[axis]));
+            if (mode != predictor.mode(axis)) {
+                predictor.setMode(axis, mode);
+            }
+            if (params.predictNoise[axis] != predictor.processNoise(axis)) {
+                predictor.setProcessNoise(axis, params.predictNoise[axis]);
+            }
+        }
+        if (!params.poseFromFrame || params.hostStrokes) {
+            predictor.reset();
+        } else {
+            if (params.newPose) {
+                predictor.addSample(params.pose, trace.hostTime_us);
+            }
+            float predicted[MotionLink::POSE_AXES];
+            uint32_t lead_us = (us_ticker_read() - trace.arrival_us) + static_cast<uint32_t>(params.predictLead_ms * 1000.0f);
+            if (predictor.predict(trace.hostTime_us + lead_us, predicted)) {
+                translationX_mm = predicted[MotionLink::POSE_X_MM];
+                translationY_mm = predicted[MotionLink::POSE_Y_MM];
+                translationZ_mm = predicted[MotionLink::POSE_Z_MM];
+                roll_deg  = predicted[MotionLink::POSE_ROLL_DEG];
+                pitch_deg = predicted[MotionLink::POSE_PITCH_DEG];
+                yaw_deg   = predicted[MotionLink::POSE_YAW_DEG];
+            }
+        }
+#if WASHOUT_ON_MCU
+        // The washout runs every cycle (its filters assume a fixed step); a stroke command still
+        // overrides its pose
+        washout.step(params.cueInput, cue);
+        translationX_mm = cue.translation_mm[0];
+        translationY_mm = cue.translation_mm[1];
+        translationZ_mm = cue.translation_mm[2];
+        roll_deg  = cue.roll_deg;
+        pitch_deg = cue.pitch_deg;
+        yaw_deg   = cue.yaw_deg;
+#endif
+#if TRAJECTORY_ENABLED
+        // Move towards the pose rather than jump to it. During stroke commands the trajectory
+        // waits where it was and carries on from there when poses come back.
+        if (!params.hostStrokes) {
+            float wanted[MotionLink::POSE_AXES] = { translationX_mm, translationY_mm, translationZ_mm, roll_deg, pitch_deg, yaw_deg };
+            float shaped[MotionLink::POSE_AXES];
+            trajectory.setLimits(trajectoryLimits(params));
+            trajectory.step(wanted, shaped);
+            translationX_mm = shaped[MotionLink::POSE_X_MM];
+            translationY_mm = shaped[MotionLink::POSE_Y_MM];
+            translationZ_mm = shaped[MotionLink::POSE_Z_MM];
+            roll_deg  = shaped[MotionLink::POSE_ROLL_DEG];
+            pitch_deg = shaped[MotionLink::POSE_PITCH_DEG];
+            yaw_deg   = shaped[MotionLink::POSE_YAW_DEG];
+        }
+#endif
 
-        // 3. Calculate Required TOTAL Actuator Lengths (Base Joint to Platform Joint)
         array<float, 6> target_total_lengths;
-        for (size_t i = 0; i < 6; ++i) { // Loop through actuators 0 to 5
-            int base_idx = actuator_connections[i].first;
-            int plat_idx = actuator_connections[i].second;
-            Vector3f actuator_vector = platform_joints_world[plat_idx] - base_joints[base_idx];
-            target_total_lengths[i] = actuator_vector.norm();
-        }
-
-        // 4. Convert Total Lengths to Target STROKES and Update Actuator Targets
-        for (size_t i = 0; i < 6; ++i) { // Loop through actuators 0 to 5
-            // Target stroke = Total required length - Length when stroke is zero
-            float target_stroke = target_total_lengths[i] - BASE_ACTUATOR_LENGTH;
-
-            // Clamp target stroke to valid physical range [0, MAX_STROKE]
-            // Note: Using actuators[i].MAX_STROKE allows potential future flexibility
-            // if MAX_STROKE were not static constexpr, but here it refers to the static const.
-            if (target_stroke < 0.0f) {
-                target_stroke = 0.0f;
-                 // Optional: Add a warning if commanded length is too short
-                 // printf("Warning: Actuator %d target stroke clamped to 0 (demanded length %.2f mm too short)\n", i + 1, target_total_lengths[i]);
-            } else if (target_stroke > DigitalPosFeedback::MAX_STROKE) { // Access static member
-                target_stroke = DigitalPosFeedback::MAX_STROKE;
-                 // Optional: Add a warning if commanded length is too long
-                 // printf("Warning: Actuator %d target stroke clamped to %.2f (demanded length %.2f mm too long)\n", i + 1, DigitalPosFeedback::MAX_STROKE, target_total_lengths[i]);
+        if (params.hostStrokes) {
+            // Offload mode: the host already did steps 1-3, only clamp and hand the strokes over
+            for (size_t i = 0; i < 6; ++i) {
+                float target_stroke = params.stroke_mm[i];
+                target_total_lengths[i] = target_stroke + BASE_ACTUATOR_LENGTH;
+                if (target_stroke < 0.0f) target_stroke = 0.0f;
+                if (target_stroke > DigitalPosFeedback::MAX_STROKE) target_stroke = DigitalPosFeedback::MAX_STROKE;
+                actuators[i].targetPosition = target_stroke;
+            }
+        } else {
+            // 1. Calculate Target Pose Transformation
+            Matrix3f R = getRotationMatrix(roll_deg, pitch_deg, yaw_deg);
+            Vector3f T(translationX_mm, translationY_mm, translationZ_mm);
+
+            // 2. Calculate Transformed Platform Joint Positions in World Frame
+            array<Vector3f, 6> platform_joints_world;
+            for (size_t i = 0; i < platform_joints_home_rotated.size(); ++i) {
+                platform_joints_world[i] = R * (platform_joints_home_rotated[i] - center_P_home) + center_P_home + T;
+            }
+
+            // 3. Calculate Required TOTAL Actuator Lengths (Base Joint to Platform Joint)
+            for (size_t i = 0; i < 6; ++i) { // Loop through actuators 0 to 5
+                int base_idx = actuator_connections[i].first;
+                int plat_idx = actuator_connections[i].second;
+                Vector3f actuator_vector = platform_joints_world[plat_idx] - base_joints[base_idx];
+                target_total_lengths[i] = actuator_vector.norm();
             }
 
-            actuators[i].targetPosition = target_stroke; // Set the target STROKE for the feedback controller
+            // 4. Convert Total Lengths to Target STROKES and Update Actuator Targets
+            for (size_t i = 0; i < 6; ++i) { // Loop through actuators 0 to 5
+                // Target stroke = Total required length - Length when stroke is zero
+                float target_stroke = target_total_lengths[i] - BASE_ACTUATOR_LENGTH;
+
+                // Clamp target stroke to valid physical range [0, MAX_STROKE]
+                // Note: Using actuators[i].MAX_STROKE allows potential future flexibility
+                // if MAX_STROKE were not static constexpr, but here it refers to the static const.
+                if (target_stroke < 0.0f) {
+                    target_stroke = 0.0f;
+                     // Optional: Add a warning if commanded length is too short
+                     // printf("Warning: Actuator %d target stroke clamped to 0 (demanded length %.2f mm too short)\n", i + 1, target_total_lengths[i]);
+                } else if (target_stroke > DigitalPosFeedback::MAX_STROKE) { // Access static member
+                    target_stroke = DigitalPosFeedback::MAX_STROKE;
+                     // Optional: Add a warning if commanded length is too long
+                     // printf("Warning: Actuator %d target stroke clamped to %.2f (demanded length %.2f mm too long)\n", i + 1, DigitalPosFeedback::MAX_STROKE, target_total_lengths[i]);
+                }
+
+                actuators[i].targetPosition = target_stroke; // Set the target STROKE for the feedback controller
+            }
         }
+        uint32_t ikDone_us = us_ticker_read();
 
         // 5. Update Position Estimates and Move Actuators Towards Target Stroke
         for (size_t i = 0; i < 6; ++i) {
@@ -168,7 +690,60 @@ int main()
             actuators[i].moveToTarget();   // Command motion (extend/retract/stop) based on error
         }
 
-        // --- Optional: Print Status periodically ---
+        // Report how long the new pose took to get here
+        if (params.newPose) {
+            trace.ikDone_us = ikDone_us;
+            trace.pwmCommit_us = us_ticker_read();
+            uint8_t frame[MotionLink::frameSize(MotionLink::LATENCY_TRACE_SIZE)];
+            size_t frameLength = MotionLink::buildLatencyTrace(trace, frame);
+            link_port.write(frame, frameLength);
+        }
+
+        // 6. Telemetry: copy this cycle's state into the current batch
+        if (cycle % params.telemetryDecimation == 0) {
+            // The batch header carries one decimation, so a change sends what was gathered at the old one
+            if (telemetryBatch != nullptr && telemetryBatch->decimation != params.telemetryDecimation) {
+                telemetryBatch->recordsDropped = telemetryRecordsDropped; // Never empty: allocated with its first record
+                telemetryMail.put(telemetryBatch);
+                telemetryBatch = nullptr;
+            }
+
+            if (telemetryBatch == nullptr) {
+                telemetryBatch = telemetryMail.try_alloc();
+                if (telemetryBatch != nullptr) {
+                    telemetryBatch->count = 0;
+                    telemetryBatch->decimation = params.telemetryDecimation;
+                }
+            }
+
+            if (telemetryBatch == nullptr) {
+                ++telemetryRecordsDropped; // Telemetry thread is behind, skip this record
+            } else {
+                MotionLink::TelemetryRecord& record = telemetryBatch->records[telemetryBatch->count++];
+                record.cycle = cycle;
+                record.cycleStart_us = cycleStart_us;
+                record.period_us = cycleStart_us - previousCycleStart_us;
+                record.work_us = us_ticker_read() - cycleStart_us;
+                record.poseSequence = trace.sequence;
+                for (size_t i = 0; i < 6; ++i) {
+                    record.actuators[i].target_mm = actuators[i].targetPosition;
+                    record.actuators[i].estimate_mm = actuators[i].currentPosition;
+                    record.actuators[i].state = static_cast<uint8_t>(actuators[i].state);
+                    record.actuators[i].duty = actuators[i].getDutyCycle();
+                }
+
+                if (telemetryBatch->count >= TELEMETRY_BATCH_RECORDS) {
+                    telemetryBatch->recordsDropped = telemetryRecordsDropped;
+                    telemetryMail.put(telemetryBatch);
+                    telemetryBatch = nullptr;
+                }
+            }
+        }
+        previousCycleStart_us = cycleStart_us;
+        ++cycle;
+
+#if STATUS_PRINTF
+        // --- Optional: Print Status periodically (formats floats, costs ms in this thread) ---
         static LowPowerTimeout printTimer; // Use LowPowerTimeout for one-shot delay
         static bool canPrint = true;
         if (canPrint) {
@@ -189,8 +764,13 @@ int main()
                         actuators[i].currentPosition,
                         static_cast<int>(actuators[i].state));
              }
-             printf("---------------------------\n");
+             printf("Prediction RMS error (predicted / held):");
+             for (size_t axis = 0; axis < MotionLink::POSE_AXES; ++axis) {
+                 printf(" %.2f/%.2f", predictor.stats(axis).rmsPredicted(), predictor.stats(axis).rmsHeld());
+             }
+             printf("\n---------------------------\n");
          }
+#endif
         // --- End Optional Print ---
 
 
@@ -1,4 +1,5 @@
 #include "DigiPosFeedback.hpp"
+#include <cmath>
 
 // Constructor
 DigitalPosFeedback::DigitalPosFeedback(PinName rpwm, PinName lpwm, float actuatorspeed, float duty)
@@ -31,6 +32,10 @@ void DigitalPosFeedback::setActuatorSpeed(float speed) {
     ACTUATOR_SPEED = speed;
 }
 
+void DigitalPosFeedback::setTolerance(float tol) {
+    tolerance = tol;
+}
+
 void DigitalPosFeedback::printPosition(const char* label) {
     // Using std::printf for potentially better performance on embedded
     printf("%s Position: %6.2f mm\n", label, currentPosition);
@@ -66,6 +71,17 @@ void DigitalPosFeedback::stop() {
          RPWM.write(0.0f);
      }
 }
+
+void DigitalPosFeedback::moveToTarget() {
+    float error = targetPosition - currentPosition;
+    if (fabsf(error) <= tolerance) {
+        stop();
+    } else if (error > 0) {
+        extend();
+    } else {
+        retract();
+    }
+}
 // ---------------------------------------
 
 void DigitalPosFeedback::updatePosition() {
@@ -22,6 +22,8 @@ private:
 
 public:
     float currentPosition; // Estimated position in mm
+    float targetPosition = 0.0f; // Stroke moveToTarget() drives towards, in mm
+    float tolerance = 5.0f;      // Close enough to the target, in mm
 
     enum class ActuatorState {
         EXTENDING,
@@ -38,12 +40,14 @@ public:
     void extend();
     void retract();
     void stop();
+    void moveToTarget(); // Extend, retract or stop towards targetPosition
     // -------------------------
 
     // Removed handleInput as control is now external
 
     void setDuty_Cycle(float duty); // Renamed for consistency
     void setActuatorSpeed(float speed);
+    void setTolerance(float tol);
     void updatePosition();
     void printPosition(const char* label);
     void resetPosition(); // Utility to reset estimated position
@@ -0,0 +1,291 @@
+#ifndef KEYFRAME_SEQUENCER_HPP
+#define KEYFRAME_SEQUENCER_HPP
+
+// --- Keyframe Motion Sequencer ---
+// Plays a list of target poses as smooth moves, one control tick at a time. The caller runs its
+// own fixed-rate loop and asks tick() for the pose of "now"; nothing here waits, so the loop can
+// take a stop or home command on the very next tick.
+//
+// Each move interpolates from where the platform was commanded to be towards the keyframe:
+//   translation  straight line
+//   attitude     SLERP between the two orientations (no gimbal detours, constant axis)
+// both along the same minimum-jerk profile s(u) = 10u^3 - 15u^4 + 6u^5, which starts and ends
+// at rest with zero acceleration and has bounded jerk. The move time is the longest of the
+// keyframe's own minimum and what the limits allow:
+//   peak speed  1.875 D / T,  peak acceleration 5.774 D / T^2,  peak jerk 60 D / T^3
+// for the translation distance and the rotation angle, and the same speed bound for every leg's
+// stroke change along the path (sampled), so no actuator is asked to outrun itself.
+//
+// Poses are X, Y, Z (mm) and roll, pitch, yaw (deg) in the IK's convention (R = Ry * Rz * Rx).
+// Plain floats, no allocation, no mbed.h: the keyframe list is the caller's array.
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include "LegKinematics.hpp"
+
+namespace PoseSequence {
+
+struct Pose {
+    float translation_mm[3] = { 0.0f, 0.0f, 0.0f };
+    float roll_deg = 0.0f;
+    float pitch_deg = 0.0f;
+    float yaw_deg = 0.0f;
+};
+
+struct Keyframe {
+    const char* label;
+    Pose pose;
+    float minMove_s;        // Take at least this long to get there (0 = as fast as the limits allow)
+    float hold_s;           // Then stay this long
+};
+
+struct Limits {
+    float speed_mm_s = 50.0f;
+    float accel_mm_s2 = 100.0f;
+    float jerk_mm_s3 = 400.0f;
+    float angularSpeed_dps = 20.0f;
+    float angularAccel_dps2 = 40.0f;
+    float angularJerk_dps3 = 160.0f;
+    float legSpeed_mm_s = 30.0f;    // Actuator stroke speed
+};
+
+// --- Unit quaternion (w, x, y, z) ---
+struct Quaternion {
+    float w = 1.0f, x = 0.0f, y = 0.0f, z = 0.0f;
+
+    static Quaternion axisAngle(float ax, float ay, float az, float angle_rad) {
+        float s = sinf(0.5f * angle_rad);
+        Quaternion q;
+        q.w = cosf(0.5f * angle_rad);
+        q.x = ax * s; q.y = ay * s; q.z = az * s;
+        return q;
+    }
+
+    Quaternion operator*(const Quaternion& b) const {
+        Quaternion r;
+        r.w = w * b.w - x * b.x - y * b.y - z * b.z;
+        r.x = w * b.x + x * b.w + y * b.z - z * b.y;
+        r.y = w * b.y - x * b.z + y * b.w + z * b.x;
+        r.z = w * b.z + x * b.y - y * b.x + z * b.w;
+        return r;
+    }
+
+    // Same rotation as PlatformGeometry::rotationFromRpy: Ry(pitch) * Rz(yaw) * Rx(roll)
+    static Quaternion fromRpy(float roll_deg, float pitch_deg, float yaw_deg) {
+        const float DEG = 3.14159265358979323846f / 180.0f;
+        return axisAngle(0, 1, 0, pitch_deg * DEG) * axisAngle(0, 0, 1, yaw_deg * DEG) * axisAngle(1, 0, 0, roll_deg * DEG);
+    }
+
+    void toMatrix(float R[3][3]) const {
+        R[0][0] = 1 - 2 * (y * y + z * z); R[0][1] = 2 * (x * y - w * z);     R[0][2] = 2 * (x * z + w * y);
+        R[1][0] = 2 * (x * y + w * z);     R[1][1] = 1 - 2 * (x * x + z * z); R[1][2] = 2 * (y * z - w * x);
+        R[2][0] = 2 * (x * z - w * y);     R[2][1] = 2 * (y * z + w * x);     R[2][2] = 1 - 2 * (x * x + y * y);
+    }
+
+    // Angle (rad) of the rotation between a and b
+    static float angleBetween(const Quaternion& a, const Quaternion& b) {
+        float d = fabsf(a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z);
+        return 2.0f * acosf(d > 1.0f ? 1.0f : d);
+    }
+
+    // Shortest-path spherical interpolation, t in 0..1
+    static Quaternion slerp(const Quaternion& a, Quaternion b, float t) {
+        float d = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+        if (d < 0.0f) {
+            d = -d;
+            b.w = -b.w; b.x = -b.x; b.y = -b.y; b.z = -b.z;
+        }
+        float ka, kb;
+        if (d > 0.9995f) {
+            ka = 1.0f - t;      // Nearly the same orientation: lerp and renormalize
+            kb = t;
+        } else {
+            float theta = acosf(d);
+            float s = sinf(theta);
+            ka = sinf((1.0f - t) * theta) / s;
+            kb = sinf(t * theta) / s;
+        }
+        Quaternion r;
+        r.w = ka * a.w + kb * b.w; r.x = ka * a.x + kb * b.x;
+        r.y = ka * a.y + kb * b.y; r.z = ka * a.z + kb * b.z;
+        float n = sqrtf(r.w * r.w + r.x * r.x + r.y * r.y + r.z * r.z);
+        r.w /= n; r.x /= n; r.y /= n; r.z /= n;
+        return r;
+    }
+};
+
+// Minimum-jerk position along a move, u = elapsed / duration in 0..1
+inline float minimumJerk(float u) {
+    if (u <= 0.0f) return 0.0f;
+    if (u >= 1.0f) return 1.0f;
+    return u * u * u * (10.0f + u * (-15.0f + 6.0f * u));
+}
+
+// Peak |d/du| of the profile is 1.875, peak |d2/du2| 5.774, peak |d3/du3| 60
+constexpr float PEAK_SPEED = 1.875f;
+constexpr float PEAK_ACCEL = 5.7735f;
+constexpr float PEAK_JERK = 60.0f;
+constexpr int LEG_SAMPLES = 8;      // Path samples used to bound leg speeds
+
+class KeyframeSequencer {
+public:
+    enum class State {
+        IDLE,       // Holding the last commanded pose, nothing to play
+        MOVING,     // Interpolating towards keyframes[index]
+        HOLDING     // At keyframes[index], waiting out its hold time
+    };
+
+    void configure(const Limits& newLimits, const Pose& start) {
+        limits = newLimits;
+        from.pose = start;
+        from.rotation = Quaternion::fromRpy(start.roll_deg, start.pitch_deg, start.yaw_deg);
+        to = from;
+        current = from;
+        frames = nullptr;
+        count = 0;
+        index = 0;
+        currentState = State::IDLE;
+    }
+
+    // Plays frames[0..n) starting from the pose commanded now; the array must outlive the run
+    void start(const Keyframe* newFrames, size_t n, float now_s) {
+        frames = newFrames;
+        count = n;
+        index = 0;
+        if (count == 0) {
+            currentState = State::IDLE;
+            return;
+        }
+        beginMove(frames[0].pose, frames[0].minMove_s, now_s);
+    }
+
+    // One move to pose, outside any keyframe list
+    void goTo(const Pose& pose, float minMove_s, float now_s) {
+        frames = nullptr;
+        count = 0;
+        index = 0;
+        beginMove(pose, minMove_s, now_s);
+    }
+
+    // Freezes at the pose commanded at the last tick, in that tick's cycle
+    void stop() {
+        from = current;
+        to = current;
+        frames = nullptr;
+        count = 0;
+        currentState = State::IDLE;
+    }
+
+    // Pose for now_s (rotation matrix and translation, ready for the IK). Advances through the
+    // keyframes as their moves and holds finish.
+    void tick(float now_s, float R[3][3], float T[3]) {
+        if (currentState == State::MOVING) {
+            float u = duration_s > 0.0f ? (now_s - moveStart_s) / duration_s : 1.0f;
+            float s = minimumJerk(u);
+            for (int axis = 0; axis < 3; ++axis) {
+                current.pose.translation_mm[axis] = from.pose.translation_mm[axis]
+                    + s * (to.pose.translation_mm[axis] - from.pose.translation_mm[axis]);
+            }
+            current.rotation = Quaternion::slerp(from.rotation, to.rotation, s);
+            if (u >= 1.0f) {
+                current = to;
+                currentState = frames ? State::HOLDING : State::IDLE;
+                holdUntil_s = now_s + (frames ? frames[index].hold_s : 0.0f);
+            }
+        }
+        if (currentState == State::HOLDING && now_s >= holdUntil_s) {
+            if (++index < count) {
+                beginMove(frames[index].pose, frames[index].minMove_s, now_s);
+            } else {
+                from = current;
+                frames = nullptr;
+                currentState = State::IDLE;
+            }
+        }
+        current.rotation.toMatrix(R);
+        for (int axis = 0; axis < 3; ++axis) {
+            T[axis] = current.pose.translation_mm[axis];
+        }
+    }
+
+    State state() const { return currentState; }
+    bool active() const { return currentState != State::IDLE; }
+    size_t keyframe() const { return index; }
+    float moveDuration_s() const { return duration_s; }
+
+private:
+    struct Orientation {
+        Pose pose;                  // Only the translation is interpolated
+        Quaternion rotation;        // The attitude, as SLERP uses it
+    };
+
+    void beginMove(const Pose& target, float minMove_s, float now_s) {
+        from = current;
+        to.pose = target;
+        to.rotation = Quaternion::fromRpy(target.roll_deg, target.pitch_deg, target.yaw_deg);
+
+        float distance = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            float d = to.pose.translation_mm[axis] - from.pose.translation_mm[axis];
+            distance += d * d;
+        }
+        distance = sqrtf(distance);
+        float angle_deg = Quaternion::angleBetween(from.rotation, to.rotation) * 57.2957795f;
+
+        float t = minMove_s;
+        t = fmaxf(t, profileTime(distance, limits.speed_mm_s, limits.accel_mm_s2, limits.jerk_mm_s3));
+        t = fmaxf(t, profileTime(angle_deg, limits.angularSpeed_dps, limits.angularAccel_dps2, limits.angularJerk_dps3));
+        t = fmaxf(t, PEAK_SPEED * maxLegRate() / limits.legSpeed_mm_s);
+
+        duration_s = t;
+        moveStart_s = now_s;
+        currentState = State::MOVING;
+    }
+
+    // Shortest T for which a minimum-jerk move over distance stays inside all three limits
+    static float profileTime(float distance, float speed, float accel, float jerk) {
+        if (distance <= 0.0f) return 0.0f;
+        float t = PEAK_SPEED * distance / speed;
+        t = fmaxf(t, sqrtf(PEAK_ACCEL * distance / accel));
+        t = fmaxf(t, cbrtf(PEAK_JERK * distance / jerk));
+        return t;
+    }
+
+    // Largest |d stroke / ds| of any leg along the path from -> to, from LEG_SAMPLES pieces
+    float maxLegRate() const {
+        float previous[PlatformGeometry::LEGS];
+        float strokes[PlatformGeometry::LEGS];
+        float worst = 0.0f;
+        for (int k = 0; k <= LEG_SAMPLES; ++k) {
+            float s = static_cast<float>(k) / LEG_SAMPLES;
+            float R[3][3], T[3];
+            Quaternion::slerp(from.rotation, to.rotation, s).toMatrix(R);
+            for (int axis = 0; axis < 3; ++axis) {
+                T[axis] = from.pose.translation_mm[axis] + s * (to.pose.translation_mm[axis] - from.pose.translation_mm[axis]);
+            }
+            PlatformGeometry::legStrokes(R, T, strokes);
+            for (size_t leg = 0; k > 0 && leg < PlatformGeometry::LEGS; ++leg) {
+                worst = fmaxf(worst, fabsf(strokes[leg] - previous[leg]) * LEG_SAMPLES);
+            }
+            for (size_t leg = 0; leg < PlatformGeometry::LEGS; ++leg) {
+                previous[leg] = strokes[leg];
+            }
+        }
+        return worst;
+    }
+
+    Limits limits;
+    Orientation from, to, current;
+    const Keyframe* frames = nullptr;
+    size_t count = 0;
+    size_t index = 0;
+    State currentState = State::IDLE;
+    float moveStart_s = 0.0f;
+    float duration_s = 0.0f;
+    float holdUntil_s = 0.0f;
+};
+
+} // namespace PoseSequence
+
+#endif // KEYFRAME_SEQUENCER_HPP
@@ -0,0 +1,109 @@
+#ifndef LEG_KINEMATICS_HPP
+#define LEG_KINEMATICS_HPP
+
+// --- Leg Kinematics ---
+// Actuator strokes for a platform pose, on the PlatformGeometry.hpp joints. Same maths as the
+// Eigen IK in Platform IK/main.cpp and the host's FlightData/PlatformIK (rotate the home joints
+// about their centroid, translate, leg length minus BASE_ACTUATOR_LENGTH), written out in plain
+// floats for firmware that doesn't carry Eigen.
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include "PlatformGeometry.hpp"
+
+namespace PlatformGeometry {
+
+// R = Ry * Rz * Rx, angles in degrees (getRotationMatrix() in Platform IK/main.cpp)
+inline void rotationFromRpy(float roll_deg, float pitch_deg, float yaw_deg, float R[3][3]) {
+    const float DEG = 3.14159265358979323846f / 180.0f;
+    float sr = sinf(roll_deg * DEG), cr = cosf(roll_deg * DEG);
+    float sp = sinf(pitch_deg * DEG), cp = cosf(pitch_deg * DEG);
+    float sy = sinf(yaw_deg * DEG), cy = cosf(yaw_deg * DEG);
+    R[0][0] = cp * cy;  R[0][1] = sp * sr - cp * sy * cr; R[0][2] = cp * sy * sr + sp * cr;
+    R[1][0] = sy;       R[1][1] = cy * cr;                R[1][2] = -cy * sr;
+    R[2][0] = -sp * cy; R[2][1] = sp * sy * cr + cp * sr; R[2][2] = cp * cr - sp * sy * sr;
+}
+
+// Centroid of the home platform joints, the point the platform rotates about
+inline void homeCentroid(float center[3]) {
+    center[0] = center[1] = center[2] = 0.0f;
+    for (size_t j = 0; j < LEGS; ++j) {
+        for (int axis = 0; axis < 3; ++axis) {
+            center[axis] += PLATFORM_JOINTS_HOME[j][axis] / LEGS;
+        }
+    }
+}
+
+// Unclamped stroke (mm) of each actuator A1..A6 for rotation R and translation T (mm)
+inline void legStrokes(const float R[3][3], const float T[3], float stroke_mm[LEGS]) {
+    float center[3];
+    homeCentroid(center);
+    for (size_t i = 0; i < LEGS; ++i) {
+        const float* p = PLATFORM_JOINTS_HOME[ACTUATOR_PLATFORM[i]];
+        const float* b = BASE_JOINTS[ACTUATOR_BASE[i]];
+        float local[3] = { p[0] - center[0], p[1] - center[1], p[2] - center[2] };
+        float length2 = 0.0f;
+        for (int row = 0; row < 3; ++row) {
+            float leg = R[row][0] * local[0] + R[row][1] * local[1] + R[row][2] * local[2]
+                      + center[row] + T[row] - b[row];
+            length2 += leg * leg;
+        }
+        stroke_mm[i] = sqrtf(length2) - BASE_ACTUATOR_LENGTH;
+    }
+}
+
+// Jacobian of the strokes with respect to the pose X, Y, Z (mm), roll, pitch, yaw (deg), at that
+// pose: J[leg][axis] is mm of stroke per mm or per degree. Analytic: a leg's length changes by its
+// unit vector n dotted with how its platform joint moves, and with R = Ry * Rz * Rx the joint at
+// R q moves by R (x cross q) per radian of roll, y cross R q per radian of pitch and
+// (Ry z) cross R q per radian of yaw.
+inline void legJacobian(const float pose[6], float J[LEGS][6]) {
+    const float DEG = 3.14159265358979323846f / 180.0f;
+    float R[3][3], center[3];
+    rotationFromRpy(pose[3], pose[4], pose[5], R);
+    homeCentroid(center);
+    float yawAxis[3] = { sinf(pose[4] * DEG), 0.0f, cosf(pose[4] * DEG) };
+    for (size_t i = 0; i < LEGS; ++i) {
+        const float* p = PLATFORM_JOINTS_HOME[ACTUATOR_PLATFORM[i]];
+        const float* b = BASE_JOINTS[ACTUATOR_BASE[i]];
+        float q[3] = { p[0] - center[0], p[1] - center[1], p[2] - center[2] };
+        float xq[3] = { 0.0f, -q[2], q[1] };                            // x cross q
+        float Rq[3], Rxq[3], n[3];
+        float length = 0.0f;
+        for (int row = 0; row < 3; ++row) {
+            Rq[row] = R[row][0] * q[0] + R[row][1] * q[1] + R[row][2] * q[2];
+            Rxq[row] = R[row][0] * xq[0] + R[row][1] * xq[1] + R[row][2] * xq[2];
+            n[row] = Rq[row] + center[row] + pose[row] - b[row];
+            length += n[row] * n[row];
+        }
+        length = sqrtf(length);
+        for (int row = 0; row < 3; ++row) {
+            n[row] /= length;
+        }
+        float pitchMove[3] = { Rq[2], 0.0f, -Rq[0] };                   // y cross R q
+        float yawMove[3] = { yawAxis[1] * Rq[2] - yawAxis[2] * Rq[1],   // (Ry z) cross R q
+                             yawAxis[2] * Rq[0] - yawAxis[0] * Rq[2],
+                             yawAxis[0] * Rq[1] - yawAxis[1] * Rq[0] };
+        J[i][0] = n[0];
+        J[i][1] = n[1];
+        J[i][2] = n[2];
+        J[i][3] = DEG * (n[0] * Rxq[0] + n[1] * Rxq[1] + n[2] * Rxq[2]);
+        J[i][4] = DEG * (n[0] * pitchMove[0] + n[1] * pitchMove[1] + n[2] * pitchMove[2]);
+        J[i][5] = DEG * (n[0] * yawMove[0] + n[1] * yawMove[1] + n[2] * yawMove[2]);
+    }
+}
+
+// Clamps strokes to 0 .. MAX_STROKE; false if any leg had to be clamped
+inline bool clampStrokes(float stroke_mm[LEGS]) {
+    bool reachable = true;
+    for (size_t i = 0; i < LEGS; ++i) {
+        if (stroke_mm[i] < 0.0f) { stroke_mm[i] = 0.0f; reachable = false; }
+        if (stroke_mm[i] > MAX_STROKE) { stroke_mm[i] = MAX_STROKE; reachable = false; }
+    }
+    return reachable;
+}
+
+} // namespace PlatformGeometry
+
+#endif // LEG_KINEMATICS_HPP
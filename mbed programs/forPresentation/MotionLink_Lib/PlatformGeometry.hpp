@@ -0,0 +1,51 @@
+#ifndef PLATFORM_GEOMETRY_HPP
+#define PLATFORM_GEOMETRY_HPP
+
+// --- Stewart Platform Geometry ---
+// Joint positions and actuator wiring of the platform (from the MATLAB model). The firmware IK
+// (Platform IK/main.cpp) and the host-side IK (FlightData/PlatformIK) both read them from here,
+// so the two can never disagree about where a leg is. Plain floats, no Eigen, so it stays
+// shared between the mbed firmware and the host bridge.
+//
+// Frames: base joints sit in the z = 0 plane; platform joints are at their home pose (after the
+// 180-degree rotation in the MATLAB script). A pose rotates the platform about the centroid of
+// its home joints (R = Ry * Rz * Rx, angles in degrees) and then translates it.
+
+#include <cstdint>
+#include <cstddef>
+
+namespace PlatformGeometry {
+
+constexpr size_t LEGS = 6;
+
+// Total leg length (mm) at zero stroke, including the joints
+constexpr float BASE_ACTUATOR_LENGTH = 500.0f;
+// Usable stroke (mm), DigitalPosFeedback::MAX_STROKE on the firmware side
+constexpr float MAX_STROKE = 300.0f;
+
+// x, y, z (mm)
+constexpr float BASE_JOINTS[LEGS][3] = {
+    /*b1*/ { -293.2250f, -227.0286f, 0.0f },
+    /*b2*/ {  293.2250f, -227.0286f, 0.0f },
+    /*b3*/ {  343.2250f, -140.4260f, 0.0f },
+    /*b4*/ {   50.0000f,  367.4546f, 0.0f },
+    /*b5*/ {  -50.0000f,  367.4546f, 0.0f },
+    /*b6*/ { -343.2250f, -140.4260f, 0.0f }
+};
+
+constexpr float PLATFORM_JOINTS_HOME[LEGS][3] = {
+    /*p1*/ {  -50.0000f, -286.1637f, 458.5300f },
+    /*p2*/ {   50.0000f, -286.1637f, 458.5300f },
+    /*p3*/ {  272.8250f,   99.7806f, 458.5300f },
+    /*p4*/ {  222.8250f,  186.3831f, 458.5300f },
+    /*p5*/ { -222.8250f,  186.3831f, 458.5300f },
+    /*p6*/ { -272.8250f,   99.7806f, 458.5300f }
+};
+
+// Actuator i (A1..A6) runs from BASE_JOINTS[ACTUATOR_BASE[i]] to PLATFORM_JOINTS_HOME[ACTUATOR_PLATFORM[i]]
+constexpr uint8_t ACTUATOR_BASE[LEGS]     = { 4, 3, 2, 1, 0, 5 };   // b5, b4, b3, b2, b1, b6
+constexpr uint8_t ACTUATOR_PLATFORM[LEGS] = { 1, 0, 5, 4, 3, 2 };   // p2, p1, p6, p5, p4, p3
+
+} // namespace PlatformGeometry
+
+#endif // PLATFORM_GEOMETRY_HPP
@@ -1,12 +1,14 @@
 #include "mbed.h"
 #include <cstdio> // Use cstdio for printf
 #include "DigiPosFeedback_Lib/DigiPosFeedback.hpp"
+#include "MotionLink_Lib/LegKinematics.hpp"
+#include "MotionLink_Lib/KeyframeSequencer.hpp"
 #include <vector> // To hold actuator pointers
 #include <chrono> // For durations
-// #include "mbed_pinmap.h" // <--- REMOVE THIS INCLUDE
 
 using namespace std;
 using namespace std::chrono;
+using PoseSequence::Keyframe;
 
 // LED indicators
 DigitalOut led1(LED1); // Indicate running sequence
@@ -19,54 +21,123 @@ static BufferedSerial terminal(USBTX, USBRX, 115200);
 const float ACTUATOR_SPEED = 30.6827057f; // mm/s
 const float MAX_ACTUATOR_STROKE = 300.0f; // mm
 const float ACTUATOR_DUTY_CYCLE = 0.6f;   // Default duty cycle
+const float ACTUATOR_TOLERANCE = 3.0f;    // mm, bang-bang deadband around each leg's target
 
-// Timing calculations
+// Timing
 const float TIME_FULL_STROKE_S = MAX_ACTUATOR_STROKE / ACTUATOR_SPEED; // Approx 9.777 seconds
-const milliseconds TIME_FOR_100MM = chrono::duration_cast<milliseconds>(chrono::duration<float>((100.0f / MAX_ACTUATOR_STROKE) * TIME_FULL_STROKE_S));
-const milliseconds TIME_FOR_40_DEG = 3000ms; // Estimated time for 40deg rotation
-
-// Durations for motion segments
-const milliseconds INITIAL_EXTEND_DURATION = 3500ms;
-const milliseconds ROTATION_DURATION_HALF = TIME_FOR_40_DEG;
-const milliseconds TRANSLATION_DURATION_HALF = TIME_FOR_100MM;
-const milliseconds PAUSE_DURATION = 1000ms;
+const milliseconds CONTROL_PERIOD = 20ms;  // One tick: read keys, advance the sequencer, drive the legs
+const milliseconds STATUS_PERIOD = 1000ms;
+const float PAUSE_S = 1.0f;                // Hold at each keyframe
 const milliseconds HOMING_DURATION = chrono::duration_cast<milliseconds>(chrono::duration<float>(TIME_FULL_STROKE_S * 1.1f));
 
+// --- Motion ---
+// The legs are position-estimated only (no end stops besides full retraction), so poses are
+// played around a neutral stroke rather than as absolute IK lengths: each leg's target is
+// NEUTRAL_STROKE plus how much the IK says that leg changes between the home pose and the
+// keyframe pose. Mid-stroke leaves the most room both ways, the same idea as the old script's
+// "initial extend" step.
+const float NEUTRAL_STROKE = MAX_ACTUATOR_STROKE / 2.0f;
+
+const PoseSequence::Limits MOTION_LIMITS = [] {
+    PoseSequence::Limits limits;
+    limits.speed_mm_s = 50.0f;
+    limits.accel_mm_s2 = 100.0f;
+    limits.jerk_mm_s3 = 400.0f;
+    limits.angularSpeed_dps = 20.0f;
+    limits.angularAccel_dps2 = 40.0f;
+    limits.angularJerk_dps3 = 160.0f;
+    limits.legSpeed_mm_s = 0.9f * ACTUATOR_SPEED;   // Leave the legs a margin to catch up
+    return limits;
+}();
+
+// The demo, steps 2-16 of the old sleep-chained script as poses:
+//                 label                       X, Y, Z (mm)      roll, pitch, yaw (deg)  min move (s), hold (s)
+const Keyframe DEMO_SEQUENCE[] = {
+    { "Roll Left (+40 deg)",        { {    0.0f,    0.0f, 0.0f },  40.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Roll Right (-40 deg)",       { {    0.0f,    0.0f, 0.0f }, -40.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Roll Center",                { {    0.0f,    0.0f, 0.0f },   0.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Pitch Up (+40 deg)",         { {    0.0f,    0.0f, 0.0f },   0.0f,  40.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Pitch Down (-40 deg)",       { {    0.0f,    0.0f, 0.0f },   0.0f, -40.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Pitch Center",               { {    0.0f,    0.0f, 0.0f },   0.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Yaw Left (+40 deg)",         { {    0.0f,    0.0f, 0.0f },   0.0f,   0.0f,  40.0f }, 0.0f, PAUSE_S },
+    { "Yaw Right (-40 deg)",        { {    0.0f,    0.0f, 0.0f },   0.0f,   0.0f, -40.0f }, 0.0f, PAUSE_S },
+    { "Yaw Center",                 { {    0.0f,    0.0f, 0.0f },   0.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Translate X Right (+100mm)", { {  100.0f,    0.0f, 0.0f },   0.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Translate X Left (-100mm)",  { { -100.0f,    0.0f, 0.0f },   0.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Translate X Center",         { {    0.0f,    0.0f, 0.0f },   0.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Translate Y Forward (+100mm)", { {  0.0f,  100.0f, 0.0f },   0.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Translate Y Backward (-100mm)", { { 0.0f, -100.0f, 0.0f },   0.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+    { "Translate Y Center",         { {    0.0f,    0.0f, 0.0f },   0.0f,   0.0f,   0.0f }, 0.0f, PAUSE_S },
+};
+const size_t DEMO_STEPS = sizeof(DEMO_SEQUENCE) / sizeof(DEMO_SEQUENCE[0]);
+
 
 // --- Actuator Setup ---
 std::vector<DigitalPosFeedback*> actuators;
 
 // --- State Machine ---
+// Every state is advanced once per tick and nothing in the loop waits, so 's' and 'q' take
+// effect on the next tick whatever the platform is doing.
 enum class DemoState {
-    IDLE,
-    RUNNING,
-    STOPPING,
-    HOMING
+    IDLE,       // Legs stopped
+    RAISING,    // Driving every leg to NEUTRAL_STROKE before the sequence (old step 1)
+    RUNNING,    // Sequencer playing DEMO_SEQUENCE
+    HOMING      // Retracting everything until homeDeadline (old step 17)
 };
 DemoState currentState = DemoState::IDLE;
-bool sequenceComplete = false;
 
+PoseSequence::KeyframeSequencer sequencer;
+float homeStrokes[PlatformGeometry::LEGS];   // IK strokes of the neutral pose
+Timer demoClock;
+float homeDeadline_s = 0.0f;
+size_t announcedStep = DEMO_STEPS;
 
-// --- Helper Functions (stopAllActuators, homePlatform, printStatus - unchanged) ---
-// Stop all actuators
+
+// --- Helper Functions ---
+// Stop all actuators and hold them where they are
 void stopAllActuators() {
     for (auto& act : actuators) {
         act->stop();
+        act->targetPosition = act->currentPosition;
+    }
+}
+
+float demoTime_s() {
+    return duration<float>(demoClock.elapsed_time()).count();
+}
+
+// Leg targets for a pose: neutral stroke plus the IK change from the home pose. False if any
+// leg had to be clamped.
+bool poseToTargets(const float R[3][3], const float T[3], float target_mm[PlatformGeometry::LEGS]) {
+    PlatformGeometry::legStrokes(R, T, target_mm);
+    for (size_t i = 0; i < PlatformGeometry::LEGS; ++i) {
+        target_mm[i] = NEUTRAL_STROKE + (target_mm[i] - homeStrokes[i]);
+    }
+    return PlatformGeometry::clampStrokes(target_mm);
+}
+
+// Warn up front about keyframes that need more stroke than the legs have around neutral
+void checkSequence() {
+    for (size_t k = 0; k < DEMO_STEPS; ++k) {
+        const PoseSequence::Pose& pose = DEMO_SEQUENCE[k].pose;
+        float R[3][3], target_mm[PlatformGeometry::LEGS];
+        PlatformGeometry::rotationFromRpy(pose.roll_deg, pose.pitch_deg, pose.yaw_deg, R);
+        if (!poseToTargets(R, pose.translation_mm, target_mm)) {
+            printf("Warning: step %zu (%s) is outside the stroke range and will be clamped\n", k + 2, DEMO_SEQUENCE[k].label);
+        }
     }
 }
 
-// Retract all actuators for homing
-void homePlatform() {
+// Start retracting everything; the loop finishes the job when homeDeadline_s passes
+void startHoming() {
+    sequencer.stop();
     printf("Homing: Retracting all actuators...\n");
     for (auto& act : actuators) {
         act->retract();
     }
-    ThisThread::sleep_for(HOMING_DURATION); // Wait for retraction
-    stopAllActuators();
-    for (auto& act : actuators) { // Reset estimated position after homing
-        act->resetPosition();
-    }
-    printf("Homing complete (estimated).\n");
+    homeDeadline_s = demoTime_s() + duration<float>(HOMING_DURATION).count();
+    currentState = DemoState::HOMING;
+    led1 = 1; led2 = 1;
 }
 
 // Print current status
@@ -77,11 +148,15 @@ void printStatus() {
     printf("State: ");
     switch (currentState) {
         case DemoState::IDLE:     printf("IDLE (Press 'e' to start, 'q' to home)\n"); break;
-        case DemoState::RUNNING:  printf("RUNNING SEQUENCE (Press 's' to stop, 'q' to home)\n"); break;
-        case DemoState::STOPPING: printf("STOPPING...\n"); break;
+        case DemoState::RAISING:  printf("RAISING TO NEUTRAL (Press 's' to stop, 'q' to home)\n"); break;
+        case DemoState::RUNNING:
+            printf("RUNNING step %zu/%zu: %s (Press 's' to stop, 'q' to home)\n",
+                   sequencer.keyframe() + 2, DEMO_STEPS + 1,
+                   DEMO_SEQUENCE[sequencer.keyframe() < DEMO_STEPS ? sequencer.keyframe() : DEMO_STEPS - 1].label);
+            break;
         case DemoState::HOMING:   printf("HOMING...\n"); break;
     }
-    printf("Target Ranges: +/- %.0f deg, +/- %.0f mm\n", 40.0, 100.0);
+    printf("Target Ranges: +/- %.0f deg, +/- %.0f mm around %.0f mm stroke\n", 40.0, 100.0, NEUTRAL_STROKE);
     printf("-----------------------------\n");
     for (size_t i = 0; i < actuators.size(); ++i) {
         char label[20];
@@ -89,8 +164,7 @@ void printStatus() {
         actuators[i]->printPosition(label);
     }
     printf("-----------------------------\n");
-    printf("Note: Platform may not remain perfectly flat during pure translation\n");
-    printf("      due to open-loop control and actuator mechanics.\n");
+    printf("Note: Positions are open-loop estimates from actuator speed and time.\n");
     fflush(stdout); // Make sure output is sent
 }
 
@@ -102,10 +176,8 @@ int main()
 
     printf("--- Mbed Stewart Platform Controller Initializing ---\n");
     printf("Full stroke time: %.2f s\n", TIME_FULL_STROKE_S);
-    printf("Time for 100mm (half trans): %lld ms\n", TRANSLATION_DURATION_HALF.count());
-    printf("Time for 40 deg (half rot): %lld ms (estimated)\n", ROTATION_DURATION_HALF.count());
+    printf("Control tick: %lld ms, %zu keyframes\n", CONTROL_PERIOD.count(), DEMO_STEPS);
     printf("Actuator Mapping (Check Wiring):\n");
-    // *** CHANGE HERE: Use string literals for pin names ***
     printf("  Actuator 1 (A1 - %s,%s)\n", "PC_8", "PC_9");
     printf("  Actuator 2 (A2 - %s,%s)\n", "PE_5", "PE_6");
     printf("  Actuator 3 (A3 - %s,%s)\n", "PB_8", "PB_9");
@@ -123,148 +195,123 @@ int main()
     actuators.push_back(new DigitalPosFeedback(PD_13, PD_12, ACTUATOR_SPEED, ACTUATOR_DUTY_CYCLE)); // Actuator 5 (A5)
     actuators.push_back(new DigitalPosFeedback(PE_9, PE_11, ACTUATOR_SPEED, ACTUATOR_DUTY_CYCLE)); // Actuator 6 (A6)
 
-    if (actuators.size() != 6) {
+    if (actuators.size() != PlatformGeometry::LEGS) {
         printf("Error: Failed to initialize all actuators!\n");
         led1 = 1; led2 = 1; return 1;
     }
 
+    for (auto& act : actuators) {
+        act->setTolerance(ACTUATOR_TOLERANCE);
+        act->resetPosition();
+    }
     stopAllActuators();
-     for (auto& act : actuators) act->resetPosition();
+
+    float R[3][3], T[3] = { 0.0f, 0.0f, 0.0f };
+    PlatformGeometry::rotationFromRpy(0.0f, 0.0f, 0.0f, R);
+    PlatformGeometry::legStrokes(R, T, homeStrokes);
+    sequencer.configure(MOTION_LIMITS, PoseSequence::Pose());
+    checkSequence();
 
     currentState = DemoState::IDLE;
     led1 = 0; led2 = 1;
+    demoClock.start();
 
+    auto nextTick = Kernel::Clock::now();
+    auto nextStatus = nextTick;
     while (true) {
-        // --- Input Handling (unchanged) ---
+        float now_s = demoTime_s();
+
+        // --- Input Handling ---
         char inputChar = '\0';
-        if (terminal.readable()) {
-            ssize_t numRead = terminal.read(&inputChar, 1);
-            if (numRead > 0) {
-                 if (inputChar == 'e' && currentState == DemoState::IDLE) {
-                    currentState = DemoState::RUNNING; sequenceComplete = false;
-                    printf("Starting sequence...\n"); led1 = 1; led2 = 0;
-                } else if (inputChar == 's') {
-                    if (currentState == DemoState::RUNNING || currentState == DemoState::HOMING) {
-                         currentState = DemoState::STOPPING; printf("Stop requested.\n");
-                    } else {
-                         stopAllActuators(); currentState = DemoState::IDLE; led1 = 0; led2 = 1;
-                    }
-                } else if (inputChar == 'q') {
-                     if (currentState != DemoState::HOMING) {
-                        currentState = DemoState::HOMING; printf("Home requested.\n"); led1 = 1; led2 = 1;
-                     }
+        if (terminal.readable() && terminal.read(&inputChar, 1) > 0) {
+            if (inputChar == 'e' && currentState == DemoState::IDLE) {
+                printf("Starting sequence...\n");
+                printf("Step 1: Raise to neutral (%.0f mm)\n", NEUTRAL_STROKE);
+                for (auto& act : actuators) {
+                    act->targetPosition = NEUTRAL_STROKE;
                 }
+                currentState = DemoState::RAISING;
+                led1 = 1; led2 = 0;
+            } else if (inputChar == 's') {
+                sequencer.stop();
+                stopAllActuators();
+                if (currentState != DemoState::IDLE) {
+                    printf("Stopped.\n");
+                }
+                currentState = DemoState::IDLE;
+                led1 = 0; led2 = 1;
+            } else if (inputChar == 'q' && currentState != DemoState::HOMING) {
+                printf("Home requested.\n");
+                startHoming();
             }
         }
 
+        // --- State Machine Logic ---
+        for (auto& act : actuators) {
+            act->updatePosition();
+        }
 
-        // --- State Machine Logic (unchanged from previous version) ---
         switch (currentState) {
             case DemoState::IDLE:
-                led1 = 0; led2 = 1;
                 break;
 
-            case DemoState::RUNNING:
-                if (!sequenceComplete) {
-                    printf("\n--- SEQUENCE START ---\n");
-
-                    // Steps 1-10 (Initial Extend, Roll, Pitch, Yaw) are unchanged...
-                    // 1. Initial Extend
-                    printf("Step 1: Initial Extend (%lld ms)\n", INITIAL_EXTEND_DURATION.count());
-                    for(auto& act : actuators) act->extend();
-                    ThisThread::sleep_for(INITIAL_EXTEND_DURATION); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 2. Roll Left
-                    printf("Step 2: Roll Left (+40 deg, %lld ms)\n", ROTATION_DURATION_HALF.count());
-                    actuators[1]->extend(); actuators[2]->extend(); actuators[4]->retract(); actuators[5]->retract(); actuators[0]->stop(); actuators[3]->stop();
-                    ThisThread::sleep_for(ROTATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 3. Roll Right
-                    printf("Step 3: Roll Right (-40 deg, %lld ms)\n", (ROTATION_DURATION_HALF * 2).count());
-                    actuators[4]->extend(); actuators[5]->extend(); actuators[1]->retract(); actuators[2]->retract(); actuators[0]->stop(); actuators[3]->stop();
-                    ThisThread::sleep_for(ROTATION_DURATION_HALF * 2); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 4. Roll Center
-                    printf("Step 4: Roll Center (from -40 deg, %lld ms)\n", ROTATION_DURATION_HALF.count());
-                    actuators[1]->extend(); actuators[2]->extend(); actuators[4]->retract(); actuators[5]->retract(); actuators[0]->stop(); actuators[3]->stop();
-                    ThisThread::sleep_for(ROTATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 5. Pitch Up
-                    printf("Step 5: Pitch Up (+40 deg, %lld ms)\n", ROTATION_DURATION_HALF.count());
-                    actuators[0]->extend(); actuators[5]->extend(); actuators[2]->retract(); actuators[3]->retract(); actuators[1]->stop(); actuators[4]->stop();
-                    ThisThread::sleep_for(ROTATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 6. Pitch Down
-                    printf("Step 6: Pitch Down (-40 deg, %lld ms)\n", (ROTATION_DURATION_HALF * 2).count());
-                    actuators[2]->extend(); actuators[3]->extend(); actuators[0]->retract(); actuators[5]->retract(); actuators[1]->stop(); actuators[4]->stop();
-                    ThisThread::sleep_for(ROTATION_DURATION_HALF * 2); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 7. Pitch Center
-                    printf("Step 7: Pitch Center (from -40 deg, %lld ms)\n", ROTATION_DURATION_HALF.count());
-                    actuators[0]->extend(); actuators[5]->extend(); actuators[2]->retract(); actuators[3]->retract(); actuators[1]->stop(); actuators[4]->stop();
-                    ThisThread::sleep_for(ROTATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 8. Yaw Left
-                    printf("Step 8: Yaw Left (+40 deg, %lld ms)\n", ROTATION_DURATION_HALF.count());
-                    actuators[0]->extend(); actuators[2]->extend(); actuators[4]->extend(); actuators[1]->retract(); actuators[3]->retract(); actuators[5]->retract();
-                    ThisThread::sleep_for(ROTATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 9. Yaw Right
-                    printf("Step 9: Yaw Right (-40 deg, %lld ms)\n", (ROTATION_DURATION_HALF * 2).count());
-                    actuators[1]->extend(); actuators[3]->extend(); actuators[5]->extend(); actuators[0]->retract(); actuators[2]->retract(); actuators[4]->retract();
-                    ThisThread::sleep_for(ROTATION_DURATION_HALF * 2); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 10. Yaw Center
-                    printf("Step 10: Yaw Center (from -40 deg, %lld ms)\n", ROTATION_DURATION_HALF.count());
-                    actuators[0]->extend(); actuators[2]->extend(); actuators[4]->extend(); actuators[1]->retract(); actuators[3]->retract(); actuators[5]->retract();
-                    ThisThread::sleep_for(ROTATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 11. Translate X Right
-                    printf("Step 11: Translate X Right (+100mm, %lld ms)\n", TRANSLATION_DURATION_HALF.count());
-                    actuators[1]->extend(); actuators[2]->extend();   actuators[4]->retract(); actuators[5]->retract(); actuators[0]->stop(); actuators[3]->stop();
-                    ThisThread::sleep_for(TRANSLATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 12. Translate X Left
-                    printf("Step 12: Translate X Left (-100mm, %lld ms)\n", (TRANSLATION_DURATION_HALF * 2).count());
-                    actuators[1]->retract(); actuators[2]->retract(); actuators[4]->extend(); actuators[5]->extend();   actuators[0]->stop(); actuators[3]->stop();
-                    ThisThread::sleep_for(TRANSLATION_DURATION_HALF * 2); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 13. Translate X Center
-                    printf("Step 13: Translate X Center (from -100mm, %lld ms)\n", TRANSLATION_DURATION_HALF.count());
-                    actuators[1]->extend(); actuators[2]->extend();   actuators[4]->retract(); actuators[5]->retract(); actuators[0]->stop(); actuators[3]->stop();
-                    ThisThread::sleep_for(TRANSLATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 14. Translate Y Forward
-                    printf("Step 14: Translate Y Forward (+100mm, %lld ms)\n", TRANSLATION_DURATION_HALF.count());
-                    actuators[0]->extend(); actuators[3]->extend();   actuators[2]->retract(); actuators[5]->retract(); actuators[1]->stop(); actuators[4]->stop();
-                    ThisThread::sleep_for(TRANSLATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 15. Translate Y Backward
-                    printf("Step 15: Translate Y Backward (-100mm, %lld ms)\n", (TRANSLATION_DURATION_HALF * 2).count());
-                    actuators[0]->retract(); actuators[3]->retract(); actuators[2]->extend(); actuators[5]->extend();   actuators[1]->stop(); actuators[4]->stop();
-                    ThisThread::sleep_for(TRANSLATION_DURATION_HALF * 2); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 16. Translate Y Center
-                    printf("Step 16: Translate Y Center (from -100mm, %lld ms)\n", TRANSLATION_DURATION_HALF.count());
-                    actuators[0]->extend(); actuators[3]->extend();   actuators[2]->retract(); actuators[5]->retract(); actuators[1]->stop(); actuators[4]->stop();
-                    ThisThread::sleep_for(TRANSLATION_DURATION_HALF); stopAllActuators(); ThisThread::sleep_for(PAUSE_DURATION); if (currentState != DemoState::RUNNING) break;
-                    // 17. Return Home
-                    printf("Step 17: Returning Home...\n");
-                    homePlatform();
-
-                    printf("--- SEQUENCE COMPLETE ---\n");
-                    sequenceComplete = true;
-                    currentState = DemoState::IDLE;
-                    led1 = 0; led2 = 1;
+            case DemoState::RAISING: {
+                bool raised = true;
+                for (auto& act : actuators) {
+                    act->moveToTarget();
+                    raised = raised && act->state == DigitalPosFeedback::ActuatorState::STOPPED;
                 }
-                break; // End of RUNNING case
+                if (raised) {
+                    sequencer.configure(MOTION_LIMITS, PoseSequence::Pose());
+                    sequencer.start(DEMO_SEQUENCE, DEMO_STEPS, now_s);
+                    announcedStep = DEMO_STEPS;
+                    currentState = DemoState::RUNNING;
+                }
+                break;
+            }
 
-            case DemoState::STOPPING:
-                stopAllActuators();
-                currentState = DemoState::IDLE;
-                led1 = 0; led2 = 1;
+            case DemoState::RUNNING: {
+                sequencer.tick(now_s, R, T);
+                float target_mm[PlatformGeometry::LEGS];
+                poseToTargets(R, T, target_mm);
+                for (size_t i = 0; i < PlatformGeometry::LEGS; ++i) {
+                    actuators[i]->targetPosition = target_mm[i];
+                    actuators[i]->moveToTarget();
+                }
+                if (sequencer.keyframe() != announcedStep && sequencer.keyframe() < DEMO_STEPS) {
+                    announcedStep = sequencer.keyframe();
+                    printf("Step %zu: %s (%.1f s)\n", announcedStep + 2, DEMO_SEQUENCE[announcedStep].label, sequencer.moveDuration_s());
+                }
+                if (!sequencer.active()) {
+                    printf("Step %zu: Returning Home...\n", DEMO_STEPS + 2);
+                    startHoming();
+                }
                 break;
+            }
 
             case DemoState::HOMING:
-                homePlatform();
-                currentState = DemoState::IDLE;
-                led1 = 0; led2 = 1;
+                if (now_s >= homeDeadline_s) {
+                    stopAllActuators();
+                    for (auto& act : actuators) { // Reset estimated position after homing
+                        act->resetPosition();
+                        act->targetPosition = 0.0f;
+                    }
+                    printf("Homing complete (estimated).\n");
+                    currentState = DemoState::IDLE;
+                    led1 = 0; led2 = 1;
+                }
                 break;
         }
 
-        // --- Update and Print Status ---
-        for (auto& act : actuators) {
-            act->updatePosition();
+        // --- Print Status (about once a second, it costs several ms of printf) ---
+        if (Kernel::Clock::now() >= nextStatus) {
+            printStatus();
+            nextStatus += STATUS_PERIOD;
         }
-        printStatus();
 
-        // Main loop delay
-        ThisThread::sleep_for(50ms);
+        // Fixed-rate tick: sleep until the next period boundary, not for a fixed time after the work
+        nextTick += CONTROL_PERIOD;
+        ThisThread::sleep_until(nextTick);
     }
     // return 0; // Unreachable
-}
\ No newline at end of file
+}